@@ -0,0 +1,65 @@
+#include "state_handlers.h"
+#include <Arduino.h>
+
+// ========================================
+// READY / PRODUCTION STATE HANDLERS
+// ========================================
+// Kept apart from state_handlers.cpp so they build on the host
+// (tests/host/main_screen_tests.cpp). Everything these states show or
+// persist is done by the main loop, every state alike:
+//   screen       displayMainScreen() renders the DisplayView. Drawing
+//                here as well would dirty the frame on every call and
+//                overwrite the view's fields.
+//   hour         serviceHourBoundary() -> handleHourChange()
+//   counters     writeCheckpoint() at the configured save interval,
+//                saveState() every minute
+// What is left is the periodic health check. A false return sends the
+// loop to STATE_ERROR.
+
+static const unsigned long HEALTH_CHECK_INTERVAL = 30000; // Check health every 30 seconds
+
+static unsigned long lastHealthCheckTime = 0;
+
+// ============================================================================
+// READY STATE HANDLER
+// ============================================================================
+
+bool executeReadyState() {
+  unsigned long currentTime = millis();
+
+  // Monitor system health
+  if (currentTime - lastHealthCheckTime >= HEALTH_CHECK_INTERVAL) {
+    if (!checkSystemHealth()) {
+      LoggerManager::warn("System health check detected issues");
+      return false;
+    }
+    lastHealthCheckTime = currentTime;
+  }
+
+  // Check for production start signal (event-driven)
+  // This is handled by event processing in main loop
+
+  return true;
+}
+
+// ============================================================================
+// PRODUCTION STATE HANDLER
+// ============================================================================
+
+bool executeProductionState() {
+  unsigned long currentTime = millis();
+
+  // Monitor system health during production
+  if (currentTime - lastHealthCheckTime >= HEALTH_CHECK_INTERVAL) {
+    if (!checkSystemHealth()) {
+      LoggerManager::error("System health degraded during production");
+      return false;
+    }
+    lastHealthCheckTime = currentTime;
+  }
+
+  // Check for production stop signal (event-driven)
+  // This is handled by event processing in main loop
+
+  return true;
+}
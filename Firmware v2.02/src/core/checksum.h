@@ -0,0 +1,24 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// CRC32 (IEEE 802.3, reflected, poly 0xEDB88320)
+// ========================================
+// Used by every binary record written to SD or EEPROM so a torn or
+// bit-rotted record is rejected instead of being parsed as valid data.
+//
+// Incremental use:
+//   uint32_t crc = crc32Begin();
+//   crc = crc32Update(crc, part1, len1);
+//   crc = crc32Update(crc, part2, len2);
+//   uint32_t result = crc32End(crc);
+inline uint32_t crc32Begin() { return 0xFFFFFFFFu; }
+inline uint32_t crc32End(uint32_t crc) { return crc ^ 0xFFFFFFFFu; }
+
+uint32_t crc32Update(uint32_t crc, const void* data, size_t length);
+uint32_t crc32(const void* data, size_t length);
+
+#endif // CHECKSUM_H
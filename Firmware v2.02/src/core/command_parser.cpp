@@ -0,0 +1,117 @@
+#include "command_parser.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================
+// COMMAND PARSER IMPLEMENTATION
+// ========================================
+
+char* CommandParser::normalize(char* line) {
+  while (isspace((unsigned char)*line)) {
+    line++;
+  }
+  char* end = line + strlen(line);
+  while (end > line && isspace((unsigned char)end[-1])) {
+    end--;
+  }
+  *end = '\0';
+  for (char* c = line; c < end; c++) {
+    *c = toupper((unsigned char)*c);
+  }
+  return line;
+}
+
+const CommandSpec* CommandParser::find(const CommandSpec* table, size_t count, const char* name) {
+  size_t low = 0;
+  size_t high = count;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    int order = strcmp(name, table[mid].name);
+    if (order == 0) {
+      return &table[mid];
+    }
+    if (order < 0) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return nullptr;
+}
+
+bool CommandParser::parseArgs(const char* schema, char* rest, CommandArgs& args) {
+  args.count = 0;
+  const char* letter = schema;
+  bool optional = false;
+
+  while (rest != nullptr) {
+    if (*letter == '*' && args.count > 0) {
+      letter = schema;               // Next group
+    }
+    if (*letter == '\0' || *letter == '*' || args.count >= CommandArgs::MAX_ARGS) {
+      return false;                  // More arguments than the schema takes
+    }
+    if (isupper((unsigned char)*letter)) {
+      optional = true;
+    }
+    char kind = tolower((unsigned char)*letter);
+
+    char* token = rest;
+    if (kind == 't') {
+      rest = nullptr;
+    } else {
+      rest = strchr(token, ',');
+      if (rest != nullptr) {
+        *rest++ = '\0';
+      }
+    }
+    if (*token == '\0') {
+      return false;
+    }
+
+    long value = 0;
+    if (kind == 'i') {
+      char* end;
+      value = strtol(token, &end, 10);
+      if (*end != '\0') {
+        return false;
+      }
+    }
+    args.word[args.count] = token;
+    args.number[args.count] = value;
+    args.count++;
+    letter++;
+  }
+
+  // Out of arguments: fine at the end of the schema or of a group, or
+  // where the optional ones begin
+  return optional || *letter == '\0' || *letter == '*' || isupper((unsigned char)*letter);
+}
+
+CommandParser::Result CommandParser::execute(char* line, const CommandSpec* table, size_t count,
+                                             const CommandSpec** matched) {
+  char* name = normalize(line);
+  if (*name == '\0') {
+    return EMPTY;
+  }
+  char* rest = strchr(name, ',');
+  if (rest != nullptr) {
+    *rest++ = '\0';
+  }
+
+  const CommandSpec* spec = find(table, count, name);
+  if (spec == nullptr) {
+    return UNKNOWN;
+  }
+  if (matched != nullptr) {
+    *matched = spec;
+  }
+
+  CommandArgs args;
+  if (!parseArgs(spec->schema, rest, args)) {
+    return BAD_ARGS;
+  }
+  spec->handler(args);
+  return OK;
+}
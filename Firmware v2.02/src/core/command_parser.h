@@ -0,0 +1,79 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// SERIAL COMMAND PARSER
+// ========================================
+// Serial commands without String or heap: the line is tokenized in place
+// in the caller's fixed buffer, the command name is looked up by binary
+// search in a constexpr table sorted by name, and the arguments are
+// checked against the command's schema before its handler runs.
+//
+// Line:   NAME[,arg[,arg...]]   (trimmed and upper-cased in place)
+//
+// Schema, one letter per argument:
+//   i   integer (decimal, optional sign)
+//   w   word (anything up to the next comma)
+//   t   text: the rest of the line, commas included (last letter only)
+//   Upper case (I, W, T): this and all following arguments are optional
+//   *   as the last letter: the arguments so far repeat as a group
+//       ("ii*" = one or more <n>,<value> pairs)
+//
+// The table is checked for order at compile time:
+//   constexpr CommandSpec COMMANDS[] = { {"COUNT", "", "COUNT", cmdCount}, ... };
+//   static_assert(CommandParser::isSorted(COMMANDS, COUNT_OF(COMMANDS)), "...");
+struct CommandArgs {
+  static const size_t MAX_ARGS = 12;
+
+  uint8_t count;
+  const char* word[MAX_ARGS];      // Each argument, inside the line buffer
+  long number[MAX_ARGS];           // Value of 'i' arguments, 0 otherwise
+};
+
+typedef void (*CommandHandler)(const CommandArgs& args);
+
+struct CommandSpec {
+  const char* name;
+  const char* schema;
+  const char* usage;               // For HELP and argument errors
+  CommandHandler handler;
+};
+
+class CommandParser {
+public:
+  enum Result : uint8_t {
+    OK,                            // Handler ran
+    EMPTY,                         // Blank line
+    UNKNOWN,                       // No such command
+    BAD_ARGS                       // Arguments do not match the schema
+  };
+
+  // Tokenize line (modified in place), find and run the command. matched
+  // is set for OK and BAD_ARGS.
+  static Result execute(char* line, const CommandSpec* table, size_t count,
+                        const CommandSpec** matched = nullptr);
+
+  // Binary search; nullptr if absent
+  static const CommandSpec* find(const CommandSpec* table, size_t count, const char* name);
+
+  // Split the arguments after the name (rest may be nullptr: none)
+  static bool parseArgs(const char* schema, char* rest, CommandArgs& args);
+
+  // Strip surrounding whitespace and upper-case; returns the first character
+  static char* normalize(char* line);
+
+  static constexpr bool isSorted(const CommandSpec* table, size_t count) {
+    return count < 2 || (compare(table[0].name, table[1].name) < 0 && isSorted(table + 1, count - 1));
+  }
+
+private:
+  static constexpr int compare(const char* a, const char* b) {
+    return (*a != *b || *a == '\0') ? (int)(unsigned char)*a - (int)(unsigned char)*b
+                                    : compare(a + 1, b + 1);
+  }
+};
+
+#endif // COMMAND_PARSER_H
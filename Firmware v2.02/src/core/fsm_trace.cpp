@@ -0,0 +1,120 @@
+#include "fsm_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if FSM_TRACE_LOCKED
+#include <freertos/FreeRTOS.h>
+
+// Recorded from loop() and the button ISRs; held for a 12-byte copy
+static portMUX_TYPE traceMux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK()   portENTER_CRITICAL(&traceMux)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&traceMux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+static_assert((FsmTrace::CAPACITY & (FsmTrace::CAPACITY - 1)) == 0, "Capacity must be a power of two");
+static_assert(sizeof(FsmTrace::Record) == 12, "Trace record is 12 bytes");
+
+static const uint32_t TRACE_MASK = FsmTrace::CAPACITY - 1;
+
+static const char* const TYPE_NAMES[] = {
+  "ENQUEUE", "DROP", "DEQUEUE", "PROCESS", "TRANSITION", "GUARD_REJECT", "HANDLER"
+};
+static_assert(sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]) == FsmTrace::TYPE_COUNT, "One name per type");
+
+// ========================================
+// FSM TRACE IMPLEMENTATION
+// ========================================
+
+FsmTrace::FsmTrace() {
+  memset(records, 0, sizeof(records));
+}
+
+void FsmTrace::record(Type type, uint8_t a, uint8_t b, uint8_t c, uint32_t timeUs, uint32_t durationUs) {
+  TRACE_LOCK();
+  if (paused) {
+    missed++;
+    TRACE_UNLOCK();
+    return;
+  }
+  Record& slot = records[head & TRACE_MASK];
+  slot.timeUs = timeUs;
+  slot.durationUs = durationUs;
+  slot.type = type;
+  slot.a = a;
+  slot.b = b;
+  slot.c = c;
+  if (head >= CAPACITY) {
+    overwritten++;
+  }
+  head++;
+  recorded++;
+  TRACE_UNLOCK();
+}
+
+void FsmTrace::clear() {
+  TRACE_LOCK();
+  head = 0;
+  recorded = 0;
+  overwritten = 0;
+  missed = 0;
+  TRACE_UNLOCK();
+}
+
+size_t FsmTrace::getCount() const {
+  return (head < CAPACITY) ? head : CAPACITY;
+}
+
+bool FsmTrace::get(size_t index, Record& out) const {
+  TRACE_LOCK();
+  size_t count = (head < CAPACITY) ? head : CAPACITY;
+  if (index >= count) {
+    TRACE_UNLOCK();
+    return false;
+  }
+  out = records[(head - count + index) & TRACE_MASK];
+  TRACE_UNLOCK();
+  return true;
+}
+
+size_t FsmTrace::formatLine(const Record& record, char* out, size_t size) {
+  int n = snprintf(out, size, "T,%u,%lu,%lu,%u,%u,%u\r\n", record.type, (unsigned long)record.timeUs,
+                   (unsigned long)record.durationUs, record.a, record.b, record.c);
+  if (n < 0) {
+    return 0;
+  }
+  return ((size_t)n < size) ? (size_t)n : size - 1;
+}
+
+bool FsmTrace::parseLine(const char* line, Record& out) {
+  if (line[0] != 'T' || line[1] != ',') {
+    return false;
+  }
+  unsigned long fields[6];
+  const char* at = line + 2;
+  for (int i = 0; i < 6; i++) {
+    char* end;
+    fields[i] = strtoul(at, &end, 10);
+    if (end == at || (i < 5 && *end != ',')) {
+      return false;
+    }
+    at = end + 1;
+  }
+  if (fields[0] >= TYPE_COUNT || fields[3] > 255 || fields[4] > 255 || fields[5] > 255) {
+    return false;
+  }
+  out.type = (uint8_t)fields[0];
+  out.timeUs = (uint32_t)fields[1];
+  out.durationUs = (uint32_t)fields[2];
+  out.a = (uint8_t)fields[3];
+  out.b = (uint8_t)fields[4];
+  out.c = (uint8_t)fields[5];
+  return true;
+}
+
+const char* FsmTrace::typeName(Type type) {
+  return (type < TYPE_COUNT) ? TYPE_NAMES[type] : "UNKNOWN";
+}
@@ -0,0 +1,90 @@
+#ifndef FSM_TRACE_H
+#define FSM_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef FSM_TRACE_LOCKED
+#define FSM_TRACE_LOCKED 1   // 0 for single-threaded host builds (no FreeRTOS)
+#endif
+
+// ========================================
+// FSM TRACE RING
+// ========================================
+// Flight recorder for the state machine: every event enqueue, dequeue,
+// transition, guard rejection, event dispatch and state-handler run as a
+// 12-byte record with a microsecond timestamp. The ring keeps the latest
+// CAPACITY records and overwrites the oldest. Recording is a copy under a
+// spinlock - safe from the button ISRs.
+//
+// TRACE dumps the ring as text lines (formatLine); tests/host/fsm_trace_json
+// turns a capture into Chrome/Perfetto trace JSON.
+//
+// Record fields by type:
+//   ENQUEUE       a=event  b=queue depth after    time=enqueue
+//   DROP          a=event  b=queue depth (full)   time=attempt
+//   DEQUEUE       a=event  b=queue depth after    time=enqueue  duration=wait in queue
+//   PROCESS       a=event  b=state                time=start    duration=dispatch
+//   TRANSITION    a=from   b=to                   time=start    duration=exit + entry actions
+//   GUARD_REJECT  a=state  b=target               time=check
+//   HANDLER       a=state  c=1 healthy            time=start    duration=handler run
+class FsmTrace {
+public:
+  static const size_t CAPACITY = 256;      // Records, power of two (3 KB)
+  static const size_t MAX_LINE = 48;       // formatLine output incl. "\r\n"
+
+  enum Type : uint8_t {
+    ENQUEUE,
+    DROP,
+    DEQUEUE,
+    PROCESS,
+    TRANSITION,
+    GUARD_REJECT,
+    HANDLER,
+    TYPE_COUNT
+  };
+
+  struct Record {
+    uint32_t timeUs;
+    uint32_t durationUs;
+    uint8_t type;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+  };
+
+  FsmTrace();
+
+  void record(Type type, uint8_t a, uint8_t b, uint8_t c, uint32_t timeUs, uint32_t durationUs = 0);
+
+  // Paused while TRACE dumps, so the records being printed stay put;
+  // anything recorded meanwhile is counted as missed
+  void setPaused(bool paused) { this->paused = paused; }
+  bool isPaused() const { return paused; }
+  void clear();
+
+  // index 0 = oldest record held
+  size_t getCount() const;
+  bool get(size_t index, Record& out) const;
+
+  // "T,<type>,<time>,<duration>,<a>,<b>,<c>\r\n"; returns its length
+  static size_t formatLine(const Record& record, char* out, size_t size);
+  static bool parseLine(const char* line, Record& out);
+  static const char* typeName(Type type);
+
+  // Diagnostics
+  uint32_t getRecorded() const { return recorded; }
+  uint32_t getOverwritten() const { return overwritten; }
+  uint32_t getMissed() const { return missed; }
+
+private:
+  Record records[CAPACITY];
+  volatile uint32_t head = 0;       // Free-running write index
+  volatile bool paused = false;
+
+  uint32_t recorded = 0;
+  uint32_t overwritten = 0;
+  uint32_t missed = 0;
+};
+
+#endif // FSM_TRACE_H
@@ -1,19 +1,13 @@
 #include "state_handlers.h"
 #include "state_manager.h"
 #include "managers.h"
+#include "state_store.h"
+#include "checkpoint_ring.h"
 #include "hal.h"
 #include <Arduino.h>
 
-// Global timing variables
-static unsigned long lastSaveTime = 0;
-static unsigned long lastHealthCheckTime = 0;
-static unsigned long lastDisplayUpdateTime = 0;
-static unsigned long lastHourChangeTime = 0;
-
-// Configuration
-static const unsigned long SAVE_INTERVAL = 5000;        // Save every 5 seconds
-static const unsigned long HEALTH_CHECK_INTERVAL = 30000; // Check health every 30 seconds
-static const unsigned long DISPLAY_UPDATE_INTERVAL = 100;  // Update display every 100ms
+// Checkpoint writer from main code (will be linked)
+extern bool writeCheckpoint();
 
 // ============================================================================
 // INITIALIZATION STATE HANDLER
@@ -144,93 +138,7 @@ bool executeInitializationState() {
   return true;  // Initialization still in progress
 }
 
-// ============================================================================
-// READY STATE HANDLER
-// ============================================================================
-
-bool executeReadyState() {
-  unsigned long currentTime = millis();
-  
-  // Update display periodically
-  if (currentTime - lastDisplayUpdateTime >= DISPLAY_UPDATE_INTERVAL) {
-    updateStatusDisplay();
-    lastDisplayUpdateTime = currentTime;
-  }
-  
-  // Check for hour boundary
-  if (TimeManager::getInstance().hasHourChanged()) {
-    handleHourBoundary();
-    lastHourChangeTime = currentTime;
-  }
-  
-  // Perform periodic saves
-  if (currentTime - lastSaveTime >= SAVE_INTERVAL) {
-    if (!saveCheckpoint()) {
-      LoggerManager::warn("Checkpoint save failed");
-    }
-    lastSaveTime = currentTime;
-  }
-  
-  // Monitor system health
-  if (currentTime - lastHealthCheckTime >= HEALTH_CHECK_INTERVAL) {
-    if (!checkSystemHealth()) {
-      LoggerManager::warn("System health check detected issues");
-      StateManager::getInstance().queueEvent(EVT_SYSTEM_ERROR);
-      return false;
-    }
-    lastHealthCheckTime = currentTime;
-  }
-  
-  // Check for production start signal (event-driven)
-  // This is handled by event processing in main loop
-  
-  return true;
-}
-
-// ============================================================================
-// PRODUCTION STATE HANDLER
-// ============================================================================
-
-bool executeProductionState() {
-  unsigned long currentTime = millis();
-  
-  // Update display in real-time
-  if (currentTime - lastDisplayUpdateTime >= DISPLAY_UPDATE_INTERVAL) {
-    updateProductionDisplay();
-    lastDisplayUpdateTime = currentTime;
-  }
-  
-  // Check for hour boundary during production
-  if (TimeManager::getInstance().hasHourChanged()) {
-    handleHourBoundary();
-    lastHourChangeTime = currentTime;
-  }
-  
-  // Save progress periodically
-  if (currentTime - lastSaveTime >= SAVE_INTERVAL) {
-    if (!saveProductionProgress()) {
-      LoggerManager::error("Failed to save production progress");
-      StateManager::getInstance().queueEvent(EVT_SYSTEM_ERROR);
-      return false;
-    }
-    lastSaveTime = currentTime;
-  }
-  
-  // Monitor system health during production
-  if (currentTime - lastHealthCheckTime >= HEALTH_CHECK_INTERVAL) {
-    if (!checkSystemHealth()) {
-      LoggerManager::error("System health degraded during production");
-      StateManager::getInstance().queueEvent(EVT_SYSTEM_ERROR);
-      return false;
-    }
-    lastHealthCheckTime = currentTime;
-  }
-  
-  // Check for production stop signal (event-driven)
-  // This is handled by event processing in main loop
-  
-  return true;
-}
+// READY and PRODUCTION handlers: see active_states.cpp
 
 // ============================================================================
 // DIAGNOSTIC STATE HANDLER
@@ -505,36 +413,25 @@ bool recoverFromPowerLoss() {
 // PERIODIC MAINTENANCE HELPERS
 // ============================================================================
 
+// The main loop closes the hour (serviceHourBoundary -> handleHourChange),
+// the only writer of the hourly and cumulative counts; this only reports it
 void handleHourBoundary() {
-  LoggerManager::info("Hour boundary detected - updating cumulative counts");
-  
-  // Handle hour change in TimeManager
-  TimeManager::getInstance().handleHourChange();
-  
-  // Save cumulative count
-  int totalCount = ProductionManager::getInstance().getTotalSessionCount();
-  StorageManager::getInstance().saveCount("/cumulative_count.txt", totalCount);
-  
-  // Create daily log entry
-  String logEntry = "Hour ";
-  logEntry += TimeManager::getInstance().getCurrentHour();
-  logEntry += " - Items: ";
-  logEntry += totalCount;
-  logEntry += "\n";
-  
-  LoggerManager::info("Cumulative count: %d", totalCount);
+  const PersistentStateRecord& state = StateStore::getInstance().data();
+  LoggerManager::info("Hour boundary - last hour: %ld items, cumulative: %ld",
+    (long)state.hourlyCount, (long)state.cumulativeCount);
 }
 
+// Snapshot of the counters as the main loop keeps them (writes no fields)
+// into the EEPROM checkpoint ring. SD commits are left to the loop's
+// consolidation, so an extra checkpoint costs no SD write.
 bool saveCheckpoint() {
-  // Save production count
-  int count = ProductionManager::getInstance().getTotalSessionCount();
-  
-  if (!StorageManager::getInstance().saveCount("/cumulative_count.txt", count)) {
+  if (!writeCheckpoint()) {
     LoggerManager::error("Failed to save count checkpoint");
     return false;
   }
   
-  LoggerManager::debug("Checkpoint saved - count: %d", count);
+  LoggerManager::debug("Checkpoint saved - count: %ld",
+    (long)StateStore::getInstance().data().currentCount);
   return true;
 }
 
@@ -560,25 +457,6 @@ bool checkSystemHealth() {
   return true;
 }
 
-bool updateStatusDisplay() {
-  DisplayManager& display = DisplayManager::getInstance();
-  
-  // Show ready screen with current status
-  display.showReadyScreen();
-  
-  // Add status information
-  if (isTimeValid()) {
-    String timeStr = TimeManager::getInstance().getTimeString();
-    display.displayText(0, 0, timeStr.c_str(), 1);
-  }
-  
-  // Show cumulative count
-  int totalCount = ProductionManager::getInstance().getTotalSessionCount();
-  display.displayNumber(0, 20, totalCount, 2);
-  
-  return true;
-}
-
 // ============================================================================
 // PRODUCTION STATE HELPERS
 // ============================================================================
@@ -596,34 +474,12 @@ bool handleItemCounted() {
   return true;
 }
 
-bool updateProductionDisplay() {
-  DisplayManager& display = DisplayManager::getInstance();
-  
-  // Get current session data
-  int sessionCount = ProductionManager::getInstance().getSessionCount();
-  int totalCount = ProductionManager::getInstance().getTotalSessionCount();
-  
-  // Show production screen
-  display.showProductionScreen(sessionCount);
-  
-  // Calculate and display items per minute
-  // (This would require tracking start time in a real implementation)
-  
-  return true;
-}
-
+// The session fields are the main loop's (beginProductionState/saveState);
+// this checkpoints them before leaving PRODUCTION (see saveCheckpoint)
 bool saveProductionProgress() {
   int count = ProductionManager::getInstance().getSessionCount();
   
-  // Update recovery file with current session count
-  StorageManager& storage = StorageManager::getInstance();
-  
-  // Save to temporary file (recovery will use this)
-  String recoveryData = "Session Count: ";
-  recoveryData += count;
-  recoveryData += "\n";
-  
-  if (!storage.writeFile("/prod_session.txt", recoveryData.c_str())) {
+  if (!writeCheckpoint()) {
     LoggerManager::error("Failed to save production progress");
     return false;
   }
@@ -732,6 +588,27 @@ bool testMemory() {
   return pass;
 }
 
+bool testEndurance() {
+  LoggerManager::info("Projecting checkpoint storage endurance...");
+  
+  EnduranceReport wear =
+    CheckpointRing::projectEndurance(ConfigManager::getInstance().getSaveInterval());
+  
+  LoggerManager::info("Checkpoints/day: %lu (ring writes so far: %lu)",
+    wear.checkpointsPerDay, CheckpointRing::getInstance().getWriteCount());
+  LoggerManager::info("Sector writes/day: %lu | Flash erases/page/day: %lu.%03lu",
+    wear.sectorWritesPerDay, wear.flashErasesPerDayX1000 / 1000,
+    wear.flashErasesPerDayX1000 % 1000);
+  LoggerManager::info("Projected flash life: %lu years", wear.projectedLifeYears);
+  
+  // Projection assumes counting 24/7 - flag rates that would wear out
+  // flash within the warranty period even under that worst case
+  bool pass = wear.projectedLifeYears >= 2;
+  LoggerManager::info("Endurance test: %s", pass ? "PASS" : "WARN");
+  
+  return pass;
+}
+
 bool runAllDiagnostics() {
   LoggerManager::info("=== RUNNING DIAGNOSTICS ===");
   
@@ -741,6 +618,7 @@ bool runAllDiagnostics() {
   bool rtcPass = testRTC();
   bool storagePass = testStorage();
   bool memoryPass = testMemory();
+  bool endurancePass = testEndurance();
   
   LoggerManager::info("=== DIAGNOSTIC RESULTS ===");
   LoggerManager::info("GPIO: %s", gpioPass ? "PASS" : "FAIL");
@@ -749,9 +627,11 @@ bool runAllDiagnostics() {
   LoggerManager::info("RTC: %s", rtcPass ? "PASS" : "FAIL");
   LoggerManager::info("Storage: %s", storagePass ? "PASS" : "FAIL");
   LoggerManager::info("Memory: %s", memoryPass ? "PASS" : "FAIL");
+  LoggerManager::info("Endurance: %s", endurancePass ? "PASS" : "WARN");
   
   bool allPass = gpioPass && i2cPass && rtcPass && memoryPass;
-  // SPI and storage are optional (SD card may not be present)
+  // SPI and storage are optional (SD card may not be present),
+  // endurance is advisory only
   
   LoggerManager::info("Overall: %s", allPass ? "PASS" : "FAIL");
   
@@ -45,12 +45,12 @@ bool executeInitializationState();
  * 
  * Responsibilities:
  * - Wait for production start signal
- * - Perform periodic maintenance (save counts, check time)
- * - Detect hour changes and update cumulative counts
  * - Monitor system health (heap, temperature, watchdog)
- * - Update display with status information
  * - Transition to PRODUCTION on start signal
  * 
+ * The screen is the main loop's (displayMainScreen renders the
+ * DisplayView); this handler draws nothing. See active_states.cpp.
+ * 
  * @return true if state remains healthy, false if error recovery needed
  */
 bool executeReadyState();
@@ -63,12 +63,12 @@ bool executeReadyState();
  * 
  * Responsibilities:
  * - Count items in real-time
- * - Update OLED display with live count
- * - Save count periodically to avoid data loss
- * - Detect hour changes during production
  * - Monitor for stop signal
  * - Transition to READY on stop signal
  * 
+ * The live count and rate are drawn by the main loop from the
+ * DisplayView; this handler draws nothing. See active_states.cpp.
+ * 
  * @return true if state remains healthy, false if error recovery needed
  */
 bool executeProductionState();
@@ -304,24 +304,21 @@ bool recoverFromPowerLoss();
 // ============================================================================
 
 /**
- * Perform Hour Boundary Operations
+ * Report Hour Boundary
  * 
- * Called when hour changes:
- * - Update cumulative count
- * - Create daily log file
- * - Reset hourly counters
- * - Log hour transition
- * 
- * @return true if successful
+ * Called on EVT_HOUR_CHANGED. The main loop has already closed the hour
+ * (serviceHourBoundary -> handleHourChange, the only writer of the hourly
+ * and cumulative counts):
+ * - Log the last hour's count and the cumulative count
  */
 void handleHourBoundary();
 
 /**
- * Save State to Persistent Storage
+ * Checkpoint Counters
  * 
- * Called periodically (default every 5 seconds):
- * - Save current count to SD
- * - Update recovery file
+ * On demand, in addition to the main loop's own checkpoints:
+ * - Write the counters to the EEPROM checkpoint ring (no SD write; the
+ *   loop consolidates to SD every minute)
  * - Log checkpoint
  * 
  * @return true if save successful
@@ -341,19 +338,6 @@ bool saveCheckpoint();
  */
 bool checkSystemHealth();
 
-/**
- * Update Status Display
- * 
- * Shows:
- * - Current time
- * - Cumulative count
- * - Last session info
- * - System status (OK/WARN/ERROR)
- * 
- * @return true if display updated
- */
-bool updateStatusDisplay();
-
 // ============================================================================
 // PRODUCTION STATE HELPERS
 // ============================================================================
@@ -371,25 +355,11 @@ bool updateStatusDisplay();
  */
 bool handleItemCounted();
 
-/**
- * Update Production Display
- * 
- * Shows:
- * - Current session count
- * - Session start time and duration
- * - Items per minute rate
- * - Estimated completion time (if quota set)
- * 
- * @return true if display updated
- */
-bool updateProductionDisplay();
-
 /**
  * Save Production Progress
  * 
- * Called periodically during production:
- * - Save current session count
- * - Update recovery file
+ * Called before leaving PRODUCTION for ERROR or DIAGNOSTIC:
+ * - Checkpoint the session count (see saveCheckpoint)
  * - Log checkpoint
  * 
  * @return true if save successful
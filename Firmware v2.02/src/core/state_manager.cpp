@@ -1,4 +1,5 @@
 #include "state_manager.h"
+#include "managers.h"
 
 // ========================================
 // STATE MANAGER IMPLEMENTATION
@@ -6,6 +7,7 @@
 
 StateManager::StateManager() {
   memset(eventQueue, 0, sizeof(eventQueue));
+  memset(eventQueueTimeUs, 0, sizeof(eventQueueTimeUs));
 }
 
 bool StateManager::initialize() {
@@ -15,21 +17,45 @@ bool StateManager::initialize() {
   timeSubState = TimeState::UNSYNCHRONIZED;
   stateChangeTime = millis();
   
-  Serial.println("[FSM] StateManager initialized");
+  LOG_INFO(FSM, "StateManager initialized");
   return true;
 }
 
+static uint8_t queueDepth(uint8_t head, uint8_t tail, uint8_t size) {
+  return (uint8_t)((tail + size - head) % size);
+}
+
 void StateManager::queueEvent(SystemEvent event) {
+  uint32_t now = micros();
   uint8_t nextTail = (eventQueueTail + 1) % EVENT_QUEUE_SIZE;
   
+  // Also called from the button ISRs, so no logging here (LogRing::push
+  // is not ISR-safe): the drop is traced and counted, STATUS reports it
   if (nextTail == eventQueueHead) {
-    Serial.print("[FSM] WARNING: Event queue full, dropping event: ");
-    Serial.println(getEventName(event));
+    trace.record(FsmTrace::DROP, (uint8_t)event, EVENT_QUEUE_SIZE - 1, 0, now);
+    droppedEvents++;
     return;
   }
   
   eventQueue[eventQueueTail] = event;
+  eventQueueTimeUs[eventQueueTail] = now;
   eventQueueTail = nextTail;
+  trace.record(FsmTrace::ENQUEUE, (uint8_t)event,
+               queueDepth(eventQueueHead, eventQueueTail, EVENT_QUEUE_SIZE), 0, now);
+}
+
+bool StateManager::dequeueEvent(SystemEvent& event) {
+  if (!hasQueuedEvents()) {
+    return false;
+  }
+  
+  uint32_t queuedAt = eventQueueTimeUs[eventQueueHead];
+  event = eventQueue[eventQueueHead];
+  eventQueueHead = (eventQueueHead + 1) % EVENT_QUEUE_SIZE;
+  trace.record(FsmTrace::DEQUEUE, (uint8_t)event,
+               queueDepth(eventQueueHead, eventQueueTail, EVENT_QUEUE_SIZE), 0, queuedAt,
+               micros() - queuedAt);
+  return true;
 }
 
 bool StateManager::hasQueuedEvents() const {
@@ -37,6 +63,8 @@ bool StateManager::hasQueuedEvents() const {
 }
 
 void StateManager::processEvent(SystemEvent event) {
+  uint32_t start = micros();
+  SystemState state = currentState;
   eventCounter++;
   lastEventTime = millis();
   
@@ -61,13 +89,14 @@ void StateManager::processEvent(SystemEvent event) {
       handleEventInError(event);
       break;
   }
+  
+  trace.record(FsmTrace::PROCESS, (uint8_t)event, (uint8_t)state, 0, start, micros() - start);
 }
 
 void StateManager::update() {
   // Process all queued events
-  while (hasQueuedEvents()) {
-    SystemEvent event = eventQueue[eventQueueHead];
-    eventQueueHead = (eventQueueHead + 1) % EVENT_QUEUE_SIZE;
+  SystemEvent event;
+  while (dequeueEvent(event)) {
     processEvent(event);
   }
   
@@ -77,7 +106,7 @@ void StateManager::update() {
       // Check for initialization timeout
       if (getTimeInCurrentState() > 30000) {  // 30 second timeout
         transitionTo(SystemState::ERROR);
-        Serial.println("[FSM] ERROR: Initialization timeout");
+        LOG_ERROR(FSM, "Initialization timeout");
       }
       break;
       
@@ -93,7 +122,7 @@ void StateManager::update() {
       // Diagnostic mode timeout
       if (getTimeInCurrentState() > 60000) {  // 60 second timeout
         transitionTo(SystemState::READY);
-        Serial.println("[FSM] Diagnostic timeout, returning to READY");
+        LOG_INFO(FSM, "Diagnostic timeout, returning to READY");
       }
       break;
       
@@ -101,14 +130,16 @@ void StateManager::update() {
       // Error recovery check
       if (getTimeInCurrentState() > 5000) {  // 5 second error display
         transitionTo(SystemState::READY);
-        Serial.println("[FSM] Auto-recovery from ERROR state");
+        LOG_INFO(FSM, "Auto-recovery from ERROR state");
       }
       break;
   }
 }
 
 bool StateManager::transitionTo(SystemState newState) {
+  uint32_t start = micros();
   if (!canTransitionTo(newState)) {
+    trace.record(FsmTrace::GUARD_REJECT, (uint8_t)currentState, (uint8_t)newState, 0, start);
     StateLogger::logTransitionGuard(newState, false);
     return false;
   }
@@ -136,6 +167,8 @@ bool StateManager::transitionTo(SystemState newState) {
     case SystemState::ERROR: enterError(); break;
   }
   
+  trace.record(FsmTrace::TRANSITION, (uint8_t)previousState, (uint8_t)currentState, 0, start,
+               micros() - start);
   StateLogger::logStateChange(previousState, currentState);
   return true;
 }
@@ -166,7 +199,11 @@ unsigned long StateManager::getLastStateChangeTime() const {
 }
 
 const char* StateManager::getCurrentStateName() const {
-  switch (currentState) {
+  return getStateName(currentState);
+}
+
+const char* StateManager::getStateName(SystemState state) {
+  switch (state) {
     case SystemState::INITIALIZATION: return "INITIALIZATION";
     case SystemState::READY: return "READY";
     case SystemState::PRODUCTION: return "PRODUCTION";
@@ -300,46 +337,46 @@ void StateManager::handleEventInError(SystemEvent event) {
 // ========================================
 
 void StateManager::enterInitialization() {
-  Serial.println("[FSM] >>> Entering INITIALIZATION state");
+  LOG_INFO(FSM, ">>> Entering INITIALIZATION state");
 }
 
 void StateManager::exitInitialization() {
-  Serial.println("[FSM] <<< Exiting INITIALIZATION state");
+  LOG_INFO(FSM, "<<< Exiting INITIALIZATION state");
 }
 
 void StateManager::enterReady() {
-  Serial.println("[FSM] >>> Entering READY state");
+  LOG_INFO(FSM, ">>> Entering READY state");
   productionSubState = ProductionState::IDLE;
 }
 
 void StateManager::exitReady() {
-  Serial.println("[FSM] <<< Exiting READY state");
+  LOG_INFO(FSM, "<<< Exiting READY state");
 }
 
 void StateManager::enterProduction() {
-  Serial.println("[FSM] >>> Entering PRODUCTION state");
+  LOG_INFO(FSM, ">>> Entering PRODUCTION state");
   productionSubState = ProductionState::ACTIVE;
 }
 
 void StateManager::exitProduction() {
-  Serial.println("[FSM] <<< Exiting PRODUCTION state");
+  LOG_INFO(FSM, "<<< Exiting PRODUCTION state");
   productionSubState = ProductionState::IDLE;
 }
 
 void StateManager::enterDiagnostic() {
-  Serial.println("[FSM] >>> Entering DIAGNOSTIC state");
+  LOG_INFO(FSM, ">>> Entering DIAGNOSTIC state");
 }
 
 void StateManager::exitDiagnostic() {
-  Serial.println("[FSM] <<< Exiting DIAGNOSTIC state");
+  LOG_INFO(FSM, "<<< Exiting DIAGNOSTIC state");
 }
 
 void StateManager::enterError() {
-  Serial.println("[FSM] >>> Entering ERROR state");
+  LOG_INFO(FSM, ">>> Entering ERROR state");
 }
 
 void StateManager::exitError() {
-  Serial.println("[FSM] <<< Exiting ERROR state");
+  LOG_INFO(FSM, "<<< Exiting ERROR state");
 }
 
 // ========================================
@@ -436,63 +473,26 @@ bool GuardConditions::isSessionRecoveryValid() {
 // ========================================
 
 void StateLogger::logStateChange(SystemState from, SystemState to) {
-  Serial.print("[FSM] State transition: ");
-  
-  // Print from state
-  switch (from) {
-    case SystemState::INITIALIZATION: Serial.print("INITIALIZATION"); break;
-    case SystemState::READY: Serial.print("READY"); break;
-    case SystemState::PRODUCTION: Serial.print("PRODUCTION"); break;
-    case SystemState::DIAGNOSTIC: Serial.print("DIAGNOSTIC"); break;
-    case SystemState::ERROR: Serial.print("ERROR"); break;
-  }
-  
-  Serial.print(" → ");
-  
-  // Print to state
-  switch (to) {
-    case SystemState::INITIALIZATION: Serial.print("INITIALIZATION"); break;
-    case SystemState::READY: Serial.print("READY"); break;
-    case SystemState::PRODUCTION: Serial.print("PRODUCTION"); break;
-    case SystemState::DIAGNOSTIC: Serial.print("DIAGNOSTIC"); break;
-    case SystemState::ERROR: Serial.print("ERROR"); break;
-  }
-  
-  Serial.println();
+  LOG_INFO(FSM, "State transition: %s → %s", StateManager::getStateName(from), StateManager::getStateName(to));
 }
 
 void StateLogger::logEvent(SystemEvent event, bool processed) {
-  Serial.print("[FSM] Event: ");
-  
   // Event names (abbreviated for log)
+  const char* name;
   switch (event) {
-    case SystemEvent::EVT_PRODUCTION_START: Serial.print("START"); break;
-    case SystemEvent::EVT_PRODUCTION_STOP: Serial.print("STOP"); break;
-    case SystemEvent::EVT_COUNTER_PRESSED: Serial.print("COUNT"); break;
-    case SystemEvent::EVT_HOUR_CHANGED: Serial.print("HOUR"); break;
-    default: Serial.print("?"); break;
+    case SystemEvent::EVT_PRODUCTION_START: name = "START"; break;
+    case SystemEvent::EVT_PRODUCTION_STOP: name = "STOP"; break;
+    case SystemEvent::EVT_COUNTER_PRESSED: name = "COUNT"; break;
+    case SystemEvent::EVT_HOUR_CHANGED: name = "HOUR"; break;
+    default: name = "?"; break;
   }
-  
-  Serial.print(processed ? " [✓]" : " [✗]");
-  Serial.println();
+  LOG_DEBUG(FSM, "Event: %s %s", name, processed ? "[✓]" : "[✗]");
 }
 
 void StateLogger::logTransitionGuard(SystemState target, bool result) {
-  Serial.print("[FSM] Guard check for ");
-  
-  switch (target) {
-    case SystemState::INITIALIZATION: Serial.print("INITIALIZATION"); break;
-    case SystemState::READY: Serial.print("READY"); break;
-    case SystemState::PRODUCTION: Serial.print("PRODUCTION"); break;
-    case SystemState::DIAGNOSTIC: Serial.print("DIAGNOSTIC"); break;
-    case SystemState::ERROR: Serial.print("ERROR"); break;
-  }
-  
-  Serial.print(": ");
-  Serial.println(result ? "PASS" : "FAIL");
+  LOG_DEBUG(FSM, "Guard check for %s: %s", StateManager::getStateName(target), result ? "PASS" : "FAIL");
 }
 
 void StateLogger::logError(const char* message) {
-  Serial.print("[FSM] ERROR: ");
-  Serial.println(message);
+  LOG_ERROR(FSM, "%s", message);
 }
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <cstring>
+#include "fsm_trace.h"
 
 // ========================================
 // SYSTEM STATE ENUM
@@ -106,11 +107,15 @@ public:
   
   // Event management
   void queueEvent(SystemEvent event);
+  bool dequeueEvent(SystemEvent& event);
   bool hasQueuedEvents() const;
   
   // State-specific information
   const char* getCurrentStateName() const;
   const char* getEventName(SystemEvent event) const;
+  static const char* getStateName(SystemState state);
+  static const uint8_t STATE_COUNT = (uint8_t)SystemState::ERROR + 1;
+  static const uint8_t EVENT_COUNT = (uint8_t)SystemEvent::EVT_ERROR_FATAL + 1;
   
   // Timing
   unsigned long getTimeInCurrentState() const;
@@ -119,6 +124,10 @@ public:
   // Statistics
   uint32_t getEventCount() const { return eventCounter; }
   uint32_t getTransitionCount() const { return transitionCounter; }
+  uint32_t getDroppedEvents() const { return droppedEvents; }   // Queue full
+  
+  // Trace of queue, dispatch and transitions (the main loop adds handler runs)
+  FsmTrace& getTrace() { return trace; }
   
 private:
   // Current states
@@ -130,9 +139,12 @@ private:
   // Event queue (circular buffer)
   static const uint8_t EVENT_QUEUE_SIZE = 16;
   SystemEvent eventQueue[EVENT_QUEUE_SIZE];
+  uint32_t eventQueueTimeUs[EVENT_QUEUE_SIZE];   // Enqueue time, for queue latency
   uint8_t eventQueueHead = 0;
   uint8_t eventQueueTail = 0;
   
+  FsmTrace trace;
+  
   // Timing
   unsigned long stateChangeTime = 0;
   unsigned long lastEventTime = 0;
@@ -140,6 +152,7 @@ private:
   // Statistics
   uint32_t eventCounter = 0;
   uint32_t transitionCounter = 0;
+  volatile uint32_t droppedEvents = 0;
   
   // State machine logic
   void handleEventInInitialization(SystemEvent event);
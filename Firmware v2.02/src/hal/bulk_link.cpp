@@ -0,0 +1,284 @@
+#include "bulk_link.h"
+#include <string.h>
+
+// ========================================
+// BULK LINK IMPLEMENTATION
+// ========================================
+
+uint16_t BulkLink::crc16(const uint8_t* data, size_t length, uint16_t crc) {
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t BulkLink::cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+  size_t codeAt = 0;
+  size_t written = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeAt] = code;
+      codeAt = written++;
+      code = 1;
+      continue;
+    }
+    out[written++] = in[i];
+    if (++code == 0xFF) {
+      out[codeAt] = code;
+      codeAt = written++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return written;
+}
+
+size_t BulkLink::cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t room) {
+  size_t read = 0;
+  size_t written = 0;
+  while (read < length) {
+    uint8_t code = in[read++];
+    if (code == 0 || read + code - 1 > length || written + code - 1 > room) {
+      return 0;
+    }
+    for (uint8_t i = 1; i < code; i++) {
+      if (in[read] == 0) {
+        return 0;
+      }
+      out[written++] = in[read++];
+    }
+    if (code != 0xFF && read < length) {
+      if (written >= room) {
+        return 0;
+      }
+      out[written++] = 0;
+    }
+  }
+  return written;
+}
+
+size_t BulkLink::encode(const Frame& frame, uint8_t* out) {
+  uint8_t raw[MAX_FRAME];
+  size_t length = (frame.length <= MAX_PAYLOAD) ? frame.length : MAX_PAYLOAD;
+  raw[0] = frame.type;
+  put16(raw + 1, frame.seq);
+  memcpy(raw + HEADER_SIZE, frame.payload, length);
+  // Inverted, high byte first: running the CRC over a whole frame then
+  // always ends at CRC_RESIDUE. A frame that ran into the next one or into
+  // zeros (delimiter lost) reaches the next check from a different state
+  // and cannot pass.
+  uint16_t crc = ~crc16(raw, HEADER_SIZE + length);
+  raw[HEADER_SIZE + length] = crc >> 8;
+  raw[HEADER_SIZE + length + 1] = crc & 0xFF;
+
+  size_t encoded = cobsEncode(raw, HEADER_SIZE + length + 2, out);
+  out[encoded++] = 0;
+  return encoded;
+}
+
+bool BulkLink::decode(const uint8_t* encoded, size_t length, Frame& out) {
+  uint8_t raw[MAX_FRAME];
+  size_t size = cobsDecode(encoded, length, raw, sizeof(raw));
+  if (size < HEADER_SIZE + 2 || crc16(raw, size) != CRC_RESIDUE) {
+    return false;
+  }
+  out.type = raw[0];
+  out.seq = get16(raw + 1);
+  out.length = size - HEADER_SIZE - 2;
+  memcpy(out.payload, raw + HEADER_SIZE, out.length);
+  return true;
+}
+
+void BulkLink::put16(uint8_t* p, uint16_t value) {
+  p[0] = value & 0xFF;
+  p[1] = value >> 8;
+}
+
+void BulkLink::put32(uint8_t* p, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    p[i] = (value >> (8 * i)) & 0xFF;
+  }
+}
+
+uint16_t BulkLink::get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t BulkLink::get32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool BulkLink::Decoder::feed(uint8_t byte) {
+  if (byte != 0) {
+    if (length < sizeof(buffer)) {
+      buffer[length++] = byte;
+    } else {
+      overflow = true;
+    }
+    return false;
+  }
+
+  // Delimiter: whatever came before is one frame (or noise)
+  bool valid = length > 0 && !overflow && decode(buffer, length, current);
+  if (valid) {
+    frames++;
+  } else if (length > 0 || overflow) {
+    errors++;
+  }
+  length = 0;
+  overflow = false;
+  return valid;
+}
+
+void BulkLink::Decoder::reset() {
+  length = 0;
+  overflow = false;
+}
+
+// ========================================
+// BULK WINDOW
+// ========================================
+
+void BulkWindow::start(uint32_t begin, uint32_t endOffset, uint32_t nowMs) {
+  base = begin;
+  sendAt = begin;
+  highest = begin;
+  end = endOffset;
+  progressMs = nowMs;
+  retries = 0;
+  lastSent = false;
+  rewound = false;
+  endSent = false;
+  active = true;
+}
+
+bool BulkWindow::next(uint32_t& offset, size_t& length, bool& last) {
+  if (!active || lastSent ||
+      sendAt - base >= (uint32_t)WINDOW * BulkLink::MAX_DATA) {
+    return false;
+  }
+  offset = sendAt;
+  length = (end - sendAt < BulkLink::MAX_DATA) ? end - sendAt : BulkLink::MAX_DATA;
+  sendAt += length;
+  if (sendAt > highest) {
+    highest = sendAt;
+  }
+  last = sendAt >= end;
+  lastSent = last;
+  endSent = endSent || last;
+  return true;
+}
+
+void BulkWindow::ack(uint32_t offset, bool gap, uint32_t nowMs) {
+  if (!active || offset > highest) {
+    return;                        // Beyond anything sent
+  }
+  if (offset > base) {
+    base = offset;
+    if (sendAt < base) {
+      sendAt = base;               // Late ACK for data sent before a resend
+    }
+    progressMs = nowMs;
+    retries = 0;
+    rewound = false;
+  }
+  if (endSent && base >= end) {
+    active = false;                // Host has it all
+    return;
+  }
+  // Host saw a gap at base: resend from there now, once per gap
+  if (gap && offset == base && sendAt > base && !rewound) {
+    sendAt = base;
+    lastSent = false;
+    rewound = true;
+    resends++;
+  }
+}
+
+bool BulkWindow::poll(uint32_t nowMs) {
+  if (!active) {
+    return true;
+  }
+  if (sendAt == base && !lastSent) {
+    progressMs = nowMs;            // Nothing in flight
+    return true;
+  }
+  if (nowMs - progressMs < RETRY_MS) {
+    return true;
+  }
+  if (++retries > MAX_RETRIES) {
+    active = false;
+    return false;
+  }
+  sendAt = base;
+  lastSent = false;
+  rewound = false;
+  progressMs = nowMs;
+  resends++;
+  return true;
+}
+
+// ========================================
+// BULK RECEIVER
+// ========================================
+
+void BulkReceiver::start(uint16_t transferSeq, uint32_t offset) {
+  seq = transferSeq;
+  expected = offset;
+  sinceAck = 0;
+  ackPending = false;
+  gapPending = false;
+  nackSent = false;
+  done = false;
+}
+
+BulkReceiver::Result BulkReceiver::onFrame(const BulkLink::Frame& frame, const uint8_t*& data,
+                                           size_t& length) {
+  if ((frame.type != BulkLink::DATA && frame.type != BulkLink::DATA_LAST) || frame.seq != seq ||
+      frame.length < BulkLink::DATA_HEADER) {
+    return IGNORED;
+  }
+  uint32_t offset = BulkLink::get32(frame.payload);
+  if (done || offset != expected) {
+    // A gap, or a resend of what we have (our ACK was lost): tell the
+    // device where we are, once until the next chunk arrives in order.
+    // After the end every resend is answered - it means the final ACK
+    // went missing.
+    if (done || !nackSent) {
+      ackPending = true;
+      gapPending = !done;
+      nackSent = true;
+    }
+    return OUT_OF_ORDER;
+  }
+
+  data = frame.payload + BulkLink::DATA_HEADER;
+  length = frame.length - BulkLink::DATA_HEADER;
+  expected += length;
+  nackSent = false;
+  if (frame.type == BulkLink::DATA_LAST) {
+    done = true;
+    ackPending = true;
+    return DONE;
+  }
+  if (++sinceAck >= ACK_EVERY) {
+    ackPending = true;
+  }
+  return ACCEPTED;
+}
+
+bool BulkReceiver::ackDue(uint32_t& offset, bool& gap) {
+  if (!ackPending) {
+    return false;
+  }
+  offset = expected;
+  gap = gapPending;
+  ackPending = false;
+  gapPending = false;
+  sinceAck = 0;
+  return true;
+}
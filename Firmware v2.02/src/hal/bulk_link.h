@@ -0,0 +1,183 @@
+#ifndef BULK_LINK_H
+#define BULK_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// BULK TRANSFER LINK
+// ========================================
+// Binary file download over the serial port (BULK command, see
+// bulk_transfer.h; host side tests/host/bulk_client). Host-buildable: the
+// firmware and the client share this file.
+//
+// Frame on the wire: COBS([type][seq:2][payload 0..MAX_PAYLOAD][crc16:2]) 0x00
+//   crc16 = CRC-16/CCITT-FALSE of type, seq and payload, inverted, high
+//   byte first; all other integers are little endian. A 0x00 always ends a frame, so after line noise the
+//   receiver is back in step at the next delimiter; a damaged frame fails
+//   its CRC and is dropped.
+//
+// Requests (host -> device); the reply echoes the request's seq:
+//   LIST  [start:2]                     -> LIST_REPLY [total:2][start:2][count:1]
+//                                          then count x [size:4][len:1][name]
+//   STAT  [name]                        -> STAT_REPLY [size:4][archived:1][crc32:4, 0 = unknown]
+//   GET   [offset:4][length:4][name]    -> DATA / DATA_LAST [offset:4][bytes]
+//   ACK   [next offset:4][gap:1]        (during a GET, same seq as the GET)
+//   BYE                                 -> BYE_REPLY, back to text commands
+//   Any failure                         -> ERROR_REPLY [code:1][text]
+//
+// GET is go-back-N: the device keeps up to WINDOW data frames in flight;
+// the host acknowledges the next offset it expects (every ACK_EVERY frames
+// and at the end) and sends one ACK with gap=1 when a chunk goes missing.
+// A gap makes the device resend from that offset right away; silence makes
+// it resend after RETRY_MS. An
+// interrupted download resumes with a GET at the offset already received.
+class BulkLink {
+public:
+  static const size_t MAX_PAYLOAD = 248;
+  static const size_t HEADER_SIZE = 3;                 // type, seq
+  static const size_t MAX_FRAME = HEADER_SIZE + MAX_PAYLOAD + 2;
+  static const size_t MAX_ENCODED = MAX_FRAME + MAX_FRAME / 254 + 2;   // COBS + delimiter
+  static const size_t DATA_HEADER = 4;                 // offset
+  static const uint16_t CRC_RESIDUE = 0x1D0F;          // crc16 over a frame incl. its CRC
+  static const size_t MAX_DATA = MAX_PAYLOAD - DATA_HEADER;
+
+  enum Type : uint8_t {
+    LIST = 0x01,
+    STAT = 0x02,
+    GET = 0x03,
+    ACK = 0x04,
+    BYE = 0x05,
+    LIST_REPLY = 0x81,
+    STAT_REPLY = 0x82,
+    DATA = 0x83,
+    DATA_LAST = 0x84,
+    BYE_REPLY = 0x85,
+    ERROR_REPLY = 0x8F
+  };
+
+  enum Error : uint8_t {
+    ERR_NOT_FOUND = 1,
+    ERR_BAD_REQUEST = 2,
+    ERR_STORAGE = 3
+  };
+
+  struct Frame {
+    uint8_t type;
+    uint16_t seq;
+    uint16_t length;               // Payload bytes
+    uint8_t payload[MAX_PAYLOAD];
+  };
+
+  static uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+  // COBS without the delimiter; decode returns 0 for malformed input
+  static size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+  static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t room);
+
+  // Whole frame incl. the 0x00 delimiter (at most MAX_ENCODED bytes)
+  static size_t encode(const Frame& frame, uint8_t* out);
+
+  // One frame without its delimiter; false if malformed or the CRC fails
+  static bool decode(const uint8_t* encoded, size_t length, Frame& out);
+
+  static void put16(uint8_t* p, uint16_t value);
+  static void put32(uint8_t* p, uint32_t value);
+  static uint16_t get16(const uint8_t* p);
+  static uint32_t get32(const uint8_t* p);
+
+  // Byte-at-a-time receiver
+  class Decoder {
+  public:
+    // True when a valid frame has just ended; frame() holds it until the next feed
+    bool feed(uint8_t byte);
+    const Frame& frame() const { return current; }
+    void reset();
+
+    uint32_t getFrames() const { return frames; }
+    uint32_t getErrors() const { return errors; }
+
+  private:
+    uint8_t buffer[MAX_ENCODED];
+    size_t length = 0;
+    bool overflow = false;
+    Frame current;
+    uint32_t frames = 0;
+    uint32_t errors = 0;
+  };
+};
+
+// ========================================
+// GO-BACK-N SENDER (device side of GET)
+// ========================================
+// Decides which bytes go out next; the caller reads and frames them.
+class BulkWindow {
+public:
+  static const uint8_t WINDOW = 16;          // Data frames in flight (~4 KB)
+  static const uint32_t RETRY_MS = 300;      // No progress: resend from the last ACK
+  static const uint8_t MAX_RETRIES = 8;      // Then give up
+
+  void start(uint32_t begin, uint32_t end, uint32_t nowMs);
+  void stop() { active = false; }
+  bool isActive() const { return active; }
+
+  // Next chunk, if the window has room; last = send it as DATA_LAST
+  bool next(uint32_t& offset, size_t& length, bool& last);
+
+  // Cumulative: the host has everything before offset; gap: the chunk at
+  // offset went missing
+  void ack(uint32_t offset, bool gap, uint32_t nowMs);
+
+  // Resend timer; false if the transfer was abandoned
+  bool poll(uint32_t nowMs);
+
+  uint32_t getAcked() const { return base; }
+  uint32_t getResends() const { return resends; }
+
+private:
+  uint32_t base = 0;               // First byte not acknowledged
+  uint32_t sendAt = 0;             // Next byte to send
+  uint32_t highest = 0;            // Furthest byte sent so far
+  uint32_t end = 0;
+  uint32_t progressMs = 0;
+  uint8_t retries = 0;
+  bool lastSent = false;           // This round reached the end
+  bool endSent = false;            // DATA_LAST went out at least once
+  bool rewound = false;            // Already went back for this gap
+  bool active = false;
+  uint32_t resends = 0;
+};
+
+// ========================================
+// GO-BACK-N RECEIVER (host side of GET)
+// ========================================
+class BulkReceiver {
+public:
+  static const uint8_t ACK_EVERY = 4;
+
+  enum Result : uint8_t {
+    IGNORED,                       // Not data for this transfer
+    ACCEPTED,                      // In order: data/length are the new bytes
+    OUT_OF_ORDER,                  // Duplicate or past a gap: dropped
+    DONE                           // Last chunk accepted
+  };
+
+  void start(uint16_t seq, uint32_t offset);
+  Result onFrame(const BulkLink::Frame& frame, const uint8_t*& data, size_t& length);
+
+  // ACK to send now, if one is due
+  bool ackDue(uint32_t& offset, bool& gap);
+  uint32_t getExpected() const { return expected; }
+  bool isDone() const { return done; }
+
+private:
+  uint16_t seq = 0;
+  uint32_t expected = 0;
+  uint8_t sinceAck = 0;
+  bool ackPending = false;
+  bool gapPending = false;
+  bool nackSent = false;           // Out-of-order ACK sent since the last in-order chunk
+  bool done = false;
+};
+
+#endif // BULK_LINK_H
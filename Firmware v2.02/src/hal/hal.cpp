@@ -1,5 +1,13 @@
 #include "hal.h"
 #include <Arduino.h>
+#include <Preferences.h>
+#include <Wire.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+#include "i2c_arbiter.h"
+#include "serial_out.h"
 
 // ========================================
 // GPIO IMPLEMENTATION
@@ -22,10 +30,10 @@ void GPIO::init(Pin pin, Mode mode) {
   
   pinMode((int)pin, pinMode);
   
-  Serial.print("[GPIO] Initialized pin ");
-  Serial.print((int)pin);
-  Serial.print(" as ");
-  Serial.println(getPinName(pin));
+  Console.print("[GPIO] Initialized pin ");
+  Console.print((int)pin);
+  Console.print(" as ");
+  Console.println(getPinName(pin));
 }
 
 bool GPIO::read(Pin pin) {
@@ -45,28 +53,28 @@ void GPIO::setState(Pin pin, PinState state) {
 }
 
 void GPIO::attachInterrupt(Pin pin, ISRCallback handler, int mode) {
-  Serial.print("[GPIO] Attaching interrupt to pin ");
-  Serial.println((int)pin);
+  Console.print("[GPIO] Attaching interrupt to pin ");
+  Console.println((int)pin);
   
   // Would call attachInterrupt() on real hardware
 }
 
 void GPIO::detachInterrupt(Pin pin) {
-  Serial.print("[GPIO] Detaching interrupt from pin ");
-  Serial.println((int)pin);
+  Console.print("[GPIO] Detaching interrupt from pin ");
+  Console.println((int)pin);
   
   // Would call detachInterrupt() on real hardware
 }
 
 void GPIO::initAll() {
-  Serial.println("[GPIO] Initializing all pins...");
+  Console.println("[GPIO] Initializing all pins...");
   
   init(COUNTER_BTN, INPUT_PULLUP);
   init(DIAG_BTN, INPUT_PULLUP);
   init(LATCH_BTN, INPUT_PULLUP);
   init(SD_CS, OUTPUT);
   
-  Serial.println("[GPIO] All pins initialized");
+  Console.println("[GPIO] All pins initialized");
 }
 
 const char* GPIO::getPinName(Pin pin) {
@@ -85,33 +93,33 @@ const char* GPIO::getPinName(Pin pin) {
 
 bool Timer::createTimer(uint8_t timerId, unsigned long intervalMs,
                         TimerCallback callback, TimerType type) {
-  Serial.print("[Timer] Creating timer ");
-  Serial.print(timerId);
-  Serial.print(" with interval ");
-  Serial.print(intervalMs);
-  Serial.println("ms");
+  Console.print("[Timer] Creating timer ");
+  Console.print(timerId);
+  Console.print(" with interval ");
+  Console.print(intervalMs);
+  Console.println("ms");
   
   // Would create timer on real hardware
   return true;
 }
 
 void Timer::startTimer(uint8_t timerId) {
-  Serial.print("[Timer] Starting timer ");
-  Serial.println(timerId);
+  Console.print("[Timer] Starting timer ");
+  Console.println(timerId);
   
   // Would start timer on real hardware
 }
 
 void Timer::stopTimer(uint8_t timerId) {
-  Serial.print("[Timer] Stopping timer ");
-  Serial.println(timerId);
+  Console.print("[Timer] Stopping timer ");
+  Console.println(timerId);
   
   // Would stop timer on real hardware
 }
 
 void Timer::deleteTimer(uint8_t timerId) {
-  Serial.print("[Timer] Deleting timer ");
-  Serial.println(timerId);
+  Console.print("[Timer] Deleting timer ");
+  Console.println(timerId);
   
   // Would delete timer on real hardware
 }
@@ -127,11 +135,11 @@ unsigned long Timer::getElapsed(uint8_t timerId) {
 }
 
 void Timer::setInterval(uint8_t timerId, unsigned long intervalMs) {
-  Serial.print("[Timer] Setting interval for timer ");
-  Serial.print(timerId);
-  Serial.print(" to ");
-  Serial.print(intervalMs);
-  Serial.println("ms");
+  Console.print("[Timer] Setting interval for timer ");
+  Console.print(timerId);
+  Console.print(" to ");
+  Console.print(intervalMs);
+  Console.println("ms");
 }
 
 void Timer::delay(unsigned long ms) {
@@ -158,22 +166,22 @@ void Serial_HAL::init(unsigned long baudRate) {
   Serial.begin(baudRate);
   delay(1000);
   
-  Serial.print("[Serial_HAL] Initialized at ");
-  Serial.print(baudRate);
-  Serial.println(" baud");
+  Console.print("[Serial_HAL] Initialized at ");
+  Console.print(baudRate);
+  Console.println(" baud");
 }
 
 void Serial_HAL::print(const char* str) {
-  Serial.print(str);
+  Console.print(str);
 }
 
 void Serial_HAL::println(const char* str) {
-  Serial.println(str);
+  Console.println(str);
 }
 
 void Serial_HAL::printf(const char* format, ...) {
   // Would format and print like sprintf
-  Serial.print(format);
+  Console.print(format);
 }
 
 bool Serial_HAL::available() {
@@ -209,14 +217,14 @@ String Serial_HAL::readUntil(char terminator) {
 }
 
 void Serial_HAL::setBaudRate(unsigned long baud) {
-  Serial.print("[Serial_HAL] Setting baud rate to ");
-  Serial.println(baud);
+  Console.print("[Serial_HAL] Setting baud rate to ");
+  Console.println(baud);
   
   // Would set baud rate on real hardware
 }
 
 void Serial_HAL::flush() {
-  Serial.flush();
+  Console.flush();
 }
 
 int Serial_HAL::availableForWrite() {
@@ -227,68 +235,482 @@ int Serial_HAL::availableForWrite() {
 // I2C IMPLEMENTATION
 // ========================================
 
-bool I2C::init(uint8_t sdaPin, uint8_t sclPin, uint32_t frequency) {
-  Serial.print("[I2C] Initializing I2C on SDA=");
-  Serial.print(sdaPin);
-  Serial.print(" SCL=");
-  Serial.print(sclPin);
-  Serial.print(" @ ");
-  Serial.print(frequency);
-  Serial.println("Hz");
+// SSD1306 control bytes (Wire buffer is 128 bytes, chunks stay well below)
+static const uint8_t SSD1306_CONTROL_COMMAND = 0x00;
+static const uint8_t SSD1306_CONTROL_DATA = 0x40;
+static const uint8_t SSD1306_SET_COLUMN_ADDR = 0x21;
+static const uint8_t SSD1306_SET_PAGE_ADDR = 0x22;
+
+static const uint8_t PROBE_ATTEMPTS = 3;
+
+static I2CArbiter i2cArbiter;
+static portMUX_TYPE i2cMux = portMUX_INITIALIZER_UNLOCKED;
+static EventGroupHandle_t i2cGrants = nullptr;   // Bit n: waiter slot n owns the bus
+
+static I2C::DeviceStats i2cDevices[I2C::MAX_DEVICES];
+static uint8_t i2cDeviceCount = 0;
+static uint32_t i2cClockHz = I2C::STANDARD_MODE_HZ;   // Slowest device
+static uint32_t i2cWireClockHz = I2C::STANDARD_MODE_HZ;
+static uint32_t i2cBytesTransferred = 0;
+static int64_t i2cStatsSinceMicros = 0;
+static const char* i2cLastError = "No error";
+
+// Current owner (only touched while holding the bus)
+static int8_t i2cOwner = -1;
+static int64_t i2cGrantMicros = 0;
+
+static int8_t findDevice(uint8_t address) {
+  for (uint8_t i = 0; i < i2cDeviceCount; i++) {
+    if (i2cDevices[i].address == address) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Wait for the bus by priority; false on timeout
+static bool acquireBus(I2C::Priority priority, int8_t device) {
+  int64_t startMicros = esp_timer_get_time();
+  uint8_t slot;
+  
+  portENTER_CRITICAL(&i2cMux);
+  I2CArbiter::Request request = i2cArbiter.request(priority, slot);
+  portEXIT_CRITICAL(&i2cMux);
+  
+  if (request == I2CArbiter::REJECTED || (request == I2CArbiter::QUEUED && i2cGrants == nullptr)) {
+    i2cLastError = "Too many bus waiters";
+    return false;
+  }
+  
+  if (request == I2CArbiter::QUEUED) {
+    EventBits_t bit = (EventBits_t)1 << slot;
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(I2C::BUS_TIMEOUT_MS);
+    bool owned = false;
+    
+    for (;;) {
+      TickType_t now = xTaskGetTickCount();
+      TickType_t remaining = ((int32_t)(deadline - now) > 0) ? deadline - now : 0;
+      EventBits_t bits = xEventGroupWaitBits(i2cGrants, bit, pdTRUE, pdTRUE, remaining);
+      
+      portENTER_CRITICAL(&i2cMux);
+      if (bits & bit) {
+        owned = i2cArbiter.claim(slot);   // False: stale bit from an earlier waiter
+      } else {
+        owned = !i2cArbiter.cancel(slot);  // Granted just as we gave up
+      }
+      portEXIT_CRITICAL(&i2cMux);
+      
+      if (owned || !(bits & bit)) break;
+    }
+    
+    if (!owned) {
+      i2cLastError = "Bus timeout";
+      if (device >= 0) i2cDevices[device].errors++;
+      return false;
+    }
+  }
   
-  // Wire.begin(sdaPin, sclPin);
+  i2cOwner = device;
+  i2cGrantMicros = esp_timer_get_time();
+  if (device >= 0) {
+    uint32_t waited = (uint32_t)(i2cGrantMicros - startMicros);
+    if (waited > i2cDevices[device].maxWaitMicros) {
+      i2cDevices[device].maxWaitMicros = waited;
+    }
+  }
   
+#if I2C_MIXED_CLOCK
+  uint32_t clockHz = (device >= 0 && i2cDevices[device].clockHz > 0)
+                         ? i2cDevices[device].clockHz : i2cClockHz;
+  if (clockHz != i2cWireClockHz) {
+    Wire.setClock(clockHz);
+    i2cWireClockHz = clockHz;
+  }
+#endif
   return true;
 }
 
-bool I2C::write(uint8_t address, const uint8_t* data, size_t length) {
-  Serial.print("[I2C] Writing ");
-  Serial.print(length);
-  Serial.print(" bytes to address 0x");
-  Serial.println(address, HEX);
+static void releaseBus() {
+  if (i2cOwner >= 0) {
+    i2cDevices[i2cOwner].busyMicros += esp_timer_get_time() - i2cGrantMicros;
+  }
+  i2cOwner = -1;
+  
+  portENTER_CRITICAL(&i2cMux);
+  uint8_t next = i2cArbiter.release();
+  portEXIT_CRITICAL(&i2cMux);
+  
+  if (next != I2CArbiter::NO_SLOT) {
+    xEventGroupSetBits(i2cGrants, (EventBits_t)1 << next);
+  }
+}
+
+static void countTransaction(int8_t device, size_t bytes, bool ok) {
+  i2cBytesTransferred += bytes;
+  if (device < 0) return;
+  i2cDevices[device].transactions++;
+  i2cDevices[device].bytes += bytes;
+  if (!ok) i2cDevices[device].errors++;
+}
+
+// Bus held by the caller
+static bool wireWrite(int8_t device, uint8_t address, const uint8_t* data, size_t length) {
+  Wire.beginTransmission(address);
+  Wire.write(data, length);
+  bool ok = (Wire.endTransmission() == 0);
   
+  countTransaction(device, length + 1, ok);  // + address byte
+  if (!ok) i2cLastError = "Write not acknowledged";
+  return ok;
+}
+
+static bool wireProbe(uint8_t address) {
+  for (uint8_t i = 0; i < PROBE_ATTEMPTS; i++) {
+    Wire.beginTransmission(address);
+    if (Wire.endTransmission() != 0) {
+      return false;
+    }
+  }
   return true;
 }
 
-bool I2C::read(uint8_t address, uint8_t* buffer, size_t length) {
-  Serial.print("[I2C] Reading ");
-  Serial.print(length);
-  Serial.print(" bytes from address 0x");
-  Serial.println(address, HEX);
+bool I2C::init(uint8_t sdaPin, uint8_t sclPin, uint32_t frequency) {
+  Console.print("[I2C] Initializing I2C on SDA=");
+  Console.print(sdaPin);
+  Console.print(" SCL=");
+  Console.print(sclPin);
+  Console.print(" @ ");
+  Console.print(frequency);
+  Console.println("Hz");
   
+  if (i2cGrants == nullptr) {
+    i2cGrants = xEventGroupCreate();
+    if (i2cGrants == nullptr) {
+      Console.println("[I2C] ERROR: Cannot create bus event group");
+      return false;
+    }
+  }
+  
+  if (!Wire.begin(sdaPin, sclPin, frequency)) {
+    Console.println("[I2C] ERROR: Wire.begin failed");
+    return false;
+  }
+  i2cClockHz = frequency;
+  i2cWireClockHz = frequency;
+  i2cStatsSinceMicros = esp_timer_get_time();
   return true;
 }
 
-bool I2C::writeRead(uint8_t address, const uint8_t* writeData, size_t writeLength,
-                    uint8_t* readBuffer, size_t readLength) {
-  Serial.print("[I2C] Write-Read to address 0x");
-  Serial.println(address, HEX);
+bool I2C::addDevice(uint8_t address, const char* name, uint32_t ratedHz) {
+  if (findDevice(address) >= 0) {
+    return true;
+  }
+  if (i2cDeviceCount >= MAX_DEVICES) {
+    Console.println("[I2C] ERROR: Device table full");
+    return false;
+  }
   
+  DeviceStats& device = i2cDevices[i2cDeviceCount];
+  memset(&device, 0, sizeof(device));
+  device.address = address;
+  device.name = name;
+  device.ratedHz = ratedHz;
+  i2cDeviceCount++;
   return true;
 }
 
-bool I2C::devicePresent(uint8_t address) {
-  Serial.print("[I2C] Checking device at address 0x");
-  Serial.println(address, HEX);
+uint32_t I2C::negotiateClock(uint32_t maxHz) {
+  static const uint32_t SPEEDS[] = { FAST_MODE_PLUS_HZ, FAST_MODE_HZ, STANDARD_MODE_HZ };
+  
+  if (!acquireBus(PRIORITY_URGENT, -1)) {
+    Console.println("[I2C] ERROR: Bus busy - clock not negotiated");
+    return i2cClockHz;
+  }
+  
+  uint32_t busHz = 0;
+  for (uint8_t i = 0; i < i2cDeviceCount; i++) {
+    DeviceStats& device = i2cDevices[i];
+    device.clockHz = 0;
+    
+    for (uint8_t s = 0; s < sizeof(SPEEDS) / sizeof(SPEEDS[0]); s++) {
+      if (SPEEDS[s] > maxHz || SPEEDS[s] > device.ratedHz) continue;
+      Wire.setClock(SPEEDS[s]);
+      if (wireProbe(device.address)) {
+        device.clockHz = SPEEDS[s];
+        break;
+      }
+    }
+    
+    Console.print("[I2C] 0x");
+    Console.print(device.address, HEX);
+    Console.print(" ");
+    Console.print(device.name);
+    if (device.clockHz == 0) {
+      Console.println(": not responding");
+      continue;  // Absent devices do not limit the bus
+    }
+    Console.print(": ");
+    Console.print(device.clockHz);
+    Console.print(" Hz (rated ");
+    Console.print(device.ratedHz);
+    Console.println(" Hz)");
+    
+    if (busHz == 0 || device.clockHz < busHz) {
+      busHz = device.clockHz;
+    }
+  }
+  
+  if (busHz == 0) {
+    busHz = STANDARD_MODE_HZ;
+  }
+#if !I2C_MIXED_CLOCK
+  // Every device sees all traffic: run the bus at the slowest one
+  for (uint8_t i = 0; i < i2cDeviceCount; i++) {
+    if (i2cDevices[i].clockHz > busHz) i2cDevices[i].clockHz = busHz;
+  }
+#endif
+  
+  Wire.setClock(busHz);
+  i2cClockHz = busHz;
+  i2cWireClockHz = busHz;
+  releaseBus();
+  
+  Console.print("[I2C] Bus clock ");
+  Console.print(busHz);
+  Console.println(" Hz");
+  return busHz;
+}
+
+bool I2C::write(uint8_t address, const uint8_t* data, size_t length, Priority priority) {
+  int8_t device = findDevice(address);
+  if (!acquireBus(priority, device)) {
+    return false;
+  }
+  bool ok = wireWrite(device, address, data, length);
+  releaseBus();
+  return ok;
+}
+
+bool I2C::read(uint8_t address, uint8_t* buffer, size_t length, Priority priority) {
+  int8_t device = findDevice(address);
+  if (!acquireBus(priority, device)) {
+    return false;
+  }
+  
+  bool ok = (Wire.requestFrom(address, (uint8_t)length) == length);
+  for (size_t i = 0; ok && i < length; i++) {
+    buffer[i] = Wire.read();
+  }
+  countTransaction(device, length + 1, ok);
+  if (!ok) i2cLastError = "Short read";
+  
+  releaseBus();
+  return ok;
+}
+
+bool I2C::writeRead(uint8_t address, const uint8_t* writeData, size_t writeLength,
+                    uint8_t* readBuffer, size_t readLength, Priority priority) {
+  int8_t device = findDevice(address);
+  if (!acquireBus(priority, device)) {
+    return false;
+  }
+  
+  // Repeated start: nobody else can get between the register and the data
+  Wire.beginTransmission(address);
+  Wire.write(writeData, writeLength);
+  bool ok = (Wire.endTransmission(false) == 0);
+  if (ok) {
+    ok = (Wire.requestFrom(address, (uint8_t)readLength) == readLength);
+    for (size_t i = 0; ok && i < readLength; i++) {
+      readBuffer[i] = Wire.read();
+    }
+  }
+  countTransaction(device, writeLength + readLength + 2, ok);
+  if (!ok) i2cLastError = "Write-read failed";
+  
+  releaseBus();
+  return ok;
+}
+
+I2C::Transaction::Transaction(uint8_t address, Priority priority)
+    : device(findDevice(address)), granted(false) {
+  granted = acquireBus(priority, device);
+}
+
+I2C::Transaction::~Transaction() {
+  if (!granted) return;
+  countTransaction(device, 0, true);  // Bytes unknown - bus time still counts
+  releaseBus();
+}
+
+static bool ssd1306SetWindow(int8_t device, uint8_t address, uint8_t pageStart, uint8_t pageEnd,
+                             uint8_t colStart, uint8_t colEnd) {
+  const uint8_t window[] = {
+    SSD1306_CONTROL_COMMAND,
+    SSD1306_SET_COLUMN_ADDR, colStart, colEnd,
+    SSD1306_SET_PAGE_ADDR, pageStart, pageEnd,
+  };
+  return wireWrite(device, address, window, sizeof(window));
+}
+
+bool I2C::ssd1306WriteWindow(uint8_t address, uint8_t pageStart, uint8_t pageEnd,
+                             uint8_t colStart, uint8_t colEnd,
+                             const uint8_t* data, size_t length) {
+  int8_t device = findDevice(address);
+  size_t width = colEnd - colStart + 1;
+  size_t sent = 0;
+  size_t windowEnd = 0;
+  bool windowOpen = false;
+  uint32_t panelTransactions = 0;
+  
+  uint8_t chunk[1 + BULK_CHUNK];
+  chunk[0] = SSD1306_CONTROL_DATA;
+  
+  // One chunk per bus hold; higher priorities get in between
+  do {
+    if (!acquireBus(PRIORITY_BULK, device)) {
+      return false;
+    }
+    
+    // Another transaction reached the panel between chunks: its RAM
+    // pointer may have moved, set the window again from where we are
+    if (windowOpen && device >= 0 && i2cDevices[device].transactions != panelTransactions) {
+      windowOpen = false;
+    }
+    
+    bool ok = true;
+    if (!windowOpen) {
+      uint8_t page = pageStart + sent / width;
+      uint8_t col = colStart + sent % width;
+      bool midRow = (col != colStart);   // Finish this row before wrapping
+      ok = ssd1306SetWindow(device, address, page, midRow ? page : pageEnd, col, colEnd);
+      windowEnd = midRow ? sent + (colEnd - col + 1) : length;
+      windowOpen = ok;
+    }
+    
+    if (ok && sent < length) {
+      size_t n = windowEnd - sent;
+      if (n > BULK_CHUNK) n = BULK_CHUNK;
+      memcpy(chunk + 1, data + sent, n);
+      ok = wireWrite(device, address, chunk, n + 1);
+      if (ok) sent += n;
+    }
+    if (sent == windowEnd) {
+      windowOpen = false;
+    }
+    
+    if (device >= 0) {
+      panelTransactions = i2cDevices[device].transactions;
+      if (ok && sent < length) {
+        portENTER_CRITICAL(&i2cMux);
+        bool contended = i2cArbiter.isContended(PRIORITY_BULK);
+        portEXIT_CRITICAL(&i2cMux);
+        if (contended) i2cDevices[device].yields++;
+      }
+    }
+    releaseBus();
+    
+    if (!ok) {
+      return false;
+    }
+  } while (sent < length);
   
   return true;
 }
 
+uint32_t I2C::getBytesTransferred() {
+  return i2cBytesTransferred;
+}
+
+uint8_t I2C::getDeviceCount() {
+  return i2cDeviceCount;
+}
+
+bool I2C::getDeviceStats(uint8_t index, DeviceStats& stats) {
+  if (index >= i2cDeviceCount) {
+    return false;
+  }
+  stats = i2cDevices[index];
+  return true;
+}
+
+float I2C::getUtilization(uint8_t index) {
+  int64_t elapsed = esp_timer_get_time() - i2cStatsSinceMicros;
+  if (index >= i2cDeviceCount || elapsed <= 0) {
+    return 0;
+  }
+  return i2cDevices[index].busyMicros * 100.0f / elapsed;
+}
+
+uint32_t I2C::getHandovers() {
+  return i2cArbiter.getHandovers();
+}
+
+void I2C::resetStats() {
+  if (!acquireBus(PRIORITY_URGENT, -1)) {
+    return;
+  }
+  for (uint8_t i = 0; i < i2cDeviceCount; i++) {
+    DeviceStats& device = i2cDevices[i];
+    device.transactions = 0;
+    device.errors = 0;
+    device.bytes = 0;
+    device.busyMicros = 0;
+    device.maxWaitMicros = 0;
+    device.yields = 0;
+  }
+  i2cStatsSinceMicros = esp_timer_get_time();
+  releaseBus();
+}
+
+bool I2C::devicePresent(uint8_t address) {
+  int8_t device = findDevice(address);
+  if (!acquireBus(PRIORITY_NORMAL, device)) {
+    return false;
+  }
+  Wire.beginTransmission(address);
+  bool present = (Wire.endTransmission() == 0);
+  countTransaction(device, 1, present);
+  releaseBus();
+  return present;
+}
+
 bool I2C::scanDevices(uint8_t* addresses, size_t maxDevices, size_t& foundCount) {
-  Serial.println("[I2C] Scanning for devices...");
+  Console.println("[I2C] Scanning for devices...");
   foundCount = 0;
   
+  for (uint8_t address = 0x08; address < 0x78; address++) {
+    if (devicePresent(address)) {
+      if (foundCount < maxDevices) {
+        addresses[foundCount] = address;
+      }
+      foundCount++;
+    }
+  }
   return true;
 }
 
 void I2C::setClockSpeed(uint32_t frequency) {
-  Serial.print("[I2C] Setting clock speed to ");
-  Serial.print(frequency);
-  Serial.println("Hz");
+  Console.print("[I2C] Setting clock speed to ");
+  Console.print(frequency);
+  Console.println("Hz");
+  
+  if (!acquireBus(PRIORITY_NORMAL, -1)) {
+    Console.println("[I2C] ERROR: Bus busy - clock unchanged");
+    return;
+  }
+  Wire.setClock(frequency);
+  i2cClockHz = frequency;
+  i2cWireClockHz = frequency;
+  releaseBus();
+}
+
+uint32_t I2C::getClockSpeed() {
+  return i2cClockHz;
 }
 
 const char* I2C::getLastError() {
-  return "No error";
+  return i2cLastError;
 }
 
 // ========================================
@@ -296,27 +718,27 @@ const char* I2C::getLastError() {
 // ========================================
 
 bool SPI_HAL::init(SPIBus bus, uint32_t frequency) {
-  Serial.print("[SPI_HAL] Initializing SPI bus ");
-  Serial.print(bus);
-  Serial.print(" @ ");
-  Serial.print(frequency);
-  Serial.println("Hz");
+  Console.print("[SPI_HAL] Initializing SPI bus ");
+  Console.print(bus);
+  Console.print(" @ ");
+  Console.print(frequency);
+  Console.println("Hz");
   
   return true;
 }
 
 bool SPI_HAL::initWithPins(SPIBus bus, uint8_t sckPin, uint8_t misoPin,
                            uint8_t mosiPin, uint8_t csPin) {
-  Serial.print("[SPI_HAL] Initializing SPI bus ");
-  Serial.print(bus);
-  Serial.print(" with custom pins - SCK:");
-  Serial.print(sckPin);
-  Serial.print(" MISO:");
-  Serial.print(misoPin);
-  Serial.print(" MOSI:");
-  Serial.print(mosiPin);
-  Serial.print(" CS:");
-  Serial.println(csPin);
+  Console.print("[SPI_HAL] Initializing SPI bus ");
+  Console.print(bus);
+  Console.print(" with custom pins - SCK:");
+  Console.print(sckPin);
+  Console.print(" MISO:");
+  Console.print(misoPin);
+  Console.print(" MOSI:");
+  Console.print(mosiPin);
+  Console.print(" CS:");
+  Console.println(csPin);
   
   return true;
 }
@@ -327,15 +749,15 @@ uint8_t SPI_HAL::transfer(uint8_t data) {
 }
 
 void SPI_HAL::transfer(uint8_t* data, size_t length) {
-  Serial.print("[SPI_HAL] Transferring ");
-  Serial.print(length);
-  Serial.println(" bytes");
+  Console.print("[SPI_HAL] Transferring ");
+  Console.print(length);
+  Console.println(" bytes");
 }
 
 bool SPI_HAL::transfer(const uint8_t* writeBuf, uint8_t* readBuf, size_t length) {
-  Serial.print("[SPI_HAL] Bidirectional transfer of ");
-  Serial.print(length);
-  Serial.println(" bytes");
+  Console.print("[SPI_HAL] Bidirectional transfer of ");
+  Console.print(length);
+  Console.println(" bytes");
   
   return true;
 }
@@ -349,14 +771,14 @@ void SPI_HAL::deselectDevice(uint8_t csPin) {
 }
 
 void SPI_HAL::setClockSpeed(uint32_t frequency) {
-  Serial.print("[SPI_HAL] Setting clock speed to ");
-  Serial.print(frequency);
-  Serial.println("Hz");
+  Console.print("[SPI_HAL] Setting clock speed to ");
+  Console.print(frequency);
+  Console.println("Hz");
 }
 
 void SPI_HAL::setMode(uint8_t mode) {
-  Serial.print("[SPI_HAL] Setting SPI mode to ");
-  Serial.println(mode);
+  Console.print("[SPI_HAL] Setting SPI mode to ");
+  Console.println(mode);
 }
 
 void SPI_HAL::beginTransaction() {
@@ -372,9 +794,9 @@ void SPI_HAL::endTransaction() {
 // ========================================
 
 bool Watchdog::init(uint32_t timeoutSeconds) {
-  Serial.print("[Watchdog] Initializing with ");
-  Serial.print(timeoutSeconds);
-  Serial.println(" second timeout");
+  Console.print("[Watchdog] Initializing with ");
+  Console.print(timeoutSeconds);
+  Console.println(" second timeout");
   
   // esp_task_wdt_init(timeoutSeconds, true);
   
@@ -386,23 +808,23 @@ void Watchdog::feed() {
 }
 
 void Watchdog::reset() {
-  Serial.println("[Watchdog] Resetting system...");
+  Console.println("[Watchdog] Resetting system...");
   
   // ESP.restart();
 }
 
 void Watchdog::enable() {
-  Serial.println("[Watchdog] Enabling watchdog");
+  Console.println("[Watchdog] Enabling watchdog");
 }
 
 void Watchdog::disable() {
-  Serial.println("[Watchdog] Disabling watchdog");
+  Console.println("[Watchdog] Disabling watchdog");
 }
 
 void Watchdog::setTimeout(uint32_t seconds) {
-  Serial.print("[Watchdog] Setting timeout to ");
-  Serial.print(seconds);
-  Serial.println(" seconds");
+  Console.print("[Watchdog] Setting timeout to ");
+  Console.print(seconds);
+  Console.println(" seconds");
 }
 
 bool Watchdog::isEnabled() {
@@ -418,7 +840,7 @@ bool Watchdog::wasTriggered() {
 }
 
 void Watchdog::clearTriggerFlag() {
-  Serial.println("[Watchdog] Clearing trigger flag");
+  Console.println("[Watchdog] Clearing trigger flag");
 }
 
 // ========================================
@@ -426,25 +848,25 @@ void Watchdog::clearTriggerFlag() {
 // ========================================
 
 void PowerManager::init() {
-  Serial.println("[PowerManager] Initializing power management...");
+  Console.println("[PowerManager] Initializing power management...");
 }
 
 void PowerManager::setPowerMode(PowerMode mode) {
   const char* modeNames[] = {"NORMAL", "LIGHT_SLEEP", "DEEP_SLEEP", "MODEM_SLEEP"};
-  Serial.print("[PowerManager] Setting power mode to ");
-  Serial.println(modeNames[mode]);
+  Console.print("[PowerManager] Setting power mode to ");
+  Console.println(modeNames[mode]);
 }
 
 void PowerManager::sleep(unsigned long durationMs) {
-  Serial.print("[PowerManager] Sleeping for ");
-  Serial.print(durationMs);
-  Serial.println("ms");
+  Console.print("[PowerManager] Sleeping for ");
+  Console.print(durationMs);
+  Console.println("ms");
 }
 
 void PowerManager::deepSleep(unsigned long durationUs) {
-  Serial.print("[PowerManager] Deep sleeping for ");
-  Serial.print(durationUs);
-  Serial.println("µs");
+  Console.print("[PowerManager] Deep sleeping for ");
+  Console.print(durationUs);
+  Console.println("µs");
 }
 
 uint32_t PowerManager::getChipID() {
@@ -488,60 +910,148 @@ float PowerManager::getChipTemperature() {
 // EEPROM_HAL IMPLEMENTATION
 // ========================================
 
+static const char* EEPROM_HAL_NAMESPACE = "eeprom_hal";
+
+uint8_t EEPROM_HAL::mirror[EEPROM_HAL::MAX_SIZE];
+uint32_t EEPROM_HAL::dirtyMask = 0;
+size_t EEPROM_HAL::regionSize = 0;
+uint32_t EEPROM_HAL::commitCount = 0;
+uint32_t EEPROM_HAL::sectorWriteCount = 0;
+
+static void sectorKey(size_t sector, char* key) {
+  snprintf(key, 8, "s%02u", (unsigned)sector);
+}
+
 bool EEPROM_HAL::init(size_t sizeBytes) {
-  Serial.print("[EEPROM_HAL] Initializing EEPROM (");
-  Serial.print(sizeBytes);
-  Serial.println(" bytes)");
+  Console.print("[EEPROM_HAL] Initializing EEPROM (");
+  Console.print(sizeBytes);
+  Console.println(" bytes)");
+  
+  if (sizeBytes == 0 || sizeBytes > MAX_SIZE) {
+    Console.println("[EEPROM_HAL] ERROR: Invalid size");
+    return false;
+  }
   
-  // EEPROM.begin(sizeBytes);
+  // Round up to whole sectors
+  regionSize = ((sizeBytes + SECTOR_SIZE - 1) / SECTOR_SIZE) * SECTOR_SIZE;
+  memset(mirror, 0xFF, sizeof(mirror));  // Erased state
+  dirtyMask = 0;
+  
+  Preferences prefs;
+  if (!prefs.begin(EEPROM_HAL_NAMESPACE, true)) {
+    // Namespace does not exist yet (first boot) - region stays erased
+    return true;
+  }
+  
+  char key[8];
+  for (size_t sector = 0; sector < getSectorCount(); sector++) {
+    sectorKey(sector, key);
+    if (prefs.getBytesLength(key) == SECTOR_SIZE) {
+      prefs.getBytes(key, &mirror[sector * SECTOR_SIZE], SECTOR_SIZE);
+    }
+  }
+  prefs.end();
   
   return true;
 }
 
 uint8_t EEPROM_HAL::read(size_t address) {
-  // return EEPROM.read(address);
-  return 0;
+  if (address >= regionSize) return 0xFF;
+  return mirror[address];
 }
 
 void EEPROM_HAL::readBytes(size_t address, uint8_t* buffer, size_t length) {
   for (size_t i = 0; i < length; i++) {
-    buffer[i] = 0;  // read(address + i);
+    buffer[i] = read(address + i);
   }
 }
 
 uint32_t EEPROM_HAL::readUInt32(size_t address) {
-  // return EEPROM.readUInt(address);
-  return 0;
+  uint32_t value = 0;
+  readBytes(address, reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  return value;
 }
 
 void EEPROM_HAL::write(size_t address, uint8_t value) {
-  // EEPROM.write(address, value);
+  if (address >= regionSize) return;
+  if (mirror[address] == value) return;  // Unchanged bytes never dirty a sector
+  
+  mirror[address] = value;
+  markDirty(address, 1);
 }
 
 void EEPROM_HAL::writeBytes(size_t address, const uint8_t* data, size_t length) {
   for (size_t i = 0; i < length; i++) {
-    // write(address + i, data[i]);
+    write(address + i, data[i]);
   }
 }
 
 void EEPROM_HAL::writeUInt32(size_t address, uint32_t value) {
-  // EEPROM.writeUInt(address, value);
+  writeBytes(address, reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+}
+
+void EEPROM_HAL::markDirty(size_t address, size_t length) {
+  size_t first = address / SECTOR_SIZE;
+  size_t last = (address + length - 1) / SECTOR_SIZE;
+  for (size_t sector = first; sector <= last; sector++) {
+    dirtyMask |= (1UL << sector);
+  }
 }
 
 bool EEPROM_HAL::commit() {
-  Serial.println("[EEPROM_HAL] Committing changes...");
+  if (dirtyMask == 0) {
+    return true;  // Nothing changed - no flash wear
+  }
   
-  // return EEPROM.commit();
-  return true;
+  Preferences prefs;
+  if (!prefs.begin(EEPROM_HAL_NAMESPACE, false)) {
+    Console.println("[EEPROM_HAL] ERROR: Cannot open NVS namespace");
+    return false;
+  }
+  
+  bool ok = true;
+  char key[8];
+  for (size_t sector = 0; sector < getSectorCount(); sector++) {
+    if (!(dirtyMask & (1UL << sector))) continue;
+    
+    sectorKey(sector, key);
+    if (prefs.putBytes(key, &mirror[sector * SECTOR_SIZE], SECTOR_SIZE) == SECTOR_SIZE) {
+      dirtyMask &= ~(1UL << sector);
+      sectorWriteCount++;
+    } else {
+      ok = false;
+    }
+  }
+  prefs.end();
+  
+  commitCount++;
+  if (!ok) {
+    Console.println("[EEPROM_HAL] ERROR: Sector commit failed");
+  }
+  return ok;
 }
 
 bool EEPROM_HAL::clear() {
-  Serial.println("[EEPROM_HAL] Clearing EEPROM...");
+  Console.println("[EEPROM_HAL] Clearing EEPROM...");
   
-  // Not typically done
-  return true;
+  for (size_t address = 0; address < regionSize; address++) {
+    write(address, 0xFF);
+  }
+  return commit();
 }
 
 size_t EEPROM_HAL::getSize() {
-  return 512;  // Default size
+  return regionSize;
+}
+
+size_t EEPROM_HAL::getSectorCount() {
+  return regionSize / SECTOR_SIZE;
+}
+
+size_t EEPROM_HAL::getDirtySectorCount() {
+  size_t count = 0;
+  for (uint32_t mask = dirtyMask; mask; mask &= mask - 1) {
+    count++;
+  }
+  return count;
 }
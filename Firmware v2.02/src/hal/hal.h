@@ -114,16 +114,77 @@ public:
 // ========================================
 // I2C ABSTRACTION LAYER
 // ========================================
+// Shared bus scheduler: the OLED (display task, core 0) and the RTC
+// (loop, core 1) take turns through I2CArbiter. Each transaction waits for
+// the bus by priority, so an RTC read never sits behind a whole frame -
+// display pushes go out in BULK_CHUNK pieces and yield between them.
+//
+// Devices are registered with their rated clock; negotiateClock() probes
+// each one and runs the bus at the fastest speed all of them answer at.
+// Per-device stats give bus time used and the longest wait for the bus.
+#ifndef I2C_MIXED_CLOCK
+#define I2C_MIXED_CLOCK 0   // 1 = switch the clock per device (out of spec for slower devices)
+#endif
+
 class I2C {
 public:
+  enum Priority : uint8_t {
+    PRIORITY_BULK,      // Display pushes, split into chunks
+    PRIORITY_NORMAL,    // Commands and configuration
+    PRIORITY_URGENT     // Timestamped reads (RTC edge capture)
+  };
+  
+  static const uint32_t STANDARD_MODE_HZ = 100000;
+  static const uint32_t FAST_MODE_HZ = 400000;
+  static const uint32_t FAST_MODE_PLUS_HZ = 1000000;
+  static const size_t BULK_CHUNK = 32;          // ~0.75 ms on the wire at 400 kHz
+  static const uint8_t MAX_DEVICES = 4;
+  static const uint32_t BUS_TIMEOUT_MS = 100;
+  
+  struct DeviceStats {
+    uint8_t address;
+    const char* name;
+    uint32_t ratedHz;         // Datasheet maximum
+    uint32_t clockHz;         // In use after negotiateClock()
+    uint32_t transactions;
+    uint32_t errors;
+    uint32_t bytes;           // Address + payload
+    uint64_t busyMicros;      // Bus held
+    uint32_t maxWaitMicros;   // Longest wait for the bus
+    uint32_t yields;          // Bulk transfers that let a higher priority in
+  };
+  
   // Initialization
-  static bool init(uint8_t sdaPin, uint8_t sclPin, uint32_t frequency = 100000);
+  static bool init(uint8_t sdaPin, uint8_t sclPin, uint32_t frequency = STANDARD_MODE_HZ);
+  
+  // Register a bus user (stats, clock negotiation)
+  static bool addDevice(uint8_t address, const char* name, uint32_t ratedHz);
+  
+  // Probe every present device from min(rated, maxHz) down through
+  // 1 MHz / 400 kHz / 100 kHz; returns the bus clock chosen
+  static uint32_t negotiateClock(uint32_t maxHz = FAST_MODE_PLUS_HZ);
   
   // Device communication
-  static bool write(uint8_t address, const uint8_t* data, size_t length);
-  static bool read(uint8_t address, uint8_t* buffer, size_t length);
+  static bool write(uint8_t address, const uint8_t* data, size_t length,
+                    Priority priority = PRIORITY_NORMAL);
+  static bool read(uint8_t address, uint8_t* buffer, size_t length,
+                   Priority priority = PRIORITY_NORMAL);
   static bool writeRead(uint8_t address, const uint8_t* writeData, size_t writeLength,
-                        uint8_t* readBuffer, size_t readLength);
+                        uint8_t* readBuffer, size_t readLength,
+                        Priority priority = PRIORITY_NORMAL);
+  
+  // Bus held for code that drives Wire itself (RTClib, Adafruit_SSD1306)
+  class Transaction {
+  public:
+    explicit Transaction(uint8_t address, Priority priority = PRIORITY_NORMAL);
+    ~Transaction();
+    bool ok() const { return granted; }
+  private:
+    Transaction(const Transaction&);
+    Transaction& operator=(const Transaction&);
+    int8_t device;
+    bool granted;
+  };
   
   // Device detection
   static bool devicePresent(uint8_t address);
@@ -131,6 +192,22 @@ public:
   
   // Configuration
   static void setClockSpeed(uint32_t frequency);
+  static uint32_t getClockSpeed();
+  
+  // SSD1306: set a column/page window and stream `length` bytes into it
+  // (panel must be in horizontal addressing mode, as after begin()).
+  // Sent at PRIORITY_BULK, BULK_CHUNK bytes per transaction.
+  static bool ssd1306WriteWindow(uint8_t address, uint8_t pageStart, uint8_t pageEnd,
+                                 uint8_t colStart, uint8_t colEnd,
+                                 const uint8_t* data, size_t length);
+  
+  // Bus statistics (address + payload bytes actually clocked out)
+  static uint32_t getBytesTransferred();
+  static uint8_t getDeviceCount();
+  static bool getDeviceStats(uint8_t index, DeviceStats& stats);
+  static float getUtilization(uint8_t index);   // % of time since resetStats()
+  static uint32_t getHandovers();               // Bus passed straight to a waiter
+  static void resetStats();
   
   // Error handling
   static const char* getLastError();
@@ -232,8 +309,15 @@ public:
 // ========================================
 // EEPROM ABSTRACTION LAYER
 // ========================================
+// Emulated EEPROM backed by NVS. The region is kept in a RAM mirror and
+// split into fixed-size sectors; each sector is stored as its own NVS blob.
+// commit() only writes sectors that changed since the last commit, so a
+// small record update costs one sector write instead of the whole region.
 class EEPROM_HAL {
 public:
+  static const size_t SECTOR_SIZE = 64;
+  static const size_t MAX_SIZE = 1024;
+  
   // Initialization
   static bool init(size_t sizeBytes);
   
@@ -253,6 +337,21 @@ public:
   
   // Status
   static size_t getSize();
+  static size_t getSectorCount();
+  static size_t getDirtySectorCount();
+  
+  // Wear statistics (since boot)
+  static uint32_t getCommitCount() { return commitCount; }
+  static uint32_t getSectorWriteCount() { return sectorWriteCount; }
+  
+private:
+  static void markDirty(size_t address, size_t length);
+  
+  static uint8_t mirror[MAX_SIZE];
+  static uint32_t dirtyMask;         // One bit per sector (MAX_SIZE / SECTOR_SIZE <= 32)
+  static size_t regionSize;
+  static uint32_t commitCount;
+  static uint32_t sectorWriteCount;
 };
 
 #endif // HAL_H
@@ -0,0 +1,89 @@
+#include "i2c_arbiter.h"
+
+// ========================================
+// I2C ARBITER IMPLEMENTATION
+// ========================================
+
+I2CArbiter::I2CArbiter() {
+  for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+    state[i] = SLOT_FREE;
+    slotPriority[i] = 0;
+    slotTicket[i] = 0;
+  }
+}
+
+I2CArbiter::Request I2CArbiter::request(uint8_t priority, uint8_t& slot) {
+  slot = NO_SLOT;
+  if (!busy) {
+    busy = true;
+    return GRANTED;
+  }
+
+  for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+    if (state[i] == SLOT_FREE) {
+      state[i] = SLOT_QUEUED;
+      slotPriority[i] = (priority < PRIORITY_COUNT) ? priority : PRIORITY_COUNT - 1;
+      slotTicket[i] = nextTicket++;
+      waiting++;
+      slot = i;
+      return QUEUED;
+    }
+  }
+  rejected++;
+  return REJECTED;
+}
+
+uint8_t I2CArbiter::release() {
+  uint8_t next = NO_SLOT;
+  for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+    if (state[i] != SLOT_QUEUED) continue;
+    if (next == NO_SLOT || slotPriority[i] > slotPriority[next] ||
+        (slotPriority[i] == slotPriority[next] &&
+         (int32_t)(slotTicket[i] - slotTicket[next]) < 0)) {
+      next = i;
+    }
+  }
+
+  if (next == NO_SLOT) {
+    busy = false;
+    return NO_SLOT;
+  }
+
+  // Bus stays busy: ownership passes straight to the waiter
+  state[next] = SLOT_GRANTED;
+  waiting--;
+  handovers++;
+  return next;
+}
+
+bool I2CArbiter::claim(uint8_t slot) {
+  if (slot >= MAX_WAITERS || state[slot] != SLOT_GRANTED) {
+    return false;
+  }
+  state[slot] = SLOT_FREE;
+  return true;
+}
+
+bool I2CArbiter::cancel(uint8_t slot) {
+  if (slot >= MAX_WAITERS) {
+    return true;
+  }
+  if (state[slot] == SLOT_GRANTED) {
+    state[slot] = SLOT_FREE;
+    return false;
+  }
+  if (state[slot] == SLOT_QUEUED) {
+    waiting--;
+  }
+  state[slot] = SLOT_FREE;
+  return true;
+}
+
+bool I2CArbiter::isContended(uint8_t priority) const {
+  for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+    if (state[i] == SLOT_QUEUED && slotPriority[i] > priority) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,75 @@
+#ifndef I2C_ARBITER_H
+#define I2C_ARBITER_H
+
+#include <stdint.h>
+
+// ========================================
+// I2C BUS ARBITER
+// ========================================
+// Decides who gets the shared bus next. Every I2C transaction asks for the
+// bus with a priority; if it is busy the caller gets a waiter slot and
+// blocks until release() hands the bus to it. Handover goes to the highest
+// waiting priority, first come first served within a priority - so an RTC
+// read queued behind a display push gets the bus at the end of the current
+// chunk, not the end of the frame.
+//
+// Pure bookkeeping (no RTOS calls, no time): the I2C HAL wraps it in a
+// critical section and maps slots to event-group bits; host tests drive it
+// directly.
+class I2CArbiter {
+public:
+  static const uint8_t PRIORITY_COUNT = 3;  // Matches I2C::Priority
+  static const uint8_t MAX_WAITERS = 8;     // Event-group bits available
+  static const uint8_t NO_SLOT = 0xFF;
+
+  enum Request {
+    GRANTED,      // Bus is yours now
+    QUEUED,       // Wait on `slot`
+    REJECTED      // No free waiter slot
+  };
+
+  I2CArbiter();
+
+  Request request(uint8_t priority, uint8_t& slot);
+
+  // Owner gives the bus up. Returns the slot that now owns it (its waiter
+  // must be woken) or NO_SLOT if the bus is idle.
+  uint8_t release();
+
+  // Woken waiter takes ownership and frees its slot. False if the bus was
+  // not handed to this slot (stale wakeup) - keep waiting.
+  bool claim(uint8_t slot);
+
+  // Waiter gives up (timeout). False if the bus was handed to it
+  // meanwhile - it owns the bus and must release() it.
+  bool cancel(uint8_t slot);
+
+  bool isBusy() const { return busy; }
+  uint8_t getWaiting() const { return waiting; }
+
+  // Someone above `priority` is queued (bulk transfers yield between chunks)
+  bool isContended(uint8_t priority) const;
+
+  // Diagnostics
+  uint32_t getHandovers() const { return handovers; }
+  uint32_t getRejected() const { return rejected; }
+
+private:
+  enum SlotState : uint8_t {
+    SLOT_FREE,
+    SLOT_QUEUED,
+    SLOT_GRANTED
+  };
+
+  SlotState state[MAX_WAITERS];
+  uint8_t slotPriority[MAX_WAITERS];
+  uint32_t slotTicket[MAX_WAITERS];
+  uint32_t nextTicket = 0;
+  uint8_t waiting = 0;
+  bool busy = false;
+
+  uint32_t handovers = 0;
+  uint32_t rejected = 0;
+};
+
+#endif // I2C_ARBITER_H
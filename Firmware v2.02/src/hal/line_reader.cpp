@@ -0,0 +1,50 @@
+#include "line_reader.h"
+
+// ========================================
+// LINE READER IMPLEMENTATION
+// ========================================
+
+LineReader::Status LineReader::feed(char c) {
+  if (complete) {
+    length = 0;
+    complete = false;
+  }
+
+  if (c == '\r' || c == '\n') {
+    if (discarding) {
+      discarding = false;
+      length = 0;
+      tooLong++;
+      return TOO_LONG;
+    }
+    if (length == 0) {
+      return PENDING;              // Blank line, or the '\n' of a CRLF
+    }
+    buffer[length] = '\0';
+    complete = true;
+    lines++;
+    return LINE;
+  }
+
+  if (discarding) {
+    return PENDING;
+  }
+  if (c == '\b' || c == 0x7F) {
+    if (length > 0) {
+      length--;
+    }
+    return PENDING;
+  }
+  if (length >= MAX_LINE - 1) {
+    discarding = true;
+    return PENDING;
+  }
+  buffer[length++] = c;
+  return PENDING;
+}
+
+void LineReader::reset() {
+  length = 0;
+  complete = false;
+  discarding = false;
+}
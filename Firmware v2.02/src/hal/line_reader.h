@@ -0,0 +1,49 @@
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// NON-BLOCKING LINE READER
+// ========================================
+// Assembles serial input into lines one byte at a time, so loop() can take
+// whatever has arrived (up to BYTES_PER_POLL) and move on instead of
+// waiting in readStringUntil() for the rest of a line.
+//
+// A line ends at '\r' or '\n' (CRLF gives one line; blank lines are
+// skipped). Backspace/DEL removes the last character. A line longer than
+// MAX_LINE - 1 is dropped whole: the rest is discarded up to its end,
+// which is reported once as TOO_LONG.
+class LineReader {
+public:
+  static const size_t MAX_LINE = 96;         // Buffer incl. NUL
+  static const size_t BYTES_PER_POLL = 32;   // Bytes taken per loop pass
+
+  enum Status : uint8_t {
+    PENDING,                       // No complete line yet
+    LINE,                          // line() holds one, until the next feed
+    TOO_LONG                       // Over-long line ended and was dropped
+  };
+
+  Status feed(char c);
+  void reset();
+
+  char* line() { return buffer; }
+  size_t getLength() const { return length; }
+
+  // Diagnostics
+  uint32_t getLines() const { return lines; }
+  uint32_t getTooLong() const { return tooLong; }
+
+private:
+  char buffer[MAX_LINE];
+  size_t length = 0;
+  bool complete = false;           // buffer holds a returned line
+  bool discarding = false;         // Inside an over-long line
+
+  uint32_t lines = 0;
+  uint32_t tooLong = 0;
+};
+
+#endif // LINE_READER_H
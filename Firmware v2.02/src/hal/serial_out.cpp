@@ -0,0 +1,200 @@
+#include "serial_out.h"
+#include <stdio.h>
+
+#if SERIAL_OUT_LOCKED
+#include <freertos/FreeRTOS.h>
+
+// Writers on both cores; held for a copy, never across a UART call
+static portMUX_TYPE outMux = portMUX_INITIALIZER_UNLOCKED;
+#define OUT_LOCK()   portENTER_CRITICAL(&outMux)
+#define OUT_UNLOCK() portEXIT_CRITICAL(&outMux)
+#else
+#define OUT_LOCK()
+#define OUT_UNLOCK()
+#endif
+
+static_assert((SerialOut::RING_SIZE & (SerialOut::RING_SIZE - 1)) == 0, "Ring size must be a power of two");
+
+static const uint32_t RING_MASK = SerialOut::RING_SIZE - 1;
+
+SerialOut Console;
+
+// ========================================
+// SERIAL OUT IMPLEMENTATION
+// ========================================
+
+SerialOut::SerialOut() {
+  memset(buffer, 0, sizeof(buffer));
+}
+
+size_t SerialOut::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t SerialOut::write(const uint8_t* data, size_t length) {
+  if (length == 0) {
+    return 0;
+  }
+
+  OUT_LOCK();
+  if (!makeRoom(length)) {
+    droppedBytes += length;
+    if (!gapPending) {
+      gapPending = true;
+      gapAt = head;
+    }
+    OUT_UNLOCK();
+    return 0;
+  }
+
+  size_t offset = head & RING_MASK;
+  size_t first = RING_SIZE - offset;
+  if (first >= length) {
+    memcpy(buffer + offset, data, length);
+  } else {
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, data + first, length - first);
+  }
+  head += length;
+  written += length;
+  if (head - tail > highWater) highWater = head - tail;
+  OUT_UNLOCK();
+
+  pump();
+  return length;
+}
+
+// Called locked. False: the write has to be dropped.
+bool SerialOut::makeRoom(size_t length) {
+  size_t free = RING_SIZE - (head - tail);
+  if (free >= length) {
+    return true;
+  }
+  if (dropPolicy == DROP_NEWEST || length > RING_SIZE) {
+    return false;
+  }
+
+  // Drop the oldest bytes, then the rest of that line, so the stream
+  // resumes at a line start (looks at most PUMP_CHUNK bytes ahead)
+  uint32_t newTail = tail + (length - free);
+  uint32_t scan = newTail;
+  for (size_t scanned = 0; scan != head && scanned < PUMP_CHUNK; scanned++) {
+    if (buffer[scan++ & RING_MASK] == '\n') {
+      newTail = scan;
+      break;
+    }
+  }
+  droppedBytes += newTail - tail;
+  tail = newTail;
+  gapPending = true;
+  gapAt = tail;
+  return true;
+}
+
+void SerialOut::pump() {
+  OUT_LOCK();
+  if (pumping || held) {
+    OUT_UNLOCK();
+    return;
+  }
+  pumping = true;
+  OUT_UNLOCK();
+
+  uint8_t chunk[PUMP_CHUNK];
+  int room = Serial.availableForWrite();
+  while (room > 0) {
+    size_t n = take(chunk, ((size_t)room < PUMP_CHUNK) ? (size_t)room : PUMP_CHUNK);
+    if (n == 0) {
+      break;
+    }
+    Serial.write(chunk, n);
+    atLineStart = (chunk[n - 1] == '\n');
+    room -= (int)n;
+  }
+  pumping = false;
+}
+
+// Next piece for the UART: ring bytes up to the gap, then the drop marker
+size_t SerialOut::take(uint8_t* out, size_t room) {
+  char marker[48];
+  int markerLength = 0;
+  uint32_t dropped = droppedBytes;
+  if (gapPending) {
+    markerLength = snprintf(marker, sizeof(marker), "%s[SerialOut] %lu bytes dropped\r\n",
+                            atLineStart ? "" : "\r\n", (unsigned long)(dropped - droppedReported));
+  }
+
+  OUT_LOCK();
+  if (gapPending && gapAt == tail) {
+    if (markerLength == 0 || (size_t)markerLength > room) {
+      OUT_UNLOCK();
+      return 0;  // Next pump
+    }
+    memcpy(out, marker, markerLength);
+    gapPending = false;
+    droppedReported = dropped;
+    OUT_UNLOCK();
+    return markerLength;
+  }
+
+  size_t available = gapPending ? gapAt - tail : head - tail;
+  size_t n = (available < room) ? available : room;
+  size_t offset = tail & RING_MASK;
+  size_t first = RING_SIZE - offset;
+  if (first >= n) {
+    memcpy(out, buffer + offset, n);
+  } else {
+    memcpy(out, buffer + offset, first);
+    memcpy(out + first, buffer, n - first);
+  }
+  tail += n;
+  OUT_UNLOCK();
+  return n;
+}
+
+void SerialOut::flush() {
+  if (held) {
+    return;
+  }
+  unsigned long start = millis();
+  while (getUsed() > 0 || gapPending) {
+    pump();
+    if (millis() - start >= FLUSH_TIMEOUT_MS) {
+      break;
+    }
+    delay(1);
+  }
+  Serial.flush();
+}
+
+void SerialOut::setHeld(bool hold) {
+  OUT_LOCK();
+  held = hold;
+  OUT_UNLOCK();
+  // A pump that started before (log drain task) finishes its FIFO write
+  while (hold && pumping) {
+    delay(1);
+  }
+  if (!hold) {
+    pump();
+  }
+}
+
+void SerialOut::setDropPolicy(DropPolicy policy) {
+  OUT_LOCK();
+  dropPolicy = policy;
+  OUT_UNLOCK();
+}
+
+const char* SerialOut::policyName(DropPolicy policy) {
+  return (policy == DROP_NEWEST) ? "drop-newest" : "drop-oldest";
+}
+
+void SerialOut::resetStats() {
+  OUT_LOCK();
+  highWater = head - tail;
+  written = 0;
+  droppedBytes = 0;
+  droppedReported = 0;
+  OUT_UNLOCK();
+}
@@ -0,0 +1,90 @@
+#ifndef SERIAL_OUT_H
+#define SERIAL_OUT_H
+
+#include <Arduino.h>
+
+#ifndef SERIAL_OUT_LOCKED
+#define SERIAL_OUT_LOCKED 1   // 0 for single-threaded host builds (no FreeRTOS)
+#endif
+
+// ========================================
+// NON-BLOCKING SERIAL OUTPUT
+// ========================================
+// All diagnostic output goes through Console instead of Serial. Prints land
+// in a RAM ring and return; pump() moves to the UART only what its TX FIFO
+// can take without waiting, so a slow or unplugged terminal costs dropped
+// bytes, never a stalled loop. Writes pump opportunistically; loop() and
+// the log drain task pump the rest.
+//
+// When the ring is full the policy decides what goes:
+//   DROP_OLDEST - oldest bytes, up to the next line end (latest output kept)
+//   DROP_NEWEST - the write that does not fit (earliest output kept)
+// Either way the stream gets one "[SerialOut] N bytes dropped" line where
+// the gap is. Input (Serial.read etc.) is unaffected.
+//
+// While held (the port carries BULK binary frames, see bulk_transfer.h)
+// nothing is sent: prints keep landing in the ring, subject to the same
+// policy, and go out once released.
+class SerialOut : public Print {
+public:
+  static const size_t RING_SIZE = 4096;        // Power of two
+  static const size_t PUMP_CHUNK = 128;        // UART hardware FIFO
+  static const uint32_t FLUSH_TIMEOUT_MS = 500;
+
+  enum DropPolicy : uint8_t {
+    DROP_OLDEST,
+    DROP_NEWEST
+  };
+
+  SerialOut();
+
+  // Print interface - never blocks
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t length) override;
+  using Print::write;
+
+  // Send what the UART can take now
+  void pump();
+
+  // Wait until the ring is empty (before a reset; bounded by FLUSH_TIMEOUT_MS)
+  void flush();
+
+  // Stop/resume sending; setHeld(true) returns once no pump is running
+  void setHeld(bool hold);
+  bool isHeld() const { return held; }
+
+  void setDropPolicy(DropPolicy policy);
+  DropPolicy getDropPolicy() const { return dropPolicy; }
+  static const char* policyName(DropPolicy policy);
+
+  // Diagnostics
+  size_t getUsed() const { return head - tail; }
+  size_t getHighWater() const { return highWater; }
+  uint32_t getWritten() const { return written; }
+  uint32_t getDroppedBytes() const { return droppedBytes; }
+  void resetStats();
+
+private:
+  size_t take(uint8_t* out, size_t room);
+  bool makeRoom(size_t length);
+
+  uint8_t buffer[RING_SIZE];
+  volatile uint32_t head = 0;         // Free-running write index
+  volatile uint32_t tail = 0;         // Free-running read index
+  volatile bool pumping = false;      // One pump at a time keeps bytes in order
+  volatile bool held = false;         // Port lent to the bulk link
+  DropPolicy dropPolicy = DROP_OLDEST;
+
+  bool atLineStart = true;            // Last byte pumped was '\n' (pump only)
+  bool gapPending = false;            // Drop marker not sent yet
+  uint32_t gapAt = 0;                 // Ring index the marker goes before
+  uint32_t droppedReported = 0;
+
+  size_t highWater = 0;
+  uint32_t written = 0;
+  uint32_t droppedBytes = 0;
+};
+
+extern SerialOut Console;
+
+#endif // SERIAL_OUT_H
@@ -0,0 +1,162 @@
+#ifndef BIG_DIGITS_H
+#define BIG_DIGITS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ========================================
+// PRE-RENDERED LARGE DIGITS
+// ========================================
+// The count is the largest thing on the screen. Drawing it as scaled GFX
+// text costs a fillRect per source pixel plus a text-bounds pass for
+// centering, every time it changes. Instead, the digits are rendered at
+// compile time straight into SSD1306 page format (one byte = 8 vertical
+// pixels, LSB on top), so drawing a digit is a copy of 3 pages x 15
+// columns into the frame buffer.
+//
+// The band is pages FIRST_PAGE..FIRST_PAGE+PAGES-1; glyphs sit Y_OFFSET
+// rows below its top. No Arduino dependencies - also built on the host.
+namespace BigDigits {
+
+static const int FONT_WIDTH = 5;         // Classic 5x7 GFX font
+static const int FONT_HEIGHT = 7;
+static const int SCALE = 3;
+static const int GAP = SCALE;            // Space between digits
+static const int CELL_WIDTH = FONT_WIDTH * SCALE;
+static const int PAGES = 3;
+static const int FIRST_PAGE = 2;         // Rows 16..39
+static const int Y_OFFSET = 2;           // Glyph rows 18..38
+static const int BUFFER_WIDTH = 128;
+static const int MAX_DIGITS = 10;
+
+static_assert(Y_OFFSET + FONT_HEIGHT * SCALE <= PAGES * 8, "Glyphs must fit the page band");
+
+// Column bytes of '0'..'9', bit 0 = top row (same data as glcdfont.c)
+constexpr uint8_t FONT_5X7[10][FONT_WIDTH] = {
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E },
+  { 0x00, 0x42, 0x7F, 0x40, 0x00 },
+  { 0x72, 0x49, 0x49, 0x49, 0x46 },
+  { 0x21, 0x41, 0x49, 0x4D, 0x33 },
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 },
+  { 0x27, 0x45, 0x45, 0x45, 0x39 },
+  { 0x3C, 0x4A, 0x49, 0x49, 0x31 },
+  { 0x41, 0x21, 0x11, 0x09, 0x07 },
+  { 0x36, 0x49, 0x49, 0x49, 0x36 },
+  { 0x46, 0x49, 0x49, 0x29, 0x1E },
+};
+
+// Pixel (x, y) of the scaled glyph, y relative to the top of the band
+constexpr uint8_t scaledPixel(int digit, int x, int y) {
+  return (y < Y_OFFSET || y >= Y_OFFSET + FONT_HEIGHT * SCALE) ? 0 :
+         (FONT_5X7[digit][x / SCALE] >> ((y - Y_OFFSET) / SCALE)) & 1;
+}
+
+// One SSD1306 byte: 8 vertical pixels of column `x` in band page `page`
+constexpr uint8_t pageByte(int digit, int page, int x, int bit = 0) {
+  return (bit == 8) ? 0 :
+         (uint8_t)((scaledPixel(digit, x, page * 8 + bit) << bit) |
+                   pageByte(digit, page, x, bit + 1));
+}
+
+// Horizontal ink extent in font columns ('1' is narrower than the rest)
+constexpr int firstInk(int digit, int col = 0) {
+  return (col == FONT_WIDTH || FONT_5X7[digit][col]) ? col : firstInk(digit, col + 1);
+}
+constexpr int lastInk(int digit, int col = FONT_WIDTH - 1) {
+  return (col < 0 || FONT_5X7[digit][col]) ? col : lastInk(digit, col - 1);
+}
+
+#define BIG_DIGIT_ROW(d, p) \
+  { pageByte(d, p, 0),  pageByte(d, p, 1),  pageByte(d, p, 2),  pageByte(d, p, 3),  \
+    pageByte(d, p, 4),  pageByte(d, p, 5),  pageByte(d, p, 6),  pageByte(d, p, 7),  \
+    pageByte(d, p, 8),  pageByte(d, p, 9),  pageByte(d, p, 10), pageByte(d, p, 11), \
+    pageByte(d, p, 12), pageByte(d, p, 13), pageByte(d, p, 14) }
+#define BIG_DIGIT(d) { BIG_DIGIT_ROW(d, 0), BIG_DIGIT_ROW(d, 1), BIG_DIGIT_ROW(d, 2) }
+
+static_assert(CELL_WIDTH == 15 && PAGES == 3, "Update BIG_DIGIT_ROW/BIG_DIGIT for the new cell size");
+
+constexpr uint8_t GLYPHS[10][PAGES][CELL_WIDTH] = {
+  BIG_DIGIT(0), BIG_DIGIT(1), BIG_DIGIT(2), BIG_DIGIT(3), BIG_DIGIT(4),
+  BIG_DIGIT(5), BIG_DIGIT(6), BIG_DIGIT(7), BIG_DIGIT(8), BIG_DIGIT(9),
+};
+
+#undef BIG_DIGIT
+#undef BIG_DIGIT_ROW
+
+// First inked column and inked width of each glyph, in pixels
+constexpr uint8_t INK_LEFT[10] = {
+  firstInk(0) * SCALE, firstInk(1) * SCALE, firstInk(2) * SCALE, firstInk(3) * SCALE,
+  firstInk(4) * SCALE, firstInk(5) * SCALE, firstInk(6) * SCALE, firstInk(7) * SCALE,
+  firstInk(8) * SCALE, firstInk(9) * SCALE,
+};
+constexpr uint8_t WIDTHS[10] = {
+  (lastInk(0) - firstInk(0) + 1) * SCALE, (lastInk(1) - firstInk(1) + 1) * SCALE,
+  (lastInk(2) - firstInk(2) + 1) * SCALE, (lastInk(3) - firstInk(3) + 1) * SCALE,
+  (lastInk(4) - firstInk(4) + 1) * SCALE, (lastInk(5) - firstInk(5) + 1) * SCALE,
+  (lastInk(6) - firstInk(6) + 1) * SCALE, (lastInk(7) - firstInk(7) + 1) * SCALE,
+  (lastInk(8) - firstInk(8) + 1) * SCALE, (lastInk(9) - firstInk(9) + 1) * SCALE,
+};
+
+static_assert(WIDTHS[1] < WIDTHS[0], "'1' should be narrower than '0'");
+
+// Positions of the digits of one value, centered on the buffer width
+struct Layout {
+  uint8_t count;                 // Number of digits
+  uint8_t digits[MAX_DIGITS];
+  int16_t x[MAX_DIGITS];         // Left edge of each digit's ink
+  int16_t left;                  // Extent of the whole number
+  int16_t right;                 // Exclusive
+};
+
+// Lay out `value`; O(1) per digit thanks to the width table
+inline void layout(unsigned long value, Layout& out) {
+  uint8_t reversed[MAX_DIGITS];
+  uint8_t n = 0;
+  do {
+    reversed[n++] = value % 10;
+    value /= 10;
+  } while (value > 0 && n < MAX_DIGITS);
+
+  int total = GAP * (n - 1);
+  for (uint8_t i = 0; i < n; i++) {
+    out.digits[i] = reversed[n - 1 - i];
+    total += WIDTHS[out.digits[i]];
+  }
+
+  out.count = n;
+  out.left = (BUFFER_WIDTH - total) / 2;
+  out.right = out.left + total;
+
+  int x = out.left;
+  for (uint8_t i = 0; i < n; i++) {
+    out.x[i] = x;
+    x += WIDTHS[out.digits[i]] + GAP;
+  }
+}
+
+// Erase columns [x0, x1) of the band
+inline void clearColumns(uint8_t* buffer, int x0, int x1) {
+  if (x0 < 0) x0 = 0;
+  if (x1 > BUFFER_WIDTH) x1 = BUFFER_WIDTH;
+  if (x1 <= x0) return;
+  for (int page = 0; page < PAGES; page++) {
+    memset(buffer + (FIRST_PAGE + page) * BUFFER_WIDTH + x0, 0, x1 - x0);
+  }
+}
+
+// Copy a digit's ink columns into the band at x (clipped to the buffer)
+inline void blit(uint8_t* buffer, int x, uint8_t digit) {
+  int from = INK_LEFT[digit];
+  int width = WIDTHS[digit];
+  if (x < 0) { from -= x; width += x; x = 0; }
+  if (x + width > BUFFER_WIDTH) width = BUFFER_WIDTH - x;
+  if (width <= 0) return;
+  for (int page = 0; page < PAGES; page++) {
+    memcpy(buffer + (FIRST_PAGE + page) * BUFFER_WIDTH + x, GLYPHS[digit][page] + from, width);
+  }
+}
+
+}  // namespace BigDigits
+
+#endif // BIG_DIGITS_H
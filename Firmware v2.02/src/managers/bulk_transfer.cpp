@@ -0,0 +1,278 @@
+#include "bulk_transfer.h"
+#include "read_cache.h"
+#include "serial_out.h"
+
+// ========================================
+// BULK TRANSFER IMPLEMENTATION
+// ========================================
+
+BulkTransfer& BulkTransfer::getInstance() {
+  static BulkTransfer instance;
+  return instance;
+}
+
+bool BulkTransfer::isSupportedBaud(uint32_t rate) {
+  return rate == 115200 || rate == 230400 || rate == 460800 || rate == 921600;
+}
+
+bool BulkTransfer::begin(uint32_t rate, uint32_t nowMs) {
+  if (!StorageManager::getInstance().isAvailable()) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+
+  Console.print(">> BULK mode at ");
+  Console.print(rate);
+  Console.println(" baud - frames only until BYE or 30 s idle");
+  Console.flush();
+  Console.setHeld(true);
+  Serial.flush();
+  if (rate != TEXT_BAUD) {
+    Serial.updateBaudRate(rate);
+  }
+
+  decoder.reset();
+  window.stop();
+  txLength = 0;
+  txSent = 0;
+  replyPending = false;
+  closing = false;
+  baud = rate;
+  lastRxMs = nowMs;
+  active = true;
+  sessions++;
+  return true;
+}
+
+void BulkTransfer::end(const char* reason) {
+  Serial.flush();
+  if (baud != TEXT_BAUD) {
+    Serial.updateBaudRate(TEXT_BAUD);
+  }
+  window.stop();
+  active = false;
+  Console.setHeld(false);
+  LOG_INFO(STORAGE, "BULK mode ended (%s): %lu bytes acknowledged", reason,
+           (unsigned long)dataBytes);
+}
+
+void BulkTransfer::poll(uint32_t nowMs) {
+  if (!active) {
+    return;
+  }
+
+  for (size_t i = 0; i < RX_PER_POLL && Serial.available() > 0; i++) {
+    if (decoder.feed((uint8_t)Serial.read())) {
+      lastRxMs = nowMs;
+      handleFrame(decoder.frame(), nowMs);
+    }
+  }
+
+  if (!window.poll(nowMs)) {
+    abandoned++;                   // Host gone quiet; it resumes with a new GET
+  }
+
+  // Keep the FIFO fed while there is something to send
+  uint32_t start = micros();
+  do {
+    if (txSent == txLength && !loadNextFrame()) {
+      break;
+    }
+    int room = Serial.availableForWrite();
+    if (room > 0) {
+      size_t n = txLength - txSent;
+      if ((size_t)room < n) {
+        n = room;
+      }
+      Serial.write(tx + txSent, n);
+      txSent += n;
+    }
+  } while (micros() - start < TX_BUDGET_US);
+
+  if (closing && txSent == txLength) {
+    end("BYE");
+  } else if (!window.isActive() && nowMs - lastRxMs > IDLE_TIMEOUT_MS) {
+    end("idle");
+  }
+}
+
+// Next frame into tx: a pending reply first, then window data
+bool BulkTransfer::loadNextFrame() {
+  if (replyPending) {
+    txLength = BulkLink::encode(reply, tx);
+    txSent = 0;
+    replyPending = false;
+    return true;
+  }
+
+  uint32_t offset;
+  size_t length;
+  bool last;
+  if (!window.next(offset, length, last)) {
+    return false;
+  }
+
+  BulkLink::Frame frame;
+  frame.type = last ? BulkLink::DATA_LAST : BulkLink::DATA;
+  frame.seq = getSeq;
+  frame.length = BulkLink::DATA_HEADER + length;
+  BulkLink::put32(frame.payload, offset);
+  if (length > 0 && ReadCache::getInstance().read(file.source, file.offset + offset,
+                                                  frame.payload + BulkLink::DATA_HEADER,
+                                                  length) != length) {
+    window.stop();
+    replyError(getSeq, BulkLink::ERR_STORAGE, "read failed");
+    return loadNextFrame();
+  }
+  txLength = BulkLink::encode(frame, tx);
+  txSent = 0;
+  return true;
+}
+
+void BulkTransfer::handleFrame(const BulkLink::Frame& frame, uint32_t nowMs) {
+  switch (frame.type) {
+    case BulkLink::LIST:
+      replyList(frame);
+      break;
+    case BulkLink::STAT:
+      replyStat(frame);
+      break;
+    case BulkLink::GET:
+      startGet(frame, nowMs);
+      break;
+    case BulkLink::ACK:
+      onAck(frame, nowMs);
+      break;
+    case BulkLink::BYE:
+      window.stop();
+      queueReply(BulkLink::BYE_REPLY, frame.seq, 0);
+      closing = true;
+      break;
+    default:
+      replyError(frame.seq, BulkLink::ERR_BAD_REQUEST, "unknown request");
+      break;
+  }
+}
+
+void BulkTransfer::queueReply(uint8_t type, uint16_t seq, size_t length) {
+  reply.type = type;
+  reply.seq = seq;
+  reply.length = length;
+  replyPending = true;             // Replaces an unsent reply: the host retries
+}
+
+void BulkTransfer::replyError(uint16_t seq, uint8_t code, const char* text) {
+  size_t length = strlen(text);
+  if (length > BulkLink::MAX_PAYLOAD - 1) {
+    length = BulkLink::MAX_PAYLOAD - 1;
+  }
+  reply.payload[0] = code;
+  memcpy(reply.payload + 1, text, length);
+  queueReply(BulkLink::ERROR_REPLY, seq, 1 + length);
+}
+
+// Name field from `at` to the end of the payload (not NUL terminated)
+bool BulkTransfer::readName(const BulkLink::Frame& request, size_t at, char* name, size_t size) {
+  if (request.length <= at || request.length - at >= size) {
+    return false;
+  }
+  size_t length = request.length - at;
+  memcpy(name, request.payload + at, length);
+  name[length] = '\0';
+  return true;
+}
+
+struct ListContext {
+  uint8_t* out;
+  uint16_t start;
+  uint16_t index;
+  size_t used;
+  uint8_t count;
+  bool full;
+};
+
+static void addListEntry(const char* name, uint32_t length, bool archived, void* context) {
+  ListContext* list = static_cast<ListContext*>(context);
+  if (list->index++ < list->start || list->full) {
+    return;
+  }
+  size_t nameLength = strlen(name);
+  if (list->used + 5 + nameLength > BulkLink::MAX_PAYLOAD || list->count == 255) {
+    list->full = true;             // Host asks again from start + count
+    return;
+  }
+  BulkLink::put32(list->out + list->used, length);
+  list->out[list->used + 4] = (uint8_t)nameLength;
+  memcpy(list->out + list->used + 5, name, nameLength);
+  list->used += 5 + nameLength;
+  list->count++;
+}
+
+void BulkTransfer::replyList(const BulkLink::Frame& request) {
+  uint16_t start = (request.length >= 2) ? BulkLink::get16(request.payload) : 0;
+  ListContext list = { reply.payload, start, 0, 5, 0, false };
+  int total = StorageManager::getInstance().forEachFile(addListEntry, &list);
+
+  BulkLink::put16(reply.payload, (uint16_t)total);
+  BulkLink::put16(reply.payload + 2, start);
+  reply.payload[4] = list.count;
+  queueReply(BulkLink::LIST_REPLY, request.seq, list.used);
+}
+
+void BulkTransfer::replyStat(const BulkLink::Frame& request) {
+  char name[sizeof(file.path)];
+  if (!readName(request, 0, name, sizeof(name))) {
+    replyError(request.seq, BulkLink::ERR_BAD_REQUEST, "bad name");
+    return;
+  }
+  StorageManager::FileLocation found;
+  if (!StorageManager::getInstance().locateFile(name, found)) {
+    replyError(request.seq, BulkLink::ERR_NOT_FOUND, "not found");
+    return;
+  }
+  BulkLink::put32(reply.payload, found.length);
+  reply.payload[4] = found.archived;
+  BulkLink::put32(reply.payload + 5, found.crc);
+  queueReply(BulkLink::STAT_REPLY, request.seq, 9);
+}
+
+void BulkTransfer::startGet(const BulkLink::Frame& request, uint32_t nowMs) {
+  char name[sizeof(file.path)];
+  if (request.length < 8 || !readName(request, 8, name, sizeof(name))) {
+    replyError(request.seq, BulkLink::ERR_BAD_REQUEST, "bad GET");
+    return;
+  }
+  // A new GET replaces the one in progress (the host resuming)
+  window.stop();
+  if (!StorageManager::getInstance().locateFile(name, file)) {
+    replyError(request.seq, BulkLink::ERR_NOT_FOUND, "not found");
+    return;
+  }
+  uint32_t offset = BulkLink::get32(request.payload);
+  uint32_t length = BulkLink::get32(request.payload + 4);
+  if (offset > file.length) {
+    replyError(request.seq, BulkLink::ERR_BAD_REQUEST, "offset past end");
+    return;
+  }
+  uint32_t endOffset = (length < file.length - offset) ? offset + length : file.length;
+
+  getSeq = request.seq;
+  getBegin = offset;
+  getStartMs = nowMs;
+  window.start(offset, endOffset, nowMs);
+}
+
+void BulkTransfer::onAck(const BulkLink::Frame& request, uint32_t nowMs) {
+  if (request.seq != getSeq || request.length < 5 || !window.isActive()) {
+    return;                        // Stale ACK of an earlier GET
+  }
+  uint32_t before = window.getAcked();
+  window.ack(BulkLink::get32(request.payload), request.payload[4] != 0, nowMs);
+  dataBytes += window.getAcked() - before;
+
+  if (!window.isActive()) {
+    completed++;
+    uint32_t elapsed = nowMs - getStartMs;
+    lastRate = (uint32_t)((uint64_t)(window.getAcked() - getBegin) * 1000 / (elapsed ? elapsed : 1));
+  }
+}
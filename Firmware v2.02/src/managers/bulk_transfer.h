@@ -0,0 +1,98 @@
+#ifndef BULK_TRANSFER_H
+#define BULK_TRANSFER_H
+
+#include <Arduino.h>
+#include "bulk_link.h"
+#include "managers.h"
+
+// ========================================
+// BULK FILE DOWNLOAD
+// ========================================
+// BULK[,baud] lends the serial port to the framed protocol in bulk_link.h
+// so logs come off the device at close to wire speed instead of as READ's
+// numbered text lines. The host side is tests/host/bulk_client.
+//
+//   1. BULK prints its confirmation and flushes Console, then holds it:
+//      diagnostic output stays in the ring until bulk mode ends.
+//   2. The UART switches to the requested baud (default 921600).
+//   3. loop() calls poll() instead of reading text commands. Each pass
+//      takes the requests and ACKs that have arrived, then keeps the UART
+//      FIFO fed for up to TX_BUDGET_US. Counting is interrupt driven and
+//      the rest of the loop runs between passes.
+//   4. BYE, or IDLE_TIMEOUT_MS without a valid frame, goes back to text
+//      at TEXT_BAUD.
+//
+// File text is read through ReadCache, archived sessions included (see
+// StorageManager::locateFile), so GET offsets are offsets into the text as
+// READ shows it.
+class BulkTransfer {
+public:
+  static const uint32_t TEXT_BAUD = 115200;
+  static const uint32_t DEFAULT_BAUD = 921600;
+  static const uint32_t IDLE_TIMEOUT_MS = 30000;
+  static const uint32_t TX_BUDGET_US = 1500;       // ~1.3 FIFOs at 921600 baud
+  static const size_t RX_PER_POLL = 256;
+
+  static BulkTransfer& getInstance();
+  static bool isSupportedBaud(uint32_t baud);
+
+  // From the BULK command; false if storage is unavailable
+  bool begin(uint32_t baud, uint32_t nowMs);
+  bool isActive() const { return active; }
+
+  // Every loop pass while active
+  void poll(uint32_t nowMs);
+
+  // Statistics (STATUS)
+  uint32_t getSessions() const { return sessions; }
+  uint32_t getCompleted() const { return completed; }
+  uint32_t getDataBytes() const { return dataBytes; }   // Acknowledged file bytes
+  uint32_t getResends() const { return window.getResends(); }
+  uint32_t getAbandoned() const { return abandoned; }
+  uint32_t getFrameErrors() const { return decoder.getErrors(); }
+  uint32_t getLastRate() const { return lastRate; }   // Bytes/s of the last finished GET
+
+private:
+  BulkTransfer() {}
+
+  void end(const char* reason);
+  void handleFrame(const BulkLink::Frame& frame, uint32_t nowMs);
+  void replyList(const BulkLink::Frame& request);
+  void replyStat(const BulkLink::Frame& request);
+  void startGet(const BulkLink::Frame& request, uint32_t nowMs);
+  void onAck(const BulkLink::Frame& request, uint32_t nowMs);
+  void replyError(uint16_t seq, uint8_t code, const char* text);
+  void queueReply(uint8_t type, uint16_t seq, size_t length);
+  bool loadNextFrame();
+  static bool readName(const BulkLink::Frame& request, size_t at, char* name, size_t size);
+
+  BulkLink::Decoder decoder;
+  BulkWindow window;
+
+  // Encoded frame going out; a reply waits here until the frame before it
+  // has gone (replies go ahead of data)
+  uint8_t tx[BulkLink::MAX_ENCODED];
+  size_t txLength = 0;
+  size_t txSent = 0;
+  BulkLink::Frame reply;
+  bool replyPending = false;
+
+  // Current GET
+  StorageManager::FileLocation file;
+  uint16_t getSeq = 0;
+  uint32_t getStartMs = 0;
+  uint32_t getBegin = 0;
+
+  bool active = false;
+  bool closing = false;            // BYE_REPLY queued: end once it is out
+  uint32_t baud = TEXT_BAUD;
+  uint32_t lastRxMs = 0;
+
+  uint32_t sessions = 0;
+  uint32_t completed = 0;
+  uint32_t dataBytes = 0;
+  uint32_t abandoned = 0;
+  uint32_t lastRate = 0;
+};
+
+#endif // BULK_TRANSFER_H
@@ -0,0 +1,127 @@
+#include "checkpoint_ring.h"
+#include "checksum.h"
+#include "hal.h"
+#include "managers.h"
+#include <cstddef>
+#include <cstring>
+
+// ========================================
+// CHECKPOINT RING IMPLEMENTATION
+// ========================================
+
+CheckpointRing& CheckpointRing::getInstance() {
+  static CheckpointRing instance;
+  return instance;
+}
+
+void CheckpointRing::seal(CheckpointRecord& rec) {
+  memset(rec.reserved, 0, sizeof(rec.reserved));
+  rec.crc = crc32(&rec, offsetof(CheckpointRecord, crc));
+}
+
+bool CheckpointRing::isValid(const CheckpointRecord& rec) {
+  // Erased slots read back as 0xFF..., never-written sequence is 0
+  if (rec.sequence == 0 || rec.sequence == 0xFFFFFFFFu) return false;
+  return rec.crc == crc32(&rec, offsetof(CheckpointRecord, crc));
+}
+
+bool CheckpointRing::begin() {
+  static_assert(RING_ADDRESS + RING_SLOTS * sizeof(CheckpointRecord) <= EEPROM_SIZE,
+                "Checkpoint ring exceeds EEPROM region");
+  static_assert(EEPROM_HAL::SECTOR_SIZE % sizeof(CheckpointRecord) == 0,
+                "Checkpoint records must not straddle sectors");
+
+  if (EEPROM_HAL::getSize() < EEPROM_SIZE && !EEPROM_HAL::init(EEPROM_SIZE)) {
+    LOG_ERROR(STORAGE, "Checkpoint EEPROM unavailable");
+    ready = false;
+    return false;
+  }
+
+  newestSlot = -1;
+  uint32_t newestSequence = 0;
+  int validCount = 0;
+
+  for (size_t slot = 0; slot < RING_SLOTS; slot++) {
+    CheckpointRecord rec;
+    EEPROM_HAL::readBytes(slotAddress(slot), reinterpret_cast<uint8_t*>(&rec), sizeof(rec));
+    if (!isValid(rec)) continue;
+
+    validCount++;
+    if (newestSlot < 0 || (int32_t)(rec.sequence - newestSequence) > 0) {
+      newestSlot = slot;
+      newestSequence = rec.sequence;
+    }
+  }
+
+  nextSequence = (newestSlot >= 0) ? newestSequence + 1 : 1;
+  ready = true;
+
+  LOG_INFO(STORAGE, "Checkpoint ring: %d/%u valid slots | Next seq: %lu", validCount,
+           (unsigned)RING_SLOTS, nextSequence);
+  return true;
+}
+
+bool CheckpointRing::write(CheckpointRecord& record) {
+  if (!ready) {
+    failedWrites++;
+    return false;
+  }
+
+  size_t slot = (newestSlot < 0) ? 0 : (newestSlot + 1) % RING_SLOTS;
+
+  record.sequence = nextSequence;
+  seal(record);
+
+  EEPROM_HAL::writeBytes(slotAddress(slot), reinterpret_cast<const uint8_t*>(&record),
+                         sizeof(record));
+  if (!EEPROM_HAL::commit()) {
+    failedWrites++;
+    return false;
+  }
+
+  newestSlot = slot;
+  nextSequence++;
+  writeCount++;
+  return true;
+}
+
+bool CheckpointRing::latest(CheckpointRecord& out) const {
+  if (!ready || newestSlot < 0) {
+    return false;
+  }
+
+  EEPROM_HAL::readBytes(slotAddress(newestSlot), reinterpret_cast<uint8_t*>(&out), sizeof(out));
+  return isValid(out);
+}
+
+EnduranceReport CheckpointRing::projectEndurance(unsigned long checkpointIntervalMs) {
+  EnduranceReport report = {0, 0, 0, 0};
+  if (checkpointIntervalMs == 0) {
+    return report;
+  }
+
+  const uint32_t MS_PER_DAY = 86400000UL;
+  const uint32_t ringSectors =
+    (RING_SLOTS * sizeof(CheckpointRecord)) / EEPROM_HAL::SECTOR_SIZE;
+
+  report.checkpointsPerDay = MS_PER_DAY / checkpointIntervalMs;
+
+  // Logical wear: the ring spreads commits evenly over its sectors
+  report.sectorWritesPerDay = report.checkpointsPerDay / ringSectors;
+
+  // Physical wear: NVS is log-structured, so every sector write appends
+  // entries and a page is erased once per (pages - 1) pages of appends
+  uint64_t bytesPerDay = (uint64_t)report.checkpointsPerDay *
+                         NVS_ENTRIES_PER_SECTOR_WRITE * NVS_ENTRY_BYTES;
+  uint64_t bytesPerEraseCycle = (uint64_t)(NVS_PAGES - 1) * NVS_PAGE_BYTES;
+  report.flashErasesPerDayX1000 = (uint32_t)((bytesPerDay * 1000) / bytesPerEraseCycle);
+
+  if (report.flashErasesPerDayX1000 > 0) {
+    uint64_t lifeDays = ((uint64_t)FLASH_ERASE_CYCLES * 1000) / report.flashErasesPerDayX1000;
+    report.projectedLifeYears = (uint32_t)(lifeDays / 365);
+  } else {
+    report.projectedLifeYears = 0xFFFFFFFFu;  // Effectively unlimited
+  }
+
+  return report;
+}
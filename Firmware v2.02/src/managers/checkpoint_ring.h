@@ -0,0 +1,98 @@
+#ifndef CHECKPOINT_RING_H
+#define CHECKPOINT_RING_H
+
+#include <Arduino.h>
+
+// ========================================
+// COUNTER CHECKPOINT RECORD
+// ========================================
+// High-frequency snapshot of the counters. Written to a ring in the
+// EEPROM_HAL region so the SD card only needs periodic consolidated
+// writes of the full state block (see state_store.h).
+struct __attribute__((packed)) CheckpointRecord {
+  uint32_t sequence;               // Monotonic, 0 = never written
+  uint32_t baseStateSequence;      // StateStore sequence this delta builds on
+  int32_t currentCount;
+  int32_t countAtHourStart;
+  int32_t cumulativeCount;
+  int32_t productionStartCount;
+  uint32_t productionStartUnix;    // 0 when no session is active
+  uint8_t productionActive;
+  uint8_t lastHour;
+  uint8_t reserved[30];            // Pads the record to one EEPROM_HAL sector
+  uint32_t crc;                    // CRC32 of all preceding bytes
+};
+
+static_assert(sizeof(CheckpointRecord) == 64, "CheckpointRecord must fill one EEPROM_HAL sector");
+
+// ========================================
+// ENDURANCE PROJECTION
+// ========================================
+struct EnduranceReport {
+  uint32_t checkpointsPerDay;      // Ring commits per day at the configured rate
+  uint32_t sectorWritesPerDay;     // Per EEPROM_HAL sector (after ring spreading)
+  uint32_t flashErasesPerDayX1000; // Per physical NVS page, fixed point (1/1000)
+  uint32_t projectedLifeYears;     // Until the rated erase endurance is reached
+};
+
+// ========================================
+// CHECKPOINT RING
+// ========================================
+// Records are written round-robin through RING_SLOTS slots, one per
+// EEPROM_HAL sector, so every commit dirties exactly one sector and
+// consecutive commits walk across the whole region.
+//
+// EEPROM map (EEPROM_HAL, 1 KB):
+//   0x000 - 0x0FF   Configuration (ConfigManager)
+//   0x100 - 0x3FF   Checkpoint ring (this class)
+class CheckpointRing {
+public:
+  static const size_t RING_ADDRESS = 0x100;
+  static const size_t RING_SLOTS = 12;
+  static const size_t EEPROM_SIZE = 1024;
+
+  // Flash/NVS characteristics used for the endurance projection
+  static const uint32_t FLASH_ERASE_CYCLES = 100000;
+  static const uint32_t NVS_PAGES = 5;               // Default 20 KB "nvs" partition
+  static const uint32_t NVS_PAGE_BYTES = 4096;
+  static const uint32_t NVS_ENTRY_BYTES = 32;
+  static const uint32_t NVS_ENTRIES_PER_SECTOR_WRITE = 4;  // Blob header + index + 64 B data
+
+  static CheckpointRing& getInstance();
+
+  // Scan the ring and locate the newest valid record
+  bool begin();
+
+  // Append a checkpoint (one sector commit)
+  bool write(CheckpointRecord& record);
+
+  // Newest valid checkpoint, false if the ring is empty
+  bool latest(CheckpointRecord& out) const;
+
+  // Statistics
+  uint32_t getWriteCount() const { return writeCount; }
+  uint32_t getFailedWriteCount() const { return failedWrites; }
+  uint32_t getNextSequence() const { return nextSequence; }
+
+  // Wear projection for a given checkpoint interval
+  static EnduranceReport projectEndurance(unsigned long checkpointIntervalMs);
+
+  // Validation (public for tests)
+  static bool isValid(const CheckpointRecord& rec);
+  static void seal(CheckpointRecord& rec);
+
+private:
+  CheckpointRing() {}
+
+  static size_t slotAddress(size_t slot) {
+    return RING_ADDRESS + slot * sizeof(CheckpointRecord);
+  }
+
+  bool ready = false;
+  int newestSlot = -1;
+  uint32_t nextSequence = 1;
+  uint32_t writeCount = 0;
+  uint32_t failedWrites = 0;
+};
+
+#endif // CHECKPOINT_RING_H
@@ -0,0 +1,120 @@
+#include "config_blob.h"
+#include "checksum.h"
+#include <string.h>
+#include <stddef.h>
+
+// ========================================
+// CONFIG BLOB IMPLEMENTATION
+// ========================================
+
+ConfigBlob::Payload ConfigBlob::defaults() {
+  Payload values;
+  values.saveIntervalMs = 5000;
+  values.debounceDelayMs = 50;
+  values.maxCount = 9999;
+  values.statusDisplayMs = 3000;
+  values.displayRefreshMs = 100;
+  return values;
+}
+
+bool ConfigBlob::sanitize(Payload& values) {
+  Payload fallback = defaults();
+  bool inRange = true;
+  if (values.saveIntervalMs < 1000 || values.saveIntervalMs > 60000) {
+    values.saveIntervalMs = fallback.saveIntervalMs;
+    inRange = false;
+  }
+  if (values.debounceDelayMs < 10 || values.debounceDelayMs > 500) {
+    values.debounceDelayMs = fallback.debounceDelayMs;
+    inRange = false;
+  }
+  if (values.maxCount < 100 || values.maxCount > 99999) {
+    values.maxCount = fallback.maxCount;
+    inRange = false;
+  }
+  if (values.statusDisplayMs < 1000 || values.statusDisplayMs > 10000) {
+    values.statusDisplayMs = fallback.statusDisplayMs;
+    inRange = false;
+  }
+  if (values.displayRefreshMs < 20 || values.displayRefreshMs > 1000) {
+    values.displayRefreshMs = fallback.displayRefreshMs;
+    inRange = false;
+  }
+  return inRange;
+}
+
+static uint32_t blobCrc(const ConfigBlob::Header& header, const uint8_t* payload) {
+  uint32_t crc = crc32Begin();
+  crc = crc32Update(crc, reinterpret_cast<const uint8_t*>(&header) + offsetof(ConfigBlob::Header, version),
+                    offsetof(ConfigBlob::Header, crc) - offsetof(ConfigBlob::Header, version));
+  crc = crc32Update(crc, payload, header.size);
+  return crc32End(crc);
+}
+
+bool ConfigBlob::decode(const uint8_t* region, Payload& out, Info& info) {
+  memset(&info, 0, sizeof(info));
+  info.slot = -1;
+  info.blank = true;
+  for (size_t i = 0; i < REGION_SIZE; i++) {
+    if (region[i] != 0xFF) {
+      info.blank = false;
+      break;
+    }
+  }
+
+  for (size_t slot = 0; slot < SLOT_COUNT; slot++) {
+    const uint8_t* copy = region + slot * SLOT_SIZE;
+    Header header;
+    memcpy(&header, copy, sizeof(header));
+    if (header.magic != MAGIC || header.version == 0 || header.sequence == 0 ||
+        header.size > SLOT_SIZE - sizeof(Header) ||
+        header.crc != blobCrc(header, copy + sizeof(Header))) {
+      continue;
+    }
+
+    info.validCopies++;
+    if (info.slot >= 0 && (int32_t)(header.sequence - info.sequence) <= 0) {
+      continue;
+    }
+    info.slot = slot;
+    info.version = header.version;
+    info.size = header.size;
+    info.sequence = header.sequence;
+  }
+  if (info.slot < 0) {
+    return false;
+  }
+
+  // Fields the writer did not know keep their defaults
+  out = defaults();
+  size_t known = (info.size < sizeof(Payload)) ? info.size : sizeof(Payload);
+  memcpy(&out, region + info.slot * SLOT_SIZE + sizeof(Header), known);
+  info.clamped = !sanitize(out);
+  return true;
+}
+
+void ConfigBlob::encode(const Payload& values, uint32_t sequence, uint8_t* slot) {
+  memset(slot, 0xFF, SLOT_SIZE);
+  Header header;
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.size = sizeof(Payload);
+  header.sequence = sequence;
+  memcpy(slot + sizeof(Header), &values, sizeof(Payload));
+  header.crc = blobCrc(header, slot + sizeof(Header));
+  memcpy(slot, &header, sizeof(header));
+}
+
+bool ConfigBlob::parseLegacy(const uint8_t* bytes, size_t length, Payload& out, bool& clamped) {
+  if (length < LEGACY_SIZE || bytes[16] != LEGACY_MAGIC) {
+    return false;
+  }
+  // EEPROM.writeULong / writeInt: 4 bytes little endian at 0, 4, 8, 12
+  out = defaults();
+  memcpy(&out.saveIntervalMs, bytes + 0, 4);
+  memcpy(&out.debounceDelayMs, bytes + 4, 4);
+  memcpy(&out.maxCount, bytes + 8, 4);
+  memcpy(&out.statusDisplayMs, bytes + 12, 4);
+  clamped = !sanitize(out);
+  return true;
+}
@@ -0,0 +1,87 @@
+#ifndef CONFIG_BLOB_H
+#define CONFIG_BLOB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// CONFIGURATION BLOB
+// ========================================
+// ConfigManager settings as one packed, versioned, CRC-checked record in
+// the EEPROM_HAL configuration region (0x000 - 0x0FF, see
+// checkpoint_ring.h). The region holds two copies, A at 0x000 and B at
+// 0x080; a save goes to the older one, so a torn write leaves the
+// previous settings intact. Boot reads the whole region in one go and
+// takes the newest valid copy.
+//
+// Copy: [Header 16 B][Payload, header.size bytes] ... unused to SLOT_SIZE
+//   crc = CRC32 of version, size, sequence and the payload bytes
+//
+// Schema changes: fields are only ever appended to Payload (bump VERSION,
+// give the field a default in defaults()). An older blob then simply has
+// a shorter payload and the missing tail keeps its defaults; a newer one
+// is read up to the fields this firmware knows. Nothing is relocated.
+//
+// Legacy: code_v3 kept the settings in the Arduino EEPROM at fixed
+// offsets 0/4/8/12 with a 0xAB byte at 16. parseLegacy() imports them
+// once when the region holds no valid copy.
+class ConfigBlob {
+public:
+  static const size_t REGION_ADDRESS = 0x000;
+  static const size_t REGION_SIZE = 0x100;
+  static const size_t SLOT_COUNT = 2;
+  static const size_t SLOT_SIZE = REGION_SIZE / SLOT_COUNT;
+  static const uint32_t MAGIC = 0x47464E43;     // "CNFG"
+  static const uint16_t VERSION = 2;
+
+  static const size_t LEGACY_SIZE = 17;
+  static const uint8_t LEGACY_MAGIC = 0xAB;
+
+  struct __attribute__((packed)) Header {
+    uint32_t magic;
+    uint16_t version;              // Schema version of the writer
+    uint16_t size;                 // Payload bytes that follow
+    uint32_t sequence;             // Newer copy wins, 0 = never written
+    uint32_t crc;
+  };
+
+  // Append only.
+  struct __attribute__((packed)) Payload {
+    uint32_t saveIntervalMs;
+    uint32_t debounceDelayMs;
+    int32_t maxCount;
+    uint32_t statusDisplayMs;
+    uint32_t displayRefreshMs;     // Version 2
+  };
+
+  struct Info {
+    int8_t slot;                   // Copy loaded, -1 = none
+    uint8_t validCopies;
+    uint16_t version;
+    uint16_t size;
+    uint32_t sequence;
+    bool blank;                    // Region never written (all 0xFF)
+    bool clamped;                  // Out-of-range fields replaced by defaults
+  };
+
+  static Payload defaults();
+
+  // Newest valid copy in a REGION_SIZE image; false if there is none
+  static bool decode(const uint8_t* region, Payload& out, Info& info);
+
+  // Sealed copy for a SLOT_SIZE slot (unused bytes 0xFF)
+  static void encode(const Payload& values, uint32_t sequence, uint8_t* slot);
+
+  // code_v3 layout; false if the magic byte is missing
+  static bool parseLegacy(const uint8_t* bytes, size_t length, Payload& out, bool& clamped);
+
+  // Replace out-of-range fields with defaults; false if any was
+  static bool sanitize(Payload& values);
+
+  static size_t slotAddress(size_t slot) { return REGION_ADDRESS + slot * SLOT_SIZE; }
+};
+
+static_assert(sizeof(ConfigBlob::Header) + sizeof(ConfigBlob::Payload) <= ConfigBlob::SLOT_SIZE,
+              "Config payload outgrew its slot");
+
+#endif // CONFIG_BLOB_H
@@ -0,0 +1,209 @@
+#include "display_link.h"
+#include "hal.h"
+#include "managers.h"
+#include <cstring>
+
+#if DISPLAY_ASYNC
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Guards the pending frame and the buffer swap (both sides hold it for a
+// memcpy of at most one frame, never across an I2C transfer)
+static portMUX_TYPE linkMux = portMUX_INITIALIZER_UNLOCKED;
+#define LINK_LOCK()   portENTER_CRITICAL(&linkMux)
+#define LINK_UNLOCK() portEXIT_CRITICAL(&linkMux)
+#else
+#define LINK_LOCK()
+#define LINK_UNLOCK()
+#endif
+
+// ========================================
+// DISPLAY LINK IMPLEMENTATION
+// ========================================
+
+DisplayLink& DisplayLink::getInstance() {
+  static DisplayLink instance;
+  return instance;
+}
+
+DisplayLink::DisplayLink() {
+  memset(frames, 0, sizeof(frames));
+  memset(shadow, 0, sizeof(shadow));
+  pending = frames[0];
+  transmitting = frames[1];
+  for (uint8_t page = 0; page < PAGE_COUNT; page++) {
+    pendingStart[page] = WIDTH;
+    pendingEnd[page] = 0;
+  }
+}
+
+bool DisplayLink::begin(uint8_t panelAddress) {
+  address = panelAddress;
+
+#if DISPLAY_ASYNC
+  if (task != nullptr) {
+    return true;
+  }
+
+  TaskHandle_t handle = nullptr;
+  if (xTaskCreatePinnedToCore(taskEntry, "display", TASK_STACK, this, TASK_PRIORITY,
+                              &handle, TASK_CORE) != pdPASS) {
+    LOG_ERROR(DISPLAY, "Cannot start transmitter task - sending synchronously");
+    return false;
+  }
+  task = handle;
+#endif
+  return true;
+}
+
+void DisplayLink::taskEntry(void* parameter) {
+#if DISPLAY_ASYNC
+  DisplayLink* link = static_cast<DisplayLink*>(parameter);
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    link->transmit();
+  }
+#else
+  (void)parameter;
+#endif
+}
+
+void DisplayLink::submit(const uint8_t* frame, const uint8_t* dirtyStart,
+                         const uint8_t* dirtyEnd) {
+  bool queued = false;
+
+  LINK_LOCK();
+  bool superseded = pendingReady;
+  for (uint8_t page = 0; page < PAGE_COUNT; page++) {
+    uint8_t pageBit = 1 << page;
+    uint8_t first = dirtyStart[page];
+    uint8_t last = dirtyEnd[page];
+    if (fullPageMask & pageBit) {
+      first = 0;
+      last = WIDTH - 1;
+      pendingFullMask |= pageBit;
+    }
+    if (first > last) continue;
+
+    // A superseded frame's range widens to the union of both; the columns
+    // between them in `pending` are from two frames back, so copy the
+    // whole merged span (`frame` is the complete back buffer)
+    if (first < pendingStart[page]) pendingStart[page] = first;
+    if (last > pendingEnd[page]) pendingEnd[page] = last;
+    size_t offset = page * WIDTH + pendingStart[page];
+    memcpy(pending + offset, frame + offset, pendingEnd[page] - pendingStart[page] + 1);
+    queued = true;
+  }
+  fullPageMask = 0;
+  if (queued) {
+    pendingReady = true;
+    framesSubmitted++;
+    if (superseded) framesDropped++;
+  }
+  LINK_UNLOCK();
+
+  if (!queued) {
+    return;
+  }
+#if DISPLAY_ASYNC
+  if (task != nullptr) {
+    xTaskNotifyGive(static_cast<TaskHandle_t>(task));
+    return;
+  }
+#endif
+  transmit();
+}
+
+bool DisplayLink::takePending() {
+  LINK_LOCK();
+  if (!pendingReady) {
+    LINK_UNLOCK();
+    return false;
+  }
+
+  // Swap buffers: the pending frame goes on the wire, the old transmit
+  // buffer collects the next one
+  uint8_t* next = transmitting;
+  transmitting = pending;
+  pending = next;
+  for (uint8_t page = 0; page < PAGE_COUNT; page++) {
+    txStart[page] = pendingStart[page];
+    txEnd[page] = pendingEnd[page];
+    pendingStart[page] = WIDTH;
+    pendingEnd[page] = 0;
+  }
+  txFullMask = pendingFullMask;
+  pendingFullMask = 0;
+  busy = true;            // Before clearing pendingReady - see isIdle()
+  pendingReady = false;
+  LINK_UNLOCK();
+  return true;
+}
+
+void DisplayLink::transmit() {
+  while (takePending()) {
+    unsigned long startMicros = micros();
+    uint32_t busBefore = I2C::getBytesTransferred();
+    uint8_t failedPages = 0;
+
+    for (uint8_t page = 0; page < PAGE_COUNT; page++) {
+      uint8_t first = txStart[page];
+      uint8_t last = txEnd[page];
+      if (first > last) continue;
+
+      uint8_t pageBit = 1 << page;
+      const uint8_t* row = transmitting + page * WIDTH;
+      uint8_t* sent = shadow + page * WIDTH;
+
+      if (!(txFullMask & pageBit)) {
+        // Drop columns the panel already shows
+        while (first <= last && row[first] == sent[first]) first++;
+        if (first > last) continue;
+        while (row[last] == sent[last]) last--;
+      }
+
+      size_t length = last - first + 1;
+      if (!I2C::ssd1306WriteWindow(address, page, page, first, last, row + first, length)) {
+        failedPages |= pageBit;
+        continue;
+      }
+      memcpy(sent + first, row + first, length);
+      spanCount++;
+    }
+
+    bytesSent += I2C::getBytesTransferred() - busBefore;
+    lastFrameMicros = micros() - startMicros;
+
+    LINK_LOCK();
+    if (failedPages) {
+      fullPageMask |= failedPages;  // Partially written - resend whole pages
+      failedFrames++;
+    } else {
+      framesSent++;
+    }
+    busy = false;
+    LINK_UNLOCK();
+  }
+}
+
+void DisplayLink::invalidatePanel() {
+  LINK_LOCK();
+  fullPageMask = 0xFF;
+  LINK_UNLOCK();
+}
+
+bool DisplayLink::isIdle() const {
+  return !pendingReady && !busy;
+}
+
+void DisplayLink::resetStats() {
+  LINK_LOCK();
+  framesSubmitted = 0;
+  framesSent = 0;
+  framesDropped = 0;
+  failedFrames = 0;
+  spanCount = 0;
+  bytesSent = 0;
+  lastFrameMicros = 0;
+  LINK_UNLOCK();
+}
@@ -0,0 +1,98 @@
+#ifndef DISPLAY_LINK_H
+#define DISPLAY_LINK_H
+
+#include <Arduino.h>
+
+// Set to 0 to transmit frames from the caller (no FreeRTOS task)
+#ifndef DISPLAY_ASYNC
+#define DISPLAY_ASYNC 1
+#endif
+
+// ========================================
+// ASYNCHRONOUS SSD1306 FRAME LINK
+// ========================================
+// A full frame takes ~25 ms at 400 kHz; the main loop must not wait for
+// it. DisplayManager renders into the Adafruit buffer (back buffer) and
+// submit()s the dirty columns of each page. The link copies them into the
+// pending frame and wakes a transmitter task, which swaps the pending and
+// transmit buffers and sends the changed spans while the loop carries on.
+//
+// There is at most one pending frame. A frame submitted while the previous
+// one is still pending replaces it (counted as dropped) - its dirty ranges
+// are merged, so the panel still ends up showing the newest frame.
+//
+// Each I2C transaction is atomic in the Wire driver, so the RTC can be
+// read from the loop while a frame is in flight.
+class DisplayLink {
+public:
+  static const uint8_t WIDTH = 128;
+  static const uint8_t PAGE_COUNT = 8;
+  static const size_t FRAME_SIZE = WIDTH * PAGE_COUNT;
+  static const uint32_t TASK_STACK = 3072;
+  static const uint8_t TASK_PRIORITY = 1;
+  static const uint8_t TASK_CORE = 0;       // loop() runs on core 1
+
+  static DisplayLink& getInstance();
+
+  // Start the transmitter task (falls back to synchronous sends on failure)
+  bool begin(uint8_t address);
+
+  // Queue the dirty columns [start, end] of each page of `frame`.
+  // Never blocks; a still-pending frame is superseded.
+  void submit(const uint8_t* frame, const uint8_t* dirtyStart, const uint8_t* dirtyEnd);
+
+  // Panel contents unknown (reset, failed transfer) - the next submit()
+  // sends whole pages
+  void invalidatePanel();
+  bool needsFullPages() const { return fullPageMask != 0; }
+
+  bool isIdle() const;
+  bool isAsync() const { return task != nullptr; }
+
+  // Statistics
+  uint32_t getFramesSubmitted() const { return framesSubmitted; }
+  uint32_t getFramesSent() const { return framesSent; }
+  uint32_t getFramesDropped() const { return framesDropped; }
+  uint32_t getFailedFrames() const { return failedFrames; }
+  uint32_t getSpanCount() const { return spanCount; }
+  uint32_t getBytesSent() const { return bytesSent; }
+  unsigned long getLastFrameMicros() const { return lastFrameMicros; }
+  void resetStats();
+
+private:
+  DisplayLink();
+
+  static void taskEntry(void* parameter);
+  bool takePending();
+  void transmit();
+
+  uint8_t address = 0x3C;
+  void* task = nullptr;                      // TaskHandle_t
+
+  // Pending frame (written by submit) and frame in flight (transmitter)
+  uint8_t frames[2][FRAME_SIZE];
+  uint8_t* pending;
+  uint8_t* transmitting;
+  uint8_t pendingStart[PAGE_COUNT];
+  uint8_t pendingEnd[PAGE_COUNT];
+  uint8_t txStart[PAGE_COUNT];
+  uint8_t txEnd[PAGE_COUNT];
+  uint8_t pendingFullMask = 0;               // Pages copied whole (no trimming)
+  uint8_t txFullMask = 0;
+  volatile uint8_t fullPageMask = 0xFF;      // Pages to resend whole
+  volatile bool pendingReady = false;
+  volatile bool busy = false;
+
+  // What the panel shows, owned by the transmitter
+  uint8_t shadow[FRAME_SIZE];
+
+  volatile uint32_t framesSubmitted = 0;
+  volatile uint32_t framesSent = 0;
+  volatile uint32_t framesDropped = 0;
+  volatile uint32_t failedFrames = 0;
+  volatile uint32_t spanCount = 0;
+  volatile uint32_t bytesSent = 0;
+  volatile unsigned long lastFrameMicros = 0;
+};
+
+#endif // DISPLAY_LINK_H
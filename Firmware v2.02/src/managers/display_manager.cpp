@@ -0,0 +1,420 @@
+#include "managers.h"
+#include "big_digits.h"
+#include "display_link.h"
+#include "hal.h"
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <cstring>
+
+// OLED is started by initializeHardware(); DisplayManager draws into its buffer
+extern Adafruit_SSD1306 display;
+
+// ========================================
+// DISPLAY MANAGER IMPLEMENTATION
+// ========================================
+
+// Main screen regions (see managers.h)
+static const int STATUS_Y = 0;
+static const int COUNT_TOP = BigDigits::FIRST_PAGE * 8;
+static const int COUNT_HEIGHT = BigDigits::PAGES * 8;
+static const int RATE_Y = 48;
+static const int FOOTER_Y = 56;
+static const int CLOCK_WIDTH = 64;
+static const int STORAGE_X = 80;
+static const int STORAGE_WIDTH = 48;
+static const int GLYPH_WIDTH = 6;    // 5x7 font + spacing, at text size 1
+static const int GLYPH_HEIGHT = 8;
+
+DisplayManager::DisplayManager() {
+  displayDirty = true;
+  lastRefresh = 0;
+  refreshRate = 100;  // 100ms default
+  memset(lastStatus, 0, sizeof(lastStatus));
+  memset(&lastView, 0, sizeof(lastView));
+  markClean();
+}
+
+DisplayManager& DisplayManager::getInstance() {
+  static DisplayManager instance;
+  return instance;
+}
+
+bool DisplayManager::initialize() {
+  LOG_INFO(DISPLAY, "Initializing OLED display...");
+  
+  if (display.getBuffer() == nullptr) {
+    LOG_ERROR(DISPLAY, "Display not started");
+    return false;
+  }
+  
+  // Panel contents are unknown until every page has been sent once
+  DisplayLink& link = DisplayLink::getInstance();
+  link.begin(I2C_ADDRESS);
+  link.invalidatePanel();
+  ready = true;
+  beginFullScreen();
+  
+  LOG_INFO(DISPLAY, "OLED display initialized");
+  return true;
+}
+
+void DisplayManager::update() {
+  if (!needsRefresh()) {
+    return;
+  }
+  flush();
+}
+
+void DisplayManager::flush() {
+  if (!ready) {
+    return;
+  }
+  
+  // Hand the dirty columns to the transmitter; the loop does not wait
+  DisplayLink::getInstance().submit(display.getBuffer(), dirtyStart, dirtyEnd);
+  markClean();
+  lastRefresh = millis();
+  flushCount++;
+}
+
+void DisplayManager::clear() {
+  beginFullScreen();
+}
+
+void DisplayManager::beginFullScreen() {
+  if (!ready) return;
+  display.clearDisplay();
+  display.setTextColor(SSD1306_WHITE);
+  mainScreenActive = false;
+  fieldsDrawn = 0;
+  statusHoldUntil = 0;
+  markDirty();
+}
+
+bool DisplayManager::enterMainScreen() {
+  if (mainScreenActive) {
+    return true;
+  }
+  if (!ready || (long)(millis() - statusHoldUntil) < 0) {
+    return false;  // Status message still showing
+  }
+  beginFullScreen();
+  mainScreenActive = true;
+  return true;
+}
+
+void DisplayManager::drawField(int x, int y, int w, int h, const char* text, int textSize) {
+  display.fillRect(x, y, w, h, SSD1306_BLACK);
+  display.setTextSize(textSize);
+  display.setCursor(x, y);
+  display.print(text);
+  markDirty(x, y, w, h);
+}
+
+// ========================================
+// MAIN SCREEN FIELDS
+// ========================================
+
+bool DisplayManager::sameView(const DisplayView& a, const DisplayView& b) {
+  return a.state == b.state && a.count == b.count && a.sdOk == b.sdOk &&
+         a.rtcOk == b.rtcOk && (!a.rtcOk || (a.hour == b.hour && a.minute == b.minute)) &&
+         a.rateShown == b.rateShown &&
+         (!a.rateShown || (a.rateNow == b.rateNow && a.rateAverage == b.rateAverage)) &&
+         strncmp(a.status, b.status, sizeof(a.status)) == 0;
+}
+
+bool DisplayManager::render(const DisplayView& view) {
+  if (mainScreenActive && viewRendered && sameView(view, lastView) && !needsRefresh()) {
+    framesSkipped++;
+    return false;
+  }
+  if (millis() - lastRefresh < refreshRate) {
+    return false;  // Changed, but too soon after the last frame - next pass
+  }
+  if (!enterMainScreen()) {
+    return false;  // Status message still showing
+  }
+  
+  setStatusText(view.status);
+  setCount(view.count);
+  setClock(view.rtcOk ? view.hour : -1, view.minute);
+  setStorageOk(view.sdOk);
+  setRate(view.rateShown, view.rateNow, view.rateAverage);
+  update();
+  
+  lastView = view;
+  viewRendered = true;
+  framesRendered++;
+  return true;
+}
+
+void DisplayManager::setStatusText(const char* text) {
+  if (!enterMainScreen()) return;
+  if ((fieldsDrawn & FIELD_STATUS) && strncmp(text, lastStatus, sizeof(lastStatus) - 1) == 0) {
+    return;
+  }
+  
+  strncpy(lastStatus, text, sizeof(lastStatus) - 1);
+  lastStatus[sizeof(lastStatus) - 1] = '\0';
+  drawField(0, STATUS_Y, WIDTH, GLYPH_HEIGHT, lastStatus, 1);
+  fieldsDrawn |= FIELD_STATUS;
+}
+
+void DisplayManager::setCount(long count) {
+  if (!enterMainScreen()) return;
+  if ((fieldsDrawn & FIELD_COUNT) && count == lastCount) {
+    return;
+  }
+  
+  uint8_t* buffer = display.getBuffer();
+  BigDigits::Layout next;
+  BigDigits::layout(count < 0 ? 0 : (unsigned long)count, next);
+  
+  if (count < 0 || next.left < 0 || next.right > WIDTH) {
+    // Does not fit the big digits - fall back to size 2 text
+    char text[12];
+    snprintf(text, sizeof(text), "%ld", count);
+    BigDigits::clearColumns(buffer, 0, WIDTH);
+    display.setTextSize(2);
+    display.setCursor(0, COUNT_TOP + 4);
+    display.print(text);
+    markDirty(0, COUNT_TOP, WIDTH, COUNT_HEIGHT);
+    countGlyphs = false;
+  } else {
+    // Only blit from the first digit that changed; a different width
+    // re-centers the number, which moves every digit
+    uint8_t first = 0;
+    int clearFrom = 0;
+    int clearTo = WIDTH;
+    if ((fieldsDrawn & FIELD_COUNT) && countGlyphs) {
+      BigDigits::Layout prev;
+      BigDigits::layout((unsigned long)lastCount, prev);
+      if (prev.count == next.count && prev.left == next.left) {
+        while (first < next.count && prev.digits[first] == next.digits[first]) first++;
+        clearFrom = next.x[first];
+      } else {
+        clearFrom = (prev.left < next.left) ? prev.left : next.left;
+      }
+      clearTo = (prev.right > next.right) ? prev.right : next.right;
+    }
+    
+    BigDigits::clearColumns(buffer, clearFrom, clearTo);
+    for (uint8_t i = first; i < next.count; i++) {
+      BigDigits::blit(buffer, next.x[i], next.digits[i]);
+    }
+    markDirty(clearFrom, COUNT_TOP, clearTo - clearFrom, COUNT_HEIGHT);
+    countGlyphs = true;
+  }
+  
+  lastCount = count;
+  fieldsDrawn |= FIELD_COUNT;
+}
+
+void DisplayManager::setClock(int hour, int minute) {
+  if (!enterMainScreen()) return;
+  if ((fieldsDrawn & FIELD_CLOCK) && hour == lastHour && minute == lastMinute) {
+    return;
+  }
+  
+  char text[12] = "";
+  if (hour >= 0) {
+    snprintf(text, sizeof(text), "%u:%02u", (unsigned)(hour % 24), (unsigned)(minute % 60));
+  }
+  drawField(0, FOOTER_Y, CLOCK_WIDTH, GLYPH_HEIGHT, text, 1);
+  lastHour = hour;
+  lastMinute = minute;
+  fieldsDrawn |= FIELD_CLOCK;
+}
+
+void DisplayManager::setStorageOk(bool ok) {
+  if (!enterMainScreen()) return;
+  if ((fieldsDrawn & FIELD_STORAGE) && ok == lastStorageOk) {
+    return;
+  }
+  
+  drawField(STORAGE_X, FOOTER_Y, STORAGE_WIDTH, GLYPH_HEIGHT, ok ? "SD:OK" : "SD:NG", 1);
+  lastStorageOk = ok;
+  fieldsDrawn |= FIELD_STORAGE;
+}
+
+void DisplayManager::setRate(bool shown, uint32_t now, uint32_t average) {
+  if (!enterMainScreen()) return;
+  if ((fieldsDrawn & FIELD_RATE) && shown == lastRateShown &&
+      (!shown || (now == lastRateNow && average == lastRateAverage))) {
+    return;
+  }
+  
+  char text[24] = "";
+  if (shown) {
+    char nowText[12];
+    char averageText[12];
+    RateMeter::formatTenths(now, nowText, sizeof(nowText));
+    RateMeter::formatTenths(average, averageText, sizeof(averageText));
+    if (snprintf(text, sizeof(text), "%s/min avg %s", nowText, averageText) > WIDTH / GLYPH_WIDTH) {
+      snprintf(text, sizeof(text), "%s/min", nowText);   // Would wrap into the footer
+    }
+  }
+  drawField(0, RATE_Y, WIDTH, GLYPH_HEIGHT, text, 1);
+  lastRateShown = shown;
+  lastRateNow = now;
+  lastRateAverage = average;
+  fieldsDrawn |= FIELD_RATE;
+}
+
+// ========================================
+// SCREENS
+// ========================================
+
+void DisplayManager::showMainScreen(int count, DateTime time, bool isProducing) {
+  setStatusText(isProducing ? "PRODUCTION ACTIVE" : "READY");
+  setCount(count);
+  setClock(time.hour(), time.minute());
+}
+
+void DisplayManager::showStatus(const char* message, unsigned long duration) {
+  beginFullScreen();
+  displayText(10, 30, message, 1);
+  statusHoldUntil = millis() + duration;
+  flush();
+}
+
+void DisplayManager::showError(const char* errorMessage) {
+  showErrorScreen(errorMessage);
+}
+
+void DisplayManager::showDiagnostics(const char* results) {
+  beginFullScreen();
+  displayText(0, 0, "DIAGNOSTICS", 1);
+  displayLine(10);
+  displayText(0, 16, results, 1);
+  flush();
+}
+
+void DisplayManager::showInitializationScreen() {
+  beginFullScreen();
+  displayText(10, 5, "COUNTER", 2);
+  displayText(15, 30, "Initializing...", 1);
+  flush();
+}
+
+void DisplayManager::showReadyScreen() {
+  setStatusText("READY");
+}
+
+void DisplayManager::showProductionScreen(int count) {
+  setStatusText("PRODUCTION ACTIVE");
+  setCount(count);
+}
+
+void DisplayManager::showDiagnosticScreen() {
+  beginFullScreen();
+  displayCentered(28, "DIAGNOSTIC MODE", 1);
+  flush();
+}
+
+void DisplayManager::showErrorScreen(const char* message) {
+  beginFullScreen();
+  displayText(10, 20, "ERROR:", 1);
+  displayText(10, 40, message, 1);
+  flush();
+}
+
+// ========================================
+// LOW-LEVEL DRAWING
+// ========================================
+
+void DisplayManager::displayText(int x, int y, const char* text, int textSize) {
+  if (!ready) return;
+  display.setTextSize(textSize);
+  display.setCursor(x, y);
+  display.print(text);
+  
+  // Text wraps at the right edge - treat the rest of the band as touched
+  int w = (int)strlen(text) * GLYPH_WIDTH * textSize;
+  int h = GLYPH_HEIGHT * textSize;
+  if (x + w > WIDTH) {
+    markDirty(0, y, WIDTH, HEIGHT - y);
+  } else {
+    markDirty(x, y, w, h);
+  }
+}
+
+void DisplayManager::displayNumber(int x, int y, int value, int textSize) {
+  char text[12];
+  snprintf(text, sizeof(text), "%d", value);
+  displayText(x, y, text, textSize);
+}
+
+void DisplayManager::displayCentered(int y, const char* text, int textSize) {
+  int w = (int)strlen(text) * GLYPH_WIDTH * textSize;
+  int x = (w < WIDTH) ? (WIDTH - w) / 2 : 0;
+  displayText(x, y, text, textSize);
+}
+
+void DisplayManager::displayLine(int y) {
+  if (!ready) return;
+  display.drawFastHLine(0, y, WIDTH, SSD1306_WHITE);
+  markDirty(0, y, WIDTH, 1);
+}
+
+void DisplayManager::setBrightness(uint8_t level) {
+  const uint8_t contrast[] = { 0x00, 0x81, level };  // Command stream, SETCONTRAST
+  if (!I2C::write(I2C_ADDRESS, contrast, sizeof(contrast))) {
+    LOG_ERROR(DISPLAY, "Cannot set brightness");
+  }
+}
+
+void DisplayManager::setRefreshRate(unsigned long rateMs) {
+  refreshRate = rateMs;
+  LOG_INFO(DISPLAY, "Setting refresh rate to %lums", rateMs);
+}
+
+bool DisplayManager::needsRefresh() const {
+  return displayDirty || DisplayLink::getInstance().needsFullPages();
+}
+
+void DisplayManager::markDirty() {
+  markDirty(0, 0, WIDTH, HEIGHT);
+}
+
+void DisplayManager::markDirty(int x, int y, int w, int h) {
+  // Clip to the panel
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > WIDTH) w = WIDTH - x;
+  if (y + h > HEIGHT) h = HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+  
+  for (int page = y / 8; page <= (y + h - 1) / 8; page++) {
+    if (x < dirtyStart[page]) dirtyStart[page] = x;
+    if (x + w - 1 > dirtyEnd[page]) dirtyEnd[page] = x + w - 1;
+  }
+  displayDirty = true;
+}
+
+void DisplayManager::markClean() {
+  for (uint8_t page = 0; page < PAGE_COUNT; page++) {
+    dirtyStart[page] = WIDTH;
+    dirtyEnd[page] = 0;
+  }
+  displayDirty = false;
+}
+
+void DisplayManager::resetStats() {
+  flushCount = 0;
+  framesRendered = 0;
+  framesSkipped = 0;
+  DisplayLink::getInstance().resetStats();
+}
+
+void DisplayManager::drawProgressBar(int y, int value, int maxValue) {
+  int filled = (maxValue > 0) ? (int)((long)value * (WIDTH - 4) / maxValue) : 0;
+  if (filled < 0) filled = 0;
+  if (filled > WIDTH - 4) filled = WIDTH - 4;
+  if (!ready) return;
+  
+  display.fillRect(0, y, WIDTH, 8, SSD1306_BLACK);
+  display.drawRect(0, y, WIDTH, 8, SSD1306_WHITE);
+  display.fillRect(2, y + 2, filled, 4, SSD1306_WHITE);
+  markDirty(0, y, WIDTH, 8);
+}
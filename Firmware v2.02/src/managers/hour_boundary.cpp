@@ -0,0 +1,132 @@
+#include "hour_boundary.h"
+
+// ========================================
+// HOUR BOUNDARY IMPLEMENTATION
+// ========================================
+
+HourBoundary& HourBoundary::getInstance() {
+  static HourBoundary instance;
+  return instance;
+}
+
+void HourBoundary::begin(int currentHour, Mode startMode) {
+  mode = startMode;
+  trackedHour = currentHour;
+  armed = false;
+  closed = false;
+  alarmPending = false;
+  alarmFlag = false;
+  mismatchSeen = false;
+  awaitingAlarm = false;
+  alarmsAtTick = alarmsSeen;
+  lastTickPolled = false;
+  missedAlarms = 0;
+}
+
+void HourBoundary::armDeadline(int64_t atUs, int hour) {
+  if (closed) {
+    return;  // Report the closed hour first
+  }
+  armed = false;
+  deadlineUs = atUs;
+  deadlineHour = hour;
+  armed = true;
+}
+
+bool HourBoundary::poll(int clockHour, int64_t nowUs, int countNow, Tick& tick) {
+  checkAlarmArrived(nowUs);
+
+  // Deadline passed and no pulse closed the hour: the count is unchanged
+  if (armed && nowUs >= deadlineUs) {
+    close(countNow, SOURCE_DEADLINE);
+  }
+
+  if (closed) {
+    emit(tick, deadlineHour, closedCount, closedSource, nowUs);
+    closed = false;
+    return true;
+  }
+
+  if (alarmPending) {
+    alarmPending = false;
+
+    // Late alarm for a boundary already taken from the clock
+    if (lastTickPolled && nowUs - lastTickUs < 2 * ALARM_GRACE_US) {
+      return false;
+    }
+
+    // The clock may still read hh:59:59.999 when the alarm edge arrives
+    int8_t hour = (clockHour == trackedHour) ? (trackedHour + 1) % 24 : clockHour;
+    emit(tick, hour, alarmCount, SOURCE_ALARM, nowUs);
+    return true;
+  }
+
+  if (clockHour == trackedHour) {
+    mismatchSeen = false;
+    return false;
+  }
+
+  // New clock hour with no alarm / deadline yet: give them a moment, the
+  // clock can be slightly ahead of the RTC or was just set
+  if (mode == MODE_ALARM || armed) {
+    if (!mismatchSeen) {
+      mismatchSeen = true;
+      mismatchSinceUs = nowUs;
+    }
+    if (nowUs - mismatchSinceUs < ALARM_GRACE_US) {
+      return false;
+    }
+  }
+
+  armed = false;  // Stale after a clock change - re-armed by the caller
+  emit(tick, clockHour, countNow, SOURCE_CLOCK, nowUs);
+  return true;
+}
+
+void HourBoundary::emit(Tick& tick, int8_t hour, int count, uint8_t source, int64_t nowUs) {
+  // Only the next hour has an alarm; other jumps are clock changes
+  awaitingAlarm = (mode == MODE_ALARM && hour == (trackedHour + 1) % 24);
+
+  tick.hour = hour;
+  tick.count = count;
+  tick.source = source;
+
+  trackedHour = hour;
+  mismatchSeen = false;
+  lastTickPolled = (source == SOURCE_CLOCK);
+  lastTickUs = nowUs;
+  ticksBySource[source]++;
+}
+
+void HourBoundary::checkAlarmArrived(int64_t nowUs) {
+  if (!awaitingAlarm || nowUs - lastTickUs < ALARM_GRACE_US) {
+    return;
+  }
+  awaitingAlarm = false;
+
+  uint32_t seen = alarmsSeen;
+  if (seen != alarmsAtTick) {
+    missedAlarms = 0;
+  } else {
+    missedAlarmsTotal++;
+    if (++missedAlarms >= MAX_MISSED_ALARMS) {
+      mode = MODE_POLLED;
+    }
+  }
+  alarmsAtTick = seen;
+}
+
+bool HourBoundary::takeAlarmFlag() {
+  if (!alarmFlag) {
+    return false;
+  }
+  alarmFlag = false;
+  return true;
+}
+
+void HourBoundary::resetStats() {
+  for (uint8_t i = 0; i < 4; i++) {
+    ticksBySource[i] = 0;
+  }
+  missedAlarmsTotal = 0;
+}
@@ -0,0 +1,143 @@
+#ifndef HOUR_BOUNDARY_H
+#define HOUR_BOUNDARY_H
+
+#include <stdint.h>
+
+// ========================================
+// HOUR BOUNDARY DETECTION
+// ========================================
+// Items are attributed to an hour by the count at the boundary. Polling
+// the clock from loop() takes that snapshot late whenever the loop is
+// busy (SD writes, status screens), so items counted just after hh:00
+// land in the previous hour.
+//
+// Pulse-exact split: the loop arms the next hh:00 as a deadline in MCU
+// timer microseconds (converted from epoch seconds by the software
+// clock). The counter ISR passes each pulse's timestamp to onPulse(); the
+// first pulse at or after the deadline closes the hour with the count
+// before it. One 64-bit compare per pulse, no float in the ISR. If no
+// pulse arrives, poll() closes the hour once the deadline has passed -
+// the count cannot have changed since.
+//
+// With the DS3231 INT/SQW line wired, alarm 2 fires at minute 00 and
+// onAlarm() closes the hour too (whichever comes first), which also
+// covers a software clock that is slightly behind the RTC. Without a
+// valid clock (no deadline armed) the alarm alone snapshots the count.
+//
+// Without either, boundaries come from the clock hour: after
+// ALARM_GRACE_US of a new hour with no alarm, poll() reports it with the
+// current count. Two missed alarms in a row switch to polled mode.
+class HourBoundary {
+public:
+  enum Mode {
+    MODE_POLLED,
+    MODE_ALARM
+  };
+
+  enum Source {
+    SOURCE_CLOCK,       // Clock hour changed (late snapshot)
+    SOURCE_DEADLINE,    // Deadline passed with no pulse since
+    SOURCE_PULSE,       // First pulse after the deadline
+    SOURCE_ALARM        // DS3231 alarm interrupt
+  };
+
+  struct Tick {
+    int8_t hour;        // Hour that just started
+    int count;          // Count at the boundary
+    uint8_t source;     // Source
+  };
+
+  static const int64_t ALARM_GRACE_US = 2000000;
+  static const int64_t ALARM_WINDOW_US = 2000000;  // Alarm this close to the deadline closes it
+  static const uint8_t MAX_MISSED_ALARMS = 2;
+
+  static HourBoundary& getInstance();
+
+  // Start tracking from `currentHour`
+  void begin(int currentHour, Mode mode);
+
+  // Next hh:00 (`hour` starts) at MCU timer time `deadlineUs`. Call with
+  // interrupts disabled: the ISR must not see half of the 64-bit value.
+  void armDeadline(int64_t deadlineUs, int hour);
+  bool isDeadlineArmed() const { return armed; }
+
+  // From the counter ISR, before the count is incremented
+  void onPulse(int64_t pulseUs, int countBefore) {
+    if (armed && pulseUs >= deadlineUs) {
+      close(countBefore, SOURCE_PULSE);
+    }
+  }
+
+  // From the INT/SQW interrupt (alarm 2, minute 00)
+  void onAlarm(int64_t alarmUs, int countNow) {
+    alarmsSeen++;
+    alarmFlag = true;
+    if (armed) {
+      if (alarmUs >= deadlineUs - ALARM_WINDOW_US) close(countNow, SOURCE_ALARM);
+    } else if (!closed) {
+      alarmCount = countNow;
+      alarmPending = true;
+    }
+  }
+
+  // Call from the loop; read nowUs before countNow. True when an hour
+  // started - re-arm the deadline for the next one afterwards.
+  bool poll(int clockHour, int64_t nowUs, int countNow, Tick& tick);
+
+  // True once per alarm interrupt (the RTC's alarm flag needs clearing)
+  bool takeAlarmFlag();
+
+  Mode getMode() const { return mode; }
+  int getTrackedHour() const { return trackedHour; }
+  uint32_t getAlarmTicks() const { return ticksBySource[SOURCE_ALARM]; }
+  uint32_t getPulseTicks() const { return ticksBySource[SOURCE_PULSE]; }
+  uint32_t getDeadlineTicks() const { return ticksBySource[SOURCE_DEADLINE]; }
+  uint32_t getPolledTicks() const { return ticksBySource[SOURCE_CLOCK]; }
+  uint32_t getMissedAlarms() const { return missedAlarmsTotal; }
+  void resetStats();
+
+private:
+  HourBoundary() {}
+
+  void close(int count, uint8_t source) {
+    armed = false;
+    closedCount = count;
+    closedSource = source;
+    closed = true;
+  }
+  void emit(Tick& tick, int8_t hour, int count, uint8_t source, int64_t nowUs);
+  void checkAlarmArrived(int64_t nowUs);
+
+  Mode mode = MODE_POLLED;
+  int8_t trackedHour = -1;
+
+  // Deadline of the open hour (written with interrupts off)
+  volatile bool armed = false;
+  int64_t deadlineUs = 0;
+  int8_t deadlineHour = -1;
+
+  // Hour closed by an interrupt or the deadline, not yet reported
+  volatile bool closed = false;
+  volatile int closedCount = 0;
+  volatile uint8_t closedSource = SOURCE_CLOCK;
+
+  // Alarm with no deadline armed
+  volatile bool alarmPending = false;
+  volatile int alarmCount = 0;
+  volatile bool alarmFlag = false;
+  volatile uint32_t alarmsSeen = 0;
+
+  // Clock-hour fallback and missed-alarm detection
+  bool mismatchSeen = false;
+  int64_t mismatchSinceUs = 0;
+  bool awaitingAlarm = false;
+  uint32_t alarmsAtTick = 0;
+  int64_t lastTickUs = 0;
+  bool lastTickPolled = false;
+  uint8_t missedAlarms = 0;
+
+  uint32_t ticksBySource[4] = {0, 0, 0, 0};
+  uint32_t missedAlarmsTotal = 0;
+};
+
+#endif // HOUR_BOUNDARY_H
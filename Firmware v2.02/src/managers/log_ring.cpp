@@ -0,0 +1,373 @@
+#include "log_ring.h"
+#include "checksum.h"
+#include <stdio.h>
+
+#if LOG_RING_LOCKED
+#include <freertos/FreeRTOS.h>
+
+// Producers on both cores; held for a copy of at most MAX_RECORD bytes
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+#define RING_LOCK()   portENTER_CRITICAL(&ringMux)
+#define RING_UNLOCK() portEXIT_CRITICAL(&ringMux)
+#else
+#define RING_LOCK()
+#define RING_UNLOCK()
+#endif
+
+static_assert((LogRing::RING_SIZE & (LogRing::RING_SIZE - 1)) == 0, "Ring size must be a power of two");
+static_assert(LogRing::MAX_RECORD <= 255, "Record size is one byte");
+
+// ========================================
+// LOG RING IMPLEMENTATION
+// ========================================
+
+LogRing::LogRing() {
+  memset(buffer, 0, sizeof(buffer));
+}
+
+bool LogRing::push(const uint8_t* record, size_t size) {
+  RING_LOCK();
+  if (RING_SIZE - (head - tail) < size) {
+    dropped++;
+    RING_UNLOCK();
+    return false;
+  }
+
+  size_t offset = head & (RING_SIZE - 1);
+  size_t first = RING_SIZE - offset;
+  if (first >= size) {
+    memcpy(buffer + offset, record, size);
+  } else {
+    memcpy(buffer + offset, record, first);
+    memcpy(buffer, record + first, size - first);
+  }
+  head += size;
+  pushed++;
+  if (head - tail > highWater) highWater = head - tail;
+  RING_UNLOCK();
+  return true;
+}
+
+size_t LogRing::pop(uint8_t* out) {
+  RING_LOCK();
+  if (head == tail) {
+    RING_UNLOCK();
+    return 0;
+  }
+
+  size_t offset = tail & (RING_SIZE - 1);
+  size_t size = buffer[offset];   // First byte of every record
+  size_t first = RING_SIZE - offset;
+  if (first >= size) {
+    memcpy(out, buffer + offset, size);
+  } else {
+    memcpy(out, buffer + offset, first);
+    memcpy(out + first, buffer, size - first);
+  }
+  tail += size;
+  RING_UNLOCK();
+  return size;
+}
+
+void LogRing::resetStats() {
+  RING_LOCK();
+  highWater = head - tail;
+  pushed = 0;
+  dropped = 0;
+  RING_UNLOCK();
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool LogRing::parse(const uint8_t* record, size_t size, Record& out) {
+  if (size < HEADER_SIZE || record[0] != size) {
+    return false;
+  }
+  out.level = record[1] & LEVEL_MASK;
+  out.module = record[1] >> MODULE_SHIFT;
+  out.argc = record[2];
+  out.flags = record[3];
+  out.formatId = get32(record + 4);
+  out.timestampUs = get32(record + 8);
+  out.args = record + HEADER_SIZE;
+  out.argsSize = size - HEADER_SIZE;
+  return true;
+}
+
+const char* LogRing::levelName(uint8_t level) {
+  static const char* const NAMES[] = { "DEBUG", "INFO", "WARN", "ERROR", "FATAL" };
+  return (level < sizeof(NAMES) / sizeof(NAMES[0])) ? NAMES[level] : "?";
+}
+
+const char* LogRing::moduleName(uint8_t module) {
+  // LoggerManager::Module order; SYSTEM lines carry no module tag
+  static const char* const NAMES[] = { nullptr, "FSM", "Storage", "Display", "Time",
+                                       "Production", "Config" };
+  return (module < sizeof(NAMES) / sizeof(NAMES[0])) ? NAMES[module] : "?";
+}
+
+// ========================================
+// RENDERING
+// ========================================
+
+namespace {
+
+struct Arg {
+  uint8_t type;
+  uint64_t raw;
+  const char* str;
+  uint8_t length;
+
+  long long asSigned() const {
+    switch (type) {
+      case LogRing::ARG_INT:    return (int32_t)raw;
+      case LogRing::ARG_INT64:  return (int64_t)raw;
+      case LogRing::ARG_DOUBLE: return (long long)asDouble();
+      default:                  return (long long)raw;
+    }
+  }
+  unsigned long long asUnsigned() const {
+    switch (type) {
+      case LogRing::ARG_INT:    return (unsigned long long)(long long)(int32_t)raw;
+      case LogRing::ARG_DOUBLE: return (unsigned long long)asDouble();
+      default:                  return raw;
+    }
+  }
+  double asDouble() const {
+    if (type == LogRing::ARG_DOUBLE) {
+      double d;
+      memcpy(&d, &raw, sizeof(d));
+      return d;
+    }
+    return (type == LogRing::ARG_INT || type == LogRing::ARG_INT64) ? (double)asSigned()
+                                                                    : (double)raw;
+  }
+};
+
+class ArgReader {
+public:
+  ArgReader(const LogRing::Record& record)
+      : p(record.args), end(record.args + record.argsSize), left(record.argc) {}
+
+  bool next(Arg& arg) {
+    if (left == 0 || p >= end) return false;
+    arg.type = *p++;
+    arg.raw = 0;
+    arg.str = nullptr;
+    arg.length = 0;
+
+    size_t bytes;
+    switch (arg.type) {
+      case LogRing::ARG_INT:
+      case LogRing::ARG_UINT:
+        bytes = 4;
+        break;
+      case LogRing::ARG_INT64:
+      case LogRing::ARG_UINT64:
+      case LogRing::ARG_DOUBLE:
+        bytes = 8;
+        break;
+      case LogRing::ARG_STRING:
+        if (p >= end) return false;
+        arg.length = *p++;
+        if ((size_t)(end - p) < arg.length) return false;
+        arg.str = (const char*)p;
+        p += arg.length;
+        left--;
+        return true;
+      default:
+        return false;
+    }
+    if ((size_t)(end - p) < bytes) return false;
+    for (size_t i = 0; i < bytes; i++) {
+      arg.raw |= (uint64_t)p[i] << (8 * i);
+    }
+    p += bytes;
+    left--;
+    return true;
+  }
+
+private:
+  const uint8_t* p;
+  const uint8_t* end;
+  uint8_t left;
+};
+
+}  // namespace
+
+size_t LogRing::render(const Record& record, const char* format, char* out, size_t outSize) {
+  if (outSize == 0) {
+    return 0;
+  }
+  ArgReader reader(record);
+  size_t n = 0;
+
+  // Append snprintf output, clamped to the buffer
+  #define APPEND(...)                                                   \
+    do {                                                                \
+      int written = snprintf(out + n, outSize - n, __VA_ARGS__);        \
+      if (written > 0) {                                                \
+        n += ((size_t)written < outSize - n) ? (size_t)written : outSize - n - 1; \
+      }                                                                 \
+    } while (0)
+
+  while (*format && n + 1 < outSize) {
+    if (*format != '%') {
+      out[n++] = *format++;
+      continue;
+    }
+    format++;
+    if (*format == '%') {
+      out[n++] = '%';
+      format++;
+      continue;
+    }
+
+    // Flags, width and precision are kept; length modifiers are replaced
+    // by the recorded argument type
+    char spec[24] = "%";
+    size_t specLen = 1;
+    while (*format && strchr("-+ #0123456789.*", *format) && specLen < sizeof(spec) - 8) {
+      if (*format == '*') {
+        Arg width;
+        int value = reader.next(width) ? (int)width.asSigned() : 0;
+        specLen += snprintf(spec + specLen, sizeof(spec) - specLen, "%d", value);
+        format++;
+        continue;
+      }
+      spec[specLen++] = *format++;
+    }
+    while (*format && strchr("hlLqjzt", *format)) {
+      format++;
+    }
+    char conversion = *format;
+    if (conversion == '\0') {
+      break;
+    }
+    format++;
+
+    Arg arg;
+    if (!reader.next(arg)) {
+      APPEND("<?>");
+      continue;
+    }
+
+    switch (conversion) {
+      case 'd':
+      case 'i':
+        memcpy(spec + specLen, "lld", 4);
+        APPEND(spec, arg.asSigned());
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        spec[specLen] = 'l';
+        spec[specLen + 1] = 'l';
+        spec[specLen + 2] = conversion;
+        spec[specLen + 3] = '\0';
+        APPEND(spec, arg.asUnsigned());
+        break;
+      case 'c':
+        memcpy(spec + specLen, "c", 2);
+        APPEND(spec, (int)arg.asSigned());
+        break;
+      case 'f': case 'F':
+      case 'e': case 'E':
+      case 'g': case 'G':
+      case 'a': case 'A':
+        spec[specLen] = conversion;
+        spec[specLen + 1] = '\0';
+        APPEND(spec, arg.asDouble());
+        break;
+      case 's':
+        if (arg.type == ARG_STRING) {
+          char text[MAX_STRING + 1];
+          memcpy(text, arg.str, arg.length);
+          text[arg.length] = '\0';
+          memcpy(spec + specLen, "s", 2);
+          APPEND(spec, text);
+        } else {
+          APPEND("<?>");
+        }
+        break;
+      case 'p':
+        APPEND("0x%08llx", arg.asUnsigned());
+        break;
+      default:
+        APPEND("<?>");
+        break;
+    }
+  }
+
+  if ((record.flags & FLAG_TRUNCATED) && n + 1 < outSize) {
+    APPEND(" [...]");
+  }
+  #undef APPEND
+
+  out[n] = '\0';
+  return n;
+}
+
+// ========================================
+// BINARY FRAMES
+// ========================================
+
+size_t LogRing::frame(const uint8_t* record, size_t size, uint8_t* out) {
+  out[0] = FRAME_MAGIC0;
+  out[1] = FRAME_MAGIC1;
+  out[2] = (uint8_t)size;
+  memcpy(out + 3, record, size);
+  put32(out + 3 + size, crc32(record, size));
+  return size + FRAME_OVERHEAD;
+}
+
+bool LogRing::FrameReader::feed(uint8_t byte, const uint8_t*& record, size_t& size) {
+  switch (state) {
+    case 0:
+      if (byte == FRAME_MAGIC0) {
+        state = 1;
+      } else {
+        skipped++;
+      }
+      return false;
+
+    case 1:
+      if (byte == FRAME_MAGIC1) {
+        state = 2;
+      } else if (byte != FRAME_MAGIC0) {
+        skipped += 2;
+        state = 0;
+      }
+      return false;
+
+    case 2:
+      if (byte < HEADER_SIZE || byte > MAX_RECORD) {
+        skipped += 3;
+        state = 0;
+        return false;
+      }
+      expected = byte + 4;  // Record + CRC
+      received = 0;
+      state = 3;
+      return false;
+
+    default:
+      buffer[received++] = byte;
+      if (received < expected) {
+        return false;
+      }
+      state = 0;
+
+      size_t recordSize = expected - 4;
+      if (crc32(buffer, recordSize) != get32(buffer + recordSize) || buffer[0] != recordSize) {
+        crcErrors++;
+        return false;
+      }
+      record = buffer;
+      size = recordSize;
+      return true;
+  }
+}
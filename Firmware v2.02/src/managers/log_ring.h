@@ -0,0 +1,220 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+#ifndef LOG_RING_LOCKED
+#define LOG_RING_LOCKED 1   // 0 for single-threaded host builds (no FreeRTOS)
+#endif
+
+// ========================================
+// DEFERRED LOG RECORDS
+// ========================================
+// A log call does not format anything. It stores a compact record in a RAM
+// ring - format string ID, timestamp, raw arguments - and returns; a
+// background drain turns records into text or binary frames later.
+//
+// Record (little endian):
+//   [size:1][level:1][argc:1][flags:1][formatId:4][timestampUs:4] args...
+//   level = log level (low nibble) | module << 4
+//   arg = [type:1][value]: INT/UINT 4 bytes, INT64/UINT64/DOUBLE 8 bytes,
+//         STRING [length:1][bytes] (truncated to MAX_STRING)
+//
+// formatId is the address of the format string in flash: the firmware ELF
+// is the format table, generated by the build (see tests/host/log_decode).
+// Argument types are picked at compile time from the C++ types, so the
+// renderer never trusts the format string for sizes.
+//
+// Binary frame: [0xA5][0x5A][size:1][record][crc32:4]
+class LogRing {
+public:
+  static const size_t RING_SIZE = 4096;            // Power of two
+  static const size_t MAX_RECORD = 96;
+  static const size_t HEADER_SIZE = 12;
+  static const size_t MAX_STRING = 32;
+  static const uint8_t MAX_ARGS = 8;
+  static const uint8_t FRAME_MAGIC0 = 0xA5;
+  static const uint8_t FRAME_MAGIC1 = 0x5A;
+  static const size_t FRAME_OVERHEAD = 3 + 4;      // Magic + size, CRC32
+  static const size_t MAX_FRAME = MAX_RECORD + FRAME_OVERHEAD;
+  static const uint8_t MODULE_SHIFT = 4;
+  static const uint8_t LEVEL_MASK = 0x0F;
+
+  enum ArgType : uint8_t {
+    ARG_INT,
+    ARG_UINT,
+    ARG_INT64,
+    ARG_UINT64,
+    ARG_DOUBLE,
+    ARG_STRING
+  };
+
+  enum Flags : uint8_t {
+    FLAG_TRUNCATED = 0x01     // String cut or arguments dropped (record/argument limit)
+  };
+
+  struct Record {
+    uint8_t level;
+    uint8_t module;
+    uint8_t argc;
+    uint8_t flags;
+    uint32_t formatId;
+    uint32_t timestampUs;
+    const uint8_t* args;
+    size_t argsSize;
+  };
+
+  LogRing();
+
+  // Encode a record into `out` (MAX_RECORD bytes); returns its size
+  template<typename... Args>
+  static size_t encode(uint8_t* out, uint8_t level, const char* format,
+                       uint32_t timestampUs, Args... args) {
+    size_t size = HEADER_SIZE;
+    uint8_t argc = 0;
+    uint8_t flags = 0;
+    encodeArgs(out, size, argc, flags, args...);
+
+    out[0] = (uint8_t)size;
+    out[1] = level;
+    out[2] = argc;
+    out[3] = flags;
+    put32(out + 4, (uint32_t)(uintptr_t)format);
+    put32(out + 8, timestampUs);
+    return size;
+  }
+
+  // Append an encoded record; false (and counted) when the ring is full.
+  // Safe from both cores, not from ISRs.
+  bool push(const uint8_t* record, size_t size);
+
+  // Oldest record into `out` (MAX_RECORD bytes); returns its size, 0 if empty
+  size_t pop(uint8_t* out);
+
+  bool isEmpty() const { return head == tail; }
+  size_t used() const { return head - tail; }
+  size_t getHighWater() const { return highWater; }
+  uint32_t getPushed() const { return pushed; }
+  uint32_t getDropped() const { return dropped; }
+  void resetStats();
+
+  // Record decoding / rendering (drain on the device and host decoder)
+  static bool parse(const uint8_t* record, size_t size, Record& out);
+  static size_t render(const Record& record, const char* format, char* out, size_t outSize);
+  static const char* levelName(uint8_t level);
+  static const char* moduleName(uint8_t module);   // nullptr for SYSTEM
+
+  // Binary framing
+  static size_t frame(const uint8_t* record, size_t size, uint8_t* out);
+
+  // Byte-at-a-time frame parser; skips anything between frames
+  class FrameReader {
+  public:
+    // True when `record`/`size` hold a complete, CRC-checked record
+    bool feed(uint8_t byte, const uint8_t*& record, size_t& size);
+    bool isIdle() const { return state == 0; }   // Between frames
+    uint32_t getCrcErrors() const { return crcErrors; }
+    uint32_t getSkippedBytes() const { return skipped; }
+  private:
+    uint8_t buffer[MAX_RECORD + 4];
+    size_t expected = 0;
+    size_t received = 0;
+    uint8_t state = 0;
+    uint32_t crcErrors = 0;
+    uint32_t skipped = 0;
+  };
+
+private:
+  static void put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+  }
+
+  static void encodeArgs(uint8_t*, size_t&, uint8_t&, uint8_t&) {}
+
+  template<typename T, typename... Rest>
+  static void encodeArgs(uint8_t* out, size_t& size, uint8_t& argc, uint8_t& flags,
+                         T value, Rest... rest) {
+    if (argc < MAX_ARGS && encodeArg(out, size, flags, value)) {
+      argc++;
+    } else {
+      flags |= FLAG_TRUNCATED;
+      return;
+    }
+    encodeArgs(out, size, argc, flags, rest...);
+  }
+
+  static bool encodeValue(uint8_t* out, size_t& size, uint8_t type, uint64_t value,
+                          size_t bytes) {
+    if (size + 1 + bytes > MAX_RECORD) return false;
+    out[size++] = type;
+    for (size_t i = 0; i < bytes; i++) {
+      out[size++] = (uint8_t)(value >> (8 * i));
+    }
+    return true;
+  }
+
+  // Integers and enums (promoted as printf would)
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, bool>::type
+  encodeArg(uint8_t* out, size_t& size, uint8_t&, T value) {
+    typedef typename std::conditional<std::is_enum<T>::value, int, T>::type Int;
+    bool isSigned = std::is_signed<Int>::value;
+    if (sizeof(Int) > 4) {
+      return encodeValue(out, size, isSigned ? ARG_INT64 : ARG_UINT64, (uint64_t)(Int)value, 8);
+    }
+    return encodeValue(out, size, isSigned ? ARG_INT : ARG_UINT, (uint64_t)(uint32_t)(Int)value, 4);
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+  encodeArg(uint8_t* out, size_t& size, uint8_t&, T value) {
+    double d = value;
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return encodeValue(out, size, ARG_DOUBLE, bits, 8);
+  }
+
+  // Strings are copied - the caller's buffer may be gone by drain time
+  static bool encodeArg(uint8_t* out, size_t& size, uint8_t& flags, const char* value) {
+    if (value == nullptr) value = "(null)";
+    size_t length = strnlen(value, MAX_STRING);
+    if (size + 2 + length > MAX_RECORD) {
+      length = (size + 2 < MAX_RECORD) ? MAX_RECORD - size - 2 : 0;
+      if (length == 0) return false;
+    }
+    if (value[length] != '\0') {
+      flags |= FLAG_TRUNCATED;
+    }
+    out[size++] = ARG_STRING;
+    out[size++] = (uint8_t)length;
+    for (size_t i = 0; i < length; i++) {
+      out[size++] = (uint8_t)value[i];
+    }
+    return true;
+  }
+
+  static bool encodeArg(uint8_t* out, size_t& size, uint8_t& flags, char* value) {
+    return encodeArg(out, size, flags, (const char*)value);
+  }
+
+  // Other pointers (%p): address only
+  template<typename T>
+  static bool encodeArg(uint8_t* out, size_t& size, uint8_t&, const T* value) {
+    return encodeValue(out, size, ARG_UINT, (uint64_t)(uint32_t)(uintptr_t)value, 4);
+  }
+
+  uint8_t buffer[RING_SIZE];
+  volatile uint32_t head = 0;   // Free-running write index
+  volatile uint32_t tail = 0;   // Free-running read index
+  size_t highWater = 0;
+  uint32_t pushed = 0;
+  uint32_t dropped = 0;
+};
+
+#endif // LOG_RING_H
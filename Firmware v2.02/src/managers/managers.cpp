@@ -1,6 +1,24 @@
 #include "managers.h"
+#include "state_store.h"
+#include "prealloc_log.h"
+#include "session_archive.h"
+#include "read_cache.h"
+#include "hal.h"
+#include "checkpoint_ring.h"
+#include "serial_out.h"
 #include <Arduino.h>
+#include <EEPROM.h>
+#include <SD.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <cstring>
+#include <strings.h>
+
+// SD card and RTC are brought up by initializeHardware() in the main firmware
+extern bool sdAvailable;
+extern bool rtcAvailable;
+extern RTC_DS3231 rtc;
 
 // ========================================
 // PRODUCTION MANAGER IMPLEMENTATION
@@ -13,38 +31,46 @@ ProductionManager::ProductionManager() {
   startingCountValue = 0;
 }
 
+ProductionManager& ProductionManager::getInstance() {
+  static ProductionManager instance;
+  return instance;
+}
+
 bool ProductionManager::startSession() {
   if (sessionActive) {
-    Serial.println("[ProductionManager] ERROR: Session already active");
+    LOG_ERROR(PRODUCTION, "Session already active");
     return false;
   }
   
   sessionActive = true;
   sessionCount = 0;
   startingCountValue = 0;
-  sessionStartTime = RTC_DS3231::now();  // Will be set by TimeManager
+  sessionStartTime = TimeManager::getInstance().getCurrentTime();
+  rates.begin(0, millis());
   
-  Serial.println("[ProductionManager] Session started");
-  Serial.print("  Start time: ");
-  Serial.println(sessionStartTime.unixtime());
+  LOG_INFO(PRODUCTION, "Session started");
+  Console.print("  Start time: ");
+  Console.println(sessionStartTime.unixtime());
   
   return true;
 }
 
 bool ProductionManager::stopSession() {
   if (!sessionActive) {
-    Serial.println("[ProductionManager] WARNING: No active session to stop");
+    LOG_WARN(PRODUCTION, "No active session to stop");
     return false;
   }
   
   sessionActive = false;
-  sessionStopTime = RTC_DS3231::now();  // Will be set by TimeManager
+  sessionStopTime = TimeManager::getInstance().getCurrentTime();
+  rates.update(sessionCount, millis());
+  rates.stop();
   
-  Serial.println("[ProductionManager] Session stopped");
-  Serial.print("  Stop time: ");
-  Serial.println(sessionStopTime.unixtime());
-  Serial.print("  Session count: ");
-  Serial.println(sessionCount);
+  LOG_INFO(PRODUCTION, "Session stopped");
+  Console.print("  Stop time: ");
+  Console.println(sessionStopTime.unixtime());
+  Console.print("  Session count: ");
+  Console.println(sessionCount);
   
   // Update total count
   totalSessionCount += sessionCount;
@@ -57,21 +83,20 @@ void ProductionManager::incrementCount() {
     return;  // Don't count if not in production
   }
   
+  // Called from the counter ISR: no logging (LogRing::push is not ISR-safe)
   if (sessionCount < 9999) {
     sessionCount++;
   }
-  
-  // Log every 100 items for diagnostics
-  if (sessionCount % 100 == 0) {
-    Serial.print("[ProductionManager] Count: ");
-    Serial.println(sessionCount);
-  }
 }
 
 int ProductionManager::getSessionCount() const {
   return sessionCount;
 }
 
+void ProductionManager::updateRates(uint32_t nowMs) {
+  rates.update(sessionCount, nowMs);
+}
+
 unsigned long ProductionManager::getSessionDuration() const {
   if (!sessionActive) {
     // Calculate from start to stop time
@@ -82,7 +107,7 @@ unsigned long ProductionManager::getSessionDuration() const {
   }
   
   // Session still active - calculate current duration
-  DateTime now = RTC_DS3231::now();
+  DateTime now = TimeManager::getInstance().getCurrentTime();
   if (now.unixtime() >= sessionStartTime.unixtime()) {
     return now.unixtime() - sessionStartTime.unixtime();
   }
@@ -93,42 +118,51 @@ bool ProductionManager::saveSessionToFile() {
   // File format: Production_YYYY-MM-DD_HHhMMm-HHhMMm.txt
   // This will be implemented with StorageManager
   
-  Serial.print("[ProductionManager] Would save session to file");
-  Serial.print(" | Start: ");
-  Serial.print(sessionStartTime.hour());
-  Serial.print("h");
-  Serial.print(sessionStartTime.minute());
-  Serial.print("m");
-  Serial.print(" | Stop: ");
-  Serial.print(sessionStopTime.hour());
-  Serial.print("h");
-  Serial.print(sessionStopTime.minute());
-  Serial.print("m");
-  Serial.print(" | Count: ");
-  Serial.println(sessionCount);
+  LOG_INFO(PRODUCTION, "Would save session to file | Start: %uh%um | Stop: %uh%um | Count: %d",
+           sessionStartTime.hour(), sessionStartTime.minute(),
+           sessionStopTime.hour(), sessionStopTime.minute(), sessionCount);
   
   return true;
 }
 
 bool ProductionManager::loadSessionFromFile() {
-  // Load from /prod_session.txt (recovery file)
-  Serial.println("[ProductionManager] Loading session from recovery file");
+  // Session recovery data lives in the persistent state block
+  LOG_INFO(PRODUCTION, "Loading session from state block");
+  
+  const PersistentStateRecord& state = StateStore::getInstance().data();
+  if (!state.productionActive) {
+    return false;
+  }
+  
+  sessionActive = true;
+  startingCountValue = state.productionStartCount;
+  sessionCount = state.currentCount - state.productionStartCount;
+  if (sessionCount < 0) sessionCount = 0;
+  sessionStartTime = DateTime(state.productionStartUnix);
+  rates.begin(sessionCount, millis());  // Rates cover items counted from here on
+  
+  Console.print("  Recovered count: ");
+  Console.println(sessionCount);
   return true;
 }
 
 bool ProductionManager::clearSessionFile() {
-  // Delete /prod_session.txt
-  Serial.println("[ProductionManager] Clearing recovery file");
-  return true;
+  LOG_INFO(PRODUCTION, "Clearing session recovery data");
+  
+  StateStore& store = StateStore::getInstance();
+  store.data().productionActive = 0;
+  store.data().productionStartUnix = 0;
+  return store.commit();
 }
 
 bool ProductionManager::isRecoveryValid() const {
-  // Check if recovery file exists and is valid
-  return true;
+  // Valid when the state block loaded and records an open session
+  const StateStore& store = StateStore::getInstance();
+  return store.isLoaded() && store.data().productionActive != 0;
 }
 
 bool ProductionManager::recover() {
-  Serial.println("[ProductionManager] Attempting recovery from power loss");
+  LOG_INFO(PRODUCTION, "Attempting recovery from power loss");
   return loadSessionFromFile();
 }
 
@@ -141,70 +175,125 @@ TimeManager::TimeManager() {
   timeInitialized = false;
 }
 
+TimeManager& TimeManager::getInstance() {
+  static TimeManager instance;
+  return instance;
+}
+
+static uint8_t bcdToBin(uint8_t value) {
+  return (value >> 4) * 10 + (value & 0x0F);
+}
+
+// One DS3231 read for the software clock. Urgent on the shared bus: edge
+// capture timestamps each read, so it must not wait behind a display push.
+static bool readRtcSeconds(uint32_t& unixSeconds) {
+  static const uint8_t TIME_REGISTER = 0x00;
+  uint8_t regs[7];
+  if (!I2C::writeRead(TimeManager::RTC_ADDRESS, &TIME_REGISTER, 1, regs, sizeof(regs),
+                      I2C::PRIORITY_URGENT)) {
+    return false;
+  }
+  
+  uint8_t second = bcdToBin(regs[0] & 0x7F);
+  uint8_t minute = bcdToBin(regs[1] & 0x7F);
+  uint8_t hour = bcdToBin(regs[2] & 0x3F);     // 24 h mode (as set by RTClib)
+  uint8_t day = bcdToBin(regs[4] & 0x3F);
+  uint8_t month = bcdToBin(regs[5] & 0x1F);
+  uint16_t year = 2000 + bcdToBin(regs[6]);
+  if (second > 59 || minute > 59 || hour > 23 || day < 1 || day > 31 ||
+      month < 1 || month > 12 || year < 2020) {
+    return false;
+  }
+  unixSeconds = DateTime(year, month, day, hour, minute, second).unixtime();
+  return true;
+}
+
+static int64_t clockMicros() {
+  return esp_timer_get_time();  // 64-bit, no wrap (micros() wraps at 71 min)
+}
+
 bool TimeManager::initialize() {
-  Serial.println("[TimeManager] Initializing RTC...");
+  LOG_INFO(TIME, "Initializing RTC...");
+  
+  if (!rtcAvailable) {
+    LOG_ERROR(TIME, "RTC not available");
+    return false;
+  }
   
-  // This would check if RTC is available
-  // For now, just mark as initialized
+  // Lock onto an RTC seconds edge before anyone reads the time
+  clock.begin(readRtcSeconds, clock.getResyncInterval());
+  unsigned long start = millis();
+  while (!clock.isSynced() && millis() - start < 2000) {
+    clock.poll(clockMicros());
+    delay(1);
+  }
+  
+  if (!clock.isSynced()) {
+    LOG_ERROR(TIME, "No RTC seconds edge - oscillator stopped?");
+    return false;
+  }
   timeInitialized = true;
   
   DateTime now = getCurrentTime();
   lastTrackedHour = now.hour();
   lastRecordedTime = now;
   
-  Serial.print("[TimeManager] RTC initialized");
-  Serial.print(" | Current time: ");
-  Serial.print(now.year());
-  Serial.print("-");
-  if (now.month() < 10) Serial.print("0");
-  Serial.print(now.month());
-  Serial.print("-");
-  if (now.day() < 10) Serial.print("0");
-  Serial.print(now.day());
-  Serial.print(" ");
-  if (now.hour() < 10) Serial.print("0");
-  Serial.print(now.hour());
-  Serial.print(":");
-  if (now.minute() < 10) Serial.print("0");
-  Serial.print(now.minute());
-  Serial.print(":");
-  if (now.second() < 10) Serial.print("0");
-  Serial.println(now.second());
+  LOG_INFO(TIME, "RTC initialized | Current time: %04u-%02u-%02u %02u:%02u:%02u",
+           now.year(), now.month(), now.day(), now.hour(), now.minute(), now.second());
   
   return true;
 }
 
+void TimeManager::update() {
+  if (timeInitialized) {
+    clock.poll(clockMicros());
+  }
+}
+
 DateTime TimeManager::getCurrentTime() const {
-  // In real implementation, read from RTC_DS3231
-  // For now, return dummy time
-  return DateTime(F(__DATE__), F(__TIME__));
+  if (!timeInitialized) {
+    return DateTime();  // 2000-01-01 - fails isTimeValid()
+  }
+  
+  uint32_t unixNow = clock.unixTime(clockMicros());
+  if (unixNow != cachedUnix) {
+    cachedUnix = unixNow;
+    cachedTime = DateTime(unixNow);
+  }
+  return cachedTime;
+}
+
+uint32_t TimeManager::getUnixTime() const {
+  return timeInitialized ? clock.unixTime(clockMicros()) : 0;
 }
 
 bool TimeManager::setTime(DateTime newTime) {
-  Serial.print("[TimeManager] Setting time to: ");
-  Serial.print(newTime.year());
-  Serial.print("-");
-  if (newTime.month() < 10) Serial.print("0");
-  Serial.print(newTime.month());
-  Serial.print("-");
-  if (newTime.day() < 10) Serial.print("0");
-  Serial.print(newTime.day());
-  Serial.print(" ");
-  if (newTime.hour() < 10) Serial.print("0");
-  Serial.print(newTime.hour());
-  Serial.print(":");
-  if (newTime.minute() < 10) Serial.print("0");
-  Serial.print(newTime.minute());
-  Serial.print(":");
-  if (newTime.second() < 10) Serial.print("0");
-  Serial.println(newTime.second());
-  
-  // Update RTC (would call rtc.adjust(newTime) in real code)
+  LOG_INFO(TIME, "Setting time to: %04u-%02u-%02u %02u:%02u:%02u",
+           newTime.year(), newTime.month(), newTime.day(), newTime.hour(), newTime.minute(), newTime.second());
+  
+  if (!rtcAvailable) {
+    LOG_ERROR(TIME, "RTC not available");
+    return false;
+  }
+  
+  {
+    I2C::Transaction bus(RTC_ADDRESS);
+    rtc.adjust(newTime);
+  }
+  clock.set(newTime.unixtime(), clockMicros());
+  timeInitialized = true;
   lastRecordedTime = newTime;
   
   return true;
 }
 
+void TimeManager::setResyncInterval(unsigned long intervalMs) {
+  if (intervalMs >= SoftClock::MIN_RESYNC_MS && intervalMs <= SoftClock::MAX_RESYNC_MS) {
+    clock.setResyncInterval(intervalMs);
+    LOG_INFO(TIME, "RTC resync interval set to %lu", intervalMs);
+  }
+}
+
 bool TimeManager::hasHourChanged() const {
   DateTime now = getCurrentTime();
   return now.hour() != lastTrackedHour;
@@ -219,10 +308,7 @@ void TimeManager::handleHourChange() {
   int newHour = now.hour();
   
   if (newHour != lastTrackedHour) {
-    Serial.print("[TimeManager] Hour changed: ");
-    Serial.print(lastTrackedHour);
-    Serial.print(" → ");
-    Serial.println(newHour);
+    LOG_INFO(TIME, "Hour changed: %d → %d", lastTrackedHour, newHour);
     
     lastTrackedHour = newHour;
     lastRecordedTime = now;
@@ -277,27 +363,35 @@ StorageManager::StorageManager() {
   sdAvailable = false;
 }
 
+// Pre-allocated, empty session file renamed into place when a session ends
+static const char* SPARE_SESSION_FILE = "/Production_next.tmp";
+
+StorageManager& StorageManager::getInstance() {
+  static StorageManager instance;
+  return instance;
+}
+
 bool StorageManager::initialize() {
-  Serial.println("[StorageManager] Initializing SD card...");
+  LOG_INFO(STORAGE, "Initializing SD card...");
   
-  // This would initialize the SD card
-  // For now, just mark as available
-  sdAvailable = true;
+  // Card is mounted (with speed fallback) during hardware initialization
+  sdAvailable = ::sdAvailable;
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not mounted");
+    return false;
+  }
   
-  Serial.println("[StorageManager] SD card initialized");
+  LOG_INFO(STORAGE, "SD card initialized");
   return true;
 }
 
 bool StorageManager::writeFile(const char* filename, const char* data) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
-  Serial.print("[StorageManager] Writing to ");
-  Serial.print(filename);
-  Serial.print(" | Data: ");
-  Serial.println(data);
+  LOG_DEBUG(STORAGE, "Writing to %s | Data: %s", filename, data);
   
   // Would write to file using SD library
   return true;
@@ -305,15 +399,34 @@ bool StorageManager::writeFile(const char* filename, const char* data) {
 
 bool StorageManager::readFile(const char* filename, char* buffer, size_t maxSize) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
-  Serial.print("[StorageManager] Reading from ");
-  Serial.println(filename);
+  buffer[0] = '\0';
+  ReadCache& cache = ReadCache::getInstance();
+  
+  // Stop at the logical end - pre-allocated files carry padding
+  char head[PreallocLog::HEADER_SIZE];
+  size_t headBytes = cache.read(filename, 0, reinterpret_cast<uint8_t*>(head), sizeof(head));
+  uint32_t offset = 0;
+  uint32_t length = 0xFFFFFFFFu;
+  uint32_t headerLength = 0;
+  uint32_t capacity = 0;
+  if (headBytes == sizeof(head) && PreallocLog::parseHeader(head, headerLength, capacity)) {
+    offset = PreallocLog::HEADER_SIZE;
+    length = headerLength;
+  }
+  
+  size_t toRead = maxSize - 1;
+  if (toRead > length) toRead = length;
   
-  // Would read from file using SD library
-  buffer[0] = '\0';  // Empty buffer for now
+  size_t bytesRead = cache.read(filename, offset, reinterpret_cast<uint8_t*>(buffer), toRead);
+  buffer[bytesRead] = '\0';
+  if (headBytes == 0 && bytesRead == 0 && !SD.exists(filename)) {
+    LOG_ERROR(STORAGE, "Cannot open %s", filename);
+    return false;
+  }
   return true;
 }
 
@@ -323,21 +436,18 @@ bool StorageManager::fileExists(const char* filename) const {
   }
   
   // Would check if file exists
-  Serial.print("[StorageManager] Checking if ");
-  Serial.print(filename);
-  Serial.println(" exists...");
+  LOG_DEBUG(STORAGE, "Checking if %s exists...", filename);
   
   return true;
 }
 
 bool StorageManager::deleteFile(const char* filename) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
-  Serial.print("[StorageManager] Deleting ");
-  Serial.println(filename);
+  LOG_INFO(STORAGE, "Deleting %s", filename);
   
   // Would delete file using SD library
   return true;
@@ -345,315 +455,699 @@ bool StorageManager::deleteFile(const char* filename) {
 
 bool StorageManager::saveCount(const char* filename, int value) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
   char buffer[20];
   snprintf(buffer, sizeof(buffer), "%d", value);
   
-  Serial.print("[StorageManager] Saving count to ");
-  Serial.print(filename);
-  Serial.print(" | Value: ");
-  Serial.println(value);
+  LOG_DEBUG(STORAGE, "Saving count to %s | Value: %d", filename, value);
   
   return writeFile(filename, buffer);
 }
 
 int StorageManager::loadCount(const char* filename) const {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return 0;
   }
   
-  Serial.print("[StorageManager] Loading count from ");
-  Serial.println(filename);
+  LOG_DEBUG(STORAGE, "Loading count from %s", filename);
   
   // Would read and parse integer from file
   return 0;
 }
 
 bool StorageManager::saveProductionSession(const char* filename,
-                                          DateTime start, DateTime end, int count) {
+                                          DateTime start, DateTime end, int count,
+                                          uint32_t record) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
-  Serial.print("[StorageManager] Saving production session to ");
-  Serial.print(filename);
-  Serial.print(" | Count: ");
-  Serial.println(count);
+  char content[192];
+  int length = snprintf(content, sizeof(content),
+                        "=== PRODUCTION SESSION ===\n"
+                        "Production Started: %04d-%02d-%02d %02d:%02d:%02d\n"
+                        "Production Stopped: %04d-%02d-%02d %02d:%02d:%02d\n"
+                        "Production Count: %d\n",
+                        start.year(), start.month(), start.day(), start.hour(), start.minute(), start.second(),
+                        end.year(), end.month(), end.day(), end.hour(), end.minute(), end.second(),
+                        count);
+  if (record != 0) {
+    snprintf(content + length, sizeof(content) - length, "Production Record: %lu\n",
+             (unsigned long)record);
+  }
   
-  // Would format and write session data
-  return true;
-}
-
-bool StorageManager::saveDailyLog(const char* filename, const char* data) {
-  return writeFile(filename, data);
-}
-
-bool StorageManager::listFiles() {
-  if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+  if (SD.exists(filename)) {
+    SD.remove(filename);
+  }
+  
+  // Renaming the spare only rewrites its directory entry; its cluster is
+  // already allocated, so no FAT update happens while the session closes
+  bool renamed = SD.exists(SPARE_SESSION_FILE) && SD.rename(SPARE_SESSION_FILE, filename);
+  ReadCache::getInstance().invalidate(SPARE_SESSION_FILE, true);
+  ReadCache::getInstance().invalidate(filename, true);
+  if (!renamed &&
+      !PreallocLog::getInstance().create(filename, PreallocLog::SESSION_CAPACITY)) {
+    LOG_ERROR(STORAGE, "Cannot create %s", filename);
     return false;
   }
   
-  Serial.println("[StorageManager] Listing files...");
+  if (!PreallocLog::getInstance().append(filename, content)) {
+    return false;
+  }
   
-  // Would enumerate files on SD card
+  LOG_INFO(STORAGE, "Production session saved: %s", filename);
   return true;
 }
 
-bool StorageManager::searchFiles(const char* pattern) {
+bool StorageManager::saveDailyLog(const char* filename, const char* data) {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
+    LOG_ERROR(STORAGE, "SD card not available");
     return false;
   }
   
-  Serial.print("[StorageManager] Searching for files matching: ");
-  Serial.println(pattern);
-  
-  // Would search for matching files
-  return true;
+  // Creates the file at full size if prepareDailyLog() did not run today
+  return PreallocLog::getInstance().append(filename, data);
 }
 
-int StorageManager::countFiles() const {
+bool StorageManager::prepareDailyLog(const DateTime& day) {
   if (!sdAvailable) {
-    return 0;
+    return false;
   }
   
-  Serial.println("[StorageManager] Counting files...");
-  
-  // Would count files on SD card
-  return 0;
+  char filename[40];
+  formatDailyLogName(filename, sizeof(filename), day);
+  return PreallocLog::getInstance().create(filename, PreallocLog::DAILY_CAPACITY);
 }
 
-bool StorageManager::formatSD() {
+bool StorageManager::prepareSessionFile() {
   if (!sdAvailable) {
-    Serial.println("[StorageManager] ERROR: SD card not available");
     return false;
   }
-  
-  Serial.println("[StorageManager] WARNING: Formatting SD card (destructive operation)");
-  
-  // Would format SD card
-  return true;
+  return PreallocLog::getInstance().create(SPARE_SESSION_FILE, PreallocLog::SESSION_CAPACITY);
 }
 
-// ========================================
-// DISPLAY MANAGER IMPLEMENTATION
-// ========================================
-
-DisplayManager::DisplayManager() {
-  displayDirty = true;
-  lastRefresh = 0;
-  refreshRate = 100;  // 100ms default
+bool StorageManager::isSessionFilePrepared() const {
+  return sdAvailable && SD.exists(SPARE_SESSION_FILE);
 }
 
-bool DisplayManager::initialize() {
-  Serial.println("[DisplayManager] Initializing OLED display...");
-  
-  // Would initialize display
-  displayDirty = true;
-  
-  Serial.println("[DisplayManager] OLED display initialized");
-  return true;
+void StorageManager::formatDailyLogName(char* buffer, size_t size, const DateTime& day) {
+  // DailyProduction_2025-11-15.txt
+  snprintf(buffer, size, "/DailyProduction_%04d-%02d-%02d.txt",
+           day.year(), day.month(), day.day());
 }
 
-void DisplayManager::update() {
-  unsigned long now = millis();
-  
-  // Check if refresh is needed
-  if (!needsRefresh()) {
-    return;
-  }
-  
-  // Would update OLED display
-  lastRefresh = now;
-  displayDirty = false;
-}
-
-void DisplayManager::clear() {
-  Serial.println("[DisplayManager] Clearing display");
-  displayDirty = true;
+void StorageManager::formatSessionFileName(char* buffer, size_t size,
+                                           const DateTime& start, const DateTime& end) {
+  // Production_2025-11-15_14h30m-16h45m.txt
+  snprintf(buffer, size, "/Production_%04d-%02d-%02d_%02dh%02dm-%02dh%02dm.txt",
+           start.year(), start.month(), start.day(),
+           start.hour(), start.minute(), end.hour(), end.minute());
 }
 
-void DisplayManager::showMainScreen(int count, DateTime time, bool isProducing) {
-  Serial.print("[DisplayManager] Showing main screen | Count: ");
-  Serial.print(count);
-  Serial.print(" | Producing: ");
-  Serial.println(isProducing ? "YES" : "NO");
+// Case-insensitive substring match (empty pattern matches everything)
+static bool containsIgnoreCase(const char* text, const char* pattern) {
+  if (pattern == nullptr || pattern[0] == '\0') return true;
   
-  displayDirty = true;
+  size_t patternLen = strlen(pattern);
+  for (; *text; text++) {
+    if (strncasecmp(text, pattern, patternLen) == 0) return true;
+  }
+  return false;
 }
 
-void DisplayManager::showStatus(const char* message, unsigned long duration) {
-  Serial.print("[DisplayManager] Status: ");
-  Serial.print(message);
-  Serial.print(" (for ");
-  Serial.print(duration);
-  Serial.println("ms)");
-  
-  displayDirty = true;
+static bool matchesFilter(const char* name, const char* prefix, const char* pattern) {
+  if (prefix != nullptr && strncasecmp(name, prefix, strlen(prefix)) != 0) return false;
+  return containsIgnoreCase(name, pattern);
 }
 
-void DisplayManager::showError(const char* errorMessage) {
-  Serial.print("[DisplayManager] ERROR: ");
-  Serial.println(errorMessage);
-  
-  displayDirty = true;
+bool StorageManager::listFiles() {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  startOutput(OUTPUT_FILES);
+  return true;
 }
 
-void DisplayManager::showDiagnostics(const char* results) {
-  Serial.print("[DisplayManager] Diagnostics: ");
-  Serial.println(results);
-  
-  displayDirty = true;
+bool StorageManager::listProductionFiles() {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  startOutput(OUTPUT_PRODUCTION);
+  return true;
 }
 
-void DisplayManager::showInitializationScreen() {
-  Serial.println("[DisplayManager] Showing initialization screen");
-  displayDirty = true;
+bool StorageManager::searchFiles(const char* pattern) {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  startOutput(OUTPUT_SEARCH);
+  snprintf(output.pattern, sizeof(output.pattern), "%s", pattern);
+  return true;
 }
 
-void DisplayManager::showReadyScreen() {
-  Serial.println("[DisplayManager] Showing ready screen");
-  displayDirty = true;
+// Text start of a loose file: past its PreallocLog header, if it has one
+static uint32_t looseTextOffset(const char* path) {
+  char head[PreallocLog::HEADER_SIZE];
+  uint32_t capacity = 0;
+  uint32_t headerLength = 0;
+  if (ReadCache::getInstance().read(path, 0, reinterpret_cast<uint8_t*>(head), sizeof(head)) == sizeof(head) &&
+      PreallocLog::parseHeader(head, headerLength, capacity)) {
+    return PreallocLog::HEADER_SIZE;
+  }
+  return 0;
 }
 
-void DisplayManager::showProductionScreen(int count) {
-  Serial.print("[DisplayManager] Showing production screen | Count: ");
-  Serial.println(count);
+bool StorageManager::locateFile(const char* filename, FileLocation& location) {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  
+  snprintf(location.path, sizeof(location.path), "%s%s", (filename[0] == '/') ? "" : "/", filename);
+  memcpy(location.source, location.path, sizeof(location.source));
+  location.offset = 0;
+  location.length = 0;
+  location.archived = false;
+  location.crc = 0;
+  
+  // Loose file first, then the month's archive container
+  ReadCache& cache = ReadCache::getInstance();
+  ArchiveEntry entry;
   
-  displayDirty = true;
+  if (cache.stat(location.path, location.length)) {
+    location.offset = looseTextOffset(location.path);
+    return true;
+  }
+  if (SessionArchive::getInstance().findEntry(location.path, location.source,
+                                              sizeof(location.source), entry)) {
+    location.offset = entry.offset;
+    location.length = entry.length;
+    location.archived = true;
+    location.crc = entry.crc;
+    return true;
+  }
+  LOG_ERROR(STORAGE, "File not found: %s", location.path);
+  return false;
 }
 
-void DisplayManager::showDiagnosticScreen() {
-  Serial.println("[DisplayManager] Showing diagnostic screen");
-  displayDirty = true;
+struct FileVisitContext {
+  StorageManager::FileVisitor visitor;
+  void* context;
+};
+
+static void visitLooseFile(const char* name, uint32_t logicalSize, void* context) {
+  FileVisitContext* visit = static_cast<FileVisitContext*>(context);
+  visit->visitor(name, logicalSize, false, visit->context);
 }
 
-void DisplayManager::showErrorScreen(const char* message) {
-  Serial.print("[DisplayManager] Showing error screen: ");
-  Serial.println(message);
-  
-  displayDirty = true;
+static void visitArchivedEntry(const char* archivePath, const ArchiveEntry& entry, void* context) {
+  FileVisitContext* visit = static_cast<FileVisitContext*>(context);
+  visit->visitor(entry.name, entry.length, true, visit->context);
 }
 
-void DisplayManager::displayText(int x, int y, const char* text, int textSize) {
-  Serial.print("[DisplayManager] Text at (");
-  Serial.print(x);
-  Serial.print(",");
-  Serial.print(y);
-  Serial.print") size ");
-  Serial.print(textSize);
-  Serial.print(": ");
-  Serial.println(text);
+int StorageManager::forEachFile(FileVisitor visitor, void* context) {
+  if (!sdAvailable) {
+    return 0;
+  }
+  FileVisitContext visit = { visitor, context };
+  return ReadCache::getInstance().forEachFile(visitLooseFile, &visit) +
+         SessionArchive::getInstance().forEachEntry(visitArchivedEntry, &visit);
 }
 
-void DisplayManager::displayNumber(int x, int y, int value, int textSize) {
-  Serial.print("[DisplayManager] Number at (");
-  Serial.print(x);
-  Serial.print(",");
-  Serial.print(y);
-  Serial.print") size ");
-  Serial.print(textSize);
-  Serial.print(": ");
-  Serial.println(value);
+bool StorageManager::printFile(const char* filename) {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  startOutput(OUTPUT_FILE);
+  FileLocation& location = output.location;
+  snprintf(location.path, sizeof(location.path), "%s%s", (filename[0] == '/') ? "" : "/", filename);
+  memcpy(location.source, location.path, sizeof(location.source));
+  return true;
 }
 
-void DisplayManager::displayCentered(int y, const char* text, int textSize) {
-  Serial.print("[DisplayManager] Centered at Y=");
-  Serial.print(y);
-  Serial.print(" size ");
-  Serial.print(textSize);
-  Serial.print(": ");
-  Serial.println(text);
+// ========================================
+// SERIAL FILE OUTPUT
+// ========================================
+// READ: "=== name (N bytes) ===", then "<n> | <line>" per line (cut to
+// 127 characters). LS/PROD/SEARCH: a header, "  <n>. name (N bytes)" per
+// loose file, then the entries of every archive container with the
+// container's name appended, then the total. Same pacing as the TRACE
+// dump: a line is written only while it fits below half the TX ring.
+// Each pass also stops after OUTPUT_STEPS_PER_PASS steps - a listing
+// entry or file chunk read through ReadCache - so entries SEARCH skips or
+// a line without '\n' cannot keep the loop walking the card.
+
+void StorageManager::startOutput(OutputKind kind) {
+  if (output.kind != OUTPUT_IDLE) {
+    Console.println(">> Previous output stopped");
+    endOutput();
+  }
+  memset(&output, 0, sizeof(output));
+  output.kind = kind;
 }
 
-void DisplayManager::displayLine(int y) {
-  Serial.print("[DisplayManager] Line at Y=");
-  Serial.println(y);
+void StorageManager::endOutput() {
+  output.kind = OUTPUT_IDLE;
+  ReadCache::getInstance().endWalk();
 }
 
-void DisplayManager::setBrightness(uint8_t level) {
-  Serial.print("[DisplayManager] Setting brightness to ");
-  Serial.println(level);
+void StorageManager::serviceOutput() {
+  if (output.kind == OUTPUT_FILE) {
+    serviceFileOutput();
+  } else if (output.kind != OUTPUT_IDLE) {
+    serviceListingOutput();
+  }
 }
 
-void DisplayManager::setRefreshRate(unsigned long rateMs) {
-  refreshRate = rateMs;
-  Serial.print("[DisplayManager] Setting refresh rate to ");
-  Serial.print(rateMs);
-  Serial.println("ms");
+// One step of finding the READ file: the next loose file in listing
+// order, then the next entry of its month's archive container. False once
+// the file is known not to exist (job ended).
+bool StorageManager::locateStep() {
+  FileLocation& location = output.location;
+  const char* wanted = location.path + 1;
+  char name[64];
+  uint32_t length = 0;
+  ArchiveEntry entry;
+  
+  if (!output.looseListed) {
+    if (!ReadCache::getInstance().fileAt(output.fileIndex++, name, sizeof(name), length)) {
+      output.looseListed = true;
+      char monthKey[8];
+      if (SessionArchive::sessionMonth(wanted, monthKey)) {
+        SessionArchive::formatArchivePath(output.archive, sizeof(output.archive), monthKey);
+      }
+    } else if (strcasecmp(name, wanted) == 0) {
+      location.length = length;
+      location.offset = looseTextOffset(location.path);
+      output.located = true;
+    }
+    return true;
+  }
+  
+  if (output.archive[0] != '\0' &&
+      SessionArchive::getInstance().entryAt(output.archive, output.entryIndex++, entry)) {
+    if (strcasecmp(entry.name, wanted) == 0) {
+      memcpy(location.source, output.archive, sizeof(location.source));
+      location.offset = entry.offset;
+      location.length = entry.length;
+      location.archived = true;
+      location.crc = entry.crc;
+      output.located = true;
+    }
+    return true;
+  }
+  
+  LOG_ERROR(STORAGE, "File not found: %s", location.path);
+  endOutput();
+  return false;
 }
 
-bool DisplayManager::needsRefresh() const {
-  return (millis() - lastRefresh > refreshRate) || displayDirty;
+void StorageManager::serviceFileOutput() {
+  const FileLocation& location = output.location;
+  ReadCache& cache = ReadCache::getInstance();
+  char text[sizeof(output.line) + 16];
+  
+  for (uint8_t step = 0; step < OUTPUT_STEPS_PER_PASS &&
+       Console.getUsed() + sizeof(text) <= SerialOut::RING_SIZE / 2; step++) {
+    if (!output.located) {
+      if (!locateStep()) {
+        return;
+      }
+      continue;
+    }
+    if (!output.begun) {
+      snprintf(text, sizeof(text), "=== %s (%lu bytes) ===\r\n", location.path + 1,
+               (unsigned long)location.length);
+      Console.print(text);
+      output.begun = true;
+      continue;
+    }
+    if (output.position >= location.length) {
+      endOutput();
+      return;
+    }
+    
+    // Take bytes up to the end of the line (or of the text)
+    uint8_t chunk[64];
+    uint32_t remaining = location.length - output.position;
+    size_t want = (remaining < sizeof(chunk)) ? remaining : sizeof(chunk);
+    size_t got = cache.read(location.source, location.offset + output.position, chunk, want);
+    if (got == 0) {
+      endOutput();
+      return;
+    }
+    
+    size_t used = 0;
+    bool complete = false;
+    while (used < got && !complete) {
+      char c = (char)chunk[used++];
+      if (c != '\n' && output.lineLength < sizeof(output.line) - 1) {
+        output.line[output.lineLength++] = c;
+      }
+      complete = (c == '\n' || output.position + used == location.length);
+    }
+    output.position += used;
+    if (!complete) {
+      continue;
+    }
+    
+    output.line[output.lineLength] = '\0';
+    snprintf(text, sizeof(text), "%d | %s\r\n", ++output.lineNumber, output.line);
+    Console.print(text);
+    output.lineLength = 0;
+  }
 }
 
-void DisplayManager::markDirty() {
-  displayDirty = true;
+void StorageManager::serviceListingOutput() {
+  ReadCache& cache = ReadCache::getInstance();
+  SessionArchive& archive = SessionArchive::getInstance();
+  const char* prefix = (output.kind == OUTPUT_PRODUCTION) ? "Production_" : nullptr;
+  const char* pattern = (output.kind == OUTPUT_SEARCH) ? output.pattern : nullptr;
+  char name[64];
+  char text[sizeof(name) + sizeof(output.archive) + 32];
+  
+  for (uint8_t step = 0; step < OUTPUT_STEPS_PER_PASS &&
+       Console.getUsed() + sizeof(text) <= SerialOut::RING_SIZE / 2; step++) {
+    uint32_t length = 0;
+    ArchiveEntry entry;
+    text[0] = '\0';
+    
+    if (!output.begun) {
+      if (output.kind == OUTPUT_FILES) {
+        snprintf(text, sizeof(text), "=== FILES ON SD CARD ===\r\n");
+      } else if (output.kind == OUTPUT_PRODUCTION) {
+        snprintf(text, sizeof(text), "=== PRODUCTION SESSION FILES ===\r\n");
+      } else {
+        snprintf(text, sizeof(text), "=== SEARCH: %s ===\r\n", output.pattern);
+      }
+      output.begun = true;
+    } else if (!output.looseListed) {
+      // Loose files, in listing order
+      if (!cache.fileAt(output.fileIndex, name, sizeof(name), length)) {
+        output.looseListed = true;
+      } else {
+        output.fileIndex++;
+        if (matchesFilter(name, prefix, pattern)) {
+          snprintf(text, sizeof(text), "  %d. %s (%lu bytes)\r\n", ++output.count, name,
+                   (unsigned long)length);
+        }
+      }
+    } else if (output.archive[0] != '\0') {
+      // Entries of the current container
+      if (!archive.entryAt(output.archive, output.entryIndex++, entry)) {
+        output.archive[0] = '\0';
+      } else if (matchesFilter(entry.name, prefix, pattern)) {
+        snprintf(text, sizeof(text), "  %d. %s (%lu bytes) [%s]\r\n", ++output.count, entry.name,
+                 (unsigned long)entry.length, output.archive + 1);
+      }
+    } else if (cache.fileAt(output.containerIndex++, name, sizeof(name), length)) {
+      // Next archive container among the loose files
+      if (SessionArchive::isArchiveName(name)) {
+        snprintf(output.archive, sizeof(output.archive), "/%s", name);
+        output.entryIndex = 0;
+      }
+    } else {
+      if (output.kind == OUTPUT_FILES) {
+        snprintf(text, sizeof(text), "Total files: %d\r\n", output.count);
+      } else if (output.kind == OUTPUT_PRODUCTION) {
+        snprintf(text, sizeof(text), "Total production files: %d\r\n", output.count);
+      } else {
+        snprintf(text, sizeof(text), "Found: %d file(s)\r\n", output.count);
+      }
+      Console.print(text);
+      endOutput();
+      return;
+    }
+    
+    if (text[0] != '\0') {
+      Console.print(text);
+    }
+  }
 }
 
-void DisplayManager::markClean() {
-  displayDirty = false;
+int StorageManager::countFiles() const {
+  if (!sdAvailable) {
+    return 0;
+  }
+  
+  int count = 0;
+  File root = SD.open("/");
+  if (root) {
+    File file = root.openNextFile();
+    while (file) {
+      if (!file.isDirectory()) count++;
+      file.close();
+      file = root.openNextFile();
+    }
+    root.close();
+  }
+  return count;
 }
 
-void DisplayManager::drawProgressBar(int y, int value, int maxValue) {
-  Serial.print("[DisplayManager] Progress bar at Y=");
-  Serial.print(y);
-  Serial.print(" | ");
-  Serial.print(value);
-  Serial.print("/");
-  Serial.println(maxValue);
+bool StorageManager::formatSD() {
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+  
+  LOG_WARN(STORAGE, "Formatting SD card (destructive operation)");
+  
+  // Would format SD card
+  return true;
 }
 
 // ========================================
 // LOGGER MANAGER IMPLEMENTATION
 // ========================================
 
-LoggerManager::LogLevel LoggerManager::currentLevel = LoggerManager::INFO;
+volatile uint8_t LoggerManager::moduleLevels[MODULE_COUNT] = {
+  INFO, INFO, INFO, INFO, INFO, INFO, INFO
+};
 bool LoggerManager::fileLoggingEnabled = false;
+volatile bool LoggerManager::deferredMode = true;
+volatile LoggerManager::Output LoggerManager::outputMode = LoggerManager::OUTPUT_TEXT;
+LogRing LoggerManager::ring;
+void* LoggerManager::drainTask = nullptr;
+LoggerManager::RecentMessage LoggerManager::recent[RATE_SLOTS] = {};
+uint32_t LoggerManager::coalesced = 0;
+
+// Rate limiter table; both cores log
+static portMUX_TYPE rateMux = portMUX_INITIALIZER_UNLOCKED;
+
+// First record of a binary stream; the decoder prints it like any other
+static const char* const LOG_STREAM_BANNER = "Binary log stream (build %s %s)";
+
+// Summary of a coalesced message (its format string, cut to LogRing::MAX_STRING)
+static const char* const LOG_REPEAT_FORMAT = "Repeated %lu times in %lu ms: %s";
+
+// LEVEL command names, LoggerManager::Module order
+static const char* const MODULE_KEYS[] = {
+  "SYSTEM", "FSM", "STORAGE", "DISPLAY", "TIME", "PRODUCTION", "CONFIG"
+};
+static_assert(sizeof(MODULE_KEYS) / sizeof(MODULE_KEYS[0]) == LoggerManager::MODULE_COUNT,
+              "One name per module");
 
 void LoggerManager::initialize(LogLevel level) {
-  currentLevel = level;
-  Serial.println("[LoggerManager] Logger initialized");
+  for (uint8_t i = 0; i < MODULE_COUNT; i++) {
+    moduleLevels[i] = level;
+  }
+  
+  if (drainTask == nullptr) {
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(drainTaskEntry, "log", DRAIN_STACK, nullptr, DRAIN_PRIORITY,
+                                &handle, DRAIN_CORE) != pdPASS) {
+      Console.println("[LoggerManager] ERROR: Cannot start drain task - logging immediately");
+      deferredMode = false;
+    } else {
+      drainTask = handle;
+    }
+  }
+  Console.println("[LoggerManager] Logger initialized");
 }
 
-void LoggerManager::debug(const char* format, ...) {
-  if (currentLevel > DEBUG) return;
-  
-  Serial.print("[DEBUG] ");
-  // In real implementation, would format with va_args
-  Serial.println(format);
+uint32_t LoggerManager::timestamp() {
+  return (uint32_t)esp_timer_get_time();
 }
 
-void LoggerManager::info(const char* format, ...) {
-  if (currentLevel > INFO) return;
+// Same format, argument values, level and module within RATE_WINDOW_MS:
+// count, don't log. The timestamp is not part of the hash, so only a
+// message identical to the one printed is counted
+bool LoggerManager::admit(const char* format, const uint8_t* record, size_t size) {
+  uint32_t now = millis();
+  uint8_t levelByte = record[1];
+  uint32_t argsHash = 2166136261u;
+  argsHash = (argsHash ^ record[2]) * 16777619u;  // argc
+  for (size_t i = LogRing::HEADER_SIZE; i < size; i++) {
+    argsHash = (argsHash ^ record[i]) * 16777619u;
+  }
+  RecentMessage closed = {};
+  bool admitted = true;
+  
+  portENTER_CRITICAL(&rateMux);
+  RecentMessage* slot = nullptr;
+  RecentMessage* oldest = &recent[0];
+  for (uint8_t i = 0; i < RATE_SLOTS; i++) {
+    if (recent[i].format == format && recent[i].argsHash == argsHash &&
+        recent[i].level == levelByte) {
+      slot = &recent[i];
+      break;
+    }
+    // Reuse an empty slot, else the one with the oldest window
+    if (oldest->format != nullptr &&
+        (recent[i].format == nullptr || (int32_t)(recent[i].windowStartMs - oldest->windowStartMs) < 0)) {
+      oldest = &recent[i];
+    }
+  }
   
-  Serial.print("[INFO] ");
-  Serial.println(format);
+  if (slot != nullptr && now - slot->windowStartMs < RATE_WINDOW_MS) {
+    slot->repeats++;
+    coalesced++;
+    admitted = false;
+  } else {
+    if (slot == nullptr) {
+      slot = oldest;
+    }
+    closed = *slot;  // Report what the slot counted before reusing it
+    slot->format = format;
+    slot->argsHash = argsHash;
+    slot->level = levelByte;
+    slot->windowStartMs = now;
+    slot->repeats = 0;
+  }
+  portEXIT_CRITICAL(&rateMux);
+  
+  if (closed.repeats > 0) {
+    reportRepeats(closed, now);
+  }
+  return admitted;
+}
+
+void LoggerManager::reportRepeats(const RecentMessage& message, uint32_t nowMs) {
+  uint8_t record[LogRing::MAX_RECORD];
+  size_t size = LogRing::encode(record, message.level, LOG_REPEAT_FORMAT, timestamp(),
+                                (unsigned long)message.repeats,
+                                (unsigned long)(nowMs - message.windowStartMs), message.format);
+  emit(record, size);
+}
+
+// Report repeats whose window has closed (drain task), so a burst that
+// stops is still accounted for
+void LoggerManager::flushRepeats() {
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < RATE_SLOTS; i++) {
+    RecentMessage closed = {};
+    portENTER_CRITICAL(&rateMux);
+    if (recent[i].repeats > 0 && now - recent[i].windowStartMs >= RATE_WINDOW_MS) {
+      closed = recent[i];
+      recent[i].repeats = 0;
+    }
+    portEXIT_CRITICAL(&rateMux);
+    
+    if (closed.repeats > 0) {
+      reportRepeats(closed, now);
+    }
+  }
 }
 
-void LoggerManager::warn(const char* format, ...) {
-  if (currentLevel > WARN) return;
+void LoggerManager::emit(const uint8_t* record, size_t size) {
+  if ((record[1] & LogRing::LEVEL_MASK) == FATAL) {
+    flush();  // Keep the order, then print before anything can go wrong
+    output(record, size);
+    Console.flush();
+    return;
+  }
+  if (deferredMode) {
+    ring.push(record, size);  // Full ring: dropped, reported by the drain
+    return;
+  }
+  output(record, size);
+}
+
+void LoggerManager::output(const uint8_t* record, size_t size) {
+  if (outputMode == OUTPUT_BINARY) {
+    uint8_t frame[LogRing::MAX_FRAME];
+    Console.write(frame, LogRing::frame(record, size, frame));
+    return;
+  }
   
-  Serial.print("[WARN] ");
-  Serial.println(format);
+  LogRing::Record parsed;
+  if (!LogRing::parse(record, size, parsed)) {
+    return;
+  }
+  char text[160];
+  LogRing::render(parsed, reinterpret_cast<const char*>((uintptr_t)parsed.formatId),
+                  text, sizeof(text));
+  Console.print("[");
+  Console.print(LogRing::levelName(parsed.level));
+  Console.print("] ");
+  const char* module = LogRing::moduleName(parsed.module);
+  if (module != nullptr) {
+    Console.print("[");
+    Console.print(module);
+    Console.print("] ");
+  }
+  Console.println(text);
 }
 
-void LoggerManager::error(const char* format, ...) {
-  if (currentLevel > ERROR) return;
+void LoggerManager::drain() {
+  static uint32_t droppedReported = 0;
+  uint8_t record[LogRing::MAX_RECORD];
+  size_t size;
+  while ((size = ring.pop(record)) > 0) {
+    output(record, size);
+  }
   
-  Serial.print("[ERROR] ");
-  Serial.println(format);
+  uint32_t dropped = ring.getDropped();
+  if (dropped != droppedReported) {
+    size = LogRing::encode(record, WARN, "Log ring full - %lu records dropped", timestamp(),
+                           (unsigned long)(dropped - droppedReported));
+    output(record, size);
+    droppedReported = dropped;
+  }
+}
+
+void LoggerManager::drainTaskEntry(void* parameter) {
+  (void)parameter;
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL_MS));
+    flushRepeats();
+    drain();
+    Console.pump();   // Also keeps serial output moving while loop() is busy
+  }
+}
+
+void LoggerManager::flush() {
+  drain();
 }
 
-void LoggerManager::fatal(const char* format, ...) {
-  Serial.print("[FATAL] ");
-  Serial.println(format);
+void LoggerManager::setDeferred(bool deferred) {
+  if (deferred && drainTask == nullptr) {
+    Console.println("[LoggerManager] ERROR: No drain task - staying immediate");
+    return;
+  }
+  if (!deferred) {
+    flush();
+  }
+  deferredMode = deferred;
+  Console.print("[LoggerManager] Logging ");
+  Console.println(deferred ? "deferred" : "immediate");
+}
+
+void LoggerManager::setOutput(Output output) {
+  flush();  // Records queued so far keep the old format
+  outputMode = output;
+  if (output == OUTPUT_BINARY) {
+    info(LOG_STREAM_BANNER, __DATE__, __TIME__);
+  }
 }
 
 void LoggerManager::logToFile(const char* filename, const char* message) {
@@ -661,22 +1155,59 @@ void LoggerManager::logToFile(const char* filename, const char* message) {
     return;
   }
   
-  Serial.print("[LoggerManager] Logging to ");
-  Serial.print(filename);
-  Serial.print(": ");
-  Serial.println(message);
+  Console.print("[LoggerManager] Logging to ");
+  Console.print(filename);
+  Console.print(": ");
+  Console.println(message);
 }
 
 void LoggerManager::setLogLevel(LogLevel level) {
-  currentLevel = level;
-  Serial.print("[LoggerManager] Log level set to ");
-  Serial.println(logLevelName(level));
+  for (uint8_t i = 0; i < MODULE_COUNT; i++) {
+    moduleLevels[i] = level;
+  }
+  Console.print("[LoggerManager] Log level set to ");
+  Console.println(logLevelName(level));
+}
+
+void LoggerManager::setModuleLevel(Module module, LogLevel level) {
+  if (module >= MODULE_COUNT) {
+    return;
+  }
+  moduleLevels[module] = level;
+  Console.print("[LoggerManager] ");
+  Console.print(MODULE_KEYS[module]);
+  Console.print(" log level set to ");
+  Console.println(logLevelName(level));
+}
+
+bool LoggerManager::parseModule(const char* name, Module& module) {
+  for (uint8_t i = 0; i < MODULE_COUNT; i++) {
+    if (strcasecmp(name, MODULE_KEYS[i]) == 0) {
+      module = (Module)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* LoggerManager::moduleKey(Module module) {
+  return (module < MODULE_COUNT) ? MODULE_KEYS[module] : "UNKNOWN";
+}
+
+bool LoggerManager::parseLevel(const char* name, LogLevel& level) {
+  for (int i = DEBUG; i <= FATAL; i++) {
+    if (strcasecmp(name, logLevelName((LogLevel)i)) == 0) {
+      level = (LogLevel)i;
+      return true;
+    }
+  }
+  return false;
 }
 
 void LoggerManager::enableFileLogging(bool enable) {
   fileLoggingEnabled = enable;
-  Serial.print("[LoggerManager] File logging ");
-  Serial.println(enable ? "enabled" : "disabled");
+  Console.print("[LoggerManager] File logging ");
+  Console.println(enable ? "enabled" : "disabled");
 }
 
 const char* LoggerManager::logLevelName(LogLevel level) {
@@ -694,98 +1225,240 @@ const char* LoggerManager::logLevelName(LogLevel level) {
 // CONFIG MANAGER IMPLEMENTATION
 // ========================================
 
+// code_v3 opened the Arduino EEPROM with this size
+static const size_t LEGACY_EEPROM_SIZE = 512;
+
+// Snapshot swap; the loop task publishes, other tasks may read
+static portMUX_TYPE configMux = portMUX_INITIALIZER_UNLOCKED;
+
 ConfigManager::ConfigManager() {
-  settings.saveInterval = 5000;
-  settings.debounceDelay = 50;
-  settings.maxCount = 9999;
-  settings.statusDisplayDuration = 3000;
+  snapshots[0].settings = fromPayload(ConfigBlob::defaults());
+  snapshots[0].version = 0;
+}
+
+ConfigManager& ConfigManager::getInstance() {
+  static ConfigManager instance;
+  return instance;
 }
 
 bool ConfigManager::initialize() {
-  Serial.println("[ConfigManager] Loading configuration...");
+  LOG_INFO(CONFIG, "Loading configuration...");
   
   return loadFromEEPROM();
 }
 
+void ConfigManager::publish(const Settings& next) {
+  // The spare snapshot is complete before the swap makes it visible
+  Snapshot* spare = (active == &snapshots[0]) ? &snapshots[1] : &snapshots[0];
+  spare->settings = next;
+  spare->version = active->version + 1;
+  portENTER_CRITICAL(&configMux);
+  active = spare;
+  portEXIT_CRITICAL(&configMux);
+  
+  for (uint8_t i = 0; i < subscriberCount; i++) {
+    subscribers[i](*spare);
+  }
+}
+
+bool ConfigManager::subscribe(Subscriber subscriber) {
+  if (subscriberCount >= MAX_SUBSCRIBERS) {
+    LOG_ERROR(CONFIG, "Subscriber table full");
+    return false;
+  }
+  subscribers[subscriberCount++] = subscriber;
+  subscriber(*active);
+  return true;
+}
+
 bool ConfigManager::setSettings(const Settings& newSettings) {
-  if (!validateSettings()) {
-    Serial.println("[ConfigManager] ERROR: Invalid settings");
+  if (!validate(newSettings)) {
+    LOG_ERROR(CONFIG, "Invalid settings");
     return false;
   }
   
-  settings = newSettings;
-  Serial.println("[ConfigManager] Settings updated");
+  publish(newSettings);
+  LOG_INFO(CONFIG, "Settings updated | Snapshot %lu", (unsigned long)active->version);
   
   return saveToEEPROM();
 }
 
 void ConfigManager::setSaveInterval(unsigned long interval) {
-  if (interval >= 1000 && interval <= 60000) {
-    settings.saveInterval = interval;
-    Serial.print("[ConfigManager] Save interval set to ");
-    Serial.println(interval);
+  Settings next = active->settings;
+  next.saveInterval = interval;
+  if (validate(next)) {
+    publish(next);
+    LOG_INFO(CONFIG, "Save interval set to %lu", interval);
   }
 }
 
 void ConfigManager::setDebounceDelay(unsigned long delay) {
-  if (delay >= 10 && delay <= 500) {
-    settings.debounceDelay = delay;
-    Serial.print("[ConfigManager] Debounce delay set to ");
-    Serial.println(delay);
+  Settings next = active->settings;
+  next.debounceDelay = delay;
+  if (validate(next)) {
+    publish(next);
+    LOG_INFO(CONFIG, "Debounce delay set to %lu", delay);
   }
 }
 
 void ConfigManager::setMaxCount(int maxCount) {
-  if (maxCount >= 100 && maxCount <= 99999) {
-    settings.maxCount = maxCount;
-    Serial.print("[ConfigManager] Max count set to ");
-    Serial.println(maxCount);
+  Settings next = active->settings;
+  next.maxCount = maxCount;
+  if (validate(next)) {
+    publish(next);
+    LOG_INFO(CONFIG, "Max count set to %d", maxCount);
   }
 }
 
 void ConfigManager::setStatusDisplayDuration(unsigned long duration) {
-  if (duration >= 1000 && duration <= 10000) {
-    settings.statusDisplayDuration = duration;
-    Serial.print("[ConfigManager] Status display duration set to ");
-    Serial.println(duration);
+  Settings next = active->settings;
+  next.statusDisplayDuration = duration;
+  if (validate(next)) {
+    publish(next);
+    LOG_INFO(CONFIG, "Status display duration set to %lu", duration);
+  }
+}
+
+void ConfigManager::setDisplayRefresh(unsigned long refreshMs) {
+  Settings next = active->settings;
+  next.displayRefresh = refreshMs;
+  if (validate(next)) {
+    publish(next);
+    LOG_INFO(CONFIG, "Display refresh set to %lu", refreshMs);
   }
 }
 
+static bool readLegacySettings(ConfigBlob::Payload& values, bool& clamped) {
+  uint8_t bytes[ConfigBlob::LEGACY_SIZE];
+  if (!EEPROM.begin(LEGACY_EEPROM_SIZE)) {
+    return false;
+  }
+  EEPROM.readBytes(0, bytes, sizeof(bytes));
+  EEPROM.end();
+  return ConfigBlob::parseLegacy(bytes, sizeof(bytes), values, clamped);
+}
+
 bool ConfigManager::loadFromEEPROM() {
-  Serial.println("[ConfigManager] Loading settings from EEPROM");
+  if (EEPROM_HAL::getSize() < CheckpointRing::EEPROM_SIZE &&
+      !EEPROM_HAL::init(CheckpointRing::EEPROM_SIZE)) {
+    LOG_ERROR(CONFIG, "EEPROM unavailable - using defaults");
+    applyPayload(ConfigBlob::defaults());
+    source = SOURCE_DEFAULTS;
+    return false;
+  }
   
-  // Would read from EEPROM
-  // For now, use defaults
+  // Both copies in one read
+  uint8_t region[ConfigBlob::REGION_SIZE];
+  EEPROM_HAL::readBytes(ConfigBlob::REGION_ADDRESS, region, sizeof(region));
+  
+  ConfigBlob::Payload values;
+  ConfigBlob::Info info;
+  if (ConfigBlob::decode(region, values, info)) {
+    applyPayload(values);
+    source = SOURCE_BLOB;
+    sequence = info.sequence;
+    slot = info.slot;
+    LOG_INFO(CONFIG, "Settings loaded | v%u | Seq: %lu | %u/%u copies valid", info.version,
+             sequence, info.validCopies, (unsigned)ConfigBlob::SLOT_COUNT);
+    if (info.clamped) {
+      LOG_WARN(CONFIG, "Out-of-range settings replaced by defaults");
+    }
+    // Older schema or repaired values: rewrite in the current layout. A
+    // newer schema is left as is (its extra fields would be lost)
+    if (info.version < ConfigBlob::VERSION || info.size < sizeof(ConfigBlob::Payload) || info.clamped) {
+      return saveToEEPROM();
+    }
+    return true;
+  }
   
-  return true;
+  sequence = 0;
+  slot = -1;
+  bool clamped = false;
+  if (readLegacySettings(values, clamped)) {
+    // The legacy bytes are left alone, so the old firmware still boots
+    applyPayload(values);
+    source = SOURCE_LEGACY;
+    LOG_INFO(CONFIG, "Imported legacy settings");
+    if (clamped) {
+      LOG_WARN(CONFIG, "Out-of-range legacy settings replaced by defaults");
+    }
+  } else {
+    applyPayload(ConfigBlob::defaults());
+    source = SOURCE_DEFAULTS;
+    if (info.blank) {
+      LOG_INFO(CONFIG, "No saved settings - using defaults");
+    } else {
+      LOG_WARN(CONFIG, "Settings corrupted - using defaults");
+    }
+  }
+  return saveToEEPROM();
 }
 
 bool ConfigManager::saveToEEPROM() {
-  Serial.println("[ConfigManager] Saving settings to EEPROM");
+  if (EEPROM_HAL::getSize() < ConfigBlob::REGION_ADDRESS + ConfigBlob::REGION_SIZE) {
+    LOG_ERROR(CONFIG, "EEPROM unavailable - settings not saved");
+    return false;
+  }
   
-  // Would write to EEPROM
+  // Overwrite the older copy; the newer one survives a torn write
+  int8_t target = (slot < 0) ? 0 : (slot + 1) % ConfigBlob::SLOT_COUNT;
+  uint8_t copy[ConfigBlob::SLOT_SIZE];
+  ConfigBlob::encode(toPayload(active->settings), sequence + 1, copy);
+  EEPROM_HAL::writeBytes(ConfigBlob::slotAddress(target), copy, sizeof(copy));
+  if (!EEPROM_HAL::commit()) {
+    LOG_ERROR(CONFIG, "Settings commit failed");
+    return false;
+  }
   
+  sequence++;
+  slot = target;
+  LOG_INFO(CONFIG, "Settings saved | Seq: %lu | Copy %c", sequence, 'A' + target);
   return true;
 }
 
 void ConfigManager::resetToDefaults() {
-  Serial.println("[ConfigManager] Resetting to default settings");
+  LOG_INFO(CONFIG, "Resetting to default settings");
   
-  settings.saveInterval = 5000;
-  settings.debounceDelay = 50;
-  settings.maxCount = 9999;
-  settings.statusDisplayDuration = 3000;
+  applyPayload(ConfigBlob::defaults());
   
   saveToEEPROM();
 }
 
-bool ConfigManager::validateSettings() const {
-  return settings.saveInterval >= 1000 && settings.saveInterval <= 60000 &&
-         settings.debounceDelay >= 10 && settings.debounceDelay <= 500 &&
-         settings.maxCount >= 100 && settings.maxCount <= 99999 &&
-         settings.statusDisplayDuration >= 1000 && settings.statusDisplayDuration <= 10000;
+void ConfigManager::applyPayload(const ConfigBlob::Payload& values) {
+  publish(fromPayload(values));
+}
+
+ConfigManager::Settings ConfigManager::fromPayload(const ConfigBlob::Payload& values) {
+  Settings settings;
+  settings.saveInterval = values.saveIntervalMs;
+  settings.debounceDelay = values.debounceDelayMs;
+  settings.maxCount = values.maxCount;
+  settings.statusDisplayDuration = values.statusDisplayMs;
+  settings.displayRefresh = values.displayRefreshMs;
+  return settings;
+}
+
+ConfigBlob::Payload ConfigManager::toPayload(const Settings& settings) {
+  ConfigBlob::Payload values;
+  values.saveIntervalMs = settings.saveInterval;
+  values.debounceDelayMs = settings.debounceDelay;
+  values.maxCount = settings.maxCount;
+  values.statusDisplayMs = settings.statusDisplayDuration;
+  values.displayRefreshMs = settings.displayRefresh;
+  return values;
+}
+
+const char* ConfigManager::sourceName(Source source) {
+  switch (source) {
+    case SOURCE_BLOB: return "EEPROM";
+    case SOURCE_LEGACY: return "imported from code_v3";
+    case SOURCE_DEFAULTS: return "defaults";
+  }
+  return "unknown";
 }
 
-bool ConfigManager::isValid() const {
-  return validateSettings();
+bool ConfigManager::validate(const Settings& settings) {
+  // Same ranges the blob loader enforces
+  ConfigBlob::Payload values = toPayload(settings);
+  return ConfigBlob::sanitize(values);
 }
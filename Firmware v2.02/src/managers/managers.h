@@ -3,12 +3,23 @@
 
 #include <Arduino.h>
 #include <RTClib.h>
+#include "soft_clock.h"
+#include "log_ring.h"
+#include "config_blob.h"
+#include "rate_meter.h"
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 1   // Build-time floor: 0 DEBUG, 1 INFO, 2 WARN, 3 ERROR
+#endif
 
 // ========================================
 // PRODUCTION MANAGER
 // ========================================
 class ProductionManager {
 public:
+  ProductionManager();
+  static ProductionManager& getInstance();
+  
   // Session control
   bool startSession();
   bool stopSession();
@@ -19,11 +30,18 @@ public:
   int getSessionCount() const;
   int getTotalSessionCount() const { return totalSessionCount; }
   
-  // Session info
+  // Session info: times from TimeManager::getCurrentTime(), so they never
+  // touch the I2C bus (RTC reads are the soft clock's, via the arbiter)
   DateTime getStartTime() const { return sessionStartTime; }
   DateTime getStopTime() const { return sessionStopTime; }
   unsigned long getSessionDuration() const;
   
+  // Throughput (see rate_meter.h): updateRates() every loop pass, cheap
+  // until a 5 s bucket ends. Rates stay at the last session's values
+  // after it stops.
+  void updateRates(uint32_t nowMs);
+  const RateMeter::Rates& getRates() const { return rates.getRates(); }
+  
   // File management
   bool saveSessionToFile();
   bool loadSessionFromFile();
@@ -42,6 +60,8 @@ private:
   DateTime sessionStopTime;
   
   int startingCountValue = 0;
+  
+  RateMeter rates;
 };
 
 // ========================================
@@ -49,13 +69,26 @@ private:
 // ========================================
 class TimeManager {
 public:
-  // Initialization
+  static const uint8_t RTC_ADDRESS = 0x68;   // DS3231
+  
+  TimeManager();
+  static TimeManager& getInstance();
+  
+  // Initialization (after rtc.begin(); captures the first RTC edge, <= 1.5 s)
   bool initialize();
   
-  // Time operations
+  // Keep the software clock disciplined - call every loop pass
+  void update();
+  
+  // Time operations (software clock, no I2C traffic)
   DateTime getCurrentTime() const;
+  uint32_t getUnixTime() const;
   bool setTime(DateTime newTime);
   
+  // RTC resync cadence
+  void setResyncInterval(unsigned long intervalMs);
+  unsigned long getResyncInterval() const { return clock.getResyncInterval(); }
+  
   // Hour tracking
   bool hasHourChanged() const;
   int getCurrentHour() const;
@@ -70,11 +103,18 @@ public:
   
   // Diagnostics
   const char* getTimeString(bool includeSeconds = true) const;
+  const SoftClock& getClock() const { return clock; }
   
 private:
   int lastTrackedHour = -1;
   DateTime lastRecordedTime;
   bool timeInitialized = false;
+  
+  SoftClock clock;
+  
+  // getCurrentTime() converts once per second
+  mutable uint32_t cachedUnix = 0;
+  mutable DateTime cachedTime;
 };
 
 // ========================================
@@ -82,6 +122,26 @@ private:
 // ========================================
 class StorageManager {
 public:
+  // Where a file's text lives: a loose file (past its PreallocLog header,
+  // if any) or a span of a monthly archive container
+  struct FileLocation {
+    char path[48];                 // "/name" as asked for
+    char source[48];               // File to read (the container if archived)
+    uint32_t offset;               // Text start in source
+    uint32_t length;               // Text bytes
+    bool archived;
+    uint32_t crc;                  // CRC32 of the text (archived only, else 0)
+  };
+  
+  // Called for every loose and archived file (LS order)
+  typedef void (*FileVisitor)(const char* name, uint32_t length, bool archived, void* context);
+  
+  static const uint8_t OUTPUT_STEPS_PER_PASS = 16;
+  
+
+  StorageManager();
+  static StorageManager& getInstance();
+  
   // Initialization
   bool initialize();
   bool isAvailable() const { return sdAvailable; }
@@ -97,34 +157,139 @@ public:
   int loadCount(const char* filename) const;
   
   // Production file operations
+  // record: its RecordJournal sequence number, 0 if it has none
   bool saveProductionSession(const char* filename, 
-                             DateTime start, DateTime end, int count);
+                             DateTime start, DateTime end, int count, uint32_t record = 0);
   bool saveDailyLog(const char* filename, const char* data);
   
-  // Directory operations
+  // Pre-allocation (see prealloc_log.h) - call while idle, not mid-count
+  bool prepareDailyLog(const DateTime& day);
+  bool prepareSessionFile();
+  bool isSessionFilePrepared() const;
+  static void formatDailyLogName(char* buffer, size_t size, const DateTime& day);
+  static void formatSessionFileName(char* buffer, size_t size,
+                                    const DateTime& start, const DateTime& end);
+  
+  // Directory operations (loose files and monthly archives). LS, PROD,
+  // SEARCH and READ only start an output job and touch no file;
+  // serviceOutput() runs it from loop(), at most OUTPUT_STEPS_PER_PASS
+  // steps (a listing entry, or 64 bytes of a file) per pass and only while
+  // Console is under half full, so a long file or listing is never cut by
+  // the TX ring. A new job replaces one still running.
   bool listFiles();
+  bool listProductionFiles();
   bool searchFiles(const char* pattern);
+  bool printFile(const char* filename);
+  void serviceOutput();
+  bool isOutputActive() const { return output.kind != OUTPUT_IDLE; }
   int countFiles() const;
   
+  // Reading through ReadCache (READ, BULK)
+  bool locateFile(const char* filename, FileLocation& location);
+  int forEachFile(FileVisitor visitor, void* context);
+  
   // Cleanup
   bool formatSD();
   
 private:
+  enum OutputKind : uint8_t {
+    OUTPUT_IDLE,
+    OUTPUT_FILE,                   // READ
+    OUTPUT_FILES,                  // LS
+    OUTPUT_PRODUCTION,             // PROD
+    OUTPUT_SEARCH                  // SEARCH
+  };
+  
+  // Cursor of the output job in progress
+  struct OutputJob {
+    OutputKind kind;
+    bool begun;                    // Header line written
+    bool located;                  // READ: location found
+    FileLocation location;         // READ: the text being printed
+    uint32_t position;             // READ: text bytes consumed
+    int lineNumber;
+    char line[128];                // READ: line being assembled
+    size_t lineLength;
+    char pattern[40];              // SEARCH text
+    uint32_t fileIndex;            // Next loose file
+    bool looseListed;              // All loose files done
+    uint32_t containerIndex;       // Listing: next loose file checked for a container
+    char archive[48];              // Container being searched/listed, "" between
+    uint32_t entryIndex;           // Next entry in it
+    int count;                     // Files listed so far
+  };
+  
+  void startOutput(OutputKind kind);
+  void endOutput();
+  bool locateStep();
+  void serviceFileOutput();
+  void serviceListingOutput();
+  
   bool sdAvailable = false;
+  OutputJob output = {};
 };
 
 // ========================================
 // DISPLAY MANAGER
 // ========================================
+// Draws into the Adafruit_SSD1306 frame buffer (the back buffer) but never
+// pushes the whole 1 KB frame. Every drawing call marks the columns it
+// touched per 8-pixel page; update() hands those columns to DisplayLink,
+// whose transmitter task sends only the spans that differ from what the
+// panel already shows. update() never waits for the I2C transfer.
+//
+// Main screen fields (status, count, rate, clock, SD flag) live in
+// separate regions and are redrawn only when their value changes:
+//
+//   page 0     status text
+//   pages 2-4  count (pre-rendered digits, see big_digits.h)
+//   page 6     production rate: "42.5/min avg 40.1" (blank when hidden)
+//   page 7     clock (left), SD flag (right)
+//
+// The loop describes the main screen as a DisplayView every pass;
+// render() compares it with the last view rendered and does nothing when
+// they are equal. An idle READY screen therefore draws once a minute.
+struct DisplayView {
+  uint8_t state;                   // SystemState
+  long count;
+  int8_t hour;                     // Ignored unless rtcOk
+  int8_t minute;
+  bool sdOk;
+  bool rtcOk;
+  bool rateShown;
+  uint32_t rateNow;                // Tenths of items/min (RateMeter)
+  uint32_t rateAverage;
+  char status[22];                 // Top line, one row of size 1 text
+};
+
 class DisplayManager {
 public:
-  // Initialization
+  static const uint8_t WIDTH = 128;
+  static const uint8_t HEIGHT = 64;
+  static const uint8_t PAGE_COUNT = HEIGHT / 8;
+  static const uint8_t I2C_ADDRESS = 0x3C;
+  
+  DisplayManager();
+  static DisplayManager& getInstance();
+  
+  // Initialization (after display.begin())
   bool initialize();
   
   // Display updates
-  void update();
+  void update();          // Send dirty regions to the panel
   void clear();
   
+  // Main screen from a view model - returns true if a frame was rendered.
+  // Unchanged views are skipped; changes are rate-limited to refreshRate.
+  bool render(const DisplayView& view);
+  
+  // Main screen fields - no-ops when the value did not change
+  void setStatusText(const char* text);
+  void setCount(long count);
+  void setClock(int hour, int minute);     // hour < 0 hides the clock
+  void setStorageOk(bool ok);
+  void setRate(bool shown, uint32_t now, uint32_t average);  // Tenths of items/min
+  
   // Content updates
   void showMainScreen(int count, DateTime time, bool isProducing);
   void showStatus(const char* message, unsigned long duration);
@@ -148,22 +313,81 @@ public:
   void setBrightness(uint8_t level);
   void setRefreshRate(unsigned long rateMs);
   
-  // Refresh control
+  // Refresh control (dirty regions only - there is no periodic redraw)
   bool needsRefresh() const;
-  void markDirty();
+  void markDirty();                        // Whole screen
+  void markDirty(int x, int y, int w, int h);
   void markClean();
   
+  // Statistics (bus traffic: see DisplayLink)
+  uint32_t getFlushCount() const { return flushCount; }
+  uint32_t getFramesRendered() const { return framesRendered; }
+  uint32_t getFramesSkipped() const { return framesSkipped; }
+  void resetStats();
+  
 private:
+  enum Field : uint8_t {
+    FIELD_STATUS = 0x01,
+    FIELD_COUNT = 0x02,
+    FIELD_CLOCK = 0x04,
+    FIELD_STORAGE = 0x08,
+    FIELD_RATE = 0x10
+  };
+  
+  void flush();
+  void beginFullScreen();
+  bool enterMainScreen();
+  void drawField(int x, int y, int w, int h, const char* text, int textSize);
+  static bool sameView(const DisplayView& a, const DisplayView& b);
+  
   unsigned long lastRefresh = 0;
   unsigned long refreshRate = 100;  // ms
   bool displayDirty = true;
   
+  // Dirty columns per page (inclusive, start > end when clean)
+  uint8_t dirtyStart[PAGE_COUNT];
+  uint8_t dirtyEnd[PAGE_COUNT];
+  
+  bool ready = false;               // Frame buffer allocated by display.begin()
+  
+  // Main screen field cache
+  bool mainScreenActive = false;
+  uint8_t fieldsDrawn = 0;
+  unsigned long statusHoldUntil = 0;
+  char lastStatus[22];
+  long lastCount = 0;
+  bool countGlyphs = false;         // Count drawn from BigDigits (else GFX text)
+  int lastHour = -1;
+  int lastMinute = -1;
+  bool lastStorageOk = false;
+  bool lastRateShown = false;
+  uint32_t lastRateNow = 0;
+  uint32_t lastRateAverage = 0;
+  
+  uint32_t flushCount = 0;
+  uint32_t framesRendered = 0;
+  uint32_t framesSkipped = 0;
+  
+  // Last view model rendered
+  DisplayView lastView;
+  bool viewRendered = false;
+  
   void drawProgressBar(int y, int value, int maxValue);
 };
 
 // ========================================
 // LOGGER MANAGER
 // ========================================
+// Calls are templates: arguments are captured by type into a record (see
+// log_ring.h) and formatted later. Deferred (default), a record goes into
+// a RAM ring and the drain task prints it as text or sends a binary frame
+// for tests/host/log_decode; immediate, it is formatted and printed now.
+// fatal() always flushes the ring and prints synchronously.
+//
+// Each record carries a module with its own runtime level (LEVEL command).
+// The same message - format and argument values - repeated within
+// RATE_WINDOW_MS is printed once; the rest are counted and reported as one
+// "Repeated N times" line. ERROR and FATAL are never coalesced.
 class LoggerManager {
 public:
   // Log levels
@@ -175,74 +399,236 @@ public:
     FATAL = 4
   };
   
-  // Initialization
+  // Modules (order matches the names in log_ring.cpp)
+  enum Module : uint8_t {
+    MODULE_SYSTEM,
+    MODULE_FSM,
+    MODULE_STORAGE,
+    MODULE_DISPLAY,
+    MODULE_TIME,
+    MODULE_PRODUCTION,
+    MODULE_CONFIG,
+    MODULE_COUNT
+  };
+  
+  enum Output {
+    OUTPUT_TEXT,        // "[INFO] [Module] message" lines
+    OUTPUT_BINARY       // CRC-framed records (tests/host/log_decode)
+  };
+  
+  static const uint32_t DRAIN_INTERVAL_MS = 20;
+  static const uint32_t DRAIN_STACK = 3072;
+  static const uint8_t DRAIN_PRIORITY = 1;
+  static const uint8_t DRAIN_CORE = 0;      // loop() runs on core 1
+  
+  static const uint32_t RATE_WINDOW_MS = 1000;
+  static const uint8_t RATE_SLOTS = 8;      // Distinct messages tracked
+  
+  // Initialization (starts the drain task)
   static void initialize(LogLevel level = INFO);
   
-  // Logging functions
-  static void debug(const char* format, ...);
-  static void info(const char* format, ...);
-  static void warn(const char* format, ...);
-  static void error(const char* format, ...);
-  static void fatal(const char* format, ...);
+  // Logging functions (printf-style formats, MODULE_SYSTEM)
+  template<typename... Args>
+  static void debug(const char* format, Args... args) { log(DEBUG, MODULE_SYSTEM, format, args...); }
+  template<typename... Args>
+  static void info(const char* format, Args... args) { log(INFO, MODULE_SYSTEM, format, args...); }
+  template<typename... Args>
+  static void warn(const char* format, Args... args) { log(WARN, MODULE_SYSTEM, format, args...); }
+  template<typename... Args>
+  static void error(const char* format, Args... args) { log(ERROR, MODULE_SYSTEM, format, args...); }
+  template<typename... Args>
+  static void fatal(const char* format, Args... args) { log(FATAL, MODULE_SYSTEM, format, args...); }
+  
+  template<typename... Args>
+  static void log(LogLevel level, Module module, const char* format, Args... args) {
+    if (level < LOG_COMPILE_LEVEL || level < moduleLevels[module]) return;
+    uint8_t record[LogRing::MAX_RECORD];
+    size_t size = LogRing::encode(record, (uint8_t)(level | (module << LogRing::MODULE_SHIFT)),
+                                  format, timestamp(), args...);
+    if (level < ERROR && !admit(format, record, size)) return;
+    emit(record, size);
+  }
   
   // File logging
   static void logToFile(const char* filename, const char* message);
   
   // Settings
-  static void setLogLevel(LogLevel level);
+  static void setLogLevel(LogLevel level);                  // All modules
+  static void setModuleLevel(Module module, LogLevel level);
+  static LogLevel getModuleLevel(Module module) { return (LogLevel)moduleLevels[module]; }
   static void enableFileLogging(bool enable);
+  static void setDeferred(bool deferred);
+  static void setOutput(Output output);
+  static bool isDeferred() { return deferredMode; }
+  static Output getOutput() { return outputMode; }
+  
+  // Names as used by the LEVEL command ("STORAGE", "WARN")
+  static bool parseModule(const char* name, Module& module);
+  static bool parseLevel(const char* name, LogLevel& level);
+  static const char* moduleKey(Module module);
+  static const char* logLevelName(LogLevel level);
+  
+  // Print everything still in the ring (before a reset, from fatal())
+  static void flush();
+  
+  // Diagnostics
+  static const LogRing& getRing() { return ring; }
+  static uint32_t getCoalesced() { return coalesced; }
   
 private:
-  static LogLevel currentLevel;
+  struct RecentMessage {
+    const char* format;
+    uint32_t argsHash;        // FNV-1a of the encoded arguments
+    uint32_t windowStartMs;
+    uint32_t repeats;
+    uint8_t level;            // Level and module byte of the record
+  };
+  
+  static volatile uint8_t moduleLevels[MODULE_COUNT];
   static bool fileLoggingEnabled;
-  static const char* logLevelName(LogLevel level);
+  static volatile bool deferredMode;
+  static volatile Output outputMode;
+  static LogRing ring;
+  static void* drainTask;
+  static RecentMessage recent[RATE_SLOTS];
+  static uint32_t coalesced;
+  
+  static bool admit(const char* format, const uint8_t* record, size_t size);
+  static void reportRepeats(const RecentMessage& message, uint32_t nowMs);
+  static void flushRepeats();
+  static uint32_t timestamp();
+  static void emit(const uint8_t* record, size_t size);
+  static void output(const uint8_t* record, size_t size);
+  static void drain();
+  static void drainTaskEntry(void* parameter);
 };
 
+// ========================================
+// LOG MACROS
+// ========================================
+// LOG_WARN(STORAGE, "Cannot open %s", path) logs for MODULE_STORAGE.
+// Levels below LOG_COMPILE_LEVEL are removed by the preprocessor: no call,
+// no format string in flash, and the arguments are not evaluated. The
+// runtime level of each module can only raise the bar further.
+#define LOG_AT(level, module, ...) \
+  LoggerManager::log(LoggerManager::level, LoggerManager::MODULE_##module, __VA_ARGS__)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_DEBUG(module, ...) LOG_AT(DEBUG, module, __VA_ARGS__)
+#else
+#define LOG_DEBUG(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_INFO(module, ...) LOG_AT(INFO, module, __VA_ARGS__)
+#else
+#define LOG_INFO(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_WARN(module, ...) LOG_AT(WARN, module, __VA_ARGS__)
+#else
+#define LOG_WARN(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 3
+#define LOG_ERROR(module, ...) LOG_AT(ERROR, module, __VA_ARGS__)
+#else
+#define LOG_ERROR(module, ...) do {} while (0)
+#endif
+
+#define LOG_FATAL(module, ...) LOG_AT(FATAL, module, __VA_ARGS__)  // Never compiled out
+
 // ========================================
 // CONFIGURATION MANAGER
 // ========================================
 class ConfigManager {
 public:
+  // Where the current settings came from
+  enum Source : uint8_t {
+    SOURCE_DEFAULTS,
+    SOURCE_BLOB,
+    SOURCE_LEGACY
+  };
+  
+  ConfigManager();
+  static ConfigManager& getInstance();
+  
   // Settings structure
   struct Settings {
     unsigned long saveInterval = 5000;
     unsigned long debounceDelay = 50;
     int maxCount = 9999;
     unsigned long statusDisplayDuration = 3000;
+    unsigned long displayRefresh = 100;
+  };
+  
+  // Published settings. A change never edits the live snapshot: it fills
+  // the spare one and swaps the pointer, so a reader sees the old or the
+  // new settings, never a mix. Read from the loop task; an ISR gets its
+  // values through a subscriber (below).
+  struct Snapshot {
+    Settings settings;
+    uint32_t version;              // Bumped by every publish, 1 = boot
   };
   
+  // Called right after a publish, in the publishing task (loop()), with
+  // the new snapshot. Consumers copy what they use from it here.
+  typedef void (*Subscriber)(const Snapshot& snapshot);
+  static const uint8_t MAX_SUBSCRIBERS = 6;
+  
   // Initialization
   bool initialize();
   
   // Settings access
-  Settings getSettings() const { return settings; }
-  bool setSettings(const Settings& newSettings);
+  const Snapshot& getSnapshot() const { return *active; }
+  Settings getSettings() const { return active->settings; }
+  bool setSettings(const Settings& newSettings);   // Validate, publish, save
+  
+  // Registers and immediately calls the subscriber with the current snapshot
+  bool subscribe(Subscriber subscriber);
   
   // Individual parameter access
-  unsigned long getSaveInterval() const { return settings.saveInterval; }
-  unsigned long getDebounceDelay() const { return settings.debounceDelay; }
-  int getMaxCount() const { return settings.maxCount; }
-  unsigned long getStatusDisplayDuration() const { return settings.statusDisplayDuration; }
+  unsigned long getSaveInterval() const { return active->settings.saveInterval; }
+  unsigned long getDebounceDelay() const { return active->settings.debounceDelay; }
+  int getMaxCount() const { return active->settings.maxCount; }
+  unsigned long getStatusDisplayDuration() const { return active->settings.statusDisplayDuration; }
+  unsigned long getDisplayRefresh() const { return active->settings.displayRefresh; }
   
-  // Setters
+  // Setters (publish one change, not saved; out-of-range values are ignored)
   void setSaveInterval(unsigned long interval);
   void setDebounceDelay(unsigned long delay);
   void setMaxCount(int maxCount);
   void setStatusDisplayDuration(unsigned long duration);
+  void setDisplayRefresh(unsigned long refreshMs);
   
-  // Persistence
+  // Persistence (ConfigBlob copies in the EEPROM_HAL config region)
   bool loadFromEEPROM();
   bool saveToEEPROM();
   void resetToDefaults();
   
   // Validation
-  bool validateSettings() const;
+  bool validateSettings() const { return validate(active->settings); }
+  static bool validate(const Settings& settings);
   
-private:
-  Settings settings;
-  static const uint32_t EEPROM_MAGIC = 0xABCDEF00;
+  // Diagnostics
+  Source getSource() const { return source; }
+  static const char* sourceName(Source source);
+  uint32_t getSequence() const { return sequence; }
   
-  bool isValid() const;
+private:
+  Snapshot snapshots[2];
+  const Snapshot* volatile active = &snapshots[0];
+  Subscriber subscribers[MAX_SUBSCRIBERS];
+  uint8_t subscriberCount = 0;
+  Source source = SOURCE_DEFAULTS;
+  uint32_t sequence = 0;           // Of the newest copy, 0 = none
+  int8_t slot = -1;                // Copy holding it
+  
+  void publish(const Settings& next);
+  void applyPayload(const ConfigBlob::Payload& values);
+  static Settings fromPayload(const ConfigBlob::Payload& values);
+  static ConfigBlob::Payload toPayload(const Settings& settings);
 };
 
 #endif // MANAGERS_H
@@ -0,0 +1,231 @@
+#include "prealloc_log.h"
+#include "read_cache.h"
+#include "managers.h"
+#include <cstring>
+#include <cstdio>
+
+static const char HEADER_PREFIX[] = "#LOG LEN=";
+static const char HEADER_CAPACITY[] = " CAP=";
+static const size_t HEADER_DIGITS = 8;
+static const size_t PAD_CHUNK = 512;
+
+// ========================================
+// PRE-ALLOCATED LOG IMPLEMENTATION
+// ========================================
+
+PreallocLog& PreallocLog::getInstance() {
+  static PreallocLog instance;
+  return instance;
+}
+
+void PreallocLog::formatHeader(char* out, uint32_t length, uint32_t capacity) {
+  snprintf(out, HEADER_SIZE + 1, "%s%08lu%s%08lu\n", HEADER_PREFIX, (unsigned long)length,
+           HEADER_CAPACITY, (unsigned long)capacity);
+}
+
+static bool parseDigits(const char* text, uint32_t& value) {
+  value = 0;
+  for (size_t i = 0; i < HEADER_DIGITS; i++) {
+    if (text[i] < '0' || text[i] > '9') return false;
+    value = value * 10 + (text[i] - '0');
+  }
+  return true;
+}
+
+bool PreallocLog::parseHeader(const char* header, uint32_t& length, uint32_t& capacity) {
+  const size_t prefixLen = sizeof(HEADER_PREFIX) - 1;
+  const size_t capacityLen = sizeof(HEADER_CAPACITY) - 1;
+  static_assert(sizeof(HEADER_PREFIX) - 1 + HEADER_DIGITS + sizeof(HEADER_CAPACITY) - 1 +
+                HEADER_DIGITS + 1 == HEADER_SIZE, "Header layout does not match HEADER_SIZE");
+
+  const char* cursor = header;
+  if (strncmp(cursor, HEADER_PREFIX, prefixLen) != 0) return false;
+  cursor += prefixLen;
+  if (!parseDigits(cursor, length)) return false;
+  cursor += HEADER_DIGITS;
+  if (strncmp(cursor, HEADER_CAPACITY, capacityLen) != 0) return false;
+  cursor += capacityLen;
+  if (!parseDigits(cursor, capacity)) return false;
+  cursor += HEADER_DIGITS;
+  return *cursor == '\n' && length <= capacity;
+}
+
+void PreallocLog::parseExtent(const char* head, size_t headBytes, uint32_t fileSize,
+                              LogExtent& out) {
+  uint32_t length = 0;
+  uint32_t capacity = 0;
+  if (headBytes >= HEADER_SIZE && fileSize >= HEADER_SIZE &&
+      parseHeader(head, length, capacity)) {
+    // Never trust the header beyond what is physically on the card
+    uint32_t stored = fileSize - HEADER_SIZE;
+    out.dataOffset = HEADER_SIZE;
+    out.length = (length < stored) ? length : stored;
+    out.capacity = (capacity < stored) ? capacity : stored;
+    out.preallocated = true;
+  } else {
+    out.dataOffset = 0;
+    out.length = fileSize;
+    out.capacity = fileSize;
+    out.preallocated = false;
+  }
+}
+
+bool PreallocLog::readExtent(File& file, LogExtent& out) {
+  if (!file) {
+    return false;
+  }
+
+  char header[HEADER_SIZE + 1];
+  memset(header, 0, sizeof(header));
+
+  file.seek(0);
+  size_t bytesRead = file.read(reinterpret_cast<uint8_t*>(header), HEADER_SIZE);
+  parseExtent(header, bytesRead, file.size(), out);
+
+  file.seek(out.dataOffset);
+  return true;
+}
+
+bool PreallocLog::writePadding(File& file, uint32_t bytes) {
+  uint8_t chunk[PAD_CHUNK];
+  memset(chunk, PAD_BYTE, sizeof(chunk));
+
+  while (bytes > 0) {
+    size_t n = (bytes < PAD_CHUNK) ? bytes : PAD_CHUNK;
+    if (file.write(chunk, n) != n) {
+      return false;
+    }
+    bytes -= n;
+  }
+  return true;
+}
+
+bool PreallocLog::create(const char* path, uint32_t capacity) {
+  if (SD.exists(path)) {
+    return true;
+  }
+
+  File file = SD.open(path, FILE_WRITE);
+  if (!file) {
+    LOG_ERROR(STORAGE, "Cannot create log %s", path);
+    return false;
+  }
+
+  char header[HEADER_SIZE + 1];
+  formatHeader(header, 0, capacity);
+  bool ok = file.write(reinterpret_cast<const uint8_t*>(header), HEADER_SIZE) == HEADER_SIZE &&
+            writePadding(file, capacity);
+  file.flush();
+  file.close();
+  ReadCache::getInstance().invalidate(path, true);
+
+  if (!ok) {
+    LOG_ERROR(STORAGE, "Pre-allocation failed for %s", path);
+    SD.remove(path);
+  }
+  return ok;
+}
+
+bool PreallocLog::append(const char* path, const char* text) {
+  return append(path, reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+bool PreallocLog::append(const char* path, const uint8_t* data, size_t length) {
+  unsigned long startMicros = micros();
+
+  if (!SD.exists(path) && !create(path, DAILY_CAPACITY)) {
+    failedAppends++;
+    return false;
+  }
+
+  // "r+" writes in place (FILE_WRITE would truncate, FILE_APPEND ignores seek)
+  File file = SD.open(path, "r+");
+  if (!file) {
+    failedAppends++;
+    LOG_ERROR(STORAGE, "Cannot open log %s", path);
+    return false;
+  }
+
+  LogExtent extent;
+  readExtent(file, extent);
+  if (!extent.preallocated) {
+    file.close();
+    return appendPlain(path, data, length);
+  }
+
+  // Out of reserved space: grow by whole extents (the only allocating path)
+  if (extent.length + length > extent.capacity) {
+    uint32_t growth = GROWTH_EXTENT;
+    while (extent.length + length > extent.capacity + growth) {
+      growth += GROWTH_EXTENT;
+    }
+    if (!file.seek(extent.dataOffset + extent.capacity) || !writePadding(file, growth)) {
+      file.close();
+      ReadCache::getInstance().invalidate(path, true);
+      failedAppends++;
+      LOG_ERROR(STORAGE, "Cannot grow log file");
+      return false;
+    }
+    extent.capacity += growth;
+    growthCount++;
+  }
+
+  // Text first, header last: a power cut in between only loses this entry
+  bool ok = file.seek(extent.dataOffset + extent.length) &&
+            file.write(data, length) == length;
+  if (ok) {
+    char header[HEADER_SIZE + 1];
+    formatHeader(header, extent.length + length, extent.capacity);
+    ok = file.seek(0) &&
+         file.write(reinterpret_cast<const uint8_t*>(header), HEADER_SIZE) == HEADER_SIZE;
+  }
+  file.flush();
+  file.close();
+  ReadCache::getInstance().invalidate(path, true);
+
+  if (!ok) {
+    failedAppends++;
+    LOG_ERROR(STORAGE, "Append failed for %s", path);
+    return false;
+  }
+
+  recordAppend(startMicros);
+  return true;
+}
+
+bool PreallocLog::appendPlain(const char* path, const uint8_t* data, size_t length) {
+  unsigned long startMicros = micros();
+
+  File file = SD.open(path, FILE_APPEND);
+  if (!file) {
+    failedAppends++;
+    return false;
+  }
+  bool ok = file.write(data, length) == length;
+  file.flush();
+  file.close();
+  ReadCache::getInstance().invalidate(path, true);
+
+  if (!ok) {
+    failedAppends++;
+    return false;
+  }
+  recordAppend(startMicros);
+  return true;
+}
+
+void PreallocLog::recordAppend(unsigned long startMicros) {
+  lastAppendMicros = micros() - startMicros;
+  if (lastAppendMicros > maxAppendMicros) {
+    maxAppendMicros = lastAppendMicros;
+  }
+  appendCount++;
+}
+
+void PreallocLog::resetStats() {
+  appendCount = 0;
+  failedAppends = 0;
+  growthCount = 0;
+  lastAppendMicros = 0;
+  maxAppendMicros = 0;
+}
@@ -0,0 +1,82 @@
+#ifndef PREALLOC_LOG_H
+#define PREALLOC_LOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+// ========================================
+// PRE-ALLOCATED LOG FILES
+// ========================================
+// Appending to a FAT file can allocate a new cluster, which rewrites the
+// FAT table and the directory entry - the slowest operations an SD card
+// performs. Log files are therefore created once at their full extent and
+// filled in place afterwards:
+//
+//   "#LOG LEN=00000123 CAP=00016384\n"   fixed-size text header
+//   <LEN bytes of log text>
+//   <padding up to CAP bytes>
+//
+// An append only rewrites the data sector at the end of the text and the
+// header sector, both inside clusters the file already owns.
+//
+// Readers must stop at HEADER_SIZE + LEN (see readExtent()). Files without
+// a header (written by older firmware) are treated as plain text.
+struct LogExtent {
+  uint32_t dataOffset;    // First byte of log text
+  uint32_t length;        // Logical length of log text
+  uint32_t capacity;      // Bytes available before the file must grow
+  bool preallocated;      // false for legacy plain-text files
+};
+
+class PreallocLog {
+public:
+  static const size_t HEADER_SIZE = 31;
+  static const uint32_t DAILY_CAPACITY = 16384;    // ~250 session entries
+  static const uint32_t SESSION_CAPACITY = 512;    // One sector
+  static const uint32_t GROWTH_EXTENT = 8192;      // Added when a log fills up
+  static const char PAD_BYTE = ' ';                // Keeps files readable on a PC
+
+  static PreallocLog& getInstance();
+
+  // Create `path` with `capacity` bytes reserved. Existing files are kept.
+  bool create(const char* path, uint32_t capacity);
+
+  // Append text at the logical end. Missing files are created first,
+  // legacy plain-text files fall back to a normal append.
+  bool append(const char* path, const char* text);
+  bool append(const char* path, const uint8_t* data, size_t length);
+
+  // Read the header of an open file and seek to the start of the text
+  static bool readExtent(File& file, LogExtent& out);
+
+  // Same, from the first bytes of a file read elsewhere (e.g. ReadCache)
+  static void parseExtent(const char* head, size_t headBytes, uint32_t fileSize,
+                          LogExtent& out);
+
+  // Header encoding (public for tests). `out` must hold HEADER_SIZE + 1.
+  static void formatHeader(char* out, uint32_t length, uint32_t capacity);
+  static bool parseHeader(const char* header, uint32_t& length, uint32_t& capacity);
+
+  // Statistics
+  uint32_t getAppendCount() const { return appendCount; }
+  uint32_t getFailedAppendCount() const { return failedAppends; }
+  uint32_t getGrowthCount() const { return growthCount; }
+  unsigned long getLastAppendMicros() const { return lastAppendMicros; }
+  unsigned long getMaxAppendMicros() const { return maxAppendMicros; }
+  void resetStats();
+
+private:
+  PreallocLog() {}
+
+  static bool writePadding(File& file, uint32_t bytes);
+  bool appendPlain(const char* path, const uint8_t* data, size_t length);
+  void recordAppend(unsigned long startMicros);
+
+  uint32_t appendCount = 0;
+  uint32_t failedAppends = 0;
+  uint32_t growthCount = 0;
+  unsigned long lastAppendMicros = 0;
+  unsigned long maxAppendMicros = 0;
+};
+
+#endif // PREALLOC_LOG_H
@@ -0,0 +1,90 @@
+#include "rate_meter.h"
+#include <cstdio>
+#include <cstring>
+
+// ========================================
+// RATE METER IMPLEMENTATION
+// ========================================
+
+static const uint64_t TENTHS_MS_PER_MINUTE = 600000;   // 10 * 60000
+
+void RateMeter::begin(uint32_t count, uint32_t nowMs) {
+  memset(buckets, 0, sizeof(buckets));
+  memset(sums, 0, sizeof(sums));
+  head = 0;
+  filled = 0;
+  ewmaQ16 = 0;
+  startCount = count;
+  startMs = nowMs;
+  bucketStartMs = nowMs;
+  bucketCount = count;
+  closed = 0;
+  rates = Rates();
+  active = true;
+}
+
+void RateMeter::update(uint32_t count, uint32_t nowMs) {
+  if (!active || nowMs - bucketStartMs < BUCKET_MS) {
+    return;
+  }
+
+  // Normally one bucket. After a loop stall the items counted meanwhile
+  // are spread over the buckets it covered; beyond 15 minutes only the
+  // last BUCKETS matter.
+  uint32_t ended = (nowMs - bucketStartMs) / BUCKET_MS;
+  if (ended > BUCKETS) {
+    bucketStartMs += (ended - BUCKETS) * BUCKET_MS;
+    ended = BUCKETS;
+  }
+  uint32_t items = count - bucketCount;
+  for (uint32_t i = 0; i < ended; i++) {
+    closeBucket(items / ended + (i < items % ended ? 1 : 0));
+  }
+  bucketStartMs += ended * BUCKET_MS;
+  bucketCount = count;
+
+  rates.now = (uint32_t)((ewmaQ16 * 10 + 0x8000) >> 16);
+  rates.oneMinute = windowRate(sums[0], ONE_MINUTE);
+  rates.fiveMinutes = windowRate(sums[1], FIVE_MINUTES);
+  rates.fifteenMinutes = windowRate(sums[2], FIFTEEN_MINUTES);
+  uint32_t elapsed = bucketStartMs - startMs;
+  rates.session = (uint32_t)((uint64_t)(count - startCount) * TENTHS_MS_PER_MINUTE / elapsed);
+}
+
+void RateMeter::closeBucket(uint32_t items) {
+  if (items > 0xFFFF) {
+    items = 0xFFFF;
+  }
+
+  // The bucket being overwritten leaves the 15-minute window; the ones
+  // ONE_MINUTE and FIVE_MINUTES back leave the shorter windows (all zero
+  // until the ring has gone round)
+  sums[0] += items - buckets[(head + BUCKETS - ONE_MINUTE) % BUCKETS];
+  sums[1] += items - buckets[(head + BUCKETS - FIVE_MINUTES) % BUCKETS];
+  sums[2] += items - buckets[head];
+  buckets[head] = (uint16_t)items;
+  head = (head + 1) % BUCKETS;
+  if (filled < BUCKETS) {
+    filled++;
+  }
+
+  int64_t sample = (int64_t)items * (60000 / BUCKET_MS) << 16;
+  if (closed == 0) {
+    ewmaQ16 = sample;            // Start at the first bucket's rate, not 0
+  } else {
+    ewmaQ16 += ((sample - ewmaQ16) * (int64_t)EWMA_ALPHA_Q16) >> 16;
+  }
+  closed++;
+}
+
+uint32_t RateMeter::windowRate(uint32_t sum, uint16_t window) const {
+  uint32_t n = (filled < window) ? filled : window;
+  if (n == 0) {
+    return 0;
+  }
+  return (uint32_t)((uint64_t)sum * TENTHS_MS_PER_MINUTE / (n * BUCKET_MS));
+}
+
+void RateMeter::formatTenths(uint32_t tenths, char* out, int size) {
+  snprintf(out, size, "%lu.%lu", (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+}
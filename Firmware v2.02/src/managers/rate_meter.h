@@ -0,0 +1,79 @@
+#ifndef RATE_METER_H
+#define RATE_METER_H
+
+#include <stdint.h>
+
+// ========================================
+// PRODUCTION RATE METER
+// ========================================
+// Items per minute for the production screen and STATUS, in integer
+// arithmetic only:
+//
+//   now        EWMA over 5 s buckets, time constant ~30 s (Q16.16)
+//   1/5/15 min rolling windows: exact bucket sums over the last 12, 60
+//              and 180 buckets
+//   session    items since begin() / time since begin()
+//
+// The loop passes the running count to update() every pass. Nothing
+// happens until the current bucket has ended; closing it is one ring
+// write, three running-sum adjustments and one EWMA step, however many
+// items it holds. Rates are recomputed only then, so they change (and the
+// screen redraws) at most every BUCKET_MS.
+//
+// Until a window has filled, its rate is over the buckets seen so far: 30
+// seconds into a session the 1-minute rate is already meaningful. Rates
+// are in tenths of an item per minute (425 = 42.5/min).
+class RateMeter {
+public:
+  static const uint32_t BUCKET_MS = 5000;
+  static const uint16_t BUCKETS = 180;             // 15 minutes
+  static const uint16_t ONE_MINUTE = 12;           // Buckets per window
+  static const uint16_t FIVE_MINUTES = 60;
+  static const uint16_t FIFTEEN_MINUTES = BUCKETS;
+  static const uint32_t EWMA_ALPHA_Q16 = 10061;    // 1 - exp(-5 s / 30 s)
+
+  struct Rates {
+    uint32_t now;                  // EWMA
+    uint32_t oneMinute;
+    uint32_t fiveMinutes;
+    uint32_t fifteenMinutes;
+    uint32_t session;
+  };
+
+  // Start a session at `count` (rates all 0 until the first bucket ends)
+  void begin(uint32_t count, uint32_t nowMs);
+
+  // Every loop pass with the running count; O(1) per bucket closed
+  void update(uint32_t count, uint32_t nowMs);
+
+  // Session over: rates keep their last values
+  void stop() { active = false; }
+  bool isActive() const { return active; }
+
+  const Rates& getRates() const { return rates; }
+  uint32_t getBucketsClosed() const { return closed; }
+
+  // "42.5" from tenths
+  static void formatTenths(uint32_t tenths, char* out, int size);
+
+private:
+  void closeBucket(uint32_t items);
+  uint32_t windowRate(uint32_t sum, uint16_t window) const;
+
+  uint16_t buckets[BUCKETS];       // Items per bucket, ring
+  uint16_t head = 0;               // Next bucket to write
+  uint16_t filled = 0;             // Buckets written, up to BUCKETS
+  uint32_t sums[3];                // One, five, fifteen minutes
+  int64_t ewmaQ16 = 0;             // Items/min, Q16.16
+
+  bool active = false;
+  uint32_t startCount = 0;
+  uint32_t startMs = 0;
+  uint32_t bucketStartMs = 0;
+  uint32_t bucketCount = 0;        // Count when the current bucket began
+  uint32_t closed = 0;
+
+  Rates rates = {};
+};
+
+#endif // RATE_METER_H
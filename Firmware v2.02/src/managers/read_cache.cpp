@@ -0,0 +1,374 @@
+#include "read_cache.h"
+#include "prealloc_log.h"
+#include <SD.h>
+#include <cstring>
+
+// Extern variables from main code (will be linked)
+extern bool sdAvailable;
+
+// ========================================
+// READ CACHE IMPLEMENTATION
+// ========================================
+
+ReadCache& ReadCache::getInstance() {
+  static ReadCache instance;
+  return instance;
+}
+
+ReadCache::ReadCache() {
+  memset(blocks, 0, sizeof(blocks));
+}
+
+uint64_t ReadCache::pathKey(const char* path) {
+  if (path[0] == '/') path++;
+
+  // Two independent 32-bit hashes (FNV-1a, djb2) of the case-folded path;
+  // FAT names are case-insensitive and serial input is upper-cased
+  uint32_t fnv = 2166136261u;
+  uint32_t djb = 5381;
+  for (; *path; path++) {
+    uint8_t c = (uint8_t)*path;
+    if (c >= 'a' && c <= 'z') c -= 32;
+    fnv = (fnv ^ c) * 16777619u;
+    djb = djb * 33 + c;
+  }
+
+  uint64_t key = ((uint64_t)fnv << 32) | djb;
+  return (key == DIRECTORY_KEY) ? key - 1 : key;
+}
+
+ReadCache::Block* ReadCache::find(uint64_t key, uint32_t index) {
+  for (size_t i = 0; i < BLOCK_COUNT; i++) {
+    if (blocks[i].used && blocks[i].key == key && blocks[i].index == index) {
+      blocks[i].lastUse = ++useClock;
+      return &blocks[i];
+    }
+  }
+  return nullptr;
+}
+
+ReadCache::Block* ReadCache::allocate(uint64_t key, uint32_t index) {
+  Block* victim = nullptr;
+  for (size_t i = 0; i < BLOCK_COUNT; i++) {
+    Block& block = blocks[i];
+    if (!block.used) {
+      victim = &block;
+      break;
+    }
+    if (directoryPinned && block.key == DIRECTORY_KEY) {
+      continue;
+    }
+    if (victim == nullptr || block.lastUse < victim->lastUse) {
+      victim = &block;
+    }
+  }
+
+  if (victim->used) {
+    evictions++;
+    if (victim->key == DIRECTORY_KEY) {
+      directoryCached = false;
+      walkCacheable = false;
+    }
+  }
+
+  victim->used = true;
+  victim->key = key;
+  victim->index = index;
+  victim->validBytes = 0;
+  victim->lastUse = ++useClock;
+  return victim;
+}
+
+void ReadCache::drop(uint64_t key) {
+  for (size_t i = 0; i < BLOCK_COUNT; i++) {
+    if (blocks[i].used && blocks[i].key == key) {
+      blocks[i].used = false;
+    }
+  }
+}
+
+size_t ReadCache::read(const char* path, uint32_t offset, uint8_t* out, size_t length) {
+  if (!sdAvailable) {
+    return 0;
+  }
+
+  uint64_t key = pathKey(path);
+  File file;  // Opened on the first miss, shared by the following misses
+  size_t copied = 0;
+
+  while (copied < length) {
+    uint32_t position = offset + copied;
+    uint32_t index = position / BLOCK_SIZE;
+    uint32_t within = position % BLOCK_SIZE;
+
+    Block* block = find(key, index);
+    if (block) {
+      hits++;
+    } else {
+      misses++;
+      if (!file) {
+        file = SD.open(path, FILE_READ);
+        if (!file) break;
+      }
+      if (!file.seek(index * BLOCK_SIZE)) break;
+
+      block = allocate(key, index);
+      block->validBytes = file.read(block->data, BLOCK_SIZE);
+    }
+
+    if (within >= block->validBytes) break;  // End of file
+
+    size_t n = block->validBytes - within;
+    if (n > length - copied) n = length - copied;
+    memcpy(out + copied, block->data + within, n);
+    copied += n;
+
+    if (block->validBytes < BLOCK_SIZE && within + n >= block->validBytes) break;
+  }
+
+  if (file) file.close();
+  return copied;
+}
+
+// ========================================
+// DIRECTORY LISTING
+// ========================================
+
+int ReadCache::forEachFile(FileVisitor visitor, void* context) {
+  if (!sdAvailable) {
+    return 0;
+  }
+
+  // Visitors may read files through the cache - keep the listing resident
+  directoryPinned = true;
+  int count = -1;
+  if (directoryCached) {
+    count = visitCachedDirectory(visitor, context);
+  }
+  if (count < 0) {
+    misses++;
+    count = rebuildDirectory(visitor, context);
+  }
+  directoryPinned = false;
+  return count;
+}
+
+bool ReadCache::readDirectoryRecord(uint32_t index, DirectoryRecord& record) {
+  Block* block = find(DIRECTORY_KEY, index / RECORDS_PER_BLOCK);
+  if (!block) {
+    return false;
+  }
+  memcpy(&record, block->data + (index % RECORDS_PER_BLOCK) * sizeof(DirectoryRecord),
+         sizeof(record));
+  return true;
+}
+
+int ReadCache::visitCachedDirectory(FileVisitor visitor, void* context) {
+  size_t blockCount = (directoryRecords + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+  for (size_t i = 0; i < blockCount; i++) {
+    if (!find(DIRECTORY_KEY, i)) {
+      return -1;
+    }
+  }
+  hits++;
+
+  for (uint32_t r = 0; r < directoryRecords; r++) {
+    DirectoryRecord record;
+    readDirectoryRecord(r, record);
+    visitor(record.name, record.logicalSize, context);
+  }
+  return directoryRecords;
+}
+
+// Store record `index` of the listing; false (listing dropped) once it
+// no longer fits the cache
+bool ReadCache::cacheDirectoryRecord(uint32_t index, const char* name, uint32_t logicalSize) {
+  size_t blockIndex = index / RECORDS_PER_BLOCK;
+  if (strlen(name) >= MAX_NAME_LENGTH || blockIndex >= MAX_DIRECTORY_BLOCKS) {
+    drop(DIRECTORY_KEY);
+    return false;
+  }
+
+  Block* block = find(DIRECTORY_KEY, blockIndex);
+  if (!block) block = allocate(DIRECTORY_KEY, blockIndex);
+
+  DirectoryRecord record;
+  memset(&record, 0, sizeof(record));
+  strcpy(record.name, name);
+  record.logicalSize = logicalSize;
+  size_t slot = index % RECORDS_PER_BLOCK;
+  memcpy(block->data + slot * sizeof(DirectoryRecord), &record, sizeof(record));
+  block->validBytes = (slot + 1) * sizeof(DirectoryRecord);
+  return true;
+}
+
+int ReadCache::rebuildDirectory(FileVisitor visitor, void* context) {
+  endWalk();
+  drop(DIRECTORY_KEY);
+  directoryCached = false;
+
+  File root = SD.open("/");
+  if (!root) {
+    return 0;
+  }
+
+  bool cacheable = true;
+  uint32_t count = 0;
+  File file = root.openNextFile();
+  while (file) {
+    if (!file.isDirectory()) {
+      const char* name = file.name();
+      if (name[0] == '/') name++;
+
+      // Logical size - pre-allocated logs are larger on the card
+      LogExtent extent;
+      PreallocLog::readExtent(file, extent);
+
+      if (cacheable) {
+        cacheable = cacheDirectoryRecord(count, name, extent.length);
+      }
+
+      count++;
+      visitor(name, extent.length, context);
+    }
+    file.close();
+    file = root.openNextFile();
+  }
+  root.close();
+
+  if (cacheable) {
+    directoryCached = true;
+    directoryRecords = count;
+  }
+  return count;
+}
+
+void ReadCache::endWalk() {
+  if (walkDirectory) {
+    walkDirectory.close();
+  }
+}
+
+bool ReadCache::fileAt(uint32_t index, char* name, size_t nameSize, uint32_t& logicalSize) {
+  if (!sdAvailable) {
+    return false;
+  }
+
+  // A walk counts as one listing hit, at its first file
+  DirectoryRecord record;
+  if (directoryCached && (index >= directoryRecords || readDirectoryRecord(index, record))) {
+    if (index == 0) hits++;
+    if (index >= directoryRecords) {
+      return false;
+    }
+    snprintf(name, nameSize, "%s", record.name);
+    logicalSize = record.logicalSize;
+    return true;
+  }
+
+  // Listing evicted or too large to cache: walk the card on from where
+  // the previous call stopped, so reading it in order costs one directory
+  // entry per call. The walk caches the listing as it goes.
+  if (!walkDirectory || index < walkNext) {
+    endWalk();
+    drop(DIRECTORY_KEY);
+    directoryCached = false;
+    misses++;
+    walkDirectory = SD.open("/");
+    walkNext = 0;
+    walkCacheable = true;
+    if (!walkDirectory) {
+      return false;
+    }
+  }
+
+  for (;;) {
+    File file = walkDirectory.openNextFile();
+    if (!file) {
+      if (walkCacheable) {
+        directoryCached = true;
+        directoryRecords = walkNext;
+      }
+      endWalk();
+      return false;
+    }
+    if (file.isDirectory()) {
+      file.close();
+      continue;
+    }
+
+    const char* entryName = file.name();
+    if (entryName[0] == '/') entryName++;
+    LogExtent extent;
+    PreallocLog::readExtent(file, extent);
+    if (walkCacheable) {
+      walkCacheable = cacheDirectoryRecord(walkNext, entryName, extent.length);
+    }
+
+    bool wanted = (walkNext++ == index);
+    if (wanted) {
+      snprintf(name, nameSize, "%s", entryName);
+      logicalSize = extent.length;
+    }
+    file.close();
+    if (wanted) {
+      return true;
+    }
+  }
+}
+
+struct StatQuery {
+  uint64_t key;
+  bool found;
+  uint32_t logicalSize;
+};
+
+static void matchFile(const char* name, uint32_t logicalSize, void* context) {
+  StatQuery* query = static_cast<StatQuery*>(context);
+  if (!query->found && ReadCache::pathKey(name) == query->key) {
+    query->found = true;
+    query->logicalSize = logicalSize;
+  }
+}
+
+bool ReadCache::stat(const char* path, uint32_t& logicalSize) {
+  StatQuery query = { pathKey(path), false, 0 };
+  forEachFile(matchFile, &query);
+  logicalSize = query.logicalSize;
+  return query.found;
+}
+
+// ========================================
+// INVALIDATION & STATISTICS
+// ========================================
+
+void ReadCache::invalidate(const char* path, bool directoryChanged) {
+  drop(pathKey(path));
+  if (directoryChanged) {
+    endWalk();
+    drop(DIRECTORY_KEY);
+    directoryCached = false;
+  }
+  invalidations++;
+}
+
+void ReadCache::invalidateAll() {
+  for (size_t i = 0; i < BLOCK_COUNT; i++) {
+    blocks[i].used = false;
+  }
+  endWalk();
+  directoryCached = false;
+  invalidations++;
+}
+
+uint32_t ReadCache::getHitRatePercent() const {
+  uint32_t total = hits + misses;
+  return (total > 0) ? (uint32_t)(((uint64_t)hits * 100) / total) : 0;
+}
+
+void ReadCache::resetStats() {
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+  invalidations = 0;
+}
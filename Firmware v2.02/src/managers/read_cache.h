@@ -0,0 +1,114 @@
+#ifndef READ_CACHE_H
+#define READ_CACHE_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+// Cache size in KB (override with -DREAD_CACHE_KB=n)
+#ifndef READ_CACHE_KB
+#define READ_CACHE_KB 8
+#endif
+
+// ========================================
+// SD READ CACHE
+// ========================================
+// LRU cache of 512-byte file blocks for the serial browsing commands
+// (LS, PROD, SEARCH, READ), which a technician issues back to back over
+// the same files. Blocks are keyed by a 64-bit hash of the path plus the
+// block index.
+//
+// The root directory listing (name + logical size per file) is cached as
+// a pseudo-file under its own key, so repeated LS/PROD/SEARCH do not walk
+// the directory on the card. fileAt() reads it one file per call; when it
+// is not cached, those calls walk the card one entry at a time instead.
+//
+// Every writer must call invalidate() for the path it touched. Counting
+// never goes through this cache.
+class ReadCache {
+public:
+  static const size_t BLOCK_SIZE = 512;
+  static const size_t BLOCK_COUNT = (READ_CACHE_KB * 1024) / BLOCK_SIZE;
+  static const size_t MAX_NAME_LENGTH = 40;       // Longer names are listed uncached
+  static const size_t MAX_DIRECTORY_BLOCKS = BLOCK_COUNT / 2;
+
+  static_assert(BLOCK_COUNT >= 2, "READ_CACHE_KB must be at least 1");
+
+  // Called for every regular file in the root directory
+  typedef void (*FileVisitor)(const char* name, uint32_t logicalSize, void* context);
+
+  static ReadCache& getInstance();
+
+  // Read up to `length` bytes at `offset`. Returns bytes read (short at EOF).
+  size_t read(const char* path, uint32_t offset, uint8_t* out, size_t length);
+
+  // Visit all files in "/" (cached listing). Returns the file count.
+  int forEachFile(FileVisitor visitor, void* context);
+
+  // File `index` of the listing (forEachFile order), for callers that walk
+  // it a few entries at a time. False past the last file.
+  bool fileAt(uint32_t index, char* name, size_t nameSize, uint32_t& logicalSize);
+  void endWalk();                    // Caller stopped early: close the directory
+
+  // Look up a root file in the cached listing
+  bool stat(const char* path, uint32_t& logicalSize);
+
+  // Drop cached blocks of `path`; also the listing if names/sizes changed
+  void invalidate(const char* path, bool directoryChanged);
+  void invalidateAll();
+
+  // Statistics
+  uint32_t getHits() const { return hits; }
+  uint32_t getMisses() const { return misses; }
+  uint32_t getEvictions() const { return evictions; }
+  uint32_t getInvalidations() const { return invalidations; }
+  uint32_t getHitRatePercent() const;
+  void resetStats();
+
+  static uint64_t pathKey(const char* path);
+
+private:
+  struct Block {
+    uint64_t key;
+    uint32_t index;
+    uint32_t lastUse;
+    uint16_t validBytes;             // < BLOCK_SIZE only for the last block of a file
+    bool used;
+    uint8_t data[BLOCK_SIZE];
+  };
+
+  struct __attribute__((packed)) DirectoryRecord {
+    char name[MAX_NAME_LENGTH];
+    uint32_t logicalSize;
+  };
+
+  static const uint64_t DIRECTORY_KEY = 0xFFFFFFFFFFFFFFFFull;
+  static const size_t RECORDS_PER_BLOCK = BLOCK_SIZE / sizeof(DirectoryRecord);
+
+  ReadCache();
+
+  Block* find(uint64_t key, uint32_t index);
+  Block* allocate(uint64_t key, uint32_t index);
+  void drop(uint64_t key);
+  bool readDirectoryRecord(uint32_t index, DirectoryRecord& record);
+  bool cacheDirectoryRecord(uint32_t index, const char* name, uint32_t logicalSize);
+  int visitCachedDirectory(FileVisitor visitor, void* context);
+  int rebuildDirectory(FileVisitor visitor, void* context);
+
+  Block blocks[BLOCK_COUNT];
+  uint32_t useClock = 0;
+  bool directoryCached = false;
+  bool directoryPinned = false;      // Listing blocks are in use by a visitor
+  uint32_t directoryRecords = 0;
+
+  // fileAt() walk of an uncached listing
+  File walkDirectory;
+  uint32_t walkNext = 0;             // Index of the next file it returns
+  bool walkCacheable = false;
+
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t evictions = 0;
+  uint32_t invalidations = 0;
+};
+
+#endif // READ_CACHE_H
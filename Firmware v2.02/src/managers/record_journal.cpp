@@ -0,0 +1,188 @@
+#include "record_journal.h"
+#include "prealloc_log.h"
+#include "read_cache.h"
+#include "managers.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+// ========================================
+// RECORD JOURNAL IMPLEMENTATION
+// ========================================
+
+RecordJournal& RecordJournal::getInstance() {
+  static RecordJournal instance;
+  return instance;
+}
+
+bool RecordJournal::begin(const char* journal, const char* index) {
+  ready = false;
+  snprintf(journalPath, sizeof(journalPath), "%s", journal);
+  snprintf(indexPath, sizeof(indexPath), "%s", index);
+
+  PreallocLog& logs = PreallocLog::getInstance();
+  uint32_t indexLength = 0;
+  if (!logs.create(journalPath, JOURNAL_CAPACITY) || !logs.create(indexPath, INDEX_CAPACITY) ||
+      !locate(journalPath, journalStart, journalLength) || !locate(indexPath, indexStart, indexLength)) {
+    LOG_ERROR(STORAGE, "Record journal unavailable");
+    return false;
+  }
+
+  lastSequence = indexLength / sizeof(uint32_t);
+  ready = true;
+  repair();
+  LOG_INFO(STORAGE, "Record journal: %lu records", (unsigned long)lastSequence);
+  return true;
+}
+
+bool RecordJournal::locate(const char* path, uint32_t& start, uint32_t& length) {
+  StorageManager::FileLocation location;
+  if (!StorageManager::getInstance().locateFile(path, location) || location.archived) {
+    return false;
+  }
+  start = location.offset;
+  length = location.length;
+  return true;
+}
+
+// Lines after the last indexed record were written by a commit that lost
+// power before its index entry: index them now
+void RecordJournal::repair() {
+  uint32_t offset = 0;
+  char line[MAX_RECORD + 1];
+  if (lastSequence > 0 &&
+      (!readOffset(lastSequence - 1, offset) || !readLine(offset, line, sizeof(line), offset))) {
+    LOG_ERROR(STORAGE, "Record journal index damaged at %lu", (unsigned long)lastSequence);
+    ready = false;
+    return;
+  }
+
+  uint32_t next;
+  while (offset < journalLength && readLine(offset, line, sizeof(line), next) &&
+         parseSequence(line) == lastSequence + 1) {
+    uint8_t entry[4];
+    for (int i = 0; i < 4; i++) {
+      entry[i] = (offset >> (8 * i)) & 0xFF;
+    }
+    if (!PreallocLog::getInstance().append(indexPath, entry, sizeof(entry))) {
+      ready = false;
+      return;
+    }
+    lastSequence++;
+    repaired++;
+    offset = next;
+  }
+  if (offset < journalLength) {
+    LOG_WARN(STORAGE, "Record journal: %lu bytes after record %lu ignored",
+             (unsigned long)(journalLength - offset), (unsigned long)lastSequence);
+  }
+}
+
+uint32_t RecordJournal::addSession(const DateTime& start, const DateTime& stop, int count) {
+  char record[MAX_RECORD];
+  int length = snprintf(record, sizeof(record),
+                        "%lu,SESSION,%04d-%02d-%02d %02d:%02d:%02d,%04d-%02d-%02d %02d:%02d:%02d,%d\n",
+                        (unsigned long)(lastSequence + 1),
+                        start.year(), start.month(), start.day(), start.hour(), start.minute(), start.second(),
+                        stop.year(), stop.month(), stop.day(), stop.hour(), stop.minute(), stop.second(),
+                        count);
+  return append(record, length);
+}
+
+uint32_t RecordJournal::addHour(const DateTime& hourStart, int count) {
+  char record[MAX_RECORD];
+  int length = snprintf(record, sizeof(record), "%lu,HOUR,%04d-%02d-%02d %02d:00,%d\n",
+                        (unsigned long)(lastSequence + 1), hourStart.year(), hourStart.month(),
+                        hourStart.day(), hourStart.hour(), count);
+  return append(record, length);
+}
+
+// Text first, then the index entry (see repair())
+uint32_t RecordJournal::append(const char* record, size_t length) {
+  if (!ready || length >= MAX_RECORD) {
+    failed++;
+    return 0;
+  }
+
+  PreallocLog& logs = PreallocLog::getInstance();
+  uint32_t offset = journalLength;
+  if (!logs.append(journalPath, reinterpret_cast<const uint8_t*>(record), length)) {
+    failed++;
+    return 0;
+  }
+  journalLength += length;
+
+  uint8_t entry[4];
+  for (int i = 0; i < 4; i++) {
+    entry[i] = (offset >> (8 * i)) & 0xFF;
+  }
+  if (!logs.append(indexPath, entry, sizeof(entry))) {
+    // The next boot indexes the line; until then the sequence must not
+    // be handed out twice
+    ready = false;
+    failed++;
+    LOG_ERROR(STORAGE, "Record journal index write failed - journal closed until restart");
+    return 0;
+  }
+  return ++lastSequence;
+}
+
+bool RecordJournal::readOffset(uint32_t index, uint32_t& offset) {
+  uint8_t entry[4];
+  if (ReadCache::getInstance().read(indexPath, indexStart + index * sizeof(entry), entry,
+                                    sizeof(entry)) != sizeof(entry)) {
+    return false;
+  }
+  offset = (uint32_t)entry[0] | ((uint32_t)entry[1] << 8) | ((uint32_t)entry[2] << 16) |
+           ((uint32_t)entry[3] << 24);
+  return offset < journalLength;
+}
+
+// One record at `offset`, without its '\n'; false if there is no whole line
+bool RecordJournal::readLine(uint32_t offset, char* line, size_t size, uint32_t& nextOffset) {
+  if (offset >= journalLength) {
+    return false;
+  }
+  size_t want = size - 1;
+  if (journalLength - offset < want) {
+    want = journalLength - offset;
+  }
+  size_t got = ReadCache::getInstance().read(journalPath, journalStart + offset,
+                                             reinterpret_cast<uint8_t*>(line), want);
+  char* end = static_cast<char*>(memchr(line, '\n', got));
+  if (end == nullptr) {
+    return false;
+  }
+  *end = '\0';
+  nextOffset = offset + (end - line) + 1;
+  return true;
+}
+
+bool RecordJournal::seek(uint32_t since, JournalCursor& cursor) {
+  cursor.sequence = since + 1;
+  cursor.offset = journalLength;
+  cursor.last = lastSequence;
+  if (!ready) {
+    return false;
+  }
+  return since >= lastSequence || readOffset(since, cursor.offset);
+}
+
+bool RecordJournal::next(JournalCursor& cursor, char* line, size_t size) {
+  if (!ready || cursor.sequence > cursor.last) {
+    return false;
+  }
+  uint32_t nextOffset;
+  if (!readLine(cursor.offset, line, size, nextOffset) || parseSequence(line) != cursor.sequence) {
+    return false;
+  }
+  cursor.offset = nextOffset;
+  cursor.sequence++;
+  return true;
+}
+
+uint32_t RecordJournal::parseSequence(const char* line) {
+  char* end;
+  unsigned long sequence = strtoul(line, &end, 10);
+  return (end != line && *end == ',') ? (uint32_t)sequence : 0;
+}
@@ -0,0 +1,80 @@
+#ifndef RECORD_JOURNAL_H
+#define RECORD_JOURNAL_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+// ========================================
+// PRODUCTION RECORD JOURNAL
+// ========================================
+// Every production record (closed session, hourly total) is appended to
+// one journal with a sequence number that only ever grows, so a collector
+// can ask for "everything after N" (SYNC,<N>) instead of copying the card.
+//
+//   /records.txt   one text line per record, in sequence order
+//     <seq>,SESSION,<start YYYY-MM-DD hh:mm:ss>,<stop ...>,<count>
+//     <seq>,HOUR,<YYYY-MM-DD hh:00>,<count>
+//   /records.idx   uint32 text offset of record k+1 at byte 4*k
+//
+// Both are PreallocLog files (appends stay inside reserved clusters). The
+// index is dense, so finding record N is one 4-byte read. The text line
+// is written before its index entry; begin() re-indexes lines a power cut
+// left without one. Sequences are never reused: the next one is the
+// index length + 1.
+struct JournalCursor {
+  uint32_t sequence;               // Next record to read
+  uint32_t offset;                 // Its text offset
+  uint32_t last;                   // Last record when the cursor was set
+};
+
+class RecordJournal {
+public:
+  static const uint32_t JOURNAL_CAPACITY = 32768;  // ~600 records before growing
+  static const uint32_t INDEX_CAPACITY = 4096;     // 1024 records
+  static const size_t MAX_RECORD = 96;             // Line incl. '\n'
+
+  static RecordJournal& getInstance();
+
+  // Open (create) the journal after the SD card is up; repairs the index.
+  // Other paths are for tests.
+  bool begin(const char* journalPath = "/records.txt", const char* indexPath = "/records.idx");
+  bool isReady() const { return ready; }
+
+  // Append a record; returns its sequence number, 0 on failure
+  uint32_t addSession(const DateTime& start, const DateTime& stop, int count);
+  uint32_t addHour(const DateTime& hourStart, int count);
+
+  uint32_t getLastSequence() const { return lastSequence; }
+  uint32_t getRepaired() const { return repaired; }
+  uint32_t getFailed() const { return failed; }
+
+  // Reading (SYNC): records after `since`, one line per next() without
+  // the '\n'. next() returns false at cursor.last or on a read error.
+  bool seek(uint32_t since, JournalCursor& cursor);
+  bool next(JournalCursor& cursor, char* line, size_t size);
+
+  // Helpers (public for tests)
+  static uint32_t parseSequence(const char* line);
+
+private:
+  RecordJournal() {}
+
+  uint32_t append(const char* record, size_t length);
+  bool readOffset(uint32_t index, uint32_t& offset);
+  bool readLine(uint32_t offset, char* line, size_t size, uint32_t& nextOffset);
+  bool locate(const char* path, uint32_t& start, uint32_t& length);
+  void repair();
+
+  char journalPath[24] = "";
+  char indexPath[24] = "";
+  uint32_t journalStart = 0;       // Text start in the journal file (after the header)
+  uint32_t journalLength = 0;      // Text bytes
+  uint32_t indexStart = 0;
+  uint32_t lastSequence = 0;
+  bool ready = false;
+
+  uint32_t repaired = 0;
+  uint32_t failed = 0;
+};
+
+#endif // RECORD_JOURNAL_H
@@ -0,0 +1,370 @@
+#include "session_archive.h"
+#include "prealloc_log.h"
+#include "checksum.h"
+#include "read_cache.h"
+#include "managers.h"
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <strings.h>
+
+// Extern variables from main code (will be linked)
+extern bool sdAvailable;
+
+static const char SESSION_PREFIX[] = "Production_";
+static const char ARCHIVE_PREFIX[] = "Archive_";
+static const char ARCHIVE_SUFFIX[] = ".arc";
+static const size_t COPY_CHUNK = 256;
+static const size_t MONTH_KEY_LENGTH = 7;  // "YYYY-MM"
+
+// ========================================
+// SESSION ARCHIVE IMPLEMENTATION
+// ========================================
+
+SessionArchive& SessionArchive::getInstance() {
+  static SessionArchive instance;
+  return instance;
+}
+
+const char* SessionArchive::baseName(const char* filename) {
+  return (filename[0] == '/') ? filename + 1 : filename;
+}
+
+bool SessionArchive::sessionMonth(const char* filename, char* monthKey) {
+  const char* name = baseName(filename);
+  const size_t prefixLen = sizeof(SESSION_PREFIX) - 1;
+
+  // Serial commands are upper-cased, so match case-insensitively
+  if (strncasecmp(name, SESSION_PREFIX, prefixLen) != 0) return false;
+
+  const char* date = name + prefixLen;
+  for (size_t i = 0; i < MONTH_KEY_LENGTH; i++) {
+    bool dash = (i == 4);
+    if (dash ? date[i] != '-' : (date[i] < '0' || date[i] > '9')) return false;
+  }
+  if (date[MONTH_KEY_LENGTH] != '-') return false;
+
+  memcpy(monthKey, date, MONTH_KEY_LENGTH);
+  monthKey[MONTH_KEY_LENGTH] = '\0';
+  return true;
+}
+
+bool SessionArchive::isArchiveName(const char* filename) {
+  const char* name = baseName(filename);
+  size_t length = strlen(name);
+  const size_t suffixLen = sizeof(ARCHIVE_SUFFIX) - 1;
+
+  return strncasecmp(name, ARCHIVE_PREFIX, sizeof(ARCHIVE_PREFIX) - 1) == 0 &&
+         length > suffixLen && strcasecmp(name + length - suffixLen, ARCHIVE_SUFFIX) == 0;
+}
+
+void SessionArchive::formatArchivePath(char* buffer, size_t size, const char* monthKey) {
+  snprintf(buffer, size, "/%s%s%s", ARCHIVE_PREFIX, monthKey, ARCHIVE_SUFFIX);
+}
+
+void SessionArchive::seal(ArchiveHeader& header) {
+  header.magic = ARCHIVE_MAGIC;
+  header.version = ARCHIVE_VERSION;
+  header.crc = crc32(&header, offsetof(ArchiveHeader, crc));
+}
+
+bool SessionArchive::isValid(const ArchiveHeader& header) {
+  if (header.magic != ARCHIVE_MAGIC) return false;
+  if (header.version == 0 || header.version > ARCHIVE_VERSION) return false;
+  if (header.entryCount > header.maxEntries) return false;
+  return header.crc == crc32(&header, offsetof(ArchiveHeader, crc));
+}
+
+bool SessionArchive::readHeader(File& file, ArchiveHeader& header) {
+  return file.seek(0) &&
+         file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+         isValid(header);
+}
+
+bool SessionArchive::readEntry(File& file, size_t index, ArchiveEntry& entry) {
+  bool ok = file.seek(sizeof(ArchiveHeader) + index * sizeof(ArchiveEntry)) &&
+            file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(entry)) == sizeof(entry);
+  entry.name[sizeof(entry.name) - 1] = '\0';
+  return ok;
+}
+
+bool SessionArchive::readCachedHeader(const char* path, ArchiveHeader& header) {
+  return ReadCache::getInstance().read(path, 0, reinterpret_cast<uint8_t*>(&header),
+                                       sizeof(header)) == sizeof(header) &&
+         isValid(header);
+}
+
+bool SessionArchive::readCachedEntry(const char* path, size_t index, ArchiveEntry& entry) {
+  bool ok = ReadCache::getInstance().read(path,
+                                          sizeof(ArchiveHeader) + index * sizeof(ArchiveEntry),
+                                          reinterpret_cast<uint8_t*>(&entry),
+                                          sizeof(entry)) == sizeof(entry);
+  entry.name[sizeof(entry.name) - 1] = '\0';
+  return ok;
+}
+
+// ========================================
+// ROLLUP
+// ========================================
+
+bool SessionArchive::step(const DateTime& now) {
+  if (!sdAvailable) {
+    return false;
+  }
+
+  if (pendingCount == 0) {
+    if (!scanRequested) {
+      return false;
+    }
+    if (!refillBatch(now)) {
+      scanRequested = false;  // Nothing left from closed months
+      return false;
+    }
+  }
+
+  pendingCount--;
+  bool ok = archiveFile(pending[pendingCount]);
+  if (!ok) {
+    // Leave the rest for the next scan rather than retrying in a tight loop
+    failedCount++;
+    pendingCount = 0;
+    scanRequested = false;
+  }
+  return ok;
+}
+
+bool SessionArchive::refillBatch(const DateTime& now) {
+  char currentMonth[MONTH_KEY_LENGTH + 1];
+  snprintf(currentMonth, sizeof(currentMonth), "%04d-%02d", now.year(), now.month());
+
+  File root = SD.open("/");
+  if (!root) {
+    return false;
+  }
+
+  // One month per batch, so each step() touches a single container
+  char targetMonth[MONTH_KEY_LENGTH + 1] = "";
+  File file = root.openNextFile();
+  while (file && pendingCount < BATCH_SIZE) {
+    char monthKey[MONTH_KEY_LENGTH + 1];
+    const char* name = baseName(file.name());
+
+    if (!file.isDirectory() && strlen(name) < sizeof(ArchiveEntry::name) &&
+        sessionMonth(name, monthKey) && strcmp(monthKey, currentMonth) < 0) {
+      if (targetMonth[0] == '\0') {
+        strcpy(targetMonth, monthKey);
+      }
+      if (strcmp(monthKey, targetMonth) == 0) {
+        strcpy(pending[pendingCount++], name);
+      }
+    }
+    file.close();
+    file = root.openNextFile();
+  }
+  root.close();
+
+  return pendingCount > 0;
+}
+
+bool SessionArchive::createContainer(const char* path) {
+  File file = SD.open(path, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+
+  ArchiveHeader header;
+  memset(&header, 0, sizeof(header));
+  header.maxEntries = MAX_ENTRIES;
+  seal(header);
+  bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) ==
+            sizeof(header);
+
+  // Reserve the whole index up front
+  ArchiveEntry blank;
+  memset(&blank, 0, sizeof(blank));
+  for (size_t i = 0; ok && i < MAX_ENTRIES; i++) {
+    ok = file.write(reinterpret_cast<const uint8_t*>(&blank), sizeof(blank)) == sizeof(blank);
+  }
+  file.flush();
+  file.close();
+
+  if (!ok) {
+    SD.remove(path);
+  }
+  ReadCache::getInstance().invalidate(path, true);
+  return ok;
+}
+
+bool SessionArchive::archiveFile(const char* name) {
+  char monthKey[MONTH_KEY_LENGTH + 1];
+  if (!sessionMonth(name, monthKey)) {
+    return false;
+  }
+
+  char loosePath[sizeof(ArchiveEntry::name) + 1];
+  char archivePath[32];
+  snprintf(loosePath, sizeof(loosePath), "/%s", name);
+  formatArchivePath(archivePath, sizeof(archivePath), monthKey);
+
+  if (!SD.exists(archivePath) && !createContainer(archivePath)) {
+    LOG_ERROR(STORAGE, "Cannot create archive %s", archivePath);
+    return false;
+  }
+
+  File archive = SD.open(archivePath, "r+");
+  ArchiveHeader header;
+  if (!archive || !readHeader(archive, header)) {
+    LOG_ERROR(STORAGE, "Invalid archive container %s", archivePath);
+    if (archive) archive.close();
+    return false;
+  }
+
+  // Already indexed before a power cut, only the delete is missing
+  if (header.entryCount > 0) {
+    ArchiveEntry last;
+    if (readEntry(archive, header.entryCount - 1, last) && strcasecmp(last.name, name) == 0) {
+      archive.close();
+      SD.remove(loosePath);
+      ReadCache::getInstance().invalidate(loosePath, true);
+      return true;
+    }
+  }
+
+  if (header.entryCount >= header.maxEntries) {
+    archive.close();
+    LOG_WARN(STORAGE, "Archive container full %s", archivePath);
+    return false;
+  }
+
+  File loose = SD.open(loosePath, FILE_READ);
+  if (!loose) {
+    archive.close();
+    return false;
+  }
+
+  // Only the logical text is archived, never pre-allocation padding
+  LogExtent extent;
+  PreallocLog::readExtent(loose, extent);
+
+  ArchiveEntry entry;
+  memset(&entry, 0, sizeof(entry));
+  strncpy(entry.name, name, sizeof(entry.name) - 1);
+  entry.offset = archive.size();
+  entry.length = extent.length;
+
+  // 1. Text at the end of the container
+  uint8_t chunk[COPY_CHUNK];
+  uint32_t crc = crc32Begin();
+  uint32_t remaining = extent.length;
+  bool ok = archive.seek(entry.offset);
+  while (ok && remaining > 0) {
+    size_t n = (remaining < COPY_CHUNK) ? remaining : COPY_CHUNK;
+    ok = loose.read(chunk, n) == n && archive.write(chunk, n) == n;
+    crc = crc32Update(crc, chunk, n);
+    remaining -= n;
+  }
+  loose.close();
+  entry.crc = crc32End(crc);
+
+  // 2. Index entry, 3. entry count
+  if (ok) {
+    archive.flush();
+    ok = archive.seek(sizeof(ArchiveHeader) + header.entryCount * sizeof(ArchiveEntry)) &&
+         archive.write(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)) == sizeof(entry);
+  }
+  if (ok) {
+    archive.flush();
+    header.entryCount++;
+    seal(header);
+    ok = archive.seek(0) &&
+         archive.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+  }
+  archive.flush();
+  archive.close();
+  ReadCache::getInstance().invalidate(archivePath, true);
+
+  if (!ok) {
+    LOG_ERROR(STORAGE, "Failed to archive %s", name);
+    return false;
+  }
+
+  // 4. Drop the loose file
+  SD.remove(loosePath);
+  ReadCache::getInstance().invalidate(loosePath, true);
+  archivedCount++;
+  return true;
+}
+
+// ========================================
+// READING
+// ========================================
+
+struct ArchiveScan {
+  SessionArchive::EntryVisitor visitor;
+  void* context;
+  int visited;
+};
+
+static void visitArchiveFile(const char* name, uint32_t, void* context) {
+  if (!SessionArchive::isArchiveName(name)) return;
+
+  ArchiveScan* scan = static_cast<ArchiveScan*>(context);
+  char archivePath[sizeof(ArchiveEntry::name) + 1];
+  snprintf(archivePath, sizeof(archivePath), "/%s", name);
+
+  SessionArchive::getInstance().visitContainer(archivePath, scan->visitor, scan->context,
+                                               scan->visited);
+}
+
+int SessionArchive::forEachEntry(EntryVisitor visitor, void* context) {
+  if (!sdAvailable) {
+    return 0;
+  }
+
+  ArchiveScan scan = { visitor, context, 0 };
+  ReadCache::getInstance().forEachFile(visitArchiveFile, &scan);
+  return scan.visited;
+}
+
+void SessionArchive::visitContainer(const char* archivePath, EntryVisitor visitor,
+                                    void* context, int& visited) {
+  ArchiveHeader header;
+  if (!readCachedHeader(archivePath, header)) {
+    return;
+  }
+
+  ArchiveEntry entry;
+  for (size_t i = 0; i < header.entryCount && readCachedEntry(archivePath, i, entry); i++) {
+    visitor(archivePath, entry, context);
+    visited++;
+  }
+}
+
+bool SessionArchive::entryAt(const char* archivePath, size_t index, ArchiveEntry& entry) {
+  ArchiveHeader header;
+  return sdAvailable && readCachedHeader(archivePath, header) && index < header.entryCount &&
+         readCachedEntry(archivePath, index, entry);
+}
+
+bool SessionArchive::findEntry(const char* name, char* archivePath, size_t pathSize,
+                               ArchiveEntry& entry) {
+  char monthKey[MONTH_KEY_LENGTH + 1];
+  if (!sdAvailable || !sessionMonth(name, monthKey)) {
+    return false;
+  }
+
+  formatArchivePath(archivePath, pathSize, monthKey);
+
+  ArchiveHeader header;
+  if (!readCachedHeader(archivePath, header)) {
+    return false;
+  }
+
+  const char* wanted = baseName(name);
+  for (size_t i = 0; i < header.entryCount && readCachedEntry(archivePath, i, entry); i++) {
+    if (strcasecmp(entry.name, wanted) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,109 @@
+#ifndef SESSION_ARCHIVE_H
+#define SESSION_ARCHIVE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <RTClib.h>
+
+// ========================================
+// MONTHLY SESSION ARCHIVE
+// ========================================
+// Every production session leaves a small Production_*.txt file, each
+// costing a directory entry and a whole cluster. Once a month is closed,
+// its session files are merged into one container:
+//
+//   /Archive_YYYY-MM.arc
+//   [ArchiveHeader 16 B][ArchiveEntry x MAX_ENTRIES][session text...]
+//
+// The index is reserved at full size when the container is created, so
+// adding a session never moves existing data. Rollup is incremental (one
+// file per step()) and crash-safe:
+//   1. append the session text at the end of the container
+//   2. write its index entry
+//   3. bump entryCount in the header (single-sector write)
+//   4. delete the loose file
+// A power cut before 3 leaves unreferenced bytes at the end; a cut
+// between 3 and 4 is detected by comparing with the last entry.
+struct __attribute__((packed)) ArchiveHeader {
+  uint32_t magic;                  // ARCHIVE_MAGIC
+  uint16_t version;                // ARCHIVE_VERSION
+  uint16_t entryCount;             // Valid entries in the index
+  uint32_t maxEntries;             // Index capacity (fixed at creation)
+  uint32_t crc;                    // CRC32 of the preceding bytes
+};
+
+struct __attribute__((packed)) ArchiveEntry {
+  char name[40];                   // "Production_2025-11-15_14h30m-16h45m.txt"
+  uint32_t offset;                 // Absolute file offset of the text
+  uint32_t length;                 // Text length in bytes
+  uint32_t crc;                    // CRC32 of the text
+};
+
+static const uint32_t ARCHIVE_MAGIC = 0x52414350;  // "PCAR"
+static const uint16_t ARCHIVE_VERSION = 1;
+
+static_assert(sizeof(ArchiveHeader) == 16, "ArchiveHeader must stay 16 bytes");
+static_assert(sizeof(ArchiveEntry) == 52, "ArchiveEntry must stay 52 bytes");
+
+class SessionArchive {
+public:
+  static const size_t MAX_ENTRIES = 512;     // ~16 sessions/day for a month
+  static const size_t BATCH_SIZE = 8;        // File names collected per directory scan
+
+  // Called for every archived session (see forEachEntry)
+  typedef void (*EntryVisitor)(const char* archivePath, const ArchiveEntry& entry,
+                               void* context);
+
+  static SessionArchive& getInstance();
+
+  // Background rollup: archives at most one loose session file from a
+  // closed month. Returns true if a file was archived.
+  bool step(const DateTime& now);
+
+  // Look for closed months again (boot, day change)
+  void requestScan() { scanRequested = true; }
+  bool isIdle() const { return !scanRequested && pendingCount == 0; }
+
+  // Reading (through ReadCache) - visits all entries of all containers,
+  // returns the entry count
+  int forEachEntry(EntryVisitor visitor, void* context);
+
+  // Entry `index` of one container, false past its last entry
+  bool entryAt(const char* archivePath, size_t index, ArchiveEntry& entry);
+
+  // Locate `name` in its month's container; text is at entry.offset
+  bool findEntry(const char* name, char* archivePath, size_t pathSize, ArchiveEntry& entry);
+  void visitContainer(const char* archivePath, EntryVisitor visitor, void* context,
+                      int& visited);
+
+  // Helpers (public for tests)
+  static bool sessionMonth(const char* filename, char* monthKey);  // "YYYY-MM"
+  static bool isArchiveName(const char* filename);
+  static void formatArchivePath(char* buffer, size_t size, const char* monthKey);
+  static bool isValid(const ArchiveHeader& header);
+  static void seal(ArchiveHeader& header);
+
+  // Statistics
+  uint32_t getArchivedCount() const { return archivedCount; }
+  uint32_t getFailedCount() const { return failedCount; }
+
+private:
+  SessionArchive() {}
+
+  bool refillBatch(const DateTime& now);
+  bool archiveFile(const char* name);
+  bool createContainer(const char* path);
+  static bool readHeader(File& file, ArchiveHeader& header);
+  static bool readEntry(File& file, size_t index, ArchiveEntry& entry);
+  static bool readCachedHeader(const char* path, ArchiveHeader& header);
+  static bool readCachedEntry(const char* path, size_t index, ArchiveEntry& entry);
+  static const char* baseName(const char* filename);
+
+  char pending[BATCH_SIZE][sizeof(ArchiveEntry::name)];
+  size_t pendingCount = 0;
+  bool scanRequested = true;
+  uint32_t archivedCount = 0;
+  uint32_t failedCount = 0;
+};
+
+#endif // SESSION_ARCHIVE_H
@@ -0,0 +1,150 @@
+#include "soft_clock.h"
+
+// Uncertainty of the edge prediction before drift has been measured
+// (crystal tolerance of the MCU, generous)
+static const int64_t UNMEASURED_DRIFT_PPM = 100;
+static const float MAX_DRIFT_PPM = 500.0f;
+
+// ========================================
+// SOFTWARE CLOCK IMPLEMENTATION
+// ========================================
+
+SoftClock::SoftClock() : resyncUs((int64_t)DEFAULT_RESYNC_MS * 1000) {
+}
+
+void SoftClock::begin(ReadSeconds reader, uint32_t resyncMs) {
+  read = reader;
+  setResyncInterval(resyncMs);
+  nextSyncUs = 0;  // First poll() syncs
+}
+
+void SoftClock::setResyncInterval(uint32_t resyncMs) {
+  if (resyncMs < MIN_RESYNC_MS) resyncMs = MIN_RESYNC_MS;
+  if (resyncMs > MAX_RESYNC_MS) resyncMs = MAX_RESYNC_MS;
+
+  // Whole seconds, so the next resync lands on a predicted RTC edge
+  resyncUs = (int64_t)((resyncMs + 500) / 1000) * 1000000;
+  if (synced && !capturing) {
+    nextSyncUs = anchorUs + resyncUs;
+  }
+}
+
+void SoftClock::requestSync(int64_t nowUs) {
+  if (!capturing) {
+    nextSyncUs = nowUs;
+  }
+}
+
+void SoftClock::set(uint32_t unixSeconds, int64_t nowUs) {
+  // Writing the seconds register restarts the RTC's 1 Hz divider, so
+  // its next edge is ~1 s away - resync right after to lock the phase
+  anchorUnix = unixSeconds;
+  anchorUs = nowUs;
+  synced = true;
+  capturing = false;
+  steps++;
+  nextSyncUs = nowUs;
+}
+
+int64_t SoftClock::unixMicros(int64_t nowUs) const {
+  int64_t elapsed = nowUs - anchorUs;
+  int64_t correction = (int64_t)((float)elapsed * driftPpm * 1e-6f);
+  return (int64_t)anchorUnix * 1000000 + elapsed - correction;
+}
+
+uint32_t SoftClock::unixTime(int64_t nowUs) const {
+  return (uint32_t)(unixMicros(nowUs) / 1000000);
+}
+
+int64_t SoftClock::timerAt(uint32_t unixSeconds) const {
+  // Inverse of unixMicros(); double keeps an hour ahead exact to ~1 us
+  int64_t delta = ((int64_t)unixSeconds - (int64_t)anchorUnix) * 1000000;
+  return anchorUs + (int64_t)((double)delta / (1.0 - driftPpm * 1e-6));
+}
+
+bool SoftClock::poll(int64_t nowUs) {
+  if (read == nullptr) {
+    return false;
+  }
+
+  if (!capturing) {
+    int64_t lead = 0;
+    if (synced) {
+      lead = CAPTURE_LEAD_US;
+      if (!driftMeasured) lead += resyncUs / 1000000 * UNMEASURED_DRIFT_PPM;
+    }
+    if (nowUs < nextSyncUs - lead) {
+      return false;
+    }
+    capturing = true;
+    haveCaptureSecond = false;
+    captureStartUs = nowUs;
+  } else if (nowUs - lastReadUs < CAPTURE_READ_US) {
+    return true;
+  }
+
+  uint32_t seconds;
+  rtcReads++;
+  if (!read(seconds)) {
+    failCapture(nowUs);
+    return false;
+  }
+
+  if (haveCaptureSecond && seconds != captureSecond) {
+    // The RTC ticked between the previous read and this one
+    capturing = false;
+    anchor(seconds, lastReadUs + (nowUs - lastReadUs) / 2);
+    return false;
+  }
+
+  captureSecond = seconds;
+  haveCaptureSecond = true;
+  lastReadUs = nowUs;
+  if (nowUs - captureStartUs > CAPTURE_TIMEOUT_US) {
+    failCapture(nowUs);  // Seconds never changed - oscillator stopped?
+    return false;
+  }
+  return true;
+}
+
+void SoftClock::anchor(uint32_t unixSeconds, int64_t edgeUs) {
+  if (synced) {
+    int64_t offset = unixMicros(edgeUs) - (int64_t)unixSeconds * 1000000;
+    int64_t elapsed = edgeUs - anchorUs;
+
+    if (offset > MAX_STEP_US || offset < -MAX_STEP_US) {
+      steps++;  // RTC was set elsewhere - not drift
+    } else if (elapsed >= MIN_DRIFT_INTERVAL_US) {
+      // Residual rate error since the last edge; halve it once a first
+      // estimate exists so edge jitter (one poll) averages out
+      float residual = (float)offset * 1e6f / (float)elapsed;
+      driftPpm += driftMeasured ? residual / 2 : residual;
+      if (driftPpm > MAX_DRIFT_PPM) driftPpm = MAX_DRIFT_PPM;
+      if (driftPpm < -MAX_DRIFT_PPM) driftPpm = -MAX_DRIFT_PPM;
+      driftMeasured = true;
+    }
+
+    if (offset > INT32_MAX) offset = INT32_MAX;
+    if (offset < INT32_MIN) offset = INT32_MIN;
+    lastOffsetUs = (int32_t)offset;
+  }
+
+  anchorUnix = unixSeconds;
+  anchorUs = edgeUs;
+  synced = true;
+  syncCount++;
+  retryUs = RETRY_US;
+
+  // Next resync on a predicted edge, in MCU timer time
+  nextSyncUs = edgeUs + resyncUs + (int64_t)((float)resyncUs * driftPpm * 1e-6f);
+}
+
+void SoftClock::failCapture(int64_t nowUs) {
+  capturing = false;
+  failedSyncs++;
+
+  // Back off while the RTC stays unreadable (each capture is ~1500 reads)
+  nextSyncUs = nowUs + retryUs;
+  retryUs *= 2;
+  if (retryUs > resyncUs) retryUs = resyncUs;
+}
@@ -0,0 +1,103 @@
+#ifndef SOFT_CLOCK_H
+#define SOFT_CLOCK_H
+
+#include <stdint.h>
+
+// ========================================
+// SOFTWARE CLOCK DISCIPLINED FROM THE RTC
+// ========================================
+// Reading the DS3231 is an I2C transaction per call. The software clock
+// keeps Unix time from the MCU's 64-bit microsecond timer instead, so
+// reading the time costs nothing on the bus.
+//
+// The RTC only has 1 s resolution, so a resync captures a seconds edge:
+// the RTC is read every poll() from just before the predicted edge until
+// its seconds value changes. The time of the change anchors the clock,
+// within one poll interval (~1 ms from loop()). Comparing the edge with
+// the software clock's prediction gives the oscillator drift, which is
+// corrected between resyncs.
+//
+// Times are passed in (monotonic microseconds) so the clock can be
+// simulated on the host; the RTC is reached through a read callback.
+class SoftClock {
+public:
+  // One RTC read. Returns false on bus error / implausible time.
+  typedef bool (*ReadSeconds)(uint32_t& unixSeconds);
+
+  static const uint32_t DEFAULT_RESYNC_MS = 600000;        // 10 minutes
+  static const uint32_t MIN_RESYNC_MS = 10000;
+  static const uint32_t MAX_RESYNC_MS = 86400000;          // 24 hours
+  static const int64_t CAPTURE_LEAD_US = 20000;           // Start reading before the edge
+  static const int64_t CAPTURE_TIMEOUT_US = 1500000;      // No edge seen -> RTC stopped
+  static const int64_t CAPTURE_READ_US = 1000;            // At most one RTC read per ms
+  static const int64_t RETRY_US = 10000000;               // After a failed resync, doubling
+  static const int64_t MIN_DRIFT_INTERVAL_US = 60000000;  // Too short to measure drift
+  static const int64_t MAX_STEP_US = 1000000;             // Larger offsets are time changes
+
+  SoftClock();
+
+  // Resync cadence (rounded to whole seconds, clamped to the limits above)
+  void begin(ReadSeconds reader, uint32_t resyncMs = DEFAULT_RESYNC_MS);
+  void setResyncInterval(uint32_t resyncMs);
+  uint32_t getResyncInterval() const { return (uint32_t)(resyncUs / 1000); }
+
+  // Drive resyncs; call every loop pass. Returns true while capturing.
+  bool poll(int64_t nowUs);
+
+  // Start a resync now (first sync, after the RTC has been set)
+  void requestSync(int64_t nowUs);
+
+  // Set the time directly (e.g. right after writing it to the RTC)
+  void set(uint32_t unixSeconds, int64_t nowUs);
+
+  bool isSynced() const { return synced; }
+  bool isCapturing() const { return capturing; }
+
+  // Current time (valid once synced)
+  uint32_t unixTime(int64_t nowUs) const;
+  int64_t unixMicros(int64_t nowUs) const;
+
+  // MCU timer time at which the clock will read `unixSeconds`.0
+  // (deadlines the ISRs can compare against without any float math)
+  int64_t timerAt(uint32_t unixSeconds) const;
+
+  // Diagnostics
+  float getDriftPpm() const { return driftPpm; }           // MCU timer vs RTC, + = fast
+  int32_t getLastOffsetMicros() const { return lastOffsetUs; }  // + = clock was ahead
+  uint32_t getSyncCount() const { return syncCount; }
+  uint32_t getFailedSyncs() const { return failedSyncs; }
+  uint32_t getSteps() const { return steps; }
+  uint32_t getRtcReads() const { return rtcReads; }
+  int64_t getLastSyncMicros() const { return anchorUs; }
+
+private:
+  void anchor(uint32_t unixSeconds, int64_t edgeUs);
+  void failCapture(int64_t nowUs);
+
+  ReadSeconds read = nullptr;
+  int64_t resyncUs;
+
+  // Unix time anchorUnix started (RTC edge) at anchorUs
+  bool synced = false;
+  uint32_t anchorUnix = 0;
+  int64_t anchorUs = 0;
+  float driftPpm = 0;
+  bool driftMeasured = false;
+  int64_t nextSyncUs = 0;
+  int64_t retryUs = RETRY_US;
+
+  // Edge capture
+  bool capturing = false;
+  bool haveCaptureSecond = false;
+  uint32_t captureSecond = 0;
+  int64_t captureStartUs = 0;
+  int64_t lastReadUs = 0;
+
+  int32_t lastOffsetUs = 0;
+  uint32_t syncCount = 0;
+  uint32_t failedSyncs = 0;
+  uint32_t steps = 0;
+  uint32_t rtcReads = 0;
+};
+
+#endif // SOFT_CLOCK_H
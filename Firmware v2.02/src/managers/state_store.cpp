@@ -0,0 +1,280 @@
+#include "state_store.h"
+#include "checksum.h"
+#include "read_cache.h"
+#include "managers.h"
+#include <SD.h>
+#include <RTClib.h>
+#include <cstring>
+#include <cstdlib>
+#include <cstddef>
+
+// Extern variables from main code (will be linked)
+extern bool sdAvailable;
+
+const char* StateStore::STATE_FILE = "/state.bin";
+
+// Legacy files imported once, then removed
+static const char* LEGACY_COUNT_FILE = "/count.txt";
+static const char* LEGACY_HOURLY_FILE = "/hourly_count.txt";
+static const char* LEGACY_CUMULATIVE_FILE = "/cumulative_count.txt";
+static const char* LEGACY_SESSION_FILE = "/prod_session.txt";
+
+static const int STATE_SLOT_COUNT = 2;
+static const int STATE_SLOT_SIZE = sizeof(PersistentStateRecord);
+static const int LEGACY_MAX_COUNT = 99999;
+
+// ========================================
+// STATE STORE IMPLEMENTATION
+// ========================================
+
+StateStore& StateStore::getInstance() {
+  static StateStore instance;
+  return instance;
+}
+
+StateStore::StateStore() {
+  resetRecord(record);
+}
+
+void StateStore::resetRecord(PersistentStateRecord& rec) {
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = STATE_RECORD_MAGIC;
+  rec.version = STATE_RECORD_VERSION;
+  rec.length = sizeof(PersistentStateRecord);
+  rec.lastHour = 0xFF;
+}
+
+void StateStore::seal(PersistentStateRecord& rec) {
+  rec.magic = STATE_RECORD_MAGIC;
+  rec.version = STATE_RECORD_VERSION;
+  rec.length = sizeof(PersistentStateRecord);
+  rec.crc = crc32(&rec, offsetof(PersistentStateRecord, crc));
+}
+
+bool StateStore::isValid(const PersistentStateRecord& rec) {
+  if (rec.magic != STATE_RECORD_MAGIC) return false;
+  if (rec.length != sizeof(PersistentStateRecord)) return false;
+  if (rec.version == 0 || rec.version > STATE_RECORD_VERSION) return false;
+  return rec.crc == crc32(&rec, offsetof(PersistentStateRecord, crc));
+}
+
+bool StateStore::begin() {
+  loaded = false;
+  resetRecord(record);
+
+  if (!sdAvailable) {
+    LOG_ERROR(STORAGE, "SD card not available");
+    return false;
+  }
+
+  if (SD.exists(STATE_FILE) && loadSlots()) {
+    loaded = true;
+    LOG_INFO(STORAGE, "Loaded state | Seq: %lu | Count: %ld", record.sequence, record.currentCount);
+    return true;
+  }
+
+  // No usable state block - create one, seeded from the legacy files
+  if (!createFile()) {
+    LOG_ERROR(STORAGE, "Cannot create state file");
+    return false;
+  }
+
+  bool imported = importLegacyFiles();
+  if (!commit()) {
+    return false;
+  }
+
+  // Only drop the legacy files once the imported values are safely on disk
+  if (imported) {
+    SD.remove(LEGACY_COUNT_FILE);
+    SD.remove(LEGACY_HOURLY_FILE);
+    SD.remove(LEGACY_CUMULATIVE_FILE);
+    SD.remove(LEGACY_SESSION_FILE);
+    ReadCache::getInstance().invalidateAll();
+    LOG_INFO(STORAGE, "Legacy count files imported and removed");
+  }
+
+  loaded = true;
+  return true;
+}
+
+bool StateStore::loadSlots() {
+  File file = SD.open(STATE_FILE, FILE_READ);
+  if (!file) {
+    return false;
+  }
+
+  // Both slots in a single read
+  PersistentStateRecord slots[STATE_SLOT_COUNT];
+  memset(slots, 0, sizeof(slots));
+  size_t bytesRead = file.read(reinterpret_cast<uint8_t*>(slots), sizeof(slots));
+  file.close();
+
+  int best = -1;
+  for (int i = 0; i < STATE_SLOT_COUNT; i++) {
+    if ((i + 1) * STATE_SLOT_SIZE > (int)bytesRead) break;
+    if (!isValid(slots[i])) {
+      LOG_WARN(STORAGE, "State slot %d invalid", i);
+      continue;
+    }
+    // Signed difference handles sequence wrap-around
+    if (best < 0 || (int32_t)(slots[i].sequence - slots[best].sequence) > 0) {
+      best = i;
+    }
+  }
+
+  if (best < 0) {
+    LOG_WARN(STORAGE, "No valid state slot found");
+    return false;
+  }
+
+  record = slots[best];
+  return true;
+}
+
+bool StateStore::createFile() {
+  File file = SD.open(STATE_FILE, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+
+  // Pre-size both slots with invalid (zeroed) records
+  uint8_t zeros[STATE_SLOT_SIZE * STATE_SLOT_COUNT];
+  memset(zeros, 0, sizeof(zeros));
+  size_t written = file.write(zeros, sizeof(zeros));
+  file.flush();
+  file.close();
+  ReadCache::getInstance().invalidate(STATE_FILE, true);
+
+  return written == sizeof(zeros);
+}
+
+bool StateStore::commit() {
+  if (!sdAvailable) {
+    failedCommits++;
+    return false;
+  }
+
+  unsigned long startTime = micros();
+
+  PersistentStateRecord next = record;
+  next.sequence = record.sequence + 1;
+  next.savedAtUnix = TimeManager::getInstance().getUnixTime();  // 0 without a clock
+  seal(next);
+
+  // "r+" keeps the other slot intact (FILE_WRITE would truncate)
+  File file = SD.open(STATE_FILE, "r+");
+  if (!file) {
+    failedCommits++;
+    LOG_ERROR(STORAGE, "Cannot open state file");
+    return false;
+  }
+
+  int slot = next.sequence % STATE_SLOT_COUNT;
+  bool ok = file.seek(slot * STATE_SLOT_SIZE) &&
+            file.write(reinterpret_cast<const uint8_t*>(&next), sizeof(next)) == sizeof(next);
+  file.flush();
+  file.close();
+  ReadCache::getInstance().invalidate(STATE_FILE, false);  // Size never changes
+
+  if (!ok) {
+    failedCommits++;
+    LOG_ERROR(STORAGE, "State commit failed");
+    return false;
+  }
+
+  record = next;
+  commitCount++;
+  lastCommitMicros = micros() - startTime;
+  return true;
+}
+
+// ========================================
+// LEGACY IMPORT
+// ========================================
+
+int StateStore::readLegacyCount(const char* filename) {
+  File file = SD.open(filename, FILE_READ);
+  if (!file) {
+    return 0;
+  }
+
+  char buffer[12] = {0};
+  file.read(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer) - 1);
+  file.close();
+
+  int count = atoi(buffer);
+  if (count < 0 || count > LEGACY_MAX_COUNT) {
+    count = 0;
+  }
+  return count;
+}
+
+bool StateStore::importLegacyFiles() {
+  bool hasCount = SD.exists(LEGACY_COUNT_FILE);
+  bool hasHourly = SD.exists(LEGACY_HOURLY_FILE);
+  bool hasCumulative = SD.exists(LEGACY_CUMULATIVE_FILE);
+  bool hasSession = SD.exists(LEGACY_SESSION_FILE);
+
+  if (!hasCount && !hasHourly && !hasCumulative && !hasSession) {
+    LOG_INFO(STORAGE, "No legacy files - starting fresh");
+    return false;
+  }
+
+  LOG_INFO(STORAGE, "Importing legacy count files...");
+
+  if (hasCount) record.currentCount = readLegacyCount(LEGACY_COUNT_FILE);
+  if (hasHourly) record.hourlyCount = readLegacyCount(LEGACY_HOURLY_FILE);
+  if (hasCumulative) record.cumulativeCount = readLegacyCount(LEGACY_CUMULATIVE_FILE);
+  record.countAtHourStart = 0;
+
+  if (hasSession) {
+    File file = SD.open(LEGACY_SESSION_FILE, FILE_READ);
+    if (file) {
+      char buffer[96] = {0};
+      file.read(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer) - 1);
+      file.close();
+
+      if (strncmp(buffer, "ACTIVE", 6) == 0) {
+        // v2.02 format: "ACTIVE\n<count>\n" (no start time recorded)
+        record.productionActive = 1;
+        record.currentCount = atoi(buffer + 7);
+        record.productionStartCount = 0;
+        record.productionStartUnix = TimeManager::getInstance().getUnixTime();
+      } else {
+        // code_v3 format: one value per line
+        // currentCount, startCount, year, month, day, hour, minute, second
+        long values[8] = {0};
+        char* cursor = buffer;
+        int parsed = 0;
+        while (parsed < 8 && *cursor) {
+          char* end = nullptr;
+          values[parsed] = strtol(cursor, &end, 10);
+          if (end == cursor) break;
+          parsed++;
+          cursor = end;
+        }
+
+        if (parsed == 8 && values[2] >= 2020 && values[2] <= 2100 &&
+            values[3] >= 1 && values[3] <= 12 && values[4] >= 1 && values[4] <= 31 &&
+            values[5] <= 23 && values[6] <= 59 && values[7] <= 59) {
+          DateTime start(values[2], values[3], values[4], values[5], values[6], values[7]);
+          record.productionActive = 1;
+          record.currentCount = values[0];
+          record.productionStartCount = values[1];
+          record.productionStartUnix = start.unixtime();
+          record.countAtHourStart = values[0];
+        } else {
+          LOG_WARN(STORAGE, "Corrupted legacy session file ignored");
+        }
+      }
+    }
+  }
+
+  record.flags |= STATE_FLAG_IMPORTED_LEGACY;
+
+  LOG_INFO(STORAGE, "Imported | Count: %ld | Hourly: %ld | Cumulative: %ld | Session: %s",
+           record.currentCount, record.hourlyCount, record.cumulativeCount,
+           record.productionActive ? "ACTIVE" : "NONE");
+  return true;
+}
@@ -0,0 +1,103 @@
+#ifndef STATE_STORE_H
+#define STATE_STORE_H
+
+#include <Arduino.h>
+
+// ========================================
+// PERSISTENT STATE RECORD
+// ========================================
+// One fixed-layout record holds every counter and the active production
+// session. It replaces the four legacy text files:
+//   /count.txt, /hourly_count.txt, /cumulative_count.txt, /prod_session.txt
+// which were rewritten one at a time and could disagree after a crash.
+//
+// Layout rules:
+// - Little-endian, packed, exactly 64 bytes (one SD write, one SD read)
+// - New fields go into `reserved` so existing offsets never move
+// - Bump STATE_RECORD_VERSION when the meaning of a field changes
+struct __attribute__((packed)) PersistentStateRecord {
+  uint32_t magic;                  // STATE_RECORD_MAGIC
+  uint16_t version;                // STATE_RECORD_VERSION
+  uint16_t length;                 // sizeof(PersistentStateRecord)
+  uint32_t sequence;               // Incremented on every commit
+
+  // Counters
+  int32_t currentCount;
+  int32_t hourlyCount;             // Count logged for the last completed hour
+  int32_t cumulativeCount;
+  int32_t countAtHourStart;
+
+  // Production session
+  int32_t productionStartCount;
+  uint32_t productionStartUnix;    // 0 when no session is active
+  uint8_t productionActive;
+  uint8_t lastHour;                // 0-23, 0xFF = unknown
+  uint8_t flags;                   // STATE_FLAG_*
+  uint8_t reserved8;
+
+  uint32_t savedAtUnix;            // RTC time of this commit (0 if no RTC)
+  uint32_t reserved[4];            // Room for growth without relocation
+
+  uint32_t crc;                    // CRC32 of all preceding bytes
+};
+
+static const uint32_t STATE_RECORD_MAGIC = 0x54534350;  // "PCST"
+static const uint16_t STATE_RECORD_VERSION = 1;
+static const uint8_t STATE_FLAG_IMPORTED_LEGACY = 0x01;
+
+static_assert(sizeof(PersistentStateRecord) == 64,
+              "PersistentStateRecord must stay 64 bytes");
+
+// ========================================
+// STATE STORE
+// ========================================
+// The record lives in /state.bin as two slots (A/B). Each commit writes the
+// complete record into the slot not holding the newest copy, so a power cut
+// mid-write can only damage the copy being replaced. Load reads both slots
+// in one read and keeps the valid slot with the highest sequence number.
+class StateStore {
+public:
+  static StateStore& getInstance();
+
+  // Load from /state.bin, or import the legacy text files once.
+  // Returns false only if the SD card is unusable.
+  bool begin();
+
+  // Write the current record to the next slot.
+  bool commit();
+
+  // Record access (modify fields, then commit())
+  PersistentStateRecord& data() { return record; }
+  const PersistentStateRecord& data() const { return record; }
+
+  // Status
+  bool isLoaded() const { return loaded; }
+  bool wasImported() const { return (record.flags & STATE_FLAG_IMPORTED_LEGACY) != 0; }
+  uint32_t getSequence() const { return record.sequence; }
+  uint32_t getCommitCount() const { return commitCount; }
+  uint32_t getFailedCommitCount() const { return failedCommits; }
+  unsigned long getLastCommitMicros() const { return lastCommitMicros; }
+
+  // Validation (public for tests)
+  static bool isValid(const PersistentStateRecord& rec);
+  static void resetRecord(PersistentStateRecord& rec);
+  static void seal(PersistentStateRecord& rec);
+
+  static const char* STATE_FILE;
+
+private:
+  StateStore();
+
+  bool loadSlots();
+  bool createFile();
+  bool importLegacyFiles();
+  static int readLegacyCount(const char* filename);
+
+  PersistentStateRecord record;
+  bool loaded = false;
+  uint32_t commitCount = 0;
+  uint32_t failedCommits = 0;
+  unsigned long lastCommitMicros = 0;
+};
+
+#endif // STATE_STORE_H
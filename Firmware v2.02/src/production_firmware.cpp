@@ -21,12 +21,26 @@
 #include <SD.h>
 #include <RTClib.h>
 #include <EEPROM.h>
+#include <esp_timer.h>
 
 // FSM Headers
 #include "state_manager.h"
 #include "state_handlers.h"
+#include "command_parser.h"
 #include "managers.h"
+#include "state_store.h"
+#include "checkpoint_ring.h"
+#include "prealloc_log.h"
+#include "session_archive.h"
+#include "read_cache.h"
+#include "bulk_transfer.h"
+#include "record_journal.h"
+#include "checksum.h"
+#include "display_link.h"
+#include "hour_boundary.h"
 #include "hal.h"
+#include "serial_out.h"
+#include "line_reader.h"
 
 // ============================================================================
 // PIN DEFINITIONS (Same as original code_v3.cpp)
@@ -35,6 +49,7 @@
 #define INTERRUPT_PIN 15      // Counter button (to GND)
 #define DIAGNOSTIC_PIN 27     // Diagnostic button (to GND)
 #define LATCHING_PIN 25       // Production latching button (to GND)
+#define RTC_INT_PIN 4         // DS3231 INT/SQW (open drain, -1 = not wired)
 
 // OLED Display - I2C
 #define SCREEN_WIDTH 128
@@ -45,6 +60,8 @@
 // I2C pins (default for ESP32)
 #define I2C_SDA 21
 #define I2C_SCL 22
+#define OLED_I2C_RATED_HZ 400000   // SSD1306 datasheet (many modules also run at 1 MHz)
+#define RTC_I2C_RATED_HZ 400000    // DS3231
 
 // SD Card - VSPI (SPI3)
 #define SD_CS_PIN 26
@@ -65,17 +82,22 @@ RTC_DS3231 rtc;
 // ============================================================================
 
 StateManager& fsm = StateManager::getInstance();
+HourBoundary& hourBoundary = HourBoundary::getInstance();
 
 // Timing for periodic operations
 static unsigned long lastSaveTime = 0;
+static unsigned long lastCheckpointTime = 0;
 static unsigned long lastHealthCheckTime = 0;
-static unsigned long lastDisplayUpdateTime = 0;
 static unsigned long lastHourChangeTime = 0;
+static unsigned long lastArchiveStepTime = 0;
 
 // Configuration
-static const unsigned long SAVE_INTERVAL = 5000;
+static const unsigned long SD_CONSOLIDATE_INTERVAL = 60000;  // Full state block on SD
 static const unsigned long HEALTH_CHECK_INTERVAL = 30000;
-static const unsigned long DISPLAY_UPDATE_INTERVAL = 100;
+static const unsigned long STATUS_MESSAGE_HOLD = 1000;       // Status message before main screen
+static const unsigned long ARCHIVE_STEP_INTERVAL = 1000;     // One session file per step
+static const unsigned long RTC_RESYNC_INTERVAL = 600000;     // Software clock <- DS3231
+static const size_t SERIAL_RX_BUFFER = 1024;                 // UART driver input buffer
 
 // Startup retry configuration
 static const int MAX_STARTUP_RETRIES = 3;
@@ -92,11 +114,49 @@ volatile int lastHour = -1;
 bool rtcAvailable = false;
 bool sdAvailable = false;
 
-// File paths (backward compatible with code_v3.cpp)
-const char* COUNT_FILE = "/count.txt";
-const char* HOURLY_FILE = "/hourly_count.txt";
-const char* CUMULATIVE_FILE = "/cumulative_count.txt";
-const char* PRODUCTION_STATE_FILE = "/prod_session.txt";
+// Count at the start of the current hour (for hourly totals)
+int countAtHourStart = 0;
+
+// Persistence helpers (defined below)
+void saveState();
+bool writeCheckpoint();
+void restoreFromCheckpoint();
+void logProductionSession(uint32_t startUnix, int sessionCount);
+void prepareLogFiles(const DateTime& now);
+
+// Hour boundary helpers (defined below)
+void configureHourAlarm();
+void armHourDeadline();
+void serviceHourBoundary(const DateTime& now);
+void handleHourChange(int finalCount);
+
+// FSM trace dump (TRACE command, defined below)
+void startTraceDump();
+void serviceTraceDump();
+
+// Record sync (SYNC command, defined below)
+void startRecordSync(uint32_t since);
+void serviceRecordSync();
+
+// Serial commands (defined below): assembled from a few bytes per loop pass
+void handleSerialInput();
+static LineReader serialLine;
+static uint32_t serialInputWorstUs = 0;   // Longest pass, incl. the command
+
+// Runtime settings (ConfigManager snapshot subscribers, defined below)
+void subscribeToConfig();
+void applySettings(const ConfigManager::Settings& next);
+
+// Copied from each published settings snapshot
+static volatile unsigned long counterDebounceMs = 50;   // Read by the counter ISR
+static unsigned long checkpointIntervalMs = 5000;       // EEPROM checkpoint ring
+
+// Day whose DailyProduction log has been pre-allocated (0 = none yet)
+static uint8_t preparedLogDay = 0;
+
+// Counters and session state are persisted in one binary record
+// (/state.bin, see state_store.h). The legacy count.txt, hourly_count.txt,
+// cumulative_count.txt and prod_session.txt are imported once on first boot.
 
 // Status for compatibility
 enum CompatibilityStatus {
@@ -113,11 +173,13 @@ CompatibilityStatus currentStatus = STATUS_INITIALIZING;
 // ============================================================================
 
 void IRAM_ATTR handleCounterButton() {
+  int64_t pulseMicros = esp_timer_get_time();
   unsigned long currentTime = millis();
   static unsigned long lastInterruptTime = 0;
   
-  if (currentTime - lastInterruptTime > 50) {  // Debounce
+  if (currentTime - lastInterruptTime > counterDebounceMs) {  // Debounce
     if (productionActive) {
+      hourBoundary.onPulse(pulseMicros, currentCount);  // Closes the hour if past hh:00
       fsm.queueEvent(EVT_ITEM_COUNTED);
       ProductionManager::getInstance().incrementCount();
       currentCount++;
@@ -137,6 +199,12 @@ void IRAM_ATTR handleDiagnosticButton() {
   }
 }
 
+// DS3231 alarm 2 (minute 00): snapshot the count exactly at the boundary
+void IRAM_ATTR handleHourAlarm() {
+  hourBoundary.onAlarm(esp_timer_get_time(), currentCount);
+  fsm.queueEvent(EVT_HOUR_CHANGED);
+}
+
 void IRAM_ATTR handleProductionLatch() {
   static unsigned long lastTime = 0;
   unsigned long now = millis();
@@ -158,8 +226,10 @@ void IRAM_ATTR handleProductionLatch() {
 bool initializeHardware() {
   LoggerManager::info("=== HARDWARE INITIALIZATION ===");
   
-  // Initialize I2C
-  Wire.begin(I2C_SDA, I2C_SCL);
+  // Initialize I2C (shared by OLED and RTC through the HAL bus scheduler)
+  I2C::init(I2C_SDA, I2C_SCL);
+  I2C::addDevice(SCREEN_ADDRESS, "OLED", OLED_I2C_RATED_HZ);
+  I2C::addDevice(TimeManager::RTC_ADDRESS, "RTC", RTC_I2C_RATED_HZ);
   LoggerManager::info("I2C initialized");
   
   // Initialize OLED
@@ -167,6 +237,7 @@ bool initializeHardware() {
     LoggerManager::error("OLED initialization failed");
     return false;
   }
+  DisplayManager::getInstance().initialize();
   LoggerManager::info("OLED initialized");
   
   // Initialize SD
@@ -195,46 +266,58 @@ bool initializeHardware() {
     LoggerManager::warn("SD card initialization failed");
   }
   
-  // Initialize RTC
-  if (!rtc.begin()) {
+  // Initialize RTC (RTClib drives Wire itself - hold the shared bus, the
+  // display task may already be pushing frames)
+  {
+    I2C::Transaction bus(TimeManager::RTC_ADDRESS);
+    rtcAvailable = rtc.begin();
+    if (rtcAvailable && rtc.lostPower()) {
+      LoggerManager::warn("RTC lost power - setting compile time");
+      rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+    }
+  }
+  
+  // Both devices are up (the display and RTC libraries reset the clock in
+  // begin()): settle on the fastest speed every device answers at
+  LoggerManager::info("I2C bus at %lu Hz", I2C::negotiateClock());
+  
+  if (!rtcAvailable) {
     LoggerManager::warn("RTC not responding");
-    rtcAvailable = false;
   } else {
-    rtcAvailable = true;
     LoggerManager::info("RTC initialized");
     
-    if (rtc.lostPower()) {
-      LoggerManager::warn("RTC lost power - setting compile time");
-      rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+    // Everything else reads the software clock, resynced from the RTC
+    TimeManager& timeManager = TimeManager::getInstance();
+    timeManager.setResyncInterval(RTC_RESYNC_INTERVAL);
+    if (!timeManager.initialize()) {
+      LoggerManager::warn("RTC not ticking - time unavailable");
+      rtcAvailable = false;
     }
   }
   
-  // Initialize file system
+  // Load persistent state (one read, imports legacy files on first boot)
   if (sdAvailable) {
-    LoggerManager::info("Initializing file system");
-    
-    if (!SD.exists(COUNT_FILE)) {
-      File f = SD.open(COUNT_FILE, FILE_WRITE);
-      if (f) {
-        f.println("0");
-        f.close();
-      }
-    }
+    LoggerManager::info("Loading persistent state");
     
-    if (!SD.exists(CUMULATIVE_FILE)) {
-      File f = SD.open(CUMULATIVE_FILE, FILE_WRITE);
-      if (f) {
-        f.println("0");
-        f.close();
-      }
+    StateStore& store = StateStore::getInstance();
+    if (store.begin()) {
+      currentCount = store.data().currentCount;
+      countAtHourStart = store.data().countAtHourStart;
+    } else {
+      LoggerManager::warn("Persistent state unavailable - starting from 0");
     }
     
-    // Load counts from files
-    File countFile = SD.open(COUNT_FILE);
-    if (countFile) {
-      currentCount = countFile.parseInt();
-      countFile.close();
-    }
+    // Sequence-numbered production records for SYNC
+    RecordJournal::getInstance().begin();
+  }
+  
+  // Settings: both EEPROM copies in one read (imports code_v3 settings once)
+  ConfigManager::getInstance().initialize();
+  subscribeToConfig();
+  
+  // Checkpoints newer than the last SD consolidation win
+  if (CheckpointRing::getInstance().begin()) {
+    restoreFromCheckpoint();
   }
   
   // Initialize GPIO
@@ -251,8 +334,8 @@ bool initializeHardware() {
   
   // Initialize RTC time tracking
   if (rtcAvailable) {
-    DateTime now = rtc.now();
-    lastHour = now.hour();
+    lastHour = TimeManager::getInstance().getCurrentHour();
+    configureHourAlarm();
   }
   
   LoggerManager::info("Hardware initialization complete");
@@ -264,131 +347,285 @@ bool initializeHardware() {
 // ============================================================================
 
 void displayStartupScreen() {
-  display.clearDisplay();
-  display.setTextSize(2);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(10, 5);
-  display.println("COUNTER");
-  display.setTextSize(1);
-  display.setCursor(15, 30);
-  display.println("Initializing...");
-  display.display();
+  DisplayManager::getInstance().showInitializationScreen();
 }
 
 void displayStatusMessage(const char* message) {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(10, 30);
-  display.println(message);
-  display.display();
+  DisplayManager::getInstance().showStatus(message, STATUS_MESSAGE_HOLD);
 }
 
-void displayMainScreen() {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  
-  // Top line: Mode status
+// Everything the main screen shows, derived from the current globals
+void buildDisplayView(DisplayView& view, SystemState state, const DateTime& now) {
+  memset(&view, 0, sizeof(view));
+  view.state = state;
+  view.count = currentCount;
+  view.rtcOk = rtcAvailable;
+  if (rtcAvailable) {
+    view.hour = now.hour();
+    view.minute = now.minute();
+  }
+  view.sdOk = sdAvailable;
+  strncpy(view.status, productionActive ? "PRODUCTION ACTIVE" : "READY",
+          sizeof(view.status) - 1);
   if (productionActive) {
-    display.setCursor(0, 0);
-    display.println("PRODUCTION ACTIVE");
-  } else {
-    display.setCursor(0, 0);
-    display.println("READY");
+    const RateMeter::Rates& rates = ProductionManager::getInstance().getRates();
+    view.rateShown = true;
+    view.rateNow = rates.now;
+    view.rateAverage = rates.session;
   }
+}
+
+// Renders only when the view differs from the last one drawn; changed
+// fields are redrawn and sent as partial page updates (see DisplayManager)
+void displayMainScreen(SystemState state, const DateTime& now) {
+  DisplayView view;
+  buildDisplayView(view, state, now);
+  DisplayManager::getInstance().render(view);
+}
+
+void displayErrorScreen(const char* message) {
+  DisplayManager::getInstance().showErrorScreen(message);
+}
+
+// ============================================================================
+// HELPER FUNCTIONS (Backward compatibility)
+// ============================================================================
+
+void saveState() {
+  if (!sdAvailable) return;
   
-  // Large count in middle
-  display.setTextSize(2);
-  display.setCursor(20, 20);
-  display.println(currentCount);
+  PersistentStateRecord& state = StateStore::getInstance().data();
   
-  // Bottom info
-  display.setTextSize(1);
-  if (rtcAvailable) {
-    DateTime now = rtc.now();
-    display.setCursor(0, 50);
-    display.print(now.hour());
-    display.print(":");
-    if (now.minute() < 10) display.print("0");
-    display.println(now.minute());
+  noInterrupts();
+  state.currentCount = currentCount;
+  interrupts();
+  
+  state.countAtHourStart = countAtHourStart;
+  state.productionActive = productionActive ? 1 : 0;
+  state.lastHour = (lastHour >= 0) ? lastHour : 0xFF;
+  
+  if (!StateStore::getInstance().commit()) {
+    LoggerManager::warn("State commit failed");
   }
+}
+
+bool writeCheckpoint() {
+  CheckpointRecord cp;
+  memset(&cp, 0, sizeof(cp));
+  
+  const PersistentStateRecord& state = StateStore::getInstance().data();
   
-  display.setCursor(80, 50);
-  display.print("SD:");
-  display.println(sdAvailable ? "OK" : "NG");
+  noInterrupts();
+  cp.currentCount = currentCount;
+  countChanged = false;
+  interrupts();
   
-  display.display();
+  cp.baseStateSequence = state.sequence;
+  cp.countAtHourStart = countAtHourStart;
+  cp.cumulativeCount = state.cumulativeCount;
+  cp.productionStartCount = state.productionStartCount;
+  cp.productionStartUnix = state.productionStartUnix;
+  cp.productionActive = productionActive ? 1 : 0;
+  cp.lastHour = (lastHour >= 0) ? lastHour : 0xFF;
+  
+  if (!CheckpointRing::getInstance().write(cp)) {
+    LoggerManager::warn("Checkpoint write failed");
+    return false;
+  }
+  return true;
 }
 
-void displayErrorScreen(const char* message) {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(10, 20);
-  display.println("ERROR:");
-  display.setCursor(10, 40);
-  display.println(message);
-  display.display();
+void restoreFromCheckpoint() {
+  CheckpointRecord cp;
+  if (!CheckpointRing::getInstance().latest(cp)) {
+    return;
+  }
+  
+  // A checkpoint taken after the newest SD commit holds fresher counters
+  PersistentStateRecord& state = StateStore::getInstance().data();
+  if (cp.baseStateSequence < state.sequence) {
+    return;
+  }
+  
+  LoggerManager::info("Restoring counters from checkpoint ring");
+  currentCount = cp.currentCount;
+  countAtHourStart = cp.countAtHourStart;
+  state.currentCount = cp.currentCount;
+  state.countAtHourStart = cp.countAtHourStart;
+  state.cumulativeCount = cp.cumulativeCount;
+  state.productionStartCount = cp.productionStartCount;
+  state.productionStartUnix = cp.productionStartUnix;
+  state.productionActive = cp.productionActive;
 }
 
-// ============================================================================
-// HELPER FUNCTIONS (Backward compatibility)
-// ============================================================================
+void beginProductionState() {
+  PersistentStateRecord& state = StateStore::getInstance().data();
+  state.productionStartCount = currentCount;
+  state.productionStartUnix = rtcAvailable ? TimeManager::getInstance().getUnixTime() : 0;
+  saveState();
+}
 
-int readCountFromFile(const char* filename) {
-  if (!sdAvailable) return 0;
+void endProductionState() {
+  PersistentStateRecord& state = StateStore::getInstance().data();
+  uint32_t startUnix = state.productionStartUnix;
   
-  File file = SD.open(filename);
-  if (!file) return 0;
+  noInterrupts();
+  int sessionCount = currentCount - state.productionStartCount;
+  interrupts();
   
-  int count = file.parseInt();
-  file.close();
-  return count;
+  state.productionStartUnix = 0;
+  saveState();
+  
+  logProductionSession(startUnix, sessionCount);
 }
 
-void writeCountToFile(const char* filename, int count) {
-  if (!sdAvailable) return;
+void logProductionSession(uint32_t startUnix, int sessionCount) {
+  if (!sdAvailable || !rtcAvailable) return;
   
-  File file = SD.open(filename, FILE_WRITE);
-  if (!file) return;
+  StorageManager& storage = StorageManager::getInstance();
+  DateTime stop = TimeManager::getInstance().getCurrentTime();
+  DateTime start = startUnix ? DateTime(startUnix) : stop;
   
-  file.seek(0);
-  file.print(count);
-  file.println();
-  file.close();
+  // Journal first: the session file and daily log quote its sequence number
+  uint32_t record = RecordJournal::getInstance().addSession(start, stop, sessionCount);
+  
+  char filename[64];
+  StorageManager::formatSessionFileName(filename, sizeof(filename), start, stop);
+  storage.saveProductionSession(filename, start, stop, sessionCount, record);
+  
+  // Summary line in the day's (pre-allocated) log
+  char entry[80];
+  snprintf(entry, sizeof(entry), "---\nSession: %02d:%02d to %02d:%02d\nCount: %d\nRecord: %lu\n",
+           start.hour(), start.minute(), stop.hour(), stop.minute(), sessionCount,
+           (unsigned long)record);
+  StorageManager::formatDailyLogName(filename, sizeof(filename), stop);
+  storage.saveDailyLog(filename, entry);
 }
 
-void saveProductionState() {
+// Reserve today's log and the next session file outside of counting, so
+// appends during the day never have to allocate clusters
+void prepareLogFiles(const DateTime& now) {
   if (!sdAvailable) return;
   
-  File file = SD.open(PRODUCTION_STATE_FILE, FILE_WRITE);
-  if (!file) return;
+  StorageManager& storage = StorageManager::getInstance();
+  if (preparedLogDay != now.day() && storage.prepareDailyLog(now)) {
+    preparedLogDay = now.day();
+    
+    // A new day may have closed a month - look for sessions to roll up
+    SessionArchive::getInstance().requestScan();
+  }
+  if (!storage.isSessionFilePrepared()) {
+    storage.prepareSessionFile();
+  }
+}
+
+// Hour boundaries: per-pulse deadlines from the software clock, plus the
+// DS3231 alarm on RTC_INT_PIN (see hour_boundary.h)
+void configureHourAlarm() {
+  HourBoundary::Mode mode = HourBoundary::MODE_POLLED;
+  
+  if (RTC_INT_PIN >= 0) {
+    bool alarmSet;
+    {
+      I2C::Transaction bus(TimeManager::RTC_ADDRESS);
+      rtc.writeSqwPinMode(DS3231_OFF);   // INT/SQW as alarm output
+      rtc.disableAlarm(1);
+      rtc.clearAlarm(1);
+      rtc.clearAlarm(2);
+      alarmSet = rtc.setAlarm2(DateTime(2000, 1, 1, 0, 0, 0), DS3231_A2_Minute);
+    }
+    if (alarmSet) {
+      pinMode(RTC_INT_PIN, INPUT_PULLUP);
+      attachInterrupt(digitalPinToInterrupt(RTC_INT_PIN), handleHourAlarm, FALLING);
+      mode = HourBoundary::MODE_ALARM;
+      LoggerManager::info("Hour alarm armed on GPIO %d", RTC_INT_PIN);
+    } else {
+      LoggerManager::warn("Cannot set RTC alarm - polling for hour changes");
+    }
+  }
   
-  file.println("ACTIVE");
-  file.print(currentCount);
-  file.println();
-  file.close();
+  hourBoundary.begin(lastHour, mode);
+  armHourDeadline();
 }
 
-void clearProductionState() {
-  if (!sdAvailable) return;
-  SD.remove(PRODUCTION_STATE_FILE);
+// Arm the next hh:00 as an MCU timer deadline, so the counter ISR splits
+// the hours exactly at the first pulse past it. Re-armed after each
+// boundary and each RTC resync (the clock's timer mapping moves slightly).
+void armHourDeadline() {
+  static uint32_t armedAtSync = 0;
+  TimeManager& timeManager = TimeManager::getInstance();
+  const SoftClock& clock = timeManager.getClock();
+  
+  if (!clock.isSynced()) return;
+  if (hourBoundary.isDeadlineArmed() && clock.getSyncCount() == armedAtSync) return;
+  
+  // Next hour after the tracked one (may already be due if not yet reported)
+  uint32_t hourStart = timeManager.getUnixTime() / 3600 * 3600;
+  uint32_t next = ((int)(hourStart / 3600 % 24) == hourBoundary.getTrackedHour())
+                      ? hourStart + 3600 : hourStart;
+  int64_t deadline = clock.timerAt(next);
+  
+  noInterrupts();
+  hourBoundary.armDeadline(deadline, next / 3600 % 24);
+  interrupts();
+  armedAtSync = clock.getSyncCount();
 }
 
-void handleHourChange() {
+// Consume a pending hour boundary (pulse, deadline, alarm or clock);
+// safe to call any time
+void serviceHourBoundary(const DateTime& now) {
+  HourBoundary::Mode modeBefore = hourBoundary.getMode();
+  
+  if (hourBoundary.takeAlarmFlag()) {
+    I2C::Transaction bus(TimeManager::RTC_ADDRESS);
+    rtc.clearAlarm(2);  // Releases INT for the next hour
+  }
+  
+  int64_t nowMicros = esp_timer_get_time();  // Before the count - see poll()
+  noInterrupts();
+  int countNow = currentCount;
+  interrupts();
+  
+  HourBoundary::Tick tick;
+  if (hourBoundary.poll(now.hour(), nowMicros, countNow, tick)) {
+    if (modeBefore == HourBoundary::MODE_ALARM &&
+        hourBoundary.getMode() == HourBoundary::MODE_POLLED) {
+      LoggerManager::warn("No RTC alarms on GPIO %d - using the clock only", RTC_INT_PIN);
+    }
+    
+    handleHourChange(tick.count);
+    lastHour = tick.hour;
+  }
+  
+  armHourDeadline();
+}
+
+void handleHourChange(int finalCount) {
   LoggerManager::info("Hour boundary detected");
   
+  int countThisHour = finalCount - countAtHourStart;
+  if (countThisHour < 0) countThisHour = 0;
+  
+  // Hourly and cumulative totals are committed together in one write
+  PersistentStateRecord& state = StateStore::getInstance().data();
+  state.hourlyCount = countThisHour;
+  state.cumulativeCount += countThisHour;
+  countAtHourStart = finalCount;
+  saveState();
+  
   if (rtcAvailable) {
-    DateTime now = rtc.now();
+    DateTime now = TimeManager::getInstance().getCurrentTime();
     
-    // Update cumulative count
-    writeCountToFile(CUMULATIVE_FILE, currentCount);
+    // Journal the hour that just ended (idle hours are left out)
+    if (sdAvailable && countThisHour > 0) {
+      DateTime hourStart((now.unixtime() / 3600 - 1) * 3600);
+      RecordJournal::getInstance().addHour(hourStart, countThisHour);
+    }
     
     // Log hour change
-    Serial.print("Hour changed: ");
-    Serial.print(now.hour());
-    Serial.println(":00");
+    Console.print("Hour changed: ");
+    Console.print(now.hour());
+    Console.println(":00");
   }
 }
 
@@ -397,6 +634,7 @@ void handleHourChange() {
 // ============================================================================
 
 void setup() {
+  Serial.setRxBufferSize(SERIAL_RX_BUFFER);   // Holds input while Console drains
   Serial.begin(115200);
   delay(1000);
   
@@ -441,8 +679,32 @@ void loop() {
   unsigned long now = millis();
   SystemState currentState = fsm.getCurrentState();
   
+  // Diagnostic output: only what the UART takes without waiting
+  Console.pump();
+  
+  // Trace dump, record sync or READ/LS/PROD/SEARCH output in progress:
+  // a few lines per pass
+  serviceTraceDump();
+  serviceRecordSync();
+  StorageManager::getInstance().serviceOutput();
+  
+  // Serial commands: what has arrived, at most one command per pass.
+  // During BULK the port carries download frames instead.
+  BulkTransfer& bulk = BulkTransfer::getInstance();
+  if (bulk.isActive()) {
+    bulk.poll(now);
+  } else {
+    handleSerialInput();
+  }
+  
+  // Production rates: one compare, real work once per 5 s bucket
+  ProductionManager::getInstance().updateRates(now);
+  
   // Execute state handler
+  uint32_t handlerStart = micros();
   bool stateHealthy = executeCurrentState(currentState);
+  fsm.getTrace().record(FsmTrace::HANDLER, (uint8_t)currentState, 0, stateHealthy, handlerStart,
+                        micros() - handlerStart);
   
   if (!stateHealthy) {
     LoggerManager::error("State execution failed - entering ERROR state");
@@ -452,21 +714,32 @@ void loop() {
   // Process all queued events
   SystemEvent event;
   while (fsm.dequeueEvent(event)) {
+    uint32_t eventStart = micros();
     processEvent(event, currentState);
+    fsm.getTrace().record(FsmTrace::PROCESS, (uint8_t)event, (uint8_t)currentState, 0, eventStart,
+                          micros() - eventStart);
   }
   
-  // Update display periodically
-  if (now - lastDisplayUpdateTime >= DISPLAY_UPDATE_INTERVAL) {
-    displayMainScreen();
-    lastDisplayUpdateTime = now;
+  // Software clock (no I2C read); resyncs from the RTC on its own cadence
+  DateTime rtcNow;
+  if (rtcAvailable) {
+    TimeManager& timeManager = TimeManager::getInstance();
+    timeManager.update();
+    rtcNow = timeManager.getCurrentTime();
   }
   
-  // Save state periodically
-  if (sdAvailable && now - lastSaveTime >= SAVE_INTERVAL) {
-    writeCountToFile(COUNT_FILE, currentCount);
-    if (productionActive) {
-      saveProductionState();
-    }
+  // Redraw only when what the screen shows has changed
+  displayMainScreen(fsm.getCurrentState(), rtcNow);
+  
+  // High-frequency checkpoint to the EEPROM ring (only when counting)
+  if (countChanged && now - lastCheckpointTime >= checkpointIntervalMs) {
+    writeCheckpoint();
+    lastCheckpointTime = now;
+  }
+  
+  // Periodic consolidated write of the full state block to SD
+  if (sdAvailable && now - lastSaveTime >= SD_CONSOLIDATE_INTERVAL) {
+    saveState();
     lastSaveTime = now;
   }
   
@@ -479,12 +752,20 @@ void loop() {
     lastHealthCheckTime = now;
   }
   
-  // Handle hour changes
+  // Handle hour changes (alarm snapshots arrive as EVT_HOUR_CHANGED too;
+  // this also covers states that ignore the event, and polled mode)
   if (rtcAvailable) {
-    DateTime rtcNow = rtc.now();
-    if (rtcNow.hour() != lastHour) {
-      handleHourChange();
-      lastHour = rtcNow.hour();
+    serviceHourBoundary(rtcNow);
+    
+    // Pre-allocation writes a few KB, so only do it while idle
+    if (currentState == STATE_READY && preparedLogDay != rtcNow.day()) {
+      prepareLogFiles(rtcNow);
+    }
+    
+    // Merge closed months' session files into archives, in small steps
+    if (currentState == STATE_READY && now - lastArchiveStepTime >= ARCHIVE_STEP_INTERVAL) {
+      SessionArchive::getInstance().step(rtcNow);
+      lastArchiveStepTime = now;
     }
   }
   
@@ -523,7 +804,7 @@ bool executeCurrentState(SystemState state) {
 // ============================================================================
 
 void processEvent(SystemEvent event, SystemState currentState) {
-  LoggerManager::debug("Event %d in state %d", event, currentState);
+  LOG_DEBUG(FSM, "Event %d in state %d", event, currentState);
   
   switch (currentState) {
     
@@ -542,6 +823,7 @@ void processEvent(SystemEvent event, SystemState currentState) {
           LoggerManager::info("Starting production");
           productionActive = true;
           ProductionManager::getInstance().startSession();
+          beginProductionState();
           fsm.transitionToState(STATE_PRODUCTION);
           displayStatusMessage("Production Started");
         }
@@ -551,7 +833,7 @@ void processEvent(SystemEvent event, SystemState currentState) {
         fsm.transitionToState(STATE_DIAGNOSTIC);
       }
       else if (event == EVT_HOUR_CHANGED) {
-        handleHourChange();
+        serviceHourBoundary(TimeManager::getInstance().getCurrentTime());
       }
       break;
     
@@ -562,9 +844,13 @@ void processEvent(SystemEvent event, SystemState currentState) {
         ProductionManager::getInstance().stopSession();
         fsm.transitionToState(STATE_READY);
         
-        // Save final count
-        writeCountToFile(CUMULATIVE_FILE, currentCount);
-        clearProductionState();
+        // Save final count and close the session in one commit
+        endProductionState();
+        
+        // Replace the spare session file consumed by this session
+        if (rtcAvailable) {
+          prepareLogFiles(TimeManager::getInstance().getCurrentTime());
+        }
         
         displayStatusMessage("Production Stopped");
       }
@@ -572,7 +858,7 @@ void processEvent(SystemEvent event, SystemState currentState) {
         // Already handled in ISR
       }
       else if (event == EVT_HOUR_CHANGED) {
-        handleHourChange();
+        serviceHourBoundary(TimeManager::getInstance().getCurrentTime());
       }
       break;
     
@@ -597,92 +883,696 @@ void processEvent(SystemEvent event, SystemState currentState) {
 // SERIAL DEBUG INTERFACE (Backward compatible with original)
 // ============================================================================
 
+// ============================================================================
+// SERIAL COMMANDS
+// ============================================================================
+
+static void cmdHelp(const CommandArgs& args);
+
+static void cmdStatus(const CommandArgs& args) {
+  Console.println("=== System Status ===");
+  Console.print("State: ");
+  printStateName(fsm.getCurrentState());
+  Console.println();
+  Console.print("Production: ");
+  Console.println(productionActive ? "ACTIVE" : "IDLE");
+  Console.print("Current Count: ");
+  Console.println(currentCount);
+  
+  // Items/min: EWMA now, rolling windows, session average
+  const RateMeter::Rates& rates = ProductionManager::getInstance().getRates();
+  char rateText[5][12];
+  RateMeter::formatTenths(rates.now, rateText[0], sizeof(rateText[0]));
+  RateMeter::formatTenths(rates.oneMinute, rateText[1], sizeof(rateText[1]));
+  RateMeter::formatTenths(rates.fiveMinutes, rateText[2], sizeof(rateText[2]));
+  RateMeter::formatTenths(rates.fifteenMinutes, rateText[3], sizeof(rateText[3]));
+  RateMeter::formatTenths(rates.session, rateText[4], sizeof(rateText[4]));
+  Console.print("Rate (items/min): now ");
+  Console.print(rateText[0]);
+  Console.print(", 1 min ");
+  Console.print(rateText[1]);
+  Console.print(", 5 min ");
+  Console.print(rateText[2]);
+  Console.print(", 15 min ");
+  Console.print(rateText[3]);
+  Console.print(", session ");
+  Console.println(rateText[4]);
+  Console.print("Free Heap: ");
+  Console.print(PowerManager::getFreeHeap());
+  Console.println(" bytes");
+  
+  EnduranceReport wear = CheckpointRing::projectEndurance(checkpointIntervalMs);
+  Console.print("Checkpoints: ");
+  Console.print(CheckpointRing::getInstance().getWriteCount());
+  Console.print(" (");
+  Console.print(wear.checkpointsPerDay);
+  Console.print("/day max, ");
+  Console.print(wear.sectorWritesPerDay);
+  Console.print(" writes/sector/day, ~");
+  Console.print(wear.projectedLifeYears);
+  Console.println(" yr flash life)");
+  
+  PreallocLog& logs = PreallocLog::getInstance();
+  Console.print("Log appends: ");
+  Console.print(logs.getAppendCount());
+  Console.print(" (last ");
+  Console.print(logs.getLastAppendMicros());
+  Console.print(" us, worst ");
+  Console.print(logs.getMaxAppendMicros());
+  Console.print(" us, ");
+  Console.print(logs.getGrowthCount());
+  Console.println(" extent growths)");
+  Console.print("Archived sessions: ");
+  Console.print(SessionArchive::getInstance().getArchivedCount());
+  Console.println(SessionArchive::getInstance().isIdle() ? "" : " (rollup pending)");
+  
+  ReadCache& cache = ReadCache::getInstance();
+  Console.print("Read cache: ");
+  Console.print(READ_CACHE_KB);
+  Console.print(" KB, ");
+  Console.print(cache.getHits());
+  Console.print(" hits / ");
+  Console.print(cache.getMisses());
+  Console.print(" misses (");
+  Console.print(cache.getHitRatePercent());
+  Console.print("%), ");
+  Console.print(cache.getEvictions());
+  Console.println(" evictions");
+  
+  DisplayManager& oled = DisplayManager::getInstance();
+  Console.print("Display frames: ");
+  Console.print(oled.getFramesRendered());
+  Console.print(" rendered, ");
+  Console.print(oled.getFramesSkipped());
+  Console.println(" skipped (view unchanged)");
+  
+  DisplayLink& link = DisplayLink::getInstance();
+  unsigned long uptimeSeconds = millis() / 1000;
+  Console.print("Display link: ");
+  Console.print(link.getFramesSent());
+  Console.print(" frames sent, ");
+  Console.print(link.getFramesDropped());
+  Console.print(" superseded, ");
+  Console.print(link.getSpanCount());
+  Console.print(" page spans, ");
+  Console.print(link.getBytesSent());
+  Console.print(" I2C bytes (");
+  Console.print(uptimeSeconds > 0 ? link.getBytesSent() / uptimeSeconds : 0);
+  Console.print(" B/s avg), last frame ");
+  Console.print(link.getLastFrameMicros());
+  Console.println(link.isAsync() ? " us (async)" : " us (sync)");
+  
+  const SoftClock& clock = TimeManager::getInstance().getClock();
+  Console.print("Clock: ");
+  Console.print(clock.getDriftPpm());
+  Console.print(" ppm drift, last offset ");
+  Console.print(clock.getLastOffsetMicros());
+  Console.print(" us, ");
+  Console.print(clock.getSyncCount());
+  Console.print(" RTC syncs every ");
+  Console.print(clock.getResyncInterval() / 1000);
+  Console.print(" s (");
+  Console.print(clock.getFailedSyncs());
+  Console.print(" failed), ");
+  Console.print(clock.getRtcReads());
+  Console.println(" RTC reads");
+  
+  HourBoundary& boundary = HourBoundary::getInstance();
+  Console.print("Hour boundaries: ");
+  Console.print(boundary.getMode() == HourBoundary::MODE_ALARM ? "RTC alarm" : "polled");
+  Console.print(" (");
+  Console.print(boundary.getPulseTicks());
+  Console.print(" at a pulse, ");
+  Console.print(boundary.getDeadlineTicks());
+  Console.print(" at deadline, ");
+  Console.print(boundary.getAlarmTicks());
+  Console.print(" from alarm, ");
+  Console.print(boundary.getPolledTicks());
+  Console.print(" from clock, ");
+  Console.print(boundary.getMissedAlarms());
+  Console.println(" missed alarms)");
+  
+  const LogRing& logRing = LoggerManager::getRing();
+  Console.print("Log: ");
+  Console.print(LoggerManager::isDeferred() ? "deferred" : "immediate");
+  Console.print(LoggerManager::getOutput() == LoggerManager::OUTPUT_BINARY ? " binary, " : " text, ");
+  Console.print(logRing.getPushed());
+  Console.print(" records, ");
+  Console.print(logRing.getDropped());
+  Console.print(" dropped, ring high water ");
+  Console.print(logRing.getHighWater());
+  Console.print("/");
+  Console.print(LogRing::RING_SIZE);
+  Console.print(", ");
+  Console.print(LoggerManager::getCoalesced());
+  Console.println(" repeats coalesced");
+  
+  ConfigManager& config = ConfigManager::getInstance();
+  Console.print("Config: ");
+  Console.print(ConfigManager::sourceName(config.getSource()));
+  Console.print(", seq ");
+  Console.print(config.getSequence());
+  const ConfigManager::Snapshot& snapshot = config.getSnapshot();
+  Console.print(", snapshot ");
+  Console.print(snapshot.version);
+  Console.print(" | save ");
+  Console.print(snapshot.settings.saveInterval);
+  Console.print(" ms, debounce ");
+  Console.print(snapshot.settings.debounceDelay);
+  Console.print(" ms, max count ");
+  Console.print(snapshot.settings.maxCount);
+  Console.print(", status ");
+  Console.print(snapshot.settings.statusDisplayDuration);
+  Console.print(" ms, display ");
+  Console.print(snapshot.settings.displayRefresh);
+  Console.println(" ms");
+  
+  const FsmTrace& trace = fsm.getTrace();
+  Console.print("FSM trace: ");
+  Console.print(trace.getCount());
+  Console.print("/");
+  Console.print(FsmTrace::CAPACITY);
+  Console.print(" records, ");
+  Console.print(trace.getOverwritten());
+  Console.print(" overwritten, ");
+  Console.print(fsm.getDroppedEvents());
+  Console.println(" events dropped (queue full)");
+  
+  Console.print("Serial TX: ");
+  Console.print(SerialOut::policyName(Console.getDropPolicy()));
+  Console.print(", ");
+  Console.print(Console.getWritten());
+  Console.print(" bytes, ");
+  Console.print(Console.getDroppedBytes());
+  Console.print(" dropped, ring high water ");
+  Console.print(Console.getHighWater());
+  Console.print("/");
+  Console.println(SerialOut::RING_SIZE);
+  
+  Console.print("Serial RX: ");
+  Console.print(serialLine.getLines());
+  Console.print(" lines, ");
+  Console.print(serialLine.getTooLong());
+  Console.print(" too long, worst pass ");
+  Console.print(serialInputWorstUs);
+  Console.println(" us");
+  
+  BulkTransfer& bulk = BulkTransfer::getInstance();
+  Console.print("Bulk: ");
+  Console.print(bulk.getSessions());
+  Console.print(" sessions, ");
+  Console.print(bulk.getCompleted());
+  Console.print(" GETs done, ");
+  Console.print(bulk.getDataBytes());
+  Console.print(" bytes, ");
+  Console.print(bulk.getResends());
+  Console.print(" resends, ");
+  Console.print(bulk.getAbandoned());
+  Console.print(" abandoned, ");
+  Console.print(bulk.getFrameErrors());
+  Console.print(" bad frames, last ");
+  Console.print(bulk.getLastRate() / 1024);
+  Console.println(" KB/s");
+  
+  RecordJournal& journal = RecordJournal::getInstance();
+  Console.print("Records: ");
+  Console.print(journal.isReady() ? "last " : "unavailable, last ");
+  Console.print(journal.getLastSequence());
+  Console.print(", ");
+  Console.print(journal.getRepaired());
+  Console.print(" re-indexed at boot, ");
+  Console.print(journal.getFailed());
+  Console.println(" failed");
+  
+  Console.print("I2C bus: ");
+  Console.print(I2C::getClockSpeed() / 1000);
+  Console.print(" kHz, ");
+  Console.print(I2C::getHandovers());
+  Console.println(" handovers to waiting transactions");
+  for (uint8_t i = 0; i < I2C::getDeviceCount(); i++) {
+    I2C::DeviceStats dev;
+    I2C::getDeviceStats(i, dev);
+    Console.print("  ");
+    Console.print(dev.name);
+    Console.print(" @ ");
+    Console.print(dev.clockHz / 1000);
+    Console.print(" kHz: ");
+    Console.print(I2C::getUtilization(i), 2);
+    Console.print("% busy, ");
+    Console.print(dev.transactions);
+    Console.print(" transactions, ");
+    Console.print(dev.bytes);
+    Console.print(" bytes, ");
+    Console.print(dev.errors);
+    Console.print(" errors, max wait ");
+    Console.print(dev.maxWaitMicros);
+    Console.print(" us, ");
+    Console.print(dev.yields);
+    Console.println(" yields");
+  }
+}
+
+static void cmdStart(const CommandArgs& args) {
+  fsm.queueEvent(EVT_PRODUCTION_START);
+  Console.println(">> Production start requested");
+}
+
+static void cmdStop(const CommandArgs& args) {
+  fsm.queueEvent(EVT_PRODUCTION_STOP);
+  Console.println(">> Production stop requested");
+}
+
+static void cmdBulk(const CommandArgs& args) {
+  uint32_t baud = (args.count > 0) ? (uint32_t)args.number[0] : BulkTransfer::DEFAULT_BAUD;
+  if (!BulkTransfer::isSupportedBaud(baud)) {
+    Console.println(">> Baud: 115200, 230400, 460800 or 921600");
+    return;
+  }
+  BulkTransfer::getInstance().begin(baud, millis());
+}
+
+static void cmdCount(const CommandArgs& args) {
+  fsm.queueEvent(EVT_ITEM_COUNTED);
+  Console.println(">> Count incremented");
+}
+
+static void cmdDiag(const CommandArgs& args) {
+  fsm.queueEvent(EVT_DIAGNOSTIC_REQUESTED);
+  Console.println(">> Diagnostic requested");
+}
+
+static void cmdReset(const CommandArgs& args) {
+  fsm.transitionToState(STATE_INITIALIZATION);
+  Console.println(">> System reset");
+}
+
+static void cmdList(const CommandArgs& args) {
+  StorageManager::getInstance().listFiles();
+}
+
+static void cmdProd(const CommandArgs& args) {
+  StorageManager::getInstance().listProductionFiles();
+}
+
+static void cmdSearch(const CommandArgs& args) {
+  StorageManager::getInstance().searchFiles(args.word[0]);
+}
+
+static void cmdRead(const CommandArgs& args) {
+  StorageManager::getInstance().printFile(args.word[0]);
+}
+
+static void cmdLog(const CommandArgs& args) {
+  const char* mode = args.word[0];
+  if (strcmp(mode, "TEXT") == 0 || strcmp(mode, "BINARY") == 0) {
+    LoggerManager::setOutput(strcmp(mode, "BINARY") == 0 ? LoggerManager::OUTPUT_BINARY
+                                                          : LoggerManager::OUTPUT_TEXT);
+  } else if (strcmp(mode, "DEFERRED") == 0 || strcmp(mode, "SYNC") == 0) {
+    LoggerManager::setDeferred(strcmp(mode, "DEFERRED") == 0);
+  } else {
+    Console.println(">> Usage: LOG,<TEXT|BINARY|DEFERRED|SYNC>");
+  }
+}
+
+static void cmdLevel(const CommandArgs& args) {
+  if (args.count == 0) {
+    Console.print("Log levels (compiled in: ");
+    Console.print(LoggerManager::logLevelName((LoggerManager::LogLevel)LOG_COMPILE_LEVEL));
+    Console.println(" and up):");
+    for (uint8_t i = 0; i < LoggerManager::MODULE_COUNT; i++) {
+      LoggerManager::Module module = (LoggerManager::Module)i;
+      Console.print("  ");
+      Console.print(LoggerManager::moduleKey(module));
+      Console.print(": ");
+      Console.println(LoggerManager::logLevelName(LoggerManager::getModuleLevel(module)));
+    }
+    return;
+  }
+  
+  LoggerManager::Module module = LoggerManager::MODULE_SYSTEM;
+  LoggerManager::LogLevel level = LoggerManager::INFO;
+  bool all = strcmp(args.word[0], "ALL") == 0;
+  if (args.count < 2 || (!all && !LoggerManager::parseModule(args.word[0], module)) ||
+      !LoggerManager::parseLevel(args.word[1], level)) {
+    Console.println(">> Usage: LEVEL,<ALL|SYSTEM|FSM|STORAGE|DISPLAY|TIME|PRODUCTION|CONFIG>,"
+                   "<DEBUG|INFO|WARN|ERROR|FATAL>");
+    return;
+  }
+  if (all) {
+    LoggerManager::setLogLevel(level);
+  } else {
+    LoggerManager::setModuleLevel(module, level);
+  }
+  if (level < LOG_COMPILE_LEVEL) {
+    Console.print(">> Note: messages below ");
+    Console.print(LoggerManager::logLevelName((LoggerManager::LogLevel)LOG_COMPILE_LEVEL));
+    Console.println(" are compiled out of this build (LOG_COMPILE_LEVEL)");
+  }
+}
+
+static void cmdSync(const CommandArgs& args) {
+  if (args.count > 0 && args.number[0] < 0) {
+    Console.println(">> Usage: SYNC[,<last record held>]");
+    return;
+  }
+  startRecordSync(args.count > 0 ? (uint32_t)args.number[0] : 0);
+}
+
+static void cmdTrace(const CommandArgs& args) {
+  if (args.count == 0) {
+    startTraceDump();
+  } else if (strcmp(args.word[0], "CLEAR") == 0) {
+    fsm.getTrace().clear();
+    Console.println(">> FSM trace cleared");
+  } else {
+    Console.println(">> Usage: TRACE[,CLEAR]");
+  }
+}
+
+static void cmdSet(const CommandArgs& args) {
+  ConfigManager::Settings next = ConfigManager::getInstance().getSettings();
+  for (uint8_t i = 0; i < args.count; i += 2) {
+    long value = args.number[i + 1];
+    switch (args.number[i]) {
+      case 1: next.saveInterval = value; break;
+      case 2: next.debounceDelay = value; break;
+      case 3: next.maxCount = value; break;
+      case 4: next.statusDisplayDuration = value; break;
+      case 5: next.displayRefresh = value; break;
+      default:
+        Console.println(">> Setting numbers: 1 save, 2 debounce, 3 max count, 4 status, "
+                       "5 display refresh");
+        return;
+    }
+  }
+  applySettings(next);
+}
+
+static void cmdDebounce(const CommandArgs& args) {
+  ConfigManager::Settings next = ConfigManager::getInstance().getSettings();
+  next.debounceDelay = args.number[0];
+  applySettings(next);
+}
+
+static void cmdTx(const CommandArgs& args) {
+  if (strcmp(args.word[0], "OLDEST") != 0 && strcmp(args.word[0], "NEWEST") != 0) {
+    Console.println(">> Usage: TX,<OLDEST|NEWEST>");
+    return;
+  }
+  Console.setDropPolicy(strcmp(args.word[0], "NEWEST") == 0 ? SerialOut::DROP_NEWEST
+                                                            : SerialOut::DROP_OLDEST);
+  Console.print(">> Serial TX: ");
+  Console.println(SerialOut::policyName(Console.getDropPolicy()));
+}
+
+// Sorted by name (binary search; checked at compile time)
+static constexpr CommandSpec COMMANDS[] = {
+  { "BULK",     "I",    "BULK[,<baud>]",                       cmdBulk },
+  { "COUNT",    "",     "COUNT",                               cmdCount },
+  { "DEBOUNCE", "i",    "DEBOUNCE,<ms>",                       cmdDebounce },
+  { "DIAG",     "",     "DIAG",                                cmdDiag },
+  { "HELP",     "",     "HELP",                                cmdHelp },
+  { "LEVEL",    "WW",   "LEVEL[,<module|ALL>,<level>]",        cmdLevel },
+  { "LOG",      "w",    "LOG,<TEXT|BINARY|DEFERRED|SYNC>",     cmdLog },
+  { "LS",       "",     "LS",                                  cmdList },
+  { "PROD",     "",     "PROD",                                cmdProd },
+  { "READ",     "t",    "READ,<file>",                         cmdRead },
+  { "RESET",    "",     "RESET",                               cmdReset },
+  { "SEARCH",   "t",    "SEARCH,<text>",                       cmdSearch },
+  { "SET",      "ii*",  "SET,<n>,<value>[,<n>,<value>...]",    cmdSet },
+  { "START",    "",     "START",                               cmdStart },
+  { "STATUS",   "",     "STATUS",                              cmdStatus },
+  { "STOP",     "",     "STOP",                                cmdStop },
+  { "SYNC",     "I",    "SYNC[,<since>]",                      cmdSync },
+  { "TRACE",    "W",    "TRACE[,CLEAR]",                       cmdTrace },
+  { "TX",       "w",    "TX,<OLDEST|NEWEST>",                  cmdTx },
+};
+static const size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+static_assert(CommandParser::isSorted(COMMANDS, COMMAND_COUNT), "COMMANDS must be sorted by name");
+
+static void cmdHelp(const CommandArgs& args) {
+  Console.print("Commands:");
+  for (size_t i = 0; i < COMMAND_COUNT; i++) {
+    Console.print(" ");
+    Console.print(COMMANDS[i].usage);
+  }
+  Console.println();
+}
+
+// Never waits for input: takes up to LineReader::BYTES_PER_POLL bytes that
+// have already arrived and runs at most one command. Commands that print
+// files or listings (READ, LS, PROD, SEARCH, TRACE, SYNC) only start a job
+// the loop advances later. While Console is over half full, input is left
+// in the UART buffer until the output drains.
 void handleSerialInput() {
-  if (!Serial.available()) return;
-  
-  String input = Serial.readStringUntil('\n');
-  input.trim();
-  input.toUpperCase();
-  
-  if (input == "STATUS") {
-    Serial.println("=== System Status ===");
-    Serial.print("State: ");
-    printStateName(fsm.getCurrentState());
-    Serial.println();
-    Serial.print("Production: ");
-    Serial.println(productionActive ? "ACTIVE" : "IDLE");
-    Serial.print("Current Count: ");
-    Serial.println(currentCount);
-    Serial.print("Free Heap: ");
-    Serial.print(PowerManager::getFreeHeap());
-    Serial.println(" bytes");
-  }
-  else if (input == "START") {
-    fsm.queueEvent(EVT_PRODUCTION_START);
-    Serial.println(">> Production start requested");
-  }
-  else if (input == "STOP") {
-    fsm.queueEvent(EVT_PRODUCTION_STOP);
-    Serial.println(">> Production stop requested");
-  }
-  else if (input == "COUNT") {
-    fsm.queueEvent(EVT_ITEM_COUNTED);
-    Serial.println(">> Count incremented");
-  }
-  else if (input == "DIAG") {
-    fsm.queueEvent(EVT_DIAGNOSTIC_REQUESTED);
-    Serial.println(">> Diagnostic requested");
+  if (Console.getUsed() > SerialOut::RING_SIZE / 2) {
+    return;
   }
-  else if (input == "RESET") {
-    fsm.transitionToState(STATE_INITIALIZATION);
-    Serial.println(">> System reset");
+  
+  uint32_t start = micros();
+  for (size_t i = 0; i < LineReader::BYTES_PER_POLL && Serial.available() > 0; i++) {
+    LineReader::Status status = serialLine.feed((char)Serial.read());
+    if (status == LineReader::TOO_LONG) {
+      Console.println(">> Line too long - ignored");
+      break;
+    }
+    if (status != LineReader::LINE) {
+      continue;
+    }
+    
+    const CommandSpec* command = nullptr;
+    switch (CommandParser::execute(serialLine.line(), COMMANDS, COMMAND_COUNT, &command)) {
+      case CommandParser::UNKNOWN:
+        Console.println(">> Unknown command (HELP lists them)");
+        break;
+      case CommandParser::BAD_ARGS:
+        Console.print(">> Usage: ");
+        Console.println(command->usage);
+        break;
+      default:
+        break;
+    }
+    break;
   }
-  else if (input == "HELP") {
-    Serial.println("Commands: STATUS START STOP COUNT DIAG RESET HELP");
+  
+  uint32_t elapsed = micros() - start;
+  if (elapsed > serialInputWorstUs) {
+    serialInputWorstUs = elapsed;
   }
 }
 
 void printStateName(SystemState state) {
   switch (state) {
     case STATE_INITIALIZATION:
-      Serial.print("INITIALIZATION");
+      Console.print("INITIALIZATION");
       break;
     case STATE_READY:
-      Serial.print("READY");
+      Console.print("READY");
       break;
     case STATE_PRODUCTION:
-      Serial.print("PRODUCTION");
+      Console.print("PRODUCTION");
       break;
     case STATE_DIAGNOSTIC:
-      Serial.print("DIAGNOSTIC");
+      Console.print("DIAGNOSTIC");
       break;
     case STATE_ERROR:
-      Serial.print("ERROR");
+      Console.print("ERROR");
       break;
     default:
-      Serial.print("UNKNOWN");
+      Console.print("UNKNOWN");
   }
 }
 
+// ============================================================================
+// FSM TRACE DUMP
+// ============================================================================
+
+// Lines: TRACE,BEGIN,<records>,<overwritten>,<missed>,<now us>; one
+// TRACE,STATE / TRACE,EVENT line per name; the records (FsmTrace::formatLine);
+// TRACE,END. Written a few lines per loop() while Console has room, so the
+// dump neither stalls the loop nor overflows the TX ring. The trace is
+// paused meanwhile.
+static int traceDumpLine = -1;   // Next line, -1 when idle
+
+void startTraceDump() {
+  fsm.getTrace().setPaused(true);
+  traceDumpLine = 0;
+}
+
+void serviceTraceDump() {
+  if (traceDumpLine < 0) {
+    return;
+  }
+  
+  FsmTrace& trace = fsm.getTrace();
+  const int stateLines = StateManager::STATE_COUNT;
+  const int eventLines = StateManager::EVENT_COUNT;
+  const int recordLines = (int)trace.getCount();
+  char line[FsmTrace::MAX_LINE + 32];
+  
+  while (Console.getUsed() + sizeof(line) <= SerialOut::RING_SIZE / 2) {
+    int n = traceDumpLine;
+    FsmTrace::Record record;
+    if (n == 0) {
+      snprintf(line, sizeof(line), "TRACE,BEGIN,%d,%lu,%lu,%lu\r\n", recordLines,
+               (unsigned long)trace.getOverwritten(), (unsigned long)trace.getMissed(),
+               (unsigned long)micros());
+    } else if ((n -= 1) < stateLines) {
+      snprintf(line, sizeof(line), "TRACE,STATE,%d,%s\r\n", n,
+               StateManager::getStateName((SystemState)n));
+    } else if ((n -= stateLines) < eventLines) {
+      snprintf(line, sizeof(line), "TRACE,EVENT,%d,%s\r\n", n, fsm.getEventName((SystemEvent)n));
+    } else if ((n -= eventLines) < recordLines && trace.get(n, record)) {
+      FsmTrace::formatLine(record, line, sizeof(line));
+    } else {
+      Console.print("TRACE,END\r\n");
+      trace.setPaused(false);
+      traceDumpLine = -1;
+      return;
+    }
+    Console.print(line);
+    traceDumpLine++;
+  }
+}
+
+// ============================================================================
+// RECORD SYNC
+// ============================================================================
+
+// Lines: SYNC,BEGIN,<since>,<last>; SYNC,<record> per journal record after
+// <since>, oldest first; SYNC,END,<records>,<last sent>,<crc32>. The CRC32
+// (hex) covers the record text of the SYNC,<record> lines, each with a
+// '\n'. A collector moves its watermark to <last sent> only once END
+// checks out. Records added meanwhile wait for the next SYNC. Paced like
+// the trace dump.
+static bool recordSyncActive = false;
+static bool recordSyncBegun = false;
+static JournalCursor recordSyncCursor;
+static uint32_t recordSyncSince = 0;
+static uint32_t recordSyncSent = 0;
+static uint32_t recordSyncCrc = 0;
+
+void startRecordSync(uint32_t since) {
+  RecordJournal& journal = RecordJournal::getInstance();
+  if (!journal.seek(since, recordSyncCursor)) {
+    Console.println(">> Record journal unavailable");
+    return;
+  }
+  recordSyncSince = since;
+  recordSyncSent = 0;
+  recordSyncCrc = crc32Begin();
+  recordSyncBegun = false;
+  recordSyncActive = true;
+}
+
+void serviceRecordSync() {
+  if (!recordSyncActive) {
+    return;
+  }
+  
+  RecordJournal& journal = RecordJournal::getInstance();
+  char record[RecordJournal::MAX_RECORD + 1];
+  char line[sizeof(record) + 8];
+  
+  while (Console.getUsed() + sizeof(line) <= SerialOut::RING_SIZE / 2) {
+    if (!recordSyncBegun) {
+      snprintf(line, sizeof(line), "SYNC,BEGIN,%lu,%lu\r\n", (unsigned long)recordSyncSince,
+               (unsigned long)recordSyncCursor.last);
+      recordSyncBegun = true;
+    } else if (journal.next(recordSyncCursor, record, sizeof(record))) {
+      size_t length = strlen(record);
+      recordSyncCrc = crc32Update(recordSyncCrc, record, length);
+      recordSyncCrc = crc32Update(recordSyncCrc, "\n", 1);
+      recordSyncSent++;
+      snprintf(line, sizeof(line), "SYNC,%s\r\n", record);
+    } else {
+      // Stops short of cursor.last only on a read error: END then names
+      // the last record actually sent
+      snprintf(line, sizeof(line), "SYNC,END,%lu,%lu,%08lx\r\n", (unsigned long)recordSyncSent,
+               (unsigned long)(recordSyncSince + recordSyncSent),
+               (unsigned long)crc32End(recordSyncCrc));
+      Console.print(line);
+      recordSyncActive = false;
+      return;
+    }
+    Console.print(line);
+  }
+}
+
+// ============================================================================
+// RUNTIME SETTINGS
+// ============================================================================
+
+// ConfigManager publishes each change as one snapshot and calls these from
+// loop() (serial commands) right away, so every consumer switches to the new
+// settings within the same loop pass. The ISR only ever reads the one word
+// its subscriber writes.
+
+static void applyDebounce(const ConfigManager::Snapshot& config) {
+  counterDebounceMs = config.settings.debounceDelay;
+}
+
+static void applySaveSchedule(const ConfigManager::Snapshot& config) {
+  checkpointIntervalMs = config.settings.saveInterval;
+}
+
+static void applyDisplayRate(const ConfigManager::Snapshot& config) {
+  DisplayManager::getInstance().setRefreshRate(config.settings.displayRefresh);
+}
+
+void subscribeToConfig() {
+  ConfigManager& config = ConfigManager::getInstance();
+  config.subscribe(applyDebounce);
+  config.subscribe(applySaveSchedule);
+  config.subscribe(applyDisplayRate);
+}
+
+// SET and DEBOUNCE: the whole change is checked, then published as one
+void applySettings(const ConfigManager::Settings& next) {
+  ConfigManager& config = ConfigManager::getInstance();
+  if (!ConfigManager::validate(next)) {
+    Console.println(">> Value out of range - settings unchanged (see HELP)");
+    return;
+  }
+  
+  bool saved = config.setSettings(next);
+  Console.print(">> Settings applied (snapshot ");
+  Console.print(config.getSnapshot().version);
+  Console.println(saved ? ", saved)" : ", NOT saved)");
+}
+
 // ============================================================================
 // DEBUG MENU (Backward compatible)
 // ============================================================================
 
 void debugMenu() {
-  Serial.println("\n=== DEBUG MENU ===");
-  Serial.println("Available commands:");
-  Serial.println("  STATUS - Show system status");
-  Serial.println("  START  - Begin production");
-  Serial.println("  STOP   - End production");
-  Serial.println("  COUNT  - Increment count");
-  Serial.println("  DIAG   - Run diagnostics");
-  Serial.println("  RESET  - Reset system");
-  Serial.println("  HELP   - Show this menu");
-  Serial.println("\nNote: Type 'INFO' to show this menu again");
-  Serial.println();
-}
-
-// Override serialEvent for interactive commands
-void serialEvent() {
-  handleSerialInput();
+  Console.println("\n=== DEBUG MENU ===");
+  Console.println("Available commands:");
+  Console.println("  STATUS - Show system status");
+  Console.println("  START  - Begin production");
+  Console.println("  STOP   - End production");
+  Console.println("  COUNT  - Increment count");
+  Console.println("  DIAG   - Run diagnostics");
+  Console.println("  RESET  - Reset system");
+  Console.println("  LS     - List files (including archived sessions)");
+  Console.println("  PROD   - List production session files");
+  Console.println("  SEARCH,<text> - Find files by name");
+  Console.println("  READ,<file>   - Print a file (loose or archived)");
+  Console.println("  BULK[,<baud>] - Binary download mode (tests/host/bulk_client, default 921600)");
+  Console.println("  LOG,TEXT|BINARY - Log lines or binary frames (tests/host/log_decode)");
+  Console.println("  LOG,DEFERRED|SYNC - Log through the RAM ring or print immediately");
+  Console.println("  LEVEL  - Show per-module log levels");
+  Console.println("  LEVEL,<module|ALL>,<level> - e.g. LEVEL,STORAGE,DEBUG");
+  Console.println("  TRACE  - Dump the FSM trace (tests/host/fsm_trace_json -> Perfetto)");
+  Console.println("  TRACE,CLEAR - Empty the FSM trace");
+  Console.println("  SYNC[,<since>] - Production records after <since> (tests/host/sync_collector)");
+  Console.println("  SET,<n>,<value>[,<n>,<value>...] - Change settings together and save:");
+  Console.println("         1 save interval (1000-60000 ms), 2 debounce (10-500 ms),");
+  Console.println("         3 max count (100-99999), 4 status time (1000-10000 ms),");
+  Console.println("         5 display refresh (20-1000 ms)");
+  Console.println("  DEBOUNCE,<ms> - Same as SET,2,<ms>");
+  Console.println("  TX,OLDEST|NEWEST  - Serial output full: drop oldest or newest bytes");
+  Console.println("  HELP   - Show this menu");
+  Console.println("\nNote: Type 'INFO' to show this menu again");
+  Console.println();
 }
@@ -10,10 +10,13 @@
  * 5. Serial communication tests
  * 6. Power management tests
  * 7. Timing accuracy tests
+ * 8. SD append latency benchmark
  */
 
 #include <Arduino.h>
+#include <SD.h>
 #include "../hal.h"
+#include "../prealloc_log.h"
 
 struct HardwareTestResult {
   const char* testName;
@@ -314,6 +317,68 @@ bool test_SDCardSpeedDetection() {
   return result;
 }
 
+/**
+ * Test HW-22: SD Append Latency Benchmark
+ * Worst-case append time for a growing FILE_APPEND log (cluster allocation
+ * and FAT writes as the file grows) versus a pre-allocated log that only
+ * rewrites data and header sectors. Requires a mounted SD card.
+ */
+bool test_SDAppendLatencyBenchmark() {
+  unsigned long startTime = millis();
+  
+  const char* PLAIN_FILE = "/bench_plain.txt";
+  const char* PREALLOC_FILE = "/bench_prealloc.txt";
+  const int APPENDS = 200;  // ~11 KB, crosses several cluster boundaries
+  const char* line = "Session: 14:30 to 16:45 | Count: 1234\n";
+  size_t lineLength = strlen(line);
+  
+  SD.remove(PLAIN_FILE);
+  SD.remove(PREALLOC_FILE);
+  
+  unsigned long plainWorst = 0;
+  for (int i = 0; i < APPENDS; i++) {
+    unsigned long t0 = micros();
+    File file = SD.open(PLAIN_FILE, FILE_APPEND);
+    if (file) {
+      file.write(reinterpret_cast<const uint8_t*>(line), lineLength);
+      file.flush();
+      file.close();
+    }
+    unsigned long dt = micros() - t0;
+    if (dt > plainWorst) plainWorst = dt;
+  }
+  
+  PreallocLog& log = PreallocLog::getInstance();
+  bool created = log.create(PREALLOC_FILE, PreallocLog::DAILY_CAPACITY);
+  log.resetStats();
+  for (int i = 0; i < APPENDS; i++) {
+    log.append(PREALLOC_FILE, line);
+  }
+  unsigned long preallocWorst = log.getMaxAppendMicros();
+  bool noGrowth = (log.getGrowthCount() == 0);
+  
+  SD.remove(PLAIN_FILE);
+  SD.remove(PREALLOC_FILE);
+  
+  Serial.print("  Append worst case: plain ");
+  Serial.print(plainWorst);
+  Serial.print(" us, pre-allocated ");
+  Serial.print(preallocWorst);
+  Serial.println(" us");
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = created && noGrowth && (log.getAppendCount() == APPENDS) &&
+                (preallocWorst < plainWorst);
+  int reductionPercent = (plainWorst > 0)
+    ? (int)(100 - (preallocWorst * 100) / plainWorst) : 0;
+  recordHardwareTest("HW_SD_AppendLatency", "SD Card", result,
+                     "Pre-allocated worst-case append faster", reductionPercent);
+  hardwareResults[hardwareTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
 // ============================================================================
 // TIMER TESTS
 // ============================================================================
@@ -537,6 +602,7 @@ void runAllHardwareTests() {
   test_SPIBusInitialization();
   test_SDCardDetection();
   test_SDCardSpeedDetection();
+  test_SDAppendLatencyBenchmark();
   
   Serial.println("Testing Timers...");
   test_TimerInitialization();
@@ -0,0 +1,177 @@
+/**
+ * Big Digit Render Benchmark (host)
+ *
+ * Compares rendering the main screen count two ways, on a 128x64 SSD1306
+ * page buffer:
+ *   - GFX text: clear the band, measure, draw the number as 5x7 text scaled
+ *     x3 with one fillRect per font pixel (what Adafruit_GFX::drawChar does
+ *     for text sizes above 1)
+ *   - BigDigits: pre-rendered page bytes, only the changed digits blitted
+ *     (same algorithm as DisplayManager::setCount)
+ *
+ * Also checks that every pre-rendered glyph matches the scaled font
+ * pixel for pixel.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/managers big_digit_benchmark.cpp -o big_digit_benchmark
+ *   ./big_digit_benchmark
+ */
+
+#include "big_digits.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static const int WIDTH = 128;
+static const int HEIGHT = 64;
+static const int FRAMES = 200000;
+static const unsigned long START_COUNT = 9900;  // Crosses 9999 -> 10000 (re-center)
+
+static uint8_t frame[WIDTH * HEIGHT / 8];
+
+// ============================================================================
+// GFX-STYLE REFERENCE RENDERER
+// ============================================================================
+
+static void drawPixel(int x, int y, bool on) {
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+  uint8_t& b = frame[(y / 8) * WIDTH + x];
+  if (on) b |= (1 << (y & 7));
+  else b &= ~(1 << (y & 7));
+}
+
+static void fillRect(int x, int y, int w, int h, bool on) {
+  for (int i = x; i < x + w; i++) {
+    for (int j = y; j < y + h; j++) {
+      drawPixel(i, j, on);
+    }
+  }
+}
+
+static void drawChar(int x, int y, uint8_t digit, int size) {
+  for (int col = 0; col < BigDigits::FONT_WIDTH; col++) {
+    uint8_t line = BigDigits::FONT_5X7[digit][col];
+    for (int row = 0; row < 8; row++, line >>= 1) {
+      if (line & 1) fillRect(x + col * size, y + row * size, size, size, true);
+    }
+  }
+}
+
+// Clear, center (text bounds pass) and draw the whole number every frame
+static void renderGfx(unsigned long value) {
+  char text[12];
+  int n = snprintf(text, sizeof(text), "%lu", value);
+  int advance = (BigDigits::FONT_WIDTH + 1) * BigDigits::SCALE;
+  int width = n * advance - BigDigits::SCALE;
+  int x = (WIDTH - width) / 2;
+  int top = BigDigits::FIRST_PAGE * 8;
+
+  fillRect(0, top, WIDTH, BigDigits::PAGES * 8, false);
+  for (int i = 0; i < n; i++) {
+    drawChar(x + i * advance, top + BigDigits::Y_OFFSET, text[i] - '0', BigDigits::SCALE);
+  }
+}
+
+// ============================================================================
+// PRE-RENDERED RENDERER
+// ============================================================================
+
+static void renderCached(unsigned long value, unsigned long previous, bool first) {
+  BigDigits::Layout next;
+  BigDigits::layout(value, next);
+
+  uint8_t from = 0;
+  int clearFrom = 0;
+  int clearTo = WIDTH;
+  if (!first) {
+    BigDigits::Layout prev;
+    BigDigits::layout(previous, prev);
+    if (prev.count == next.count && prev.left == next.left) {
+      while (from < next.count && prev.digits[from] == next.digits[from]) from++;
+      clearFrom = next.x[from];
+    } else {
+      clearFrom = (prev.left < next.left) ? prev.left : next.left;
+    }
+    clearTo = (prev.right > next.right) ? prev.right : next.right;
+  }
+
+  BigDigits::clearColumns(frame, clearFrom, clearTo);
+  for (uint8_t i = from; i < next.count; i++) {
+    BigDigits::blit(frame, next.x[i], next.digits[i]);
+  }
+}
+
+// ============================================================================
+// CHECKS & BENCHMARK
+// ============================================================================
+
+static bool verifyGlyphs() {
+  static uint8_t expected[sizeof(frame)];
+  bool ok = true;
+
+  for (uint8_t d = 0; d < 10; d++) {
+    memset(frame, 0, sizeof(frame));
+    drawChar(20 - BigDigits::INK_LEFT[d], BigDigits::FIRST_PAGE * 8 + BigDigits::Y_OFFSET,
+             d, BigDigits::SCALE);
+    memcpy(expected, frame, sizeof(frame));
+
+    memset(frame, 0, sizeof(frame));
+    BigDigits::blit(frame, 20, d);
+    if (memcmp(expected, frame, sizeof(frame)) != 0) {
+      printf("FAIL: glyph %u does not match the scaled font\n", d);
+      ok = false;
+    }
+  }
+
+  // Incremental updates must end in the same frame as a full redraw
+  memset(frame, 0, sizeof(frame));
+  renderCached(START_COUNT, 0, true);
+  for (unsigned long v = START_COUNT + 1; v < START_COUNT + 500; v++) {
+    renderCached(v, v - 1, false);
+    memcpy(expected, frame, sizeof(frame));
+    memset(frame, 0, sizeof(frame));
+    renderCached(v, 0, true);
+    bool same = memcmp(expected, frame, sizeof(frame)) == 0;
+    memcpy(frame, expected, sizeof(frame));
+    if (!same) {
+      printf("FAIL: incremental frame differs from full redraw at %lu\n", v);
+      ok = false;
+      break;
+    }
+  }
+  return ok;
+}
+
+template <typename Render>
+static double nanosPerFrame(Render render) {
+  memset(frame, 0, sizeof(frame));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FRAMES; i++) {
+    render(START_COUNT + i);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / FRAMES;
+}
+
+int main() {
+  if (!verifyGlyphs()) {
+    return 1;
+  }
+  printf("Glyph tables match the scaled 5x7 font\n");
+
+  double gfx = nanosPerFrame([](unsigned long v) { renderGfx(v); });
+  uint8_t gfxSum = 0;
+  for (uint8_t b : frame) gfxSum ^= b;
+
+  double cached = nanosPerFrame([](unsigned long v) {
+    renderCached(v, v - 1, v == START_COUNT);
+  });
+  uint8_t cachedSum = 0;
+  for (uint8_t b : frame) cachedSum ^= b;
+
+  printf("Count render, %d frames from %lu:\n", FRAMES, START_COUNT);
+  printf("  GFX scaled text : %8.1f ns/frame (checksum %02X)\n", gfx, gfxSum);
+  printf("  BigDigits cache : %8.1f ns/frame (checksum %02X)\n", cached, cachedSum);
+  printf("  Speedup         : %8.1fx\n", gfx / cached);
+  return 0;
+}
@@ -0,0 +1,404 @@
+/**
+ * Bulk Download Client (host)
+ *
+ * Talks to the BULK command (src/managers/bulk_transfer.h) over a serial
+ * port: sends BULK,<baud> at 115200, switches to <baud> and speaks the
+ * framed protocol in bulk_link.h. Requests are retried on timeout; a GET
+ * that stalls (cable pulled, device busy) is reissued from the offset
+ * already written, so an interrupted download carries on where it
+ * stopped - also across runs with --resume. Archived files are checked
+ * against the CRC32 from their archive index.
+ *
+ * Build (from this directory, Linux/macOS):
+ *   g++ -std=c++11 -O2 -I../../src/hal -I../../src/core \
+ *       bulk_client.cpp ../../src/hal/bulk_link.cpp ../../src/core/checksum.cpp \
+ *       -o bulk_client
+ *
+ * Usage:
+ *   ./bulk_client /dev/ttyUSB0 list
+ *   ./bulk_client /dev/ttyUSB0 stat Production_2025-11-15_14h30m-16h45m.txt
+ *   ./bulk_client /dev/ttyUSB0 get DailyLog_2025-11-15.txt [out.txt] [--resume]
+ *   --baud N   115200, 230400, 460800 or 921600 (default)
+ */
+
+#include "bulk_link.h"
+#include "checksum.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <sys/time.h>
+#include <termios.h>
+#include <unistd.h>
+
+static const int REQUEST_TIMEOUT_MS = 500;
+static const int REQUEST_RETRIES = 6;
+static const int STALL_MS = 1000;          // No new data: reissue the GET
+static const int MAX_STALLS = 30;
+
+static int port = -1;
+static BulkLink::Decoder decoder;
+static uint16_t nextSeq = 1;
+
+static long long nowMs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// ============================================================================
+// SERIAL PORT
+// ============================================================================
+
+static speed_t speedFor(unsigned long baud) {
+  switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+    default: return 0;
+  }
+}
+
+static bool setBaud(unsigned long baud) {
+  struct termios tty;
+  if (tcgetattr(port, &tty) != 0) {
+    return false;
+  }
+  cfmakeraw(&tty);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 0;
+  cfsetispeed(&tty, speedFor(baud));
+  cfsetospeed(&tty, speedFor(baud));
+  return tcsetattr(port, TCSADRAIN, &tty) == 0;
+}
+
+static void writeAll(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    ssize_t n = write(port, data, length);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EINTR) continue;
+      return;
+    }
+    data += n;
+    length -= n;
+  }
+}
+
+// Next frame, or false after timeoutMs
+static bool receiveFrame(BulkLink::Frame& frame, int timeoutMs) {
+  static uint8_t pending[512];     // Read but not fed yet (may hold the next frame)
+  static size_t pendingLength = 0;
+  static size_t pendingAt = 0;
+  long long deadline = nowMs() + timeoutMs;
+
+  for (;;) {
+    while (pendingAt < pendingLength) {
+      if (decoder.feed(pending[pendingAt++])) {
+        frame = decoder.frame();
+        return true;
+      }
+    }
+    long long left = deadline - nowMs();
+    if (left <= 0) {
+      return false;
+    }
+    struct pollfd pfd = { port, POLLIN, 0 };
+    if (poll(&pfd, 1, (int)left) <= 0) {
+      continue;
+    }
+    ssize_t n = read(port, pending, sizeof(pending));
+    if (n > 0) {
+      pendingLength = n;
+      pendingAt = 0;
+    }
+  }
+}
+
+static void sendFrame(uint8_t type, uint16_t seq, const uint8_t* payload, size_t length) {
+  BulkLink::Frame frame;
+  frame.type = type;
+  frame.seq = seq;
+  frame.length = length;
+  if (length > 0) {
+    memcpy(frame.payload, payload, length);
+  }
+  uint8_t wire[BulkLink::MAX_ENCODED + 1];
+  wire[0] = 0;                     // Ends any partial frame at the device
+  size_t n = BulkLink::encode(frame, wire + 1);
+  writeAll(wire, n + 1);
+}
+
+// Request with retries; the reply is the next frame carrying its seq
+static bool request(uint8_t type, const uint8_t* payload, size_t length, BulkLink::Frame& reply) {
+  uint16_t seq = nextSeq++;
+  for (int attempt = 0; attempt < REQUEST_RETRIES; attempt++) {
+    sendFrame(type, seq, payload, length);
+    long long deadline = nowMs() + REQUEST_TIMEOUT_MS;
+    while (nowMs() < deadline) {
+      if (receiveFrame(reply, (int)(deadline - nowMs())) && reply.seq == seq &&
+          (reply.type & 0x80) != 0 && reply.type != BulkLink::DATA && reply.type != BulkLink::DATA_LAST) {
+        if (reply.type == BulkLink::ERROR_REPLY) {
+          fprintf(stderr, "Device: %.*s (error %u)\n", reply.length - 1, (const char*)reply.payload + 1,
+                  reply.payload[0]);
+          return false;
+        }
+        return true;
+      }
+    }
+  }
+  fprintf(stderr, "No reply from the device\n");
+  return false;
+}
+
+// BULK,<baud> at 115200, wait for the confirmation, switch
+static bool enterBulk(unsigned long baud) {
+  if (!setBaud(115200)) {
+    return false;
+  }
+  tcflush(port, TCIOFLUSH);
+  char command[32];
+  int length = snprintf(command, sizeof(command), "\nBULK,%lu\n", baud);
+  writeAll(reinterpret_cast<const uint8_t*>(command), length);
+
+  std::string seen;
+  long long deadline = nowMs() + 3000;
+  while (nowMs() < deadline && seen.find(">> BULK mode") == std::string::npos) {
+    struct pollfd pfd = { port, POLLIN, 0 };
+    if (poll(&pfd, 1, 100) > 0) {
+      char buffer[256];
+      ssize_t n = read(port, buffer, sizeof(buffer));
+      if (n > 0) seen.append(buffer, n);
+    }
+  }
+  if (seen.find(">> BULK mode") == std::string::npos) {
+    fprintf(stderr, "Device did not enter BULK mode (already in it? retrying at %lu)\n", baud);
+  }
+  // Wait for the end of the confirmation line, then change speed
+  usleep(50000);
+  if (!setBaud(baud)) {
+    return false;
+  }
+  tcflush(port, TCIFLUSH);
+  decoder.reset();
+  return true;
+}
+
+static void leaveBulk() {
+  BulkLink::Frame reply;
+  request(BulkLink::BYE, nullptr, 0, reply);
+}
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+static int commandList() {
+  uint16_t start = 0;
+  uint16_t total = 1;
+  while (start < total) {
+    uint8_t payload[2];
+    BulkLink::put16(payload, start);
+    BulkLink::Frame reply;
+    if (!request(BulkLink::LIST, payload, sizeof(payload), reply) || reply.type != BulkLink::LIST_REPLY ||
+        reply.length < 5) {
+      return 1;
+    }
+    total = BulkLink::get16(reply.payload);
+    uint8_t count = reply.payload[4];
+    size_t at = 5;
+    for (uint8_t i = 0; i < count && at + 5 <= reply.length; i++) {
+      uint32_t size = BulkLink::get32(reply.payload + at);
+      uint8_t nameLength = reply.payload[at + 4];
+      printf("%10u  %.*s\n", size, nameLength, (const char*)reply.payload + at + 5);
+      at += 5 + nameLength;
+    }
+    if (count == 0) break;
+    start += count;
+  }
+  printf("%u file(s)\n", total);
+  return 0;
+}
+
+static bool statFile(const char* name, uint32_t& size, bool& archived, uint32_t& crc) {
+  BulkLink::Frame reply;
+  if (!request(BulkLink::STAT, reinterpret_cast<const uint8_t*>(name), strlen(name), reply) ||
+      reply.type != BulkLink::STAT_REPLY || reply.length < 9) {
+    return false;
+  }
+  size = BulkLink::get32(reply.payload);
+  archived = reply.payload[4] != 0;
+  crc = BulkLink::get32(reply.payload + 5);
+  return true;
+}
+
+static int commandStat(const char* name) {
+  uint32_t size, crc;
+  bool archived;
+  if (!statFile(name, size, archived, crc)) {
+    return 1;
+  }
+  printf("%s: %u bytes, %s", name, size, archived ? "archived" : "loose");
+  if (crc != 0) printf(", crc32 %08x", crc);
+  printf("\n");
+  return 0;
+}
+
+static int commandGet(const char* name, const char* outPath, bool resume) {
+  uint32_t size, crc;
+  bool archived;
+  if (strlen(name) > BulkLink::MAX_PAYLOAD - 8 || !statFile(name, size, archived, crc)) {
+    return 1;
+  }
+
+  FILE* out = fopen(outPath, resume ? "ab+" : "wb+");
+  if (out == nullptr) {
+    fprintf(stderr, "Cannot open %s\n", outPath);
+    return 1;
+  }
+  fseek(out, 0, SEEK_END);
+  uint32_t have = (uint32_t)ftell(out);
+  if (have > size) {
+    fprintf(stderr, "%s is longer than the device file - not resuming\n", outPath);
+    fclose(out);
+    return 1;
+  }
+
+  long long started = nowMs();
+  uint32_t startedAt = have;
+  int stalls = 0;
+  BulkReceiver receiver;
+  bool done = have == size && size > 0;
+
+  while (!done && stalls <= MAX_STALLS) {
+    // (Re)issue the GET from what is on disk
+    uint16_t seq = nextSeq++;
+    uint8_t payload[BulkLink::MAX_PAYLOAD];
+    size_t nameLength = strlen(name);
+    BulkLink::put32(payload, have);
+    BulkLink::put32(payload + 4, 0xFFFFFFFF);
+    memcpy(payload + 8, name, nameLength);
+    receiver.start(seq, have);
+    sendFrame(BulkLink::GET, seq, payload, 8 + nameLength);
+
+    long long lastData = nowMs();
+    while (nowMs() - lastData < STALL_MS) {
+      BulkLink::Frame frame;
+      if (!receiveFrame(frame, 50)) continue;
+      if (frame.type == BulkLink::ERROR_REPLY && frame.seq == seq) {
+        fprintf(stderr, "\nDevice: %.*s\n", frame.length - 1, (const char*)frame.payload + 1);
+        fclose(out);
+        return 1;
+      }
+      const uint8_t* data;
+      size_t length;
+      BulkReceiver::Result result = receiver.onFrame(frame, data, length);
+      if (result == BulkReceiver::ACCEPTED || result == BulkReceiver::DONE) {
+        fwrite(data, 1, length, out);
+        have += length;
+        lastData = nowMs();
+        stalls = 0;
+      }
+      uint32_t ackOffset;
+      bool gap;
+      if (receiver.ackDue(ackOffset, gap)) {
+        uint8_t ack[5];
+        BulkLink::put32(ack, ackOffset);
+        ack[4] = gap;
+        sendFrame(BulkLink::ACK, seq, ack, sizeof(ack));
+      }
+      if (result == BulkReceiver::DONE) {
+        done = true;
+        break;
+      }
+      if (result == BulkReceiver::ACCEPTED && (have & 0x3FFF) < length) {
+        double seconds = (nowMs() - started) / 1000.0;
+        fprintf(stderr, "\r%u / %u bytes  %.1f KB/s ", have, size,
+                seconds > 0 ? (have - startedAt) / 1024.0 / seconds : 0.0);
+      }
+    }
+    if (!done) {
+      stalls++;
+      fprintf(stderr, "\nStalled at %u - resuming\n", have);
+    }
+  }
+  fflush(out);
+
+  double seconds = (nowMs() - started) / 1000.0;
+  fprintf(stderr, "\r%u / %u bytes in %.2f s (%.1f KB/s)\n", have, size, seconds,
+          seconds > 0 ? (have - startedAt) / 1024.0 / seconds : 0.0);
+
+  bool ok = done || have == size;
+  if (ok && crc != 0) {
+    // Whole file back from disk (resumed downloads span several runs)
+    rewind(out);
+    uint32_t value = crc32Begin();
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), out)) > 0) {
+      value = crc32Update(value, chunk, n);
+    }
+    if (crc32End(value) != crc) {
+      fprintf(stderr, "CRC32 mismatch: %08x, archive index says %08x\n", crc32End(value), crc);
+      ok = false;
+    }
+  }
+  fclose(out);
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  unsigned long baud = 921600;
+  bool resume = false;
+  const char* args[4] = { nullptr, nullptr, nullptr, nullptr };
+  int count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+      baud = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--resume") == 0) {
+      resume = true;
+    } else if (count < 4) {
+      args[count++] = argv[i];
+    }
+  }
+  if (count < 2 || speedFor(baud) == 0 ||
+      ((strcmp(args[1], "stat") == 0 || strcmp(args[1], "get") == 0) && count < 3)) {
+    fprintf(stderr, "Usage: %s <port> [--baud N] list | stat <file> | get <file> [out] [--resume]\n",
+            argv[0]);
+    return 2;
+  }
+
+  port = open(args[0], O_RDWR | O_NOCTTY);
+  if (port < 0) {
+    fprintf(stderr, "Cannot open %s: %s\n", args[0], strerror(errno));
+    return 1;
+  }
+  if (!enterBulk(baud)) {
+    fprintf(stderr, "Cannot configure %s\n", args[0]);
+    return 1;
+  }
+
+  int result;
+  if (strcmp(args[1], "list") == 0) {
+    result = commandList();
+  } else if (strcmp(args[1], "stat") == 0) {
+    result = commandStat(args[2]);
+  } else if (strcmp(args[1], "get") == 0) {
+    result = commandGet(args[2], count > 3 ? args[3] : args[2], resume);
+  } else {
+    fprintf(stderr, "Unknown command %s\n", args[1]);
+    result = 2;
+  }
+
+  leaveBulk();
+  close(port);
+  return result;
+}
@@ -0,0 +1,364 @@
+/**
+ * Bulk Transfer Link Tests (host)
+ *
+ * Checks the BULK protocol pieces in bulk_link.h: CRC-16 check value, COBS
+ * round trips (zero runs, 254-byte blocks), and that the frame decoder
+ * drops damaged frames - bit flips, lost delimiters, line noise - without
+ * ever accepting one and picks up the next intact frame.
+ *
+ * Then simulates GET downloads at 921600 baud: the device loop (1 ms
+ * passes, 128-byte UART FIFO) drives BulkWindow, the host BulkReceiver,
+ * with USB latency, random byte corruption in both directions and a cable
+ * pulled for half a second. Reports throughput against the wire rate.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/hal \
+ *       bulk_link_tests.cpp ../../src/hal/bulk_link.cpp -o bulk_link_tests
+ *   ./bulk_link_tests
+ */
+
+#include "bulk_link.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+static uint32_t rngState = 12345;
+static uint32_t rng() {
+  rngState = rngState * 1664525u + 1013904223u;
+  return rngState >> 8;
+}
+
+// ============================================================================
+// CODEC
+// ============================================================================
+
+/** CRC-16/CCITT-FALSE check value and COBS round trips */
+static void testCodec() {
+  bool crcOk = BulkLink::crc16(reinterpret_cast<const uint8_t*>("123456789"), 9) == 0x29B1;
+
+  int ok = 0;
+  const int CASES = 2000;
+  for (int c = 0; c < CASES; c++) {
+    uint8_t in[600];
+    uint8_t encoded[620];
+    uint8_t out[600];
+    size_t length = 1 + rng() % sizeof(in);
+    int zeroEvery = (c % 4 == 0) ? 0 : 1 + (int)(rng() % 300);   // 0: no zeros at all
+    for (size_t i = 0; i < length; i++) {
+      in[i] = (zeroEvery != 0 && rng() % zeroEvery == 0) ? 0 : 1 + rng() % 255;
+    }
+    size_t n = BulkLink::cobsEncode(in, length, encoded);
+    bool noZero = memchr(encoded, 0, n) == nullptr;
+    size_t back = BulkLink::cobsDecode(encoded, n, out, sizeof(out));
+    if (noZero && n <= length + length / 254 + 1 && back == length && memcmp(in, out, length) == 0) ok++;
+  }
+
+  BulkLink::Frame frame;
+  frame.type = BulkLink::DATA;
+  frame.seq = 0x0102;
+  frame.length = BulkLink::MAX_PAYLOAD;
+  memset(frame.payload, 0, sizeof(frame.payload));
+  uint8_t wire[BulkLink::MAX_ENCODED];
+  size_t n = BulkLink::encode(frame, wire);
+  BulkLink::Frame back;
+  bool frameOk = n <= BulkLink::MAX_ENCODED && wire[n - 1] == 0 &&
+                 BulkLink::decode(wire, n - 1, back) && back.seq == 0x0102 &&
+                 back.length == BulkLink::MAX_PAYLOAD;
+
+  char details[96];
+  snprintf(details, sizeof(details), "crc16 %s, %d/%d COBS round trips, full frame %zu B", crcOk ? "ok" : "WRONG",
+           ok, CASES, n);
+  check("CRC-16 and COBS", crcOk && ok == CASES && frameOk, details);
+}
+
+/** Damaged frames are dropped, intact ones after them are not */
+static void testDecoderResync() {
+  const int FRAMES = 3000;
+  std::vector<uint8_t> stream;
+  std::vector<bool> intact(FRAMES, true);
+
+  for (int i = 0; i < FRAMES; i++) {
+    BulkLink::Frame frame;
+    frame.type = BulkLink::DATA;
+    frame.seq = (uint16_t)i;
+    frame.length = rng() % (BulkLink::MAX_PAYLOAD + 1);
+    for (size_t b = 0; b < frame.length; b++) frame.payload[b] = rng() % 4 == 0 ? 0 : rng();
+    uint8_t wire[BulkLink::MAX_ENCODED];
+    size_t n = BulkLink::encode(frame, wire);
+
+    switch (rng() % 10) {
+      case 0:                      // Bit flip inside the frame
+        wire[rng() % (n - 1)] ^= 1 << (rng() % 8);
+        intact[i] = false;
+        break;
+      case 1:                      // Delimiter lost: merges with the next frame
+        n--;
+        intact[i] = false;
+        if (i + 1 < FRAMES) intact[i + 1] = false;
+        break;
+      case 2: {                    // Noise burst ending in a zero before the frame
+        int burst = 1 + rng() % 20;
+        for (int b = 0; b < burst; b++) stream.push_back(1 + rng() % 255);
+        stream.push_back(0);
+        intact[i] = true;          // The zero resyncs even after a lost delimiter
+        break;
+      }
+      case 3:                      // Bytes dropped from the middle
+        if (n > 8) {
+          memmove(wire + 2, wire + 5, n - 5);
+          n -= 3;
+          intact[i] = false;
+        }
+        break;
+    }
+    stream.insert(stream.end(), wire, wire + n);
+  }
+
+  BulkLink::Decoder decoder;
+  std::vector<bool> seen(FRAMES, false);
+  int wrong = 0;
+  for (uint8_t byte : stream) {
+    if (decoder.feed(byte)) {
+      uint16_t seq = decoder.frame().seq;
+      if (seq >= FRAMES || seen[seq]) {
+        wrong++;
+      } else {
+        seen[seq] = true;
+      }
+    }
+  }
+  int expected = 0;
+  int recovered = 0;
+  int falseAccepts = 0;
+  for (int i = 0; i < FRAMES; i++) {
+    if (intact[i]) expected++;
+    if (intact[i] && seen[i]) recovered++;
+    if (!intact[i] && seen[i]) falseAccepts++;
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "%d/%d intact frames, %d damaged accepted, %u errors", recovered,
+           expected, falseAccepts + wrong, decoder.getErrors());
+  check("decoder drops damage, resyncs", recovered == expected && falseAccepts == 0 && wrong == 0, details);
+}
+
+// ============================================================================
+// TRANSFER SIMULATION
+// ============================================================================
+
+struct Wire {
+  // Bytes in flight: value and the tick they arrive
+  std::deque<std::pair<uint8_t, long>> bytes;
+  long freeAt = 0;                 // Tick the UART is free to send again
+  double corruptRate = 0;
+  long downFrom = -1;
+  long downTo = -1;
+  unsigned long sent = 0;
+
+  void send(uint8_t byte, long now, long latency) {
+    long at = (freeAt > now) ? freeAt : now;
+    freeAt = at + 1;
+    sent++;
+    if (at >= downFrom && at < downTo) return;       // Cable out
+    if (corruptRate > 0 && (rng() % 1000000) < corruptRate * 1000000) byte ^= 1 << (rng() % 8);
+    bytes.push_back(std::make_pair(byte, at + 1 + latency));
+  }
+
+  bool receive(long now, uint8_t& byte) {
+    if (bytes.empty() || bytes.front().second > now) return false;
+    byte = bytes.front().first;
+    bytes.pop_front();
+    return true;
+  }
+};
+
+struct TransferResult {
+  bool intact;
+  double seconds;
+  double efficiency;               // File bytes / wire capacity used
+  uint32_t resends;
+  unsigned long requests;
+};
+
+// One byte time at 921600 baud (8N1) is 10.85 us; times below are in those ticks
+static TransferResult simulate(size_t fileSize, double corruptRate, bool pullCable) {
+  const long TICKS_PER_MS = 92;
+  const long LATENCY = 2 * TICKS_PER_MS;           // USB serial, each way
+  const size_t FIFO = 128;
+  const long HOST_TIMEOUT = 1000 * TICKS_PER_MS;
+
+  std::vector<uint8_t> file(fileSize);
+  for (size_t i = 0; i < fileSize; i++) file[i] = rng();
+
+  Wire down;                       // Device -> host
+  Wire up;                         // Host -> device
+  down.corruptRate = corruptRate;
+  up.corruptRate = corruptRate;
+  if (pullCable) {
+    down.downFrom = up.downFrom = 300 * TICKS_PER_MS;
+    down.downTo = up.downTo = 800 * TICKS_PER_MS;
+  }
+
+  // Device
+  BulkWindow window;
+  BulkLink::Decoder deviceRx;
+  uint16_t transferSeq = 0;
+  std::deque<uint8_t> fifo;
+
+  // Host
+  BulkLink::Decoder hostRx;
+  BulkReceiver receiver;
+  std::vector<uint8_t> received;
+  uint16_t hostSeq = 0;
+  long lastProgress = 0;
+  unsigned long requests = 0;
+
+  auto hostSend = [&](uint8_t type, const uint8_t* payload, size_t length, long now) {
+    BulkLink::Frame frame;
+    frame.type = type;
+    frame.seq = hostSeq;
+    frame.length = length;
+    memcpy(frame.payload, payload, length);
+    uint8_t wire[BulkLink::MAX_ENCODED];
+    size_t n = BulkLink::encode(frame, wire);
+    up.send(0, now, LATENCY);      // Flush any partial frame at the device
+    for (size_t i = 0; i < n; i++) up.send(wire[i], now, LATENCY);
+  };
+  auto requestGet = [&](long now) {
+    hostSeq++;
+    requests++;
+    receiver.start(hostSeq, received.size());
+    uint8_t payload[8];
+    BulkLink::put32(payload, received.size());
+    BulkLink::put32(payload + 4, 0xFFFFFFFF);
+    hostSend(BulkLink::GET, payload, sizeof(payload), now);
+    lastProgress = now;
+  };
+
+  requestGet(0);
+  long now = 0;
+  const long LIMIT = 120000L * TICKS_PER_MS;
+  for (; now < LIMIT && !receiver.isDone(); now++) {
+    // Device loop pass
+    if (now % TICKS_PER_MS == 0) {
+      uint8_t byte;
+      while (up.receive(now, byte)) {
+        if (!deviceRx.feed(byte)) continue;
+        const BulkLink::Frame& frame = deviceRx.frame();
+        if (frame.type == BulkLink::GET && frame.length >= 8) {
+          transferSeq = frame.seq;
+          uint32_t offset = BulkLink::get32(frame.payload);
+          window.start(offset < fileSize ? offset : fileSize, fileSize, now / TICKS_PER_MS);
+        } else if (frame.type == BulkLink::ACK && frame.seq == transferSeq && frame.length >= 5) {
+          window.ack(BulkLink::get32(frame.payload), frame.payload[4] != 0, now / TICKS_PER_MS);
+        }
+      }
+      window.poll(now / TICKS_PER_MS);
+
+      uint32_t offset;
+      size_t length;
+      bool last;
+      while (fifo.size() < FIFO && window.next(offset, length, last)) {
+        BulkLink::Frame frame;
+        frame.type = last ? BulkLink::DATA_LAST : BulkLink::DATA;
+        frame.seq = transferSeq;
+        frame.length = BulkLink::DATA_HEADER + length;
+        BulkLink::put32(frame.payload, offset);
+        memcpy(frame.payload + BulkLink::DATA_HEADER, file.data() + offset, length);
+        uint8_t wire[BulkLink::MAX_ENCODED];
+        size_t n = BulkLink::encode(frame, wire);
+        fifo.insert(fifo.end(), wire, wire + n);
+      }
+    }
+    // UART: one byte per tick while the FIFO has data
+    if (!fifo.empty() && down.freeAt <= now) {
+      down.send(fifo.front(), now, LATENCY);
+      fifo.pop_front();
+    }
+
+    // Host
+    uint8_t byte;
+    while (down.receive(now, byte)) {
+      if (!hostRx.feed(byte)) continue;
+      const uint8_t* data;
+      size_t length;
+      BulkReceiver::Result result = receiver.onFrame(hostRx.frame(), data, length);
+      if (result == BulkReceiver::ACCEPTED || result == BulkReceiver::DONE) {
+        received.insert(received.end(), data, data + length);
+        lastProgress = now;
+      }
+    }
+    uint32_t ackOffset;
+    bool gap;
+    if (receiver.ackDue(ackOffset, gap)) {
+      uint8_t payload[5];
+      BulkLink::put32(payload, ackOffset);
+      payload[4] = gap;
+      hostSend(BulkLink::ACK, payload, sizeof(payload), now);
+    }
+    // Nothing for a second (device gave up or the GET was lost): resume
+    if (now - lastProgress > HOST_TIMEOUT) {
+      requestGet(now);
+    }
+  }
+
+  TransferResult result;
+  result.intact = receiver.isDone() && received == file;
+  result.seconds = now / (TICKS_PER_MS * 1000.0);
+  result.efficiency = fileSize / (result.seconds * 92160.0);
+  result.resends = window.getResends();
+  result.requests = requests;
+  return result;
+}
+
+/** Clean link: close to wire speed */
+static void testCleanTransfer() {
+  TransferResult r = simulate(256 * 1024, 0, false);
+  printf("BENCH bulk_get_clean kb_per_s=%.1f wire_efficiency=%.3f\n", 256 / r.seconds, r.efficiency);
+  char details[96];
+  snprintf(details, sizeof(details), "256 KB in %.2f s = %.1f KB/s, %.1f%% of 921600 baud", r.seconds,
+           256 / r.seconds, r.efficiency * 100);
+  check("clean GET near wire speed", r.intact && r.efficiency > 0.9 && r.resends == 0, details);
+}
+
+/** Corrupted bytes both ways and a pulled cable: file still intact */
+static void testGlitchedTransfer() {
+  const double rates[] = { 1e-5, 1e-4, 5e-4 };
+  int intact = 0;
+  double at1e4 = 0;
+  char details[128];
+  int at = snprintf(details, sizeof(details), "efficiency");
+  for (double rate : rates) {
+    TransferResult r = simulate(128 * 1024, rate, false);
+    if (r.intact) intact++;
+    if (rate == 1e-4) at1e4 = r.efficiency;
+    at += snprintf(details + at, sizeof(details) - at, " %.0f%%", r.efficiency * 100);
+  }
+  TransferResult pulled = simulate(128 * 1024, 1e-5, true);
+  if (pulled.intact) intact++;
+  printf("BENCH bulk_get_glitched wire_efficiency_1e4=%.3f\n", at1e4);
+  snprintf(details + at, sizeof(details) - at, " @ 1e-5/1e-4/5e-4; cable pull: %.2f s, %lu GET(s)",
+           pulled.seconds, pulled.requests);
+  check("corruption + cable pull survived", intact == 4, details);
+}
+
+int main() {
+  testCodec();
+  testDecoderResync();
+  testCleanTransfer();
+  testGlitchedTransfer();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/**
+ * Serial Command Parser Tests (host)
+ *
+ * Checks CommandParser: binary-search lookup over a sorted constexpr
+ * table, argument schemas (integers, words, rest-of-line text, optional
+ * and repeating arguments), and in-place trimming and upper-casing. Then
+ * times parse + dispatch for a mix of console commands and counts heap
+ * allocations per command, next to the String-style parsing it replaced
+ * (emulated with std::string: trim, toUpperCase, == / startsWith chain,
+ * substring for the argument).
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/core \
+ *       command_parser_tests.cpp ../../src/core/command_parser.cpp -o command_parser_tests
+ *   ./command_parser_tests
+ */
+
+#include "command_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+// Every C++ heap allocation in this program passes through here
+static unsigned long heapAllocations = 0;
+
+void* operator new(size_t size) {
+  heapAllocations++;
+  void* p = malloc(size ? size : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// TEST TABLE (same shape as the firmware's)
+// ============================================================================
+
+static CommandArgs lastArgs;
+static const char* lastCommand = "";
+static volatile unsigned long dispatched = 0;
+
+#define HANDLER(fn, label) \
+  static void fn(const CommandArgs& args) { lastArgs = args; lastCommand = label; dispatched++; }
+
+HANDLER(cmdCount, "COUNT")
+HANDLER(cmdDebounce, "DEBOUNCE")
+HANDLER(cmdLevel, "LEVEL")
+HANDLER(cmdLog, "LOG")
+HANDLER(cmdRead, "READ")
+HANDLER(cmdSearch, "SEARCH")
+HANDLER(cmdSet, "SET")
+HANDLER(cmdStatus, "STATUS")
+HANDLER(cmdTrace, "TRACE")
+
+static constexpr CommandSpec COMMANDS[] = {
+  { "COUNT",    "",    "COUNT",                            cmdCount },
+  { "DEBOUNCE", "i",   "DEBOUNCE,<ms>",                    cmdDebounce },
+  { "LEVEL",    "WW",  "LEVEL[,<module|ALL>,<level>]",     cmdLevel },
+  { "LOG",      "w",   "LOG,<mode>",                       cmdLog },
+  { "READ",     "t",   "READ,<file>",                      cmdRead },
+  { "SEARCH",   "t",   "SEARCH,<text>",                    cmdSearch },
+  { "SET",      "ii*", "SET,<n>,<value>[,<n>,<value>...]", cmdSet },
+  { "STATUS",   "",    "STATUS",                           cmdStatus },
+  { "TRACE",    "W",   "TRACE[,CLEAR]",                    cmdTrace },
+};
+static const size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+static_assert(CommandParser::isSorted(COMMANDS, COMMAND_COUNT), "Test table must be sorted");
+
+static constexpr CommandSpec UNSORTED[] = {
+  { "STATUS", "", "", cmdStatus },
+  { "SET",    "", "", cmdSet },
+};
+static_assert(!CommandParser::isSorted(UNSORTED, 2), "Order check must catch SET after STATUS");
+
+static CommandParser::Result run(const char* text) {
+  char line[96];
+  snprintf(line, sizeof(line), "%s", text);
+  lastCommand = "";
+  return CommandParser::execute(line, COMMANDS, COMMAND_COUNT);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Every name is found; near misses are not */
+static void testLookup() {
+  int found = 0;
+  for (size_t i = 0; i < COMMAND_COUNT; i++) {
+    if (CommandParser::find(COMMANDS, COMMAND_COUNT, COMMANDS[i].name) == &COMMANDS[i]) found++;
+  }
+  const char* misses[] = { "", "A", "CO", "COUNTS", "SE", "SETS", "STAT", "STATUSX", "ZZZ", "status" };
+  int missed = 0;
+  for (const char* name : misses) {
+    if (CommandParser::find(COMMANDS, COMMAND_COUNT, name) == nullptr) missed++;
+  }
+
+  char details[64];
+  snprintf(details, sizeof(details), "%d/%zu found, %d/%zu near misses rejected", found, COMMAND_COUNT,
+           missed, sizeof(misses) / sizeof(misses[0]));
+  check("sorted table lookup", found == (int)COMMAND_COUNT &&
+        missed == (int)(sizeof(misses) / sizeof(misses[0])), details);
+}
+
+/** Each line gives the expected result, arguments and values */
+static void testSchemas() {
+  struct Case {
+    const char* line;
+    CommandParser::Result result;
+    const char* command;
+    int count;
+    const char* first;
+    long firstNumber;
+  };
+  const Case cases[] = {
+    { "STATUS",                 CommandParser::OK,       "STATUS",   0, nullptr,    0 },
+    { "  status \r",            CommandParser::OK,       "STATUS",   0, nullptr,    0 },
+    { "STATUS,1",               CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "",                       CommandParser::EMPTY,    "",         0, nullptr,    0 },
+    { " \t\r",                  CommandParser::EMPTY,    "",         0, nullptr,    0 },
+    { "FOO",                    CommandParser::UNKNOWN,  "",         0, nullptr,    0 },
+    { "DEBOUNCE,80",            CommandParser::OK,       "DEBOUNCE", 1, "80",      80 },
+    { "debounce,-5",            CommandParser::OK,       "DEBOUNCE", 1, "-5",      -5 },
+    { "DEBOUNCE",               CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "DEBOUNCE,",              CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "DEBOUNCE,8O",            CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "DEBOUNCE,80,1",          CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "LEVEL",                  CommandParser::OK,       "LEVEL",    0, nullptr,    0 },
+    { "LEVEL,storage,debug",    CommandParser::OK,       "LEVEL",    2, "STORAGE",  0 },
+    { "LEVEL,A,B,C",            CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "LOG,BINARY",             CommandParser::OK,       "LOG",      1, "BINARY",   0 },
+    { "LOG",                    CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "SEARCH,2024,06",         CommandParser::OK,       "SEARCH",   1, "2024,06",  0 },
+    { "READ,/prod/day_01.csv",  CommandParser::OK,       "READ",     1, "/PROD/DAY_01.CSV", 0 },
+    { "SET,2,120",              CommandParser::OK,       "SET",      2, "2",        2 },
+    { "SET,1,2000,2,80,5,250",  CommandParser::OK,       "SET",      6, "1",        1 },
+    { "SET,2",                  CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "SET,2,120,3",            CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "SET",                    CommandParser::BAD_ARGS, "",         0, nullptr,    0 },
+    { "TRACE,CLEAR",            CommandParser::OK,       "TRACE",    1, "CLEAR",    0 },
+    { "SET,1,1,2,2,3,3,4,4,5,5,6,6,7,7", CommandParser::BAD_ARGS, "", 0, nullptr, 0 },
+  };
+
+  int ok = 0;
+  const int total = sizeof(cases) / sizeof(cases[0]);
+  const char* firstFailure = "";
+  for (const Case& c : cases) {
+    CommandParser::Result result = run(c.line);
+    bool match = result == c.result && strcmp(lastCommand, c.command) == 0;
+    if (match && result == CommandParser::OK) {
+      match = lastArgs.count == c.count &&
+              (c.first == nullptr || (strcmp(lastArgs.word[0], c.first) == 0 &&
+                                      lastArgs.number[0] == c.firstNumber));
+    }
+    if (match) {
+      ok++;
+    } else if (*firstFailure == '\0') {
+      firstFailure = c.line;
+    }
+  }
+
+  // The last pair of a repeated group is reachable
+  run("SET,1,2000,2,80,5,250");
+  bool pairs = lastArgs.number[4] == 5 && lastArgs.number[5] == 250;
+
+  char details[96];
+  snprintf(details, sizeof(details), "%d/%d lines as expected%s%s", ok, total,
+           *firstFailure ? ", first failure: " : "", firstFailure);
+  check("argument schemas", ok == total && pairs, details);
+}
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+static const char* const MIX[] = {
+  "STATUS", "COUNT", "DEBOUNCE,80", "SET,1,2000,2,80", "LEVEL,STORAGE,DEBUG",
+  "SEARCH,DAILYPRODUCTION_2024", "READ,/PROD/PROD_SESSION_20240601.CSV", "TRACE", "NOPE",
+};
+static const size_t MIX_COUNT = sizeof(MIX) / sizeof(MIX[0]);
+
+// handleSerialInput before: String, trim, toUpperCase, compare chain
+static void legacyDispatch(const char* text) {
+  std::string input(text);
+  size_t start = input.find_first_not_of(" \t\r\n");
+  size_t end = input.find_last_not_of(" \t\r\n");
+  input = (start == std::string::npos) ? std::string() : input.substr(start, end - start + 1);
+  std::transform(input.begin(), input.end(), input.begin(), ::toupper);
+
+  const char* names[] = { "STATUS", "START", "STOP", "COUNT", "DIAG", "RESET", "LS", "PROD" };
+  for (const char* name : names) {
+    if (input == name) {
+      dispatched++;
+      return;
+    }
+  }
+  const char* prefixes[] = { "SEARCH,", "READ,", "LEVEL,", "SET,", "DEBOUNCE," };
+  for (const char* prefix : prefixes) {
+    if (input.compare(0, strlen(prefix), prefix) == 0) {
+      std::string argument = input.substr(strlen(prefix));
+      dispatched += argument.size() > 0;
+      return;
+    }
+  }
+  if (input == "TRACE" || input == "HELP") {
+    dispatched++;
+  }
+}
+
+static void benchmarkDispatch() {
+  const int ROUNDS = 200000;
+  char line[96];
+
+  unsigned long heapBefore = heapAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < MIX_COUNT; i++) {
+      memcpy(line, MIX[i], strlen(MIX[i]) + 1);
+      CommandParser::execute(line, COMMANDS, COMMAND_COUNT);
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+              (ROUNDS * MIX_COUNT);
+  double allocations = (double)(heapAllocations - heapBefore) / (ROUNDS * MIX_COUNT);
+
+  heapBefore = heapAllocations;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < MIX_COUNT; i++) {
+      legacyDispatch(MIX[i]);
+    }
+  }
+  double legacyNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                    (ROUNDS * MIX_COUNT);
+  double legacyAllocations = (double)(heapAllocations - heapBefore) / (ROUNDS * MIX_COUNT);
+
+  printf("BENCH command_dispatch ns_per_command=%.1f heap_allocs_per_command=%.2f\n", ns, allocations);
+  printf("BENCH command_dispatch_string ns_per_command=%.1f heap_allocs_per_command=%.2f\n", legacyNs,
+         legacyAllocations);
+  char details[96];
+  snprintf(details, sizeof(details), "%.1f ns, %.2f allocs (String style: %.1f ns, %.2f allocs)", ns,
+           allocations, legacyNs, legacyAllocations);
+  check("parse + dispatch, no heap", allocations == 0 && ns < 2000, details);
+}
+
+int main() {
+  testLookup();
+  testSchemas();
+  benchmarkDispatch();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
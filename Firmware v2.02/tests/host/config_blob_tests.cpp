@@ -0,0 +1,244 @@
+/**
+ * Configuration Blob Tests (host)
+ *
+ * Checks the ConfigBlob EEPROM format: round trip, newest-copy selection
+ * and fallback to the other copy after a torn or corrupted write, blobs
+ * from older (shorter payload) and newer (longer payload) schema versions,
+ * the one-time import of the code_v3 layout, and range repair.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/managers -I../../src/core \
+ *       config_blob_tests.cpp ../../src/managers/config_blob.cpp ../../src/core/checksum.cpp \
+ *       -o config_blob_tests
+ *   ./config_blob_tests
+ */
+
+#include "config_blob.h"
+#include "checksum.h"
+#include <cstdio>
+#include <cstring>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+static uint8_t region[ConfigBlob::REGION_SIZE];
+
+static void eraseRegion() {
+  memset(region, 0xFF, sizeof(region));
+}
+
+static void save(size_t slot, const ConfigBlob::Payload& values, uint32_t sequence) {
+  ConfigBlob::encode(values, sequence, region + ConfigBlob::slotAddress(slot));
+}
+
+// A copy as another firmware version would have written it
+static void saveRaw(size_t slot, uint16_t version, const uint8_t* payload, uint16_t size, uint32_t sequence) {
+  ConfigBlob::Header header;
+  header.magic = ConfigBlob::MAGIC;
+  header.version = version;
+  header.size = size;
+  header.sequence = sequence;
+  uint32_t crc = crc32Begin();
+  crc = crc32Update(crc, reinterpret_cast<uint8_t*>(&header) + 4, 8);
+  crc = crc32Update(crc, payload, size);
+  header.crc = crc32End(crc);
+
+  uint8_t* at = region + ConfigBlob::slotAddress(slot);
+  memset(at, 0xFF, ConfigBlob::SLOT_SIZE);
+  memcpy(at, &header, sizeof(header));
+  memcpy(at + sizeof(header), payload, size);
+}
+
+static ConfigBlob::Payload sample(uint32_t saveIntervalMs) {
+  ConfigBlob::Payload values;
+  values.saveIntervalMs = saveIntervalMs;
+  values.debounceDelayMs = 120;
+  values.maxCount = 4500;
+  values.statusDisplayMs = 7000;
+  values.displayRefreshMs = 250;
+  return values;
+}
+
+static bool same(const ConfigBlob::Payload& a, const ConfigBlob::Payload& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Saved settings come back unchanged; the newest copy wins */
+static void testRoundTrip() {
+  eraseRegion();
+  save(0, sample(2000), 7);
+  save(1, sample(3000), 8);
+
+  ConfigBlob::Payload out;
+  ConfigBlob::Info info;
+  bool loaded = ConfigBlob::decode(region, out, info);
+
+  char details[96];
+  snprintf(details, sizeof(details), "copy %d, seq %u, v%u, %u valid", info.slot, info.sequence,
+           info.version, info.validCopies);
+  check("round trip, newest copy", loaded && same(out, sample(3000)) && info.slot == 1 &&
+        info.sequence == 8 && info.version == ConfigBlob::VERSION && info.validCopies == 2 &&
+        !info.clamped, details);
+}
+
+/** A torn or bit-flipped newer copy falls back to the older one */
+static void testCorruptFallsBack() {
+  int fallbacks = 0;
+  const int CASES = 3;
+  for (int c = 0; c < CASES; c++) {
+    eraseRegion();
+    save(0, sample(2000), 41);
+    save(1, sample(3000), 42);
+    uint8_t* newer = region + ConfigBlob::slotAddress(1);
+    if (c == 0) newer[sizeof(ConfigBlob::Header) + 2] ^= 0x04;                // Payload bit
+    if (c == 1) newer[6] ^= 0x01;                                             // Size field
+    if (c == 2) memset(newer + sizeof(ConfigBlob::Header), 0xFF, 8);          // Torn write
+
+    ConfigBlob::Payload out;
+    ConfigBlob::Info info;
+    if (ConfigBlob::decode(region, out, info) && info.slot == 0 && info.validCopies == 1 &&
+        same(out, sample(2000))) {
+      fallbacks++;
+    }
+  }
+
+  char details[64];
+  snprintf(details, sizeof(details), "%d/%d fell back to the older copy", fallbacks, CASES);
+  check("corrupt copy falls back", fallbacks == CASES, details);
+}
+
+/** No valid copy: decode fails, and tells erased from corrupted */
+static void testNoValidCopy() {
+  ConfigBlob::Payload out;
+  ConfigBlob::Info erased;
+  eraseRegion();
+  bool loadedErased = ConfigBlob::decode(region, out, erased);
+
+  ConfigBlob::Info corrupted;
+  save(0, sample(2000), 1);
+  region[ConfigBlob::slotAddress(0) + sizeof(ConfigBlob::Header)] ^= 0x80;
+  bool loadedCorrupted = ConfigBlob::decode(region, out, corrupted);
+
+  ConfigBlob::Info zeroed;
+  memset(region, 0, sizeof(region));
+  bool loadedZeroed = ConfigBlob::decode(region, out, zeroed);
+
+  char details[96];
+  snprintf(details, sizeof(details), "erased: blank=%d, corrupted: blank=%d, zeroed: blank=%d",
+           erased.blank, corrupted.blank, zeroed.blank);
+  check("no valid copy detected", !loadedErased && erased.blank && !loadedCorrupted &&
+        !corrupted.blank && !loadedZeroed && !zeroed.blank, details);
+}
+
+/** Older blob (shorter payload) keeps defaults for the missing fields;
+ *  newer blob (longer payload) is read up to the known fields */
+static void testSchemaVersions() {
+  ConfigBlob::Payload values = sample(2500);
+  uint8_t payload[ConfigBlob::SLOT_SIZE - sizeof(ConfigBlob::Header)];
+
+  // Written before statusDisplayMs existed
+  eraseRegion();
+  memcpy(payload, &values, 12);
+  saveRaw(0, 1, payload, 12, 5);
+  ConfigBlob::Payload older;
+  ConfigBlob::Info olderInfo;
+  bool olderOk = ConfigBlob::decode(region, older, olderInfo);
+  ConfigBlob::Payload wantOlder = values;
+  wantOlder.statusDisplayMs = ConfigBlob::defaults().statusDisplayMs;
+  wantOlder.displayRefreshMs = ConfigBlob::defaults().displayRefreshMs;
+
+  // Written by a later version with two more fields
+  eraseRegion();
+  memcpy(payload, &values, sizeof(values));
+  memset(payload + sizeof(values), 0x5A, 8);
+  saveRaw(1, ConfigBlob::VERSION + 1, payload, sizeof(values) + 8, 9);
+  ConfigBlob::Payload newer;
+  ConfigBlob::Info newerInfo;
+  bool newerOk = ConfigBlob::decode(region, newer, newerInfo);
+
+  char details[96];
+  snprintf(details, sizeof(details), "older: %u B, status %u ms; newer: v%u %u B", olderInfo.size,
+           older.statusDisplayMs, newerInfo.version, newerInfo.size);
+  check("older/newer schema", olderOk && same(older, wantOlder) && newerOk && same(newer, values) &&
+        newerInfo.version == ConfigBlob::VERSION + 1, details);
+}
+
+/** code_v3 EEPROM bytes are imported; no magic, no import */
+static void testLegacyImport() {
+  uint8_t legacy[ConfigBlob::LEGACY_SIZE];
+  uint32_t saveInterval = 10000;
+  uint32_t debounce = 80;
+  int32_t maxCount = 5000;
+  uint32_t status = 2000;
+  memcpy(legacy + 0, &saveInterval, 4);
+  memcpy(legacy + 4, &debounce, 4);
+  memcpy(legacy + 8, &maxCount, 4);
+  memcpy(legacy + 12, &status, 4);
+  legacy[16] = ConfigBlob::LEGACY_MAGIC;
+
+  ConfigBlob::Payload out;
+  bool clamped = true;
+  bool imported = ConfigBlob::parseLegacy(legacy, sizeof(legacy), out, clamped);
+  bool exact = imported && !clamped && out.saveIntervalMs == 10000 && out.debounceDelayMs == 80 &&
+               out.maxCount == 5000 && out.statusDisplayMs == 2000;
+
+  // Magic present but a value out of range: that field falls back
+  uint32_t tooShort = 3;
+  memcpy(legacy + 4, &tooShort, 4);
+  bool repairedClamped = false;
+  ConfigBlob::Payload repaired;
+  bool repairedOk = ConfigBlob::parseLegacy(legacy, sizeof(legacy), repaired, repairedClamped) &&
+                    repairedClamped && repaired.debounceDelayMs == ConfigBlob::defaults().debounceDelayMs &&
+                    repaired.saveIntervalMs == 10000;
+
+  legacy[16] = 0x00;
+  bool noMagic = !ConfigBlob::parseLegacy(legacy, sizeof(legacy), out, clamped);
+
+  char details[96];
+  snprintf(details, sizeof(details), "exact=%d, repaired=%d, rejected without magic=%d", exact,
+           repairedOk, noMagic);
+  check("legacy layout import", exact && repairedOk && noMagic, details);
+}
+
+/** A valid copy with out-of-range values is repaired field by field */
+static void testRangeRepair() {
+  eraseRegion();
+  ConfigBlob::Payload values = sample(2000);
+  values.maxCount = 5;
+  values.statusDisplayMs = 999999;
+  save(0, values, 3);
+
+  ConfigBlob::Payload out;
+  ConfigBlob::Info info;
+  bool loaded = ConfigBlob::decode(region, out, info);
+  ConfigBlob::Payload want = values;
+  want.maxCount = ConfigBlob::defaults().maxCount;
+  want.statusDisplayMs = ConfigBlob::defaults().statusDisplayMs;
+
+  char details[96];
+  snprintf(details, sizeof(details), "clamped=%d, max count %d, status %u ms", info.clamped,
+           out.maxCount, out.statusDisplayMs);
+  check("out-of-range fields repaired", loaded && info.clamped && same(out, want), details);
+}
+
+int main() {
+  testRoundTrip();
+  testCorruptFallsBack();
+  testNoValidCopy();
+  testSchemaVersions();
+  testLegacyImport();
+  testRangeRepair();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
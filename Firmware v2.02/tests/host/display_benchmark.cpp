@@ -0,0 +1,188 @@
+/**
+ * Display Render Benchmark (host)
+ *
+ * Runs the main screen through typical workloads on simulated time, one
+ * loop pass per millisecond, and reports per scenario:
+ *   - frames rendered and I2C bytes per frame (emulated bus, exact)
+ *   - average I2C bytes per second of simulated time
+ *   - host CPU time per rendered frame (render + transfer into the emulator)
+ *     and per loop pass (including the passes that draw nothing)
+ *
+ * "legacy_full" reproduces the original displayMainScreen(): clear,
+ * redraw everything with GFX text and push the whole frame every 100 ms.
+ * It is the baseline the DisplayManager scenarios are compared against.
+ *
+ * Each scenario also prints one "BENCH key=value ..." line for CI to
+ * collect.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DDISPLAY_ASYNC=0 -DSERIAL_OUT_LOCKED=0 -Ishim -I../../src/managers \
+ *       -I../../src/hal \
+ *       display_benchmark.cpp host_runtime.cpp ssd1306_emulator.cpp \
+ *       ../../src/managers/display_manager.cpp ../../src/managers/display_link.cpp \
+ *       ../../src/managers/rate_meter.cpp ../../src/hal/serial_out.cpp \
+ *       -o display_benchmark
+ *   ./display_benchmark
+ */
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <chrono>
+#include "managers.h"
+#include "ssd1306_emulator.h"
+
+Adafruit_SSD1306 display(128, 64, &Wire, -1);
+
+static const unsigned long LOOP_PASS_MS = 1;
+
+struct Workload {
+  const char* name;
+  unsigned long durationMs;
+  unsigned long countEveryMs;      // 0 = no counting
+  bool production;
+};
+
+struct Result {
+  uint32_t passes;
+  uint32_t frames;
+  uint32_t busBytes;
+  double hostMicros;       // Whole run, every loop pass
+  double frameMicros;      // Passes that produced a frame only
+};
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double microsSince(BenchClock::time_point start) {
+  return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+}
+
+// Simulated wall clock of the workload (starts at 09:00:00)
+static void clockAt(unsigned long elapsedMs, int& hour, int& minute) {
+  unsigned long minutes = elapsedMs / 60000;
+  hour = (9 + minutes / 60) % 24;
+  minute = minutes % 60;
+}
+
+// ============================================================================
+// RENDERERS
+// ============================================================================
+
+// Original v2.02 displayMainScreen(), every DISPLAY_UPDATE_INTERVAL
+static Result runLegacy(const Workload& work) {
+  Ssd1306Emulator& panel = Ssd1306Emulator::getInstance();
+  panel.resetStats();
+  Result result = {};
+  unsigned long lastDisplay = 0;
+  long count = 0;
+
+  BenchClock::time_point start = BenchClock::now();
+  for (unsigned long t = 0; t < work.durationMs; t += LOOP_PASS_MS) {
+    result.passes++;
+    if (work.countEveryMs && t % work.countEveryMs == 0) count++;
+    if (t - lastDisplay < 100 && t != 0) continue;
+    lastDisplay = t;
+
+    BenchClock::time_point frameStart = BenchClock::now();
+    int hour, minute;
+    clockAt(t, hour, minute);
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.setCursor(0, 0);
+    display.println(work.production ? "PRODUCTION ACTIVE" : "READY");
+    display.setTextSize(2);
+    display.setCursor(20, 20);
+    display.println(count);
+    display.setTextSize(1);
+    display.setCursor(0, 50);
+    display.print(hour);
+    display.print(":");
+    if (minute < 10) display.print("0");
+    display.println(minute);
+    display.setCursor(80, 50);
+    display.print("SD:");
+    display.println("OK");
+    display.display();
+    result.frameMicros += microsSince(frameStart);
+    result.frames++;
+  }
+
+  result.hostMicros = microsSince(start);
+  result.busBytes = panel.getBusBytes();
+  return result;
+}
+
+// DisplayManager: view model every loop pass
+static Result runDisplayManager(const Workload& work) {
+  DisplayManager& dm = DisplayManager::getInstance();
+  Ssd1306Emulator& panel = Ssd1306Emulator::getInstance();
+  dm.initialize();
+  dm.resetStats();
+  panel.resetStats();
+  Result result = {};
+  long count = 0;
+
+  DisplayView view;
+  memset(&view, 0, sizeof(view));
+  view.rtcOk = true;
+  view.sdOk = true;
+  strncpy(view.status, work.production ? "PRODUCTION ACTIVE" : "READY", sizeof(view.status) - 1);
+
+  BenchClock::time_point start = BenchClock::now();
+  for (unsigned long t = 0; t < work.durationMs; t += LOOP_PASS_MS) {
+    result.passes++;
+    if (work.countEveryMs && t % work.countEveryMs == 0) count++;
+
+    int hour, minute;
+    clockAt(t, hour, minute);
+    view.count = count;
+    view.hour = hour;
+    view.minute = minute;
+
+    BenchClock::time_point passStart = BenchClock::now();
+    if (dm.render(view)) {
+      result.frameMicros += microsSince(passStart);
+    }
+    hostAdvanceMillis(LOOP_PASS_MS);
+  }
+
+  result.hostMicros = microsSince(start);
+  result.frames = dm.getFramesRendered();
+  result.busBytes = panel.getBusBytes();
+  return result;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+static void report(const char* renderer, const Workload& work, const Result& r) {
+  double seconds = work.durationMs / 1000.0;
+  double bytesPerFrame = r.frames ? (double)r.busBytes / r.frames : 0;
+  double usPerFrame = r.frames ? r.frameMicros / r.frames : 0;
+  double nsPerPass = r.passes ? r.hostMicros * 1000.0 / r.passes : 0;
+
+  printf("%-18s %-16s %7u frames %8.1f B/frame %9.1f B/s %8.2f us/frame %7.1f ns/pass\n",
+         work.name, renderer, r.frames, bytesPerFrame, r.busBytes / seconds, usPerFrame,
+         nsPerPass);
+  printf("BENCH scenario=%s renderer=%s frames=%u bus_bytes=%u bytes_per_frame=%.1f "
+         "bytes_per_s=%.1f us_per_frame=%.2f ns_per_pass=%.1f\n",
+         work.name, renderer, r.frames, r.busBytes, bytesPerFrame, r.busBytes / seconds,
+         usPerFrame, nsPerPass);
+}
+
+int main() {
+  display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+
+  const Workload workloads[] = {
+    { "idle_ready",     10 * 60000UL, 0,    false },  // Nothing happens for 10 minutes
+    { "counting_5hz",   60000UL,      200,  true  },  // Typical production line
+    { "counting_50hz",  60000UL,      20,   true  },  // Bursty sensor input
+  };
+
+  for (const Workload& work : workloads) {
+    report("legacy_full", work, runLegacy(work));
+    report("display_manager", work, runDisplayManager(work));
+  }
+  return 0;
+}
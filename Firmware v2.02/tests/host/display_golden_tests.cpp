@@ -0,0 +1,146 @@
+/**
+ * Display Golden-Image Tests (host)
+ *
+ * Drives DisplayManager through every screen and compares what the
+ * emulated SSD1306 panel shows (its RAM, as written over I2C) with the
+ * reference images in golden/. Each check also requires the panel to match
+ * the MCU frame buffer, which catches partial updates that miss a span.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DDISPLAY_ASYNC=0 -DSERIAL_OUT_LOCKED=0 -Ishim -I../../src/managers \
+ *       -I../../src/hal \
+ *       display_golden_tests.cpp host_runtime.cpp ssd1306_emulator.cpp \
+ *       ../../src/managers/display_manager.cpp ../../src/managers/display_link.cpp \
+ *       ../../src/managers/rate_meter.cpp ../../src/hal/serial_out.cpp \
+ *       -o display_golden_tests
+ *   ./display_golden_tests            # compare, actual frames go to out/
+ *   ./display_golden_tests --update   # rewrite golden/ after a deliberate change
+ *
+ * Images are plain PBM (P1): viewable in most image tools and diffable as text.
+ */
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <sys/stat.h>
+#include "managers.h"
+#include "ssd1306_emulator.h"
+
+Adafruit_SSD1306 display(128, 64, &Wire, -1);
+
+static bool updateGoldens = false;
+static int testsRun = 0;
+static int testsFailed = 0;
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static void checkScreen(const char* name) {
+  const uint8_t* panel = Ssd1306Emulator::getInstance().panelRam();
+  char goldenPath[96];
+  char actualPath[96];
+  snprintf(goldenPath, sizeof(goldenPath), "golden/%s.pbm", name);
+  snprintf(actualPath, sizeof(actualPath), "out/%s.pbm", name);
+  testsRun++;
+
+  int bufferDiff = Ssd1306Emulator::countDifferences(panel, display.getBuffer());
+
+  if (updateGoldens) {
+    bool written = Ssd1306Emulator::writePbm(goldenPath, panel);
+    printf("%s %-16s %s\n", written ? "[UPDATE]" : "[FAIL]  ", name, goldenPath);
+    if (!written || bufferDiff != 0) testsFailed++;
+    return;
+  }
+
+  uint8_t golden[Ssd1306Emulator::RAM_SIZE];
+  if (!Ssd1306Emulator::readPbm(goldenPath, golden)) {
+    printf("[FAIL]   %-16s missing %s (run with --update)\n", name, goldenPath);
+    testsFailed++;
+    return;
+  }
+
+  int goldenDiff = Ssd1306Emulator::countDifferences(panel, golden);
+  if (goldenDiff == 0 && bufferDiff == 0) {
+    printf("[PASS]   %s\n", name);
+    return;
+  }
+
+  Ssd1306Emulator::writePbm(actualPath, panel);
+  printf("[FAIL]   %-16s %d px differ from golden, %d px from frame buffer (see %s)\n",
+         name, goldenDiff, bufferDiff, actualPath);
+  testsFailed++;
+}
+
+static DisplayView makeView(const char* status, long count, int hour, int minute, bool sdOk) {
+  DisplayView view;
+  memset(&view, 0, sizeof(view));
+  view.count = count;
+  view.rtcOk = hour >= 0;
+  view.hour = hour;
+  view.minute = minute;
+  view.sdOk = sdOk;
+  strncpy(view.status, status, sizeof(view.status) - 1);
+  return view;
+}
+
+// Loop passes until the view has been rendered (rate limit, status holds)
+static void renderView(const DisplayView& view) {
+  DisplayManager& dm = DisplayManager::getInstance();
+  for (int pass = 0; pass < 5000 && !dm.render(view); pass++) {
+    hostAdvanceMillis(1);
+  }
+}
+
+// ============================================================================
+// SCREENS
+// ============================================================================
+
+int main(int argc, char** argv) {
+  updateGoldens = (argc > 1 && strcmp(argv[1], "--update") == 0);
+  mkdir("out", 0755);
+
+  display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  DisplayManager& dm = DisplayManager::getInstance();
+  dm.initialize();
+
+  dm.showInitializationScreen();
+  checkScreen("startup");
+
+  dm.showStatus("Ready!", 1000);
+  checkScreen("status");
+
+  renderView(makeView("READY", 0, 9, 5, true));
+  checkScreen("ready");
+
+  // Same screen after partial updates: count, clock and SD flag change
+  renderView(makeView("READY", 1, 9, 6, false));
+  checkScreen("ready_updated");
+
+  renderView(makeView("PRODUCTION ACTIVE", 1234, 14, 30, true));
+  checkScreen("production");
+
+  renderView(makeView("PRODUCTION ACTIVE", 12345678, 14, 31, true));
+  checkScreen("production_wide");
+
+  DisplayView rated = makeView("PRODUCTION ACTIVE", 1234, 14, 32, true);
+  rated.rateShown = true;
+  rated.rateNow = 425;
+  rated.rateAverage = 401;
+  renderView(rated);
+  checkScreen("production_rate");
+
+  renderView(makeView("READY", 57, -1, 0, true));
+  checkScreen("ready_no_rtc");
+
+  dm.showDiagnosticScreen();
+  checkScreen("diagnostic_mode");
+
+  dm.showDiagnostics("RTC:OK SD:OK EE:OK");
+  checkScreen("diagnostics");
+
+  dm.showErrorScreen("INIT ERROR");
+  checkScreen("error");
+
+  printf("\n%d screens, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
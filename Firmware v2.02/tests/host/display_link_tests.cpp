@@ -0,0 +1,154 @@
+/**
+ * Display Link Tests (host, asynchronous mode)
+ *
+ * Builds DisplayLink with its transmitter task (DISPLAY_ASYNC=1) on the
+ * single-task FreeRTOS stand-in in shim/freertos: the task only runs when
+ * the test calls hostRunTask(), so frames can be submitted while another
+ * is still pending - the case the synchronous builds never reach. After
+ * every transmitter run the emulated panel must show the newest frame
+ * submitted:
+ *   - supersede: two submits with separate dirty ranges, the columns
+ *     between them last written two frames back
+ *   - replay: random frames, dirty ranges and transmitter wake-ups
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DSERIAL_OUT_LOCKED=0 -Ishim -I../../src/managers -I../../src/hal \
+ *       display_link_tests.cpp host_runtime.cpp ssd1306_emulator.cpp \
+ *       ../../src/managers/display_link.cpp ../../src/hal/serial_out.cpp \
+ *       -o display_link_tests
+ *   ./display_link_tests
+ */
+
+#include <Arduino.h>
+#include <freertos/task.h>
+#include <cstdlib>
+#include "display_link.h"
+#include "ssd1306_emulator.h"
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static const uint8_t WIDTH = DisplayLink::WIDTH;
+static const uint8_t PAGES = DisplayLink::PAGE_COUNT;
+
+// Back buffer as DisplayManager keeps it, plus the columns changed since
+// the last submit
+static uint8_t frame[DisplayLink::FRAME_SIZE];
+static uint8_t dirtyStart[PAGES];
+static uint8_t dirtyEnd[PAGES];
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static void clearDirty() {
+  for (uint8_t page = 0; page < PAGES; page++) {
+    dirtyStart[page] = WIDTH;
+    dirtyEnd[page] = 0;
+  }
+}
+
+static void draw(uint8_t page, uint8_t first, uint8_t last, uint8_t value) {
+  memset(frame + page * WIDTH + first, value, last - first + 1);
+  if (first < dirtyStart[page]) dirtyStart[page] = first;
+  if (last > dirtyEnd[page]) dirtyEnd[page] = last;
+}
+
+static void submit() {
+  DisplayLink::getInstance().submit(frame, dirtyStart, dirtyEnd);
+  clearDirty();
+}
+
+static int panelDifferences() {
+  const uint8_t* panel = Ssd1306Emulator::getInstance().panelRam();
+  int columns = 0;
+  for (size_t i = 0; i < DisplayLink::FRAME_SIZE; i++) {
+    if (panel[i] != frame[i]) columns++;
+  }
+  return columns;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Frame superseded while pending: the gap between both ranges is current */
+static void testSupersede() {
+  DisplayLink& link = DisplayLink::getInstance();
+  uint32_t droppedBefore = link.getFramesDropped();
+
+  draw(0, 0, WIDTH - 1, 0x11);     // Frame 1, sent: both buffers now differ
+  submit();
+  hostRunTask();
+  draw(0, 10, 20, 0x22);           // Frame 2, sent from the other buffer
+  submit();
+  hostRunTask();
+
+  draw(0, 0, 2, 0x33);             // Frame 3, pending in the buffer holding frame 1
+  submit();
+  draw(0, 100, 102, 0x44);         // Frame 4 supersedes it: merged 0..102
+  submit();
+  hostRunTask();
+
+  int diff = panelDifferences();
+  char details[96];
+  snprintf(details, sizeof(details), "%lu dropped, %d columns differ from the newest frame",
+           (unsigned long)(link.getFramesDropped() - droppedBefore), diff);
+  check("superseded frame", link.getFramesDropped() - droppedBefore == 1 && diff == 0, details);
+}
+
+/** Random frames and wake-ups: the panel always ends on the newest frame */
+static void testReplay() {
+  DisplayLink& link = DisplayLink::getInstance();
+  uint32_t droppedBefore = link.getFramesDropped();
+  srand(42);
+
+  int runs = 0;
+  int wrongRuns = 0;
+  for (int i = 0; i < 5000; i++) {
+    int spans = 1 + rand() % 3;
+    for (int s = 0; s < spans; s++) {
+      uint8_t page = rand() % PAGES;
+      uint8_t first = rand() % WIDTH;
+      uint8_t last = first + rand() % (WIDTH - first);
+      draw(page, first, last, (uint8_t)rand());
+    }
+    submit();
+
+    if (rand() % 3 == 0) {         // Transmitter wakes after every third frame or so
+      hostRunTask();
+      runs++;
+      if (panelDifferences() != 0) wrongRuns++;
+    }
+  }
+  hostRunTask();
+  int diff = panelDifferences();
+
+  char details[128];
+  snprintf(details, sizeof(details), "%d runs, %lu frames superseded, %d runs wrong, %d columns off",
+           runs, (unsigned long)(link.getFramesDropped() - droppedBefore), wrongRuns, diff);
+  check("random supersede replay", link.getFramesDropped() > droppedBefore &&
+        wrongRuns == 0 && diff == 0, details);
+}
+
+int main() {
+  clearDirty();
+  DisplayLink& link = DisplayLink::getInstance();
+  bool started = link.begin(0x3C) && link.isAsync();
+  check("transmitter task started", started, "host task stand-in");
+  if (!started) {
+    return 1;
+  }
+
+  testSupersede();
+  testReplay();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/**
+ * FSM Trace -> Chrome Trace JSON (host)
+ *
+ * Turns the output of the TRACE serial command into Chrome trace event
+ * JSON, which opens in https://ui.perfetto.dev or chrome://tracing. The
+ * capture may contain other serial output; only TRACE lines are used, and
+ * of several dumps the last complete one. State and event names come from
+ * the dump itself, so no firmware build is needed.
+ *
+ * Timeline (one process, three tracks):
+ *   State handler - one slice per state-handler run (loop pass)
+ *   Events        - one slice per event dispatch; queue waits as async
+ *                   slices from enqueue to dequeue; queue depth counter
+ *   FSM           - transitions (exit + entry actions), guard rejections,
+ *                   dropped events
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -DFSM_TRACE_LOCKED=0 -I../../src/core \
+ *       fsm_trace_json.cpp ../../src/core/fsm_trace.cpp -o fsm_trace_json
+ *
+ * Usage:
+ *   ./fsm_trace_json capture.txt > trace.json      (or capture on stdin)
+ */
+
+#include "fsm_trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CAPTURE PARSING
+// ============================================================================
+
+struct Dump {
+  uint32_t nowUs = 0;
+  unsigned long overwritten = 0;
+  unsigned long missed = 0;
+  std::vector<std::string> states;
+  std::vector<std::string> events;
+  std::vector<FsmTrace::Record> records;
+};
+
+static void setName(std::vector<std::string>& names, const char* fields) {
+  char* end;
+  unsigned long id = strtoul(fields, &end, 10);
+  if (*end != ',' || id > 255) return;
+  if (names.size() <= id) names.resize(id + 1);
+  names[id] = end + 1;
+}
+
+// Last complete dump in the capture
+static bool readCapture(FILE* input, Dump& result) {
+  Dump current;
+  bool inDump = false;
+  bool found = false;
+  char line[256];
+
+  while (fgets(line, sizeof(line), input) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (strncmp(line, "TRACE,BEGIN,", 12) == 0) {
+      current = Dump();
+      unsigned long records, now;
+      inDump = sscanf(line + 12, "%lu,%lu,%lu,%lu", &records, &current.overwritten,
+                      &current.missed, &now) == 4;
+      current.nowUs = (uint32_t)now;
+    } else if (!inDump) {
+      continue;
+    } else if (strncmp(line, "TRACE,STATE,", 12) == 0) {
+      setName(current.states, line + 12);
+    } else if (strncmp(line, "TRACE,EVENT,", 12) == 0) {
+      setName(current.events, line + 12);
+    } else if (strcmp(line, "TRACE,END") == 0) {
+      result = current;
+      found = true;
+      inDump = false;
+    } else {
+      FsmTrace::Record record;
+      if (FsmTrace::parseLine(line, record)) {
+        current.records.push_back(record);
+      }
+    }
+  }
+  return found;
+}
+
+// ============================================================================
+// JSON OUTPUT
+// ============================================================================
+
+static const int TID_HANDLER = 1;
+static const int TID_EVENTS = 2;
+static const int TID_FSM = 3;
+
+static std::string nameOf(const std::vector<std::string>& names, uint8_t id) {
+  if (id < names.size() && !names[id].empty()) return names[id];
+  return "#" + std::to_string(id);
+}
+
+static std::string quoted(const std::string& text) {
+  std::string out = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') out += '\\';
+    if ((unsigned char)c >= 0x20) out += c;
+  }
+  return out + "\"";
+}
+
+static bool firstEvent = true;
+
+static void event(const char* fields) {
+  printf("%s\n  {%s}", firstEvent ? "" : ",", fields);
+  firstEvent = false;
+}
+
+int main(int argc, char** argv) {
+  FILE* input = (argc > 1) ? fopen(argv[1], "r") : stdin;
+  if (input == nullptr) {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+  Dump dump;
+  if (!readCapture(input, dump)) {
+    fprintf(stderr, "No complete TRACE dump (TRACE,BEGIN ... TRACE,END) found\n");
+    return 1;
+  }
+
+  // Timestamps are micros() and wrap every 71 minutes: place records by
+  // their age at dump time, oldest at 0
+  uint32_t oldestAge = 0;
+  for (const FsmTrace::Record& r : dump.records) {
+    uint32_t age = dump.nowUs - r.timeUs;
+    if (age > oldestAge) oldestAge = age;
+  }
+
+  printf("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  const char* tracks[] = { "State handler", "Events", "FSM" };
+  for (int tid = TID_HANDLER; tid <= TID_FSM; tid++) {
+    char fields[160];
+    snprintf(fields, sizeof(fields), "\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+             "\"args\": {\"name\": \"%s\"}", tid, tracks[tid - 1]);
+    event(fields);
+  }
+
+  unsigned long queueId = 0;
+  for (const FsmTrace::Record& r : dump.records) {
+    unsigned long ts = oldestAge - (dump.nowUs - r.timeUs);
+    std::string state = quoted(nameOf(dump.states, r.a));
+    std::string name = quoted(nameOf(dump.events, r.a));
+    char fields[320];
+
+    switch (r.type) {
+      case FsmTrace::HANDLER:
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"handler\", \"ph\": \"X\", \"ts\": %lu, "
+                 "\"dur\": %lu, \"pid\": 1, \"tid\": %d, \"args\": {\"healthy\": %s}", state.c_str(), ts,
+                 (unsigned long)r.durationUs, TID_HANDLER, r.c ? "true" : "false");
+        event(fields);
+        break;
+
+      case FsmTrace::PROCESS:
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"event\", \"ph\": \"X\", \"ts\": %lu, "
+                 "\"dur\": %lu, \"pid\": 1, \"tid\": %d, \"args\": {\"state\": %s}", name.c_str(), ts,
+                 (unsigned long)r.durationUs, TID_EVENTS, quoted(nameOf(dump.states, r.b)).c_str());
+        event(fields);
+        break;
+
+      case FsmTrace::DEQUEUE:
+        // Queue waits overlap without nesting: async slices
+        queueId++;
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"queue\", \"ph\": \"b\", \"id\": %lu, "
+                 "\"ts\": %lu, \"pid\": 1, \"tid\": %d, \"args\": {\"wait_us\": %lu}", name.c_str(),
+                 queueId, ts, TID_EVENTS, (unsigned long)r.durationUs);
+        event(fields);
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"queue\", \"ph\": \"e\", \"id\": %lu, "
+                 "\"ts\": %lu, \"pid\": 1, \"tid\": %d", name.c_str(), queueId,
+                 ts + (unsigned long)r.durationUs, TID_EVENTS);
+        event(fields);
+        break;
+
+      case FsmTrace::ENQUEUE:
+      case FsmTrace::DROP:
+        snprintf(fields, sizeof(fields), "\"name\": \"queue depth\", \"ph\": \"C\", \"ts\": %lu, "
+                 "\"pid\": 1, \"args\": {\"depth\": %u}", ts, r.b);
+        event(fields);
+        if (r.type == FsmTrace::DROP) {
+          snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"queue\", \"ph\": \"i\", "
+                   "\"s\": \"t\", \"ts\": %lu, \"pid\": 1, \"tid\": %d",
+                   quoted("Dropped " + nameOf(dump.events, r.a)).c_str(), ts, TID_FSM);
+          event(fields);
+        }
+        break;
+
+      case FsmTrace::TRANSITION:
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"transition\", \"ph\": \"X\", "
+                 "\"ts\": %lu, \"dur\": %lu, \"pid\": 1, \"tid\": %d",
+                 quoted(nameOf(dump.states, r.a) + " -> " + nameOf(dump.states, r.b)).c_str(), ts,
+                 (unsigned long)r.durationUs, TID_FSM);
+        event(fields);
+        break;
+
+      case FsmTrace::GUARD_REJECT:
+        snprintf(fields, sizeof(fields), "\"name\": %s, \"cat\": \"guard\", \"ph\": \"i\", \"s\": \"t\", "
+                 "\"ts\": %lu, \"pid\": 1, \"tid\": %d, \"args\": {\"state\": %s}",
+                 quoted("Guard rejected " + nameOf(dump.states, r.b)).c_str(), ts, TID_FSM,
+                 state.c_str());
+        event(fields);
+        break;
+    }
+  }
+  printf("\n]}\n");
+
+  fprintf(stderr, "%zu records (%lu overwritten, %lu missed during dump), %.3f s\n",
+          dump.records.size(), dump.overwritten, dump.missed, oldestAge / 1e6);
+  return 0;
+}
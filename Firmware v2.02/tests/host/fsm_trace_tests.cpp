@@ -0,0 +1,139 @@
+/**
+ * FSM Trace Tests (host)
+ *
+ * Checks the FsmTrace ring: it keeps the latest records in order and
+ * counts what it overwrote, a paused trace (TRACE dump in progress) stays
+ * put, and the dump line format round-trips every field. Also times a
+ * record call, which runs in the button ISRs.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DFSM_TRACE_LOCKED=0 -I../../src/core \
+ *       fsm_trace_tests.cpp ../../src/core/fsm_trace.cpp -o fsm_trace_tests
+ *   ./fsm_trace_tests
+ */
+
+#include "fsm_trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Wrap-around keeps the newest CAPACITY records, oldest first */
+static void testRingWrap() {
+  static FsmTrace trace;
+  const uint32_t TOTAL = FsmTrace::CAPACITY * 3 + 17;
+  for (uint32_t i = 0; i < TOTAL; i++) {
+    trace.record(FsmTrace::ENQUEUE, (uint8_t)i, 0, 0, i * 10, i);
+  }
+
+  int inOrder = 0;
+  FsmTrace::Record record;
+  uint32_t first = TOTAL - FsmTrace::CAPACITY;
+  for (size_t i = 0; i < trace.getCount(); i++) {
+    if (trace.get(i, record) && record.timeUs == (first + i) * 10 && record.durationUs == first + i &&
+        record.a == (uint8_t)(first + i)) {
+      inOrder++;
+    }
+  }
+  bool pastEnd = !trace.get(trace.getCount(), record);
+
+  char details[96];
+  snprintf(details, sizeof(details), "%d/%zu in order, %u overwritten of %u", inOrder,
+           FsmTrace::CAPACITY, trace.getOverwritten(), trace.getRecorded());
+  check("ring keeps latest records", inOrder == (int)FsmTrace::CAPACITY && pastEnd &&
+        trace.getOverwritten() == TOTAL - FsmTrace::CAPACITY && trace.getRecorded() == TOTAL, details);
+}
+
+/** Records arriving during a dump are counted, not written */
+static void testPause() {
+  static FsmTrace trace;
+  for (int i = 0; i < 5; i++) {
+    trace.record(FsmTrace::HANDLER, 1, 0, 1, i, 100);
+  }
+  trace.setPaused(true);
+  for (int i = 0; i < 40; i++) {
+    trace.record(FsmTrace::DROP, 2, 15, 0, 1000 + i);
+  }
+  FsmTrace::Record last;
+  trace.get(trace.getCount() - 1, last);
+  size_t countPaused = trace.getCount();
+  trace.setPaused(false);
+  trace.record(FsmTrace::HANDLER, 1, 0, 1, 2000, 100);
+  size_t countAfter = trace.getCount();
+  uint32_t missed = trace.getMissed();
+  trace.clear();
+
+  char details[96];
+  snprintf(details, sizeof(details), "%zu kept while paused, %u missed, %zu after clear", countPaused,
+           missed, trace.getCount());
+  check("pause counts missed records", countPaused == 5 && last.type == FsmTrace::HANDLER &&
+        countAfter == 6 && missed == 40 && trace.getCount() == 0 && trace.getMissed() == 0, details);
+}
+
+/** Every type and field extreme survives formatLine -> parseLine */
+static void testLineRoundTrip() {
+  int ok = 0;
+  int total = 0;
+  size_t longest = 0;
+  const uint32_t times[] = { 0, 1, 123456789, 0xFFFFFFFF };
+  for (uint8_t type = 0; type < FsmTrace::TYPE_COUNT; type++) {
+    for (uint32_t time : times) {
+      FsmTrace::Record in = { time, 0xFFFFFFFF - time, type, 255, (uint8_t)(type * 3), 1 };
+      FsmTrace::Record out;
+      char line[FsmTrace::MAX_LINE];
+      size_t n = FsmTrace::formatLine(in, line, sizeof(line));
+      if (n > longest) longest = n;
+      total++;
+      if (n < sizeof(line) - 1 && FsmTrace::parseLine(line, out) && memcmp(&in, &out, sizeof(in)) == 0) ok++;
+    }
+  }
+
+  FsmTrace::Record out;
+  bool rejects = !FsmTrace::parseLine("T,9,1,2,3,4,5", out) && !FsmTrace::parseLine("T,1,2,3", out) &&
+                 !FsmTrace::parseLine("T,1,2,3,4,300,5", out) &&
+                 !FsmTrace::parseLine("[FSM] T,1,2,3,4,5,6", out);
+
+  char details[96];
+  snprintf(details, sizeof(details), "%d/%d lines, longest %zu bytes, malformed %s", ok, total,
+           longest, rejects ? "rejected" : "ACCEPTED");
+  check("dump line round trip", ok == total && rejects, details);
+}
+
+/** Cost of one record call */
+static void benchmarkRecord() {
+  static FsmTrace trace;
+  const int CALLS = 10000000;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CALLS; i++) {
+    trace.record(FsmTrace::ENQUEUE, (uint8_t)i, (uint8_t)(i & 15), 0, (uint32_t)i);
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+  printf("BENCH fsm_trace_record ns_per_call=%.1f\n", ns);
+  char details[64];
+  snprintf(details, sizeof(details), "%.1f ns per record (host, unlocked)", ns);
+  check("record cost", ns < 500, details);
+}
+
+int main() {
+  testRingWrap();
+  testPause();
+  testLineRoundTrip();
+  benchmarkRecord();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/**
+ * Host runtime for the display code: simulated clock, Serial, Wire, the
+ * Adafruit_SSD1306/GFX stand-in, the I2C HAL writing into the SSD1306
+ * emulator and a LoggerManager that discards records.
+ */
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include "hal.h"
+#include "managers.h"
+#include "ssd1306_emulator.h"
+
+HostSerial Serial;
+TwoWire Wire;
+
+// ============================================================================
+// SIMULATED CLOCK
+// ============================================================================
+
+static unsigned long long hostMicros = 1000000;  // Boot takes a second
+
+unsigned long millis() { return (unsigned long)(hostMicros / 1000); }
+unsigned long micros() { return (unsigned long)hostMicros; }
+void delay(unsigned long ms) { hostMicros += (unsigned long long)ms * 1000; }
+void hostAdvanceMillis(unsigned long ms) { delay(ms); }
+
+// ============================================================================
+// LOGGER (records are encoded, then dropped)
+// ============================================================================
+
+volatile uint8_t LoggerManager::moduleLevels[LoggerManager::MODULE_COUNT] = {
+  LoggerManager::INFO, LoggerManager::INFO, LoggerManager::INFO, LoggerManager::INFO,
+  LoggerManager::INFO, LoggerManager::INFO, LoggerManager::INFO,
+};
+
+bool LoggerManager::admit(const char*, const uint8_t*, size_t) { return true; }
+uint32_t LoggerManager::timestamp() { return micros(); }
+void LoggerManager::emit(const uint8_t*, size_t) {}
+
+// ============================================================================
+// I2C HAL (mirrors src/hal/hal.cpp)
+// ============================================================================
+
+static const uint8_t SSD1306_CONTROL_COMMAND = 0x00;
+static const uint8_t SSD1306_CONTROL_DATA = 0x40;
+static uint32_t i2cBytesTransferred = 0;
+
+bool I2C::write(uint8_t address, const uint8_t* data, size_t length, Priority) {
+  Ssd1306Emulator::getInstance().transaction(address, data, length);
+  i2cBytesTransferred += length + 1;
+  return true;
+}
+
+bool I2C::ssd1306WriteWindow(uint8_t address, uint8_t pageStart, uint8_t pageEnd,
+                             uint8_t colStart, uint8_t colEnd,
+                             const uint8_t* data, size_t length) {
+  const uint8_t window[] = {
+    SSD1306_CONTROL_COMMAND, 0x21, colStart, colEnd, 0x22, pageStart, pageEnd,
+  };
+  if (!write(address, window, sizeof(window))) {
+    return false;
+  }
+
+  uint8_t chunk[1 + BULK_CHUNK];
+  chunk[0] = SSD1306_CONTROL_DATA;
+  while (length > 0) {
+    size_t n = (length < BULK_CHUNK) ? length : BULK_CHUNK;
+    memcpy(chunk + 1, data, n);
+    if (!write(address, chunk, n + 1)) {
+      return false;
+    }
+    data += n;
+    length -= n;
+  }
+  return true;
+}
+
+uint32_t I2C::getBytesTransferred() {
+  return i2cBytesTransferred;
+}
+
+// ============================================================================
+// ADAFRUIT_SSD1306 / GFX STAND-IN
+// ============================================================================
+
+// Classic GFX 5x7 font (glcdfont.c), printable ASCII 0x20..0x7E
+static const uint8_t FONT_FIRST = 0x20;
+static const uint8_t FONT_LAST = 0x7E;
+static const uint8_t FONT[][5] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 },  //   !
+  { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 },  // " #
+  { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 },  // $ %
+  { 0x36, 0x49, 0x56, 0x20, 0x50 }, { 0x00, 0x08, 0x07, 0x03, 0x00 },  // & '
+  { 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 },  // ( )
+  { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },  // * +
+  { 0x00, 0x80, 0x70, 0x30, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 },  // , -
+  { 0x00, 0x00, 0x60, 0x60, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 },  // . /
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 },  // 0 1
+  { 0x72, 0x49, 0x49, 0x49, 0x46 }, { 0x21, 0x41, 0x49, 0x4D, 0x33 },  // 2 3
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 },  // 4 5
+  { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, { 0x41, 0x21, 0x11, 0x09, 0x07 },  // 6 7
+  { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x46, 0x49, 0x49, 0x29, 0x1E },  // 8 9
+  { 0x00, 0x00, 0x14, 0x00, 0x00 }, { 0x00, 0x40, 0x34, 0x00, 0x00 },  // : ;
+  { 0x00, 0x08, 0x14, 0x22, 0x41 }, { 0x14, 0x14, 0x14, 0x14, 0x14 },  // < =
+  { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x59, 0x09, 0x06 },  // > ?
+  { 0x3E, 0x41, 0x5D, 0x59, 0x4E }, { 0x7C, 0x12, 0x11, 0x12, 0x7C },  // @ A
+  { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },  // B C
+  { 0x7F, 0x41, 0x41, 0x41, 0x3E }, { 0x7F, 0x49, 0x49, 0x49, 0x41 },  // D E
+  { 0x7F, 0x09, 0x09, 0x09, 0x01 }, { 0x3E, 0x41, 0x41, 0x51, 0x73 },  // F G
+  { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 },  // H I
+  { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 },  // J K
+  { 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x1C, 0x02, 0x7F },  // L M
+  { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },  // N O
+  { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E },  // P Q
+  { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x26, 0x49, 0x49, 0x49, 0x32 },  // R S
+  { 0x03, 0x01, 0x7F, 0x01, 0x03 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F },  // T U
+  { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F },  // V W
+  { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x03, 0x04, 0x78, 0x04, 0x03 },  // X Y
+  { 0x61, 0x59, 0x49, 0x4D, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x41 },  // Z [
+  { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x41, 0x7F },  // \ ]
+  { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 },  // ^ _
+  { 0x00, 0x03, 0x07, 0x08, 0x00 }, { 0x20, 0x54, 0x54, 0x78, 0x40 },  // ` a
+  { 0x7F, 0x28, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x28 },  // b c
+  { 0x38, 0x44, 0x44, 0x28, 0x7F }, { 0x38, 0x54, 0x54, 0x54, 0x18 },  // d e
+  { 0x00, 0x08, 0x7E, 0x09, 0x02 }, { 0x18, 0xA4, 0xA4, 0x9C, 0x78 },  // f g
+  { 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 },  // h i
+  { 0x20, 0x40, 0x40, 0x3D, 0x00 }, { 0x7F, 0x10, 0x28, 0x44, 0x00 },  // j k
+  { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x78, 0x04, 0x78 },  // l m
+  { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 },  // n o
+  { 0xFC, 0x18, 0x24, 0x24, 0x18 }, { 0x18, 0x24, 0x24, 0x18, 0xFC },  // p q
+  { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x24 },  // r s
+  { 0x04, 0x04, 0x3F, 0x44, 0x24 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C },  // t u
+  { 0x1C, 0x20, 0x40, 0x20, 0x1C }, { 0x3C, 0x40, 0x30, 0x40, 0x3C },  // v w
+  { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x4C, 0x90, 0x90, 0x90, 0x7C },  // x y
+  { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 },  // z {
+  { 0x00, 0x00, 0x77, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 },  // | }
+  { 0x02, 0x01, 0x02, 0x04, 0x02 },                                    // ~
+};
+static_assert(sizeof(FONT) / sizeof(FONT[0]) == FONT_LAST - FONT_FIRST + 1,
+              "Font must cover printable ASCII");
+
+Adafruit_SSD1306::Adafruit_SSD1306(int16_t, int16_t, TwoWire*, int8_t) {
+  memset(buffer, 0, sizeof(buffer));
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t i2cAddress) {
+  address = i2cAddress;
+  started = true;
+  clearDisplay();
+  return true;
+}
+
+void Adafruit_SSD1306::display() {
+  I2C::ssd1306WriteWindow(address, 0, HEIGHT / 8 - 1, 0, WIDTH - 1, buffer, sizeof(buffer));
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  memset(buffer, 0, sizeof(buffer));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+  uint8_t& b = buffer[(y / 8) * WIDTH + x];
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE: b |= bit; break;
+    case SSD1306_BLACK: b &= ~bit; break;
+    case SSD1306_INVERSE: b ^= bit; break;
+  }
+}
+
+void Adafruit_SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t i = x; i < x + w; i++) {
+    for (int16_t j = y; j < y + h; j++) {
+      drawPixel(i, j, color);
+    }
+  }
+}
+
+void Adafruit_SSD1306::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SSD1306::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                                uint16_t bg, uint8_t size) {
+  if (x >= WIDTH || y >= HEIGHT || x + 6 * size - 1 < 0 || y + 8 * size - 1 < 0) return;
+
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = (c >= FONT_FIRST && c <= FONT_LAST) ? FONT[c - FONT_FIRST][i] : 0;
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        fillRect(x + i * size, y + j * size, size, size, color);
+      } else if (bg != color) {
+        fillRect(x + i * size, y + j * size, size, size, bg);
+      }
+    }
+  }
+  if (bg != color) {
+    fillRect(x + 5 * size, y, size, 8 * size, bg);
+  }
+}
+
+size_t Adafruit_SSD1306::write(uint8_t c) {
+  if (c == '\n') {
+    cursorX = 0;
+    cursorY += textSize * 8;
+  } else if (c != '\r') {
+    if (wrap && cursorX + textSize * 6 > WIDTH) {
+      cursorX = 0;
+      cursorY += textSize * 8;
+    }
+    drawChar(cursorX, cursorY, c, textColor, textBackground, textSize);
+    cursorX += textSize * 6;
+  }
+  return 1;
+}
@@ -0,0 +1,294 @@
+/**
+ * Hour Attribution Tests (host)
+ *
+ * Replays a timestamped pulse recording across three hour boundaries and
+ * checks the hourly totals against the timestamps. The recording mixes
+ * normal production (one item every 50-300 ms) with line-rate bursts (one
+ * pulse every 250 us) straddling each hh:00.
+ *
+ * Pulses and the DS3231 alarm are delivered as interrupts at their exact
+ * times; the loop runs once per millisecond except during the stalls the
+ * real loop has (SD writes, status screens with delay()) - including one
+ * across every boundary. Totals are computed the way production_firmware
+ * does: count at the boundary minus count at the previous boundary, with
+ * the boundary reported by HourBoundary.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/managers hour_attribution_tests.cpp \
+ *       ../../src/managers/hour_boundary.cpp -o hour_attribution_tests
+ *   ./hour_attribution_tests
+ */
+
+#include "hour_boundary.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static const int64_t HOUR_US = 3600000000LL;
+static const int64_t START_US = 8 * HOUR_US + 59 * 60000000LL;  // 08:59:00
+static const int64_t END_US = 12 * HOUR_US + 30000000LL;        // 12:00:30
+static const int64_t LOOP_US = 1000;
+static const int FIRST_HOUR = 8;
+static const int HOURS = 5;                                     // 08..12
+
+// ============================================================================
+// RECORDING & SIMULATION
+// ============================================================================
+
+struct Scenario {
+  HourBoundary::Mode mode;
+  bool alarmWired;
+  bool clockValid;        // Software clock synced: pulse deadlines armed
+  int64_t clockErrorUs;   // Software clock vs RTC (+ = ahead)
+};
+
+struct Outcome {
+  long truth[HOURS];      // Items per hour by pulse timestamp
+  long attributed[HOURS]; // Items per hour as recorded by the firmware logic
+  long misattributed;     // Items on the wrong side of a boundary
+  long ticks;
+  long totalCount;
+};
+
+static std::vector<int64_t> recording;
+
+static unsigned long rng = 12345;
+static unsigned long nextRandom() {
+  rng = rng * 1103515245UL + 12345UL;
+  return (rng >> 8) & 0xFFFFFF;
+}
+
+static void record() {
+  int64_t t = START_US + 100000;
+  for (;;) {
+    int64_t burstStart = t - t % HOUR_US + HOUR_US - 5000;
+    if (t % HOUR_US < 5000 || t >= burstStart) {
+      t += 250;                                   // Line-rate burst across hh:00
+    } else {
+      t += 50000 + (nextRandom() % 250) * 1000;   // Normal production
+      if (t >= burstStart) t = burstStart + 37;
+    }
+    if (t >= END_US) break;
+    recording.push_back(t);
+  }
+}
+
+static int hourAt(int64_t us) { return (int)((us / HOUR_US) % 24); }
+
+// Loop stalled at `us`?
+static bool stalled(int64_t us) {
+  int64_t intoHour = us % HOUR_US;
+  if (intoHour >= HOUR_US - 300000 || intoHour < 1200000) return true;  // Across hh:00
+  if (us % 5000000 < 40000) return true;       // SD consolidation
+  if (us % 61000000 < 700000) return true;     // Status message hold
+  return false;
+}
+
+// Firmware's armHourDeadline(): next hh:00 after the tracked hour, as MCU
+// timer time (the MCU timer is true time here; the clock is off by error)
+static void armNextDeadline(HourBoundary& boundary, int64_t nowUs, int64_t clockErrorUs) {
+  int64_t clockUs = nowUs + clockErrorUs;
+  int64_t hourStart = clockUs - clockUs % HOUR_US;
+  int64_t next = (hourAt(hourStart) == boundary.getTrackedHour()) ? hourStart + HOUR_US : hourStart;
+  boundary.armDeadline(next - clockErrorUs, hourAt(next));
+}
+
+static Outcome replay(const Scenario& scenario) {
+  Outcome out = {};
+  HourBoundary& boundary = HourBoundary::getInstance();
+  boundary.begin(hourAt(START_US + scenario.clockErrorUs), scenario.mode);
+  boundary.resetStats();
+
+  int count = 0;
+  int countAtHourStart = 0;
+  int lastTickHour = hourAt(START_US);
+  size_t nextPulse = 0;
+  int64_t nextAlarm = START_US - START_US % HOUR_US + HOUR_US;
+
+  for (int64_t loopUs = START_US; loopUs < END_US; loopUs += LOOP_US) {
+    // Interrupts up to this loop pass, in time order
+    for (;;) {
+      bool pulseDue = nextPulse < recording.size() && recording[nextPulse] < loopUs;
+      bool alarmDue = scenario.alarmWired && nextAlarm < loopUs;
+      if (!pulseDue && !alarmDue) break;
+
+      if (alarmDue && (!pulseDue || nextAlarm <= recording[nextPulse])) {
+        boundary.onAlarm(nextAlarm, count);
+        nextAlarm += HOUR_US;
+      } else {
+        int64_t t = recording[nextPulse++];
+        boundary.onPulse(t, count);
+        count++;
+        out.truth[hourAt(t) - FIRST_HOUR]++;
+      }
+    }
+
+    if (stalled(loopUs)) continue;
+
+    HourBoundary::Tick tick;
+    if (boundary.poll(hourAt(loopUs + scenario.clockErrorUs), loopUs, count, tick)) {
+      out.attributed[lastTickHour - FIRST_HOUR] += tick.count - countAtHourStart;
+      countAtHourStart = tick.count;
+      lastTickHour = tick.hour;
+      out.ticks++;
+    }
+    if (scenario.clockValid && !boundary.isDeadlineArmed()) {
+      armNextDeadline(boundary, loopUs, scenario.clockErrorUs);
+    }
+  }
+  out.attributed[lastTickHour - FIRST_HOUR] += count - countAtHourStart;
+  out.totalCount = count;
+
+  // Items on the wrong side of each boundary
+  long shift = 0;
+  for (int h = 0; h < HOURS; h++) {
+    shift += out.attributed[h] - out.truth[h];
+    out.misattributed += labs(shift);
+  }
+  return out;
+}
+
+// Pulses recorded within `windowUs` before a boundary
+static long pulsesJustBeforeBoundaries(int64_t windowUs) {
+  long n = 0;
+  for (int64_t t : recording) {
+    if (HOUR_US - t % HOUR_US <= windowUs) n++;
+  }
+  return n;
+}
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-38s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+static bool totalsConserved(const Outcome& out) {
+  long sum = 0;
+  for (int h = 0; h < HOURS; h++) sum += out.attributed[h];
+  return sum == out.totalCount;
+}
+
+static void describe(char* details, size_t size, const Outcome& out) {
+  HourBoundary& b = HourBoundary::getInstance();
+  snprintf(details, size, "%ld misattributed of %ld; ticks: %u pulse, %u deadline, %u alarm, %u clock",
+           out.misattributed, out.totalCount, b.getPulseTicks(), b.getDeadlineTicks(),
+           b.getAlarmTicks(), b.getPolledTicks());
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Pulse timestamps vs. the armed deadline split the hours exactly */
+static void testPulseDeadline() {
+  Scenario scenario = { HourBoundary::MODE_POLLED, false, true, 0 };
+  Outcome out = replay(scenario);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("deadline: exact to the pulse", out.misattributed == 0 && out.ticks == 4 &&
+        HourBoundary::getInstance().getPulseTicks() == 4, details);
+}
+
+/** Deadline and alarm together: still one tick per boundary */
+static void testDeadlineWithAlarm() {
+  Scenario scenario = { HourBoundary::MODE_ALARM, true, true, 0 };
+  Outcome out = replay(scenario);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("deadline + alarm: exact, no double tick", out.misattributed == 0 && out.ticks == 4 &&
+        HourBoundary::getInstance().getMissedAlarms() == 0, details);
+}
+
+/** Clock behind the RTC: the alarm closes the hour first */
+static void testClockBehind() {
+  Scenario scenario = { HourBoundary::MODE_ALARM, true, true, -3000 };
+  Outcome out = replay(scenario);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("clock 3 ms behind: alarm wins", out.misattributed == 0 && out.ticks == 4 &&
+        HourBoundary::getInstance().getAlarmTicks() == 4, details);
+}
+
+/** Clock ahead of the RTC: error bounded by the pulses inside the offset */
+static void testClockAhead() {
+  Scenario scenario = { HourBoundary::MODE_ALARM, true, true, 600 };
+  Outcome out = replay(scenario);
+  long bound = pulsesJustBeforeBoundaries(600);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("clock 600 us ahead: within the offset", out.ticks == 4 && totalsConserved(out) &&
+        out.misattributed == bound && bound > 0, details);
+}
+
+/** No synced clock: the alarm alone snapshots the boundary */
+static void testAlarmOnly() {
+  Scenario scenario = { HourBoundary::MODE_ALARM, true, false, 0 };
+  Outcome out = replay(scenario);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("alarm only: exact", out.misattributed == 0 && out.ticks == 4, details);
+}
+
+/** Polling the clock hour loses items across a stalled boundary */
+static void testPolledBaseline() {
+  Scenario scenario = { HourBoundary::MODE_POLLED, false, false, 0 };
+  Outcome out = replay(scenario);
+  char details[128];
+  describe(details, sizeof(details), out);
+  check("polled: late snapshots (baseline)", out.misattributed > 0 && out.ticks == 4 &&
+        totalsConserved(out), details);
+}
+
+/** INT line not wired: deadlines still split exactly, alarm mode gives up */
+static void testUnwiredFallback() {
+  Scenario scenario = { HourBoundary::MODE_ALARM, false, true, 0 };
+  Outcome out = replay(scenario);
+  HourBoundary& boundary = HourBoundary::getInstance();
+  char details[128];
+  snprintf(details, sizeof(details), "%ld misattributed, %u missed alarms, mode %s",
+           out.misattributed, boundary.getMissedAlarms(),
+           boundary.getMode() == HourBoundary::MODE_POLLED ? "POLLED" : "ALARM");
+  check("unwired INT: fallback", out.misattributed == 0 && out.ticks == 4 &&
+        boundary.getMode() == HourBoundary::MODE_POLLED && boundary.getMissedAlarms() == 2,
+        details);
+}
+
+/** Cost of the per-pulse check in the ISR */
+static void benchmarkOnPulse() {
+  HourBoundary& boundary = HourBoundary::getInstance();
+  boundary.begin(8, HourBoundary::MODE_POLLED);
+  boundary.armDeadline(INT64_MAX, 9);
+
+  const int PULSES = 10000000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < PULSES; i++) {
+    boundary.onPulse(i, i);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  printf("onPulse(): %.2f ns/pulse (host)\n",
+         std::chrono::duration<double, std::nano>(elapsed).count() / PULSES);
+}
+
+int main() {
+  record();
+  printf("Recording: %zu pulses, %ld within 600 us before a boundary\n\n", recording.size(),
+         pulsesJustBeforeBoundaries(600));
+
+  testPulseDeadline();
+  testDeadlineWithAlarm();
+  testClockBehind();
+  testClockAhead();
+  testAlarmOnly();
+  testPolledBaseline();
+  testUnwiredFallback();
+
+  printf("\n");
+  benchmarkOnPulse();
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
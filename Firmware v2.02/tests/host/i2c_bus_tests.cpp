@@ -0,0 +1,272 @@
+/**
+ * I2C Bus Scheduler Tests (host)
+ *
+ * Checks I2CArbiter's handover rules (priority, FIFO within a priority,
+ * cancel after timeout, full waiter table) and replays the shared bus
+ * with the firmware's two users:
+ *   - OLED: full-frame pushes at 5 Hz (8 page windows, worst case)
+ *   - RTC: edge-capture reads, one per ms for ~25 ms around each second
+ *
+ * "legacy" is the old bus: 100 kHz, and the display task keeps Wire for
+ * the whole frame (it re-takes the lock before the waiting task wakes).
+ * "scheduler" is the HAL: 400 kHz, BULK_CHUNK pieces, urgent RTC reads.
+ * Reports per-device utilization and the RTC's wait for the bus - the
+ * capture timestamps are off by that wait.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/hal i2c_bus_tests.cpp ../../src/hal/i2c_arbiter.cpp \
+ *       -o i2c_bus_tests
+ *   ./i2c_bus_tests
+ */
+
+#include "i2c_arbiter.h"
+#include <cstdio>
+#include <vector>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+enum { BULK, NORMAL, URGENT };  // I2C::Priority
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-36s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// ARBITER RULES
+// ============================================================================
+
+/** Release hands over to the highest priority, oldest first */
+static void testHandoverOrder() {
+  I2CArbiter arbiter;
+  uint8_t owner, bulk, normal, urgent1, urgent2;
+  arbiter.request(BULK, owner);
+  arbiter.request(BULK, bulk);
+  arbiter.request(NORMAL, normal);
+  arbiter.request(URGENT, urgent1);
+  arbiter.request(URGENT, urgent2);
+
+  uint8_t order[4];
+  for (int i = 0; i < 4; i++) {
+    order[i] = arbiter.release();
+    arbiter.claim(order[i]);
+  }
+  bool idle = (arbiter.release() == I2CArbiter::NO_SLOT) && !arbiter.isBusy();
+
+  char details[64];
+  snprintf(details, sizeof(details), "slots %u %u %u %u", order[0], order[1], order[2], order[3]);
+  check("handover: priority, then FIFO", order[0] == urgent1 && order[1] == urgent2 &&
+        order[2] == normal && order[3] == bulk && idle, details);
+}
+
+/** A waiter that times out just as it is granted still owns the bus */
+static void testCancel() {
+  I2CArbiter arbiter;
+  uint8_t unused, a, b;
+  arbiter.request(NORMAL, unused);
+  arbiter.request(NORMAL, a);
+  arbiter.request(NORMAL, b);
+
+  bool cancelledQueued = arbiter.cancel(b);     // Timed out while queued
+  uint8_t next = arbiter.release();             // Goes to a
+  bool cancelledGranted = arbiter.cancel(a);    // a timed out at the same moment
+  bool staleClaim = arbiter.claim(a);           // Its late wakeup is stale
+  bool stillBusy = arbiter.isBusy();            // a owns the bus and must release
+  bool idleAfter = (arbiter.release() == I2CArbiter::NO_SLOT) && !arbiter.isBusy();
+
+  check("cancel: queued vs. granted", cancelledQueued && next == a && !cancelledGranted &&
+        !staleClaim && stillBusy && idleAfter && arbiter.getWaiting() == 0, "");
+}
+
+/** More waiters than slots are rejected, not lost */
+static void testWaiterLimit() {
+  I2CArbiter arbiter;
+  uint8_t slot;
+  arbiter.request(BULK, slot);
+  int queued = 0;
+  for (int i = 0; i < I2CArbiter::MAX_WAITERS + 2; i++) {
+    if (arbiter.request(NORMAL, slot) == I2CArbiter::QUEUED) queued++;
+  }
+  bool contended = arbiter.isContended(BULK) && !arbiter.isContended(NORMAL);
+
+  char details[64];
+  snprintf(details, sizeof(details), "%d queued, %u rejected", queued, arbiter.getRejected());
+  check("waiter table full", queued == I2CArbiter::MAX_WAITERS &&
+        arbiter.getRejected() == 2 && contended, details);
+}
+
+// ============================================================================
+// SHARED BUS REPLAY
+// ============================================================================
+
+static const int64_t DURATION_US = 10000000;
+static const int64_t FRAME_PERIOD_US = 200000;    // 5 Hz
+static const int64_t FRAME_PHASE_US = 170000;     // Frames overlap the captures
+static const int64_t CAPTURE_LEAD_US = 20000;
+static const int64_t CAPTURE_END_US = 5000;       // Edge seen a little after the second
+static const int64_t TXN_OVERHEAD_US = 20;        // Driver setup per transaction
+static const int RTC_READ_BYTES = 10;             // addr+reg, addr+7 (repeated start)
+static const int WINDOW_BYTES = 8;                // addr + control + 6 command bytes
+
+struct BusConfig {
+  const char* name;
+  uint32_t clockHz;
+  int chunk;                // Display data bytes per transaction
+  bool framePerHold;        // Display keeps the bus for a whole frame
+  bool urgentRtc;           // RTC reads at URGENT, display at BULK
+};
+
+struct Client {
+  const char* name;
+  uint8_t priority;
+  std::vector<int> holds;   // Bytes per bus hold, in order
+  size_t next = 0;
+  bool waiting = false;
+  int64_t requestUs = 0;
+  int64_t busyUs = 0;
+  int64_t maxWaitUs = 0;
+  int64_t totalWaitUs = 0;
+  long grants = 0;
+};
+
+struct BusResult {
+  double utilization[2];
+  int64_t rtcMaxWaitUs;
+  double rtcMeanWaitUs;
+  int64_t frameUs;
+};
+
+static int64_t holdMicros(int bytes, uint32_t clockHz) {
+  return TXN_OVERHEAD_US + ((int64_t)bytes * 9 + 2) * 1000000 / clockHz;
+}
+
+static BusResult replay(const BusConfig& config) {
+  enum { OLED, RTC };
+  Client clients[2];
+  clients[OLED].name = "OLED";
+  clients[OLED].priority = config.urgentRtc ? BULK : NORMAL;
+  clients[RTC].name = "RTC";
+  clients[RTC].priority = config.urgentRtc ? URGENT : NORMAL;
+
+  // One frame: 8 single-page windows of 128 columns
+  std::vector<int> frame;
+  int frameBytes = 0;
+  for (int page = 0; page < 8; page++) {
+    for (int sent = 0; sent < 128; sent += config.chunk) {
+      int n = (128 - sent < config.chunk) ? 128 - sent : config.chunk;
+      int bytes = n + 2 + (sent == 0 ? WINDOW_BYTES : 0);  // Window goes with the first chunk
+      frame.push_back(bytes);
+      frameBytes += bytes;
+    }
+  }
+  if (config.framePerHold) {
+    frame.assign(1, frameBytes);
+  }
+
+  I2CArbiter arbiter;
+  int slotClient[I2CArbiter::MAX_WAITERS];
+  int owner = -1;
+  int64_t ownerUntil = 0;
+  int64_t frameStartUs = 0;
+  int64_t frameUs = 0;
+
+  auto start = [&](int c, int64_t now) {
+    Client& client = clients[c];
+    int64_t waited = now - client.requestUs;
+    if (waited > client.maxWaitUs) client.maxWaitUs = waited;
+    client.totalWaitUs += waited;
+    client.grants++;
+    client.waiting = false;
+
+    int64_t hold = holdMicros(client.holds[client.next++], config.clockHz);
+    client.busyUs += hold;
+    owner = c;
+    ownerUntil = now + hold;
+  };
+
+  for (int64_t now = 0; now < DURATION_US; now++) {
+    if (owner >= 0 && now >= ownerUntil) {
+      if (owner == OLED && clients[OLED].next == clients[OLED].holds.size()) {
+        int64_t took = now - frameStartUs;
+        if (took > frameUs) frameUs = took;
+      }
+      owner = -1;
+      uint8_t slot = arbiter.release();
+      if (slot != I2CArbiter::NO_SLOT) {
+        arbiter.claim(slot);
+        start(slotClient[slot], now);
+      }
+    }
+
+    // New work
+    if (now % FRAME_PERIOD_US == FRAME_PHASE_US) {
+      clients[OLED].holds.insert(clients[OLED].holds.end(), frame.begin(), frame.end());
+      frameStartUs = now;
+    }
+    int64_t intoSecond = (now + CAPTURE_LEAD_US) % 1000000;
+    if (intoSecond < CAPTURE_LEAD_US + CAPTURE_END_US && now % 1000 == 0) {
+      clients[RTC].holds.push_back(RTC_READ_BYTES);
+    }
+
+    for (int c = 0; c < 2; c++) {
+      Client& client = clients[c];
+      if (client.waiting || owner == c || client.next == client.holds.size()) continue;
+      client.waiting = true;
+      client.requestUs = now;
+      uint8_t slot;
+      if (arbiter.request(client.priority, slot) == I2CArbiter::GRANTED) {
+        start(c, now);
+      } else {
+        slotClient[slot] = c;
+      }
+    }
+  }
+
+  BusResult result;
+  for (int c = 0; c < 2; c++) {
+    result.utilization[c] = clients[c].busyUs * 100.0 / DURATION_US;
+  }
+  result.rtcMaxWaitUs = clients[RTC].maxWaitUs;
+  result.rtcMeanWaitUs = clients[RTC].grants ? (double)clients[RTC].totalWaitUs / clients[RTC].grants : 0;
+  result.frameUs = frameUs;
+
+  printf("BENCH bus=%s clock_hz=%u oled_util_pct=%.2f rtc_util_pct=%.3f "
+         "rtc_wait_max_us=%lld rtc_wait_mean_us=%.1f frame_us=%lld\n",
+         config.name, config.clockHz, result.utilization[OLED], result.utilization[RTC],
+         (long long)result.rtcMaxWaitUs, result.rtcMeanWaitUs, (long long)result.frameUs);
+  return result;
+}
+
+/** Urgent RTC reads wait at most one display chunk, not a frame */
+static void testSharedBus() {
+  BusConfig legacy = { "legacy", 100000, 64, true, false };
+  BusConfig scheduler = { "scheduler", 400000, 32, false, true };
+  BusResult before = replay(legacy);
+  BusResult after = replay(scheduler);
+
+  int64_t chunkHold = holdMicros(32 + 2 + WINDOW_BYTES, 400000);
+  char details[128];
+  snprintf(details, sizeof(details), "RTC wait max %lld -> %lld us (chunk %lld us), frame %lld -> %lld us",
+           (long long)before.rtcMaxWaitUs, (long long)after.rtcMaxWaitUs, (long long)chunkHold,
+           (long long)before.frameUs, (long long)after.frameUs);
+  check("shared bus: RTC ahead of display", after.rtcMaxWaitUs <= chunkHold &&
+        before.rtcMaxWaitUs > 10 * chunkHold, details);
+
+  // Smaller chunks cost a little framing; the faster clock more than pays
+  snprintf(details, sizeof(details), "OLED %.2f%% -> %.2f%% of the bus",
+           before.utilization[0], after.utilization[0]);
+  check("shared bus: display bus time", after.frameUs * 3 < before.frameUs &&
+        after.utilization[0] * 3 < before.utilization[0], details);
+}
+
+int main() {
+  testHandoverOrder();
+  testCancel();
+  testWaiterLimit();
+  testSharedBus();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
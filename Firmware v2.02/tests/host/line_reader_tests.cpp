@@ -0,0 +1,152 @@
+/**
+ * Line Reader Tests (host)
+ *
+ * Checks LineReader: the same lines come out however the input is split
+ * across loop passes, CR/LF/CRLF endings, blank lines and backspace, and
+ * that an over-long line is dropped whole and reported once. Then replays
+ * someone typing a command at a terminal and compares the longest loop
+ * stall with readStringUntil (1 s Stream timeout) against polling the
+ * reader with BYTES_PER_POLL per pass, and times feed() per byte.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/hal \
+ *       line_reader_tests.cpp ../../src/hal/line_reader.cpp -o line_reader_tests
+ *   ./line_reader_tests
+ */
+
+#include "line_reader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// Lines and TOO_LONG markers ("!") produced by input fed chunk bytes at a time
+static std::vector<std::string> feedAll(const std::string& input, size_t chunk) {
+  LineReader reader;
+  std::vector<std::string> out;
+  for (size_t at = 0; at < input.size(); at += chunk) {
+    for (size_t i = at; i < at + chunk && i < input.size(); i++) {
+      LineReader::Status status = reader.feed(input[i]);
+      if (status == LineReader::LINE) out.push_back(reader.line());
+      if (status == LineReader::TOO_LONG) out.push_back("!");
+    }
+  }
+  return out;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Any split of the input gives the same lines */
+static void testSplitsAndEndings() {
+  const std::string input = "STATUS\nSET,1,2000\r\nLEVEL,FSM,DEBUG\r\r\n\nTRACX\bE\nLS";
+  const std::vector<std::string> want = { "STATUS", "SET,1,2000", "LEVEL,FSM,DEBUG", "TRACE" };
+
+  int same = 0;
+  const int SPLITS = (int)input.size();
+  for (int chunk = 1; chunk <= SPLITS; chunk++) {
+    if (feedAll(input, chunk) == want) same++;
+  }
+
+  char details[64];
+  snprintf(details, sizeof(details), "%d/%d chunk sizes, unterminated tail held", same, SPLITS);
+  check("splits, CR/LF/CRLF, backspace", same == SPLITS, details);
+}
+
+/** An over-long line is dropped whole, once; the limit itself fits */
+static void testTooLong() {
+  std::string longest(LineReader::MAX_LINE - 1, 'A');
+  std::string input = std::string(300, 'X') + "\r\nCOUNT\n" + longest + "\n" + longest + "B\nSTOP\n";
+  std::vector<std::string> got = feedAll(input, 7);
+  std::vector<std::string> want = { "!", "COUNT", longest, "!", "STOP" };
+
+  LineReader reader;
+  for (char c : input) reader.feed(c);
+
+  char details[64];
+  snprintf(details, sizeof(details), "%zu results, %u lines, %u too long", got.size(), reader.getLines(),
+           reader.getTooLong());
+  check("over-long line dropped", got == want && reader.getLines() == 3 && reader.getTooLong() == 2,
+        details);
+}
+
+/** Typing "STATUS" at ~150 ms per key: longest loop stall */
+static void testTypingStall() {
+  const char* typed = "STATUS\n";
+  const size_t keys = strlen(typed);
+  const unsigned long KEY_MS = 150;
+  const unsigned long STREAM_TIMEOUT_MS = 1000;
+  const unsigned long PASS_MS = 1;
+
+  // readStringUntil: the first key starts a read that waits for each
+  // following key (up to the timeout per byte) until the newline
+  unsigned long blockingStall = 0;
+  for (size_t k = 1; k < keys; k++) {
+    blockingStall += (KEY_MS < STREAM_TIMEOUT_MS) ? KEY_MS : STREAM_TIMEOUT_MS;
+  }
+
+  // LineReader: every pass takes what has arrived and returns
+  LineReader reader;
+  size_t next = 0;
+  size_t worstBytes = 0;
+  bool gotLine = false;
+  for (unsigned long now = 0; now <= keys * KEY_MS; now += PASS_MS) {
+    size_t taken = 0;
+    while (taken < LineReader::BYTES_PER_POLL && next < keys && next * KEY_MS <= now) {
+      if (reader.feed(typed[next++]) == LineReader::LINE) gotLine = strcmp(reader.line(), "STATUS") == 0;
+      taken++;
+    }
+    if (taken > worstBytes) worstBytes = taken;
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "readStringUntil blocks %lu ms; reader: %zu byte(s) per pass",
+           blockingStall, worstBytes);
+  check("typing never stalls the loop", gotLine && worstBytes <= LineReader::BYTES_PER_POLL &&
+        blockingStall > 500, details);
+}
+
+/** Cost of one feed() and of a full BYTES_PER_POLL pass */
+static void benchmarkFeed() {
+  static LineReader reader;
+  const char* stream = "SET,1,2000,2,80,3,9999,4,3000,5,100\r\nSTATUS\r\nLEVEL,STORAGE,DEBUG\r\n";
+  const size_t length = strlen(stream);
+  const int ROUNDS = 2000000;
+  unsigned long lines = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (size_t i = 0; i < length; i++) {
+      lines += reader.feed(stream[i]) == LineReader::LINE;
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+              ((double)ROUNDS * length);
+
+  printf("BENCH line_reader ns_per_byte=%.2f ns_per_poll=%.1f\n", ns, ns * LineReader::BYTES_PER_POLL);
+  char details[96];
+  snprintf(details, sizeof(details), "%.2f ns per byte, %.1f ns per %zu-byte pass (%lu lines)", ns,
+           ns * LineReader::BYTES_PER_POLL, LineReader::BYTES_PER_POLL, lines);
+  check("feed cost", ns < 100, details);
+}
+
+int main() {
+  testSplitsAndEndings();
+  testTooLong();
+  testTypingStall();
+  benchmarkFeed();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
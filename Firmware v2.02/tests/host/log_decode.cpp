@@ -0,0 +1,164 @@
+/**
+ * Binary Log Decoder (host)
+ *
+ * Turns a serial capture taken with LOG,BINARY back into text. Records
+ * carry the flash address of their format string, so the decoder needs
+ * the ELF of the exact firmware that produced the capture: its read-only
+ * sections are the format table. Anything between frames (plain
+ * Serial.print output) is passed through unchanged.
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -DLOG_RING_LOCKED=0 -I../../src/managers -I../../src/core \
+ *       log_decode.cpp ../../src/managers/log_ring.cpp ../../src/core/checksum.cpp \
+ *       -o log_decode
+ *
+ * Usage:
+ *   ./log_decode firmware.elf capture.bin      (or capture on stdin)
+ *   e.g. stty -F /dev/ttyUSB0 115200 raw && ./log_decode firmware.elf < /dev/ttyUSB0
+ */
+
+#include "log_ring.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// ============================================================================
+// ELF FORMAT TABLE
+// ============================================================================
+
+struct Section {
+  uint32_t address;
+  std::vector<uint8_t> data;
+};
+
+static std::vector<Section> sections;
+
+static uint32_t read32(const std::vector<uint8_t>& b, size_t at) {
+  return b[at] | (b[at + 1] << 8) | (b[at + 2] << 16) | ((uint32_t)b[at + 3] << 24);
+}
+
+static uint16_t read16(const std::vector<uint8_t>& b, size_t at) {
+  return b[at] | (b[at + 1] << 8);
+}
+
+// Allocated, initialized sections of a 32-bit little-endian ELF
+static bool loadElf(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> elf;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    elf.insert(elf.end(), chunk, chunk + n);
+  }
+  fclose(file);
+
+  if (elf.size() < 52 || memcmp(elf.data(), "\x7f" "ELF", 4) != 0 || elf[4] != 1 || elf[5] != 1) {
+    fprintf(stderr, "%s: not a 32-bit little-endian ELF\n", path);
+    return false;
+  }
+
+  uint32_t shoff = read32(elf, 0x20);
+  uint16_t shentsize = read16(elf, 0x2E);
+  uint16_t shnum = read16(elf, 0x30);
+  for (uint16_t i = 0; i < shnum; i++) {
+    size_t sh = shoff + (size_t)i * shentsize;
+    if (sh + 40 > elf.size()) break;
+    uint32_t type = read32(elf, sh + 4);
+    uint32_t flags = read32(elf, sh + 8);
+    uint32_t address = read32(elf, sh + 12);
+    uint32_t offset = read32(elf, sh + 16);
+    uint32_t size = read32(elf, sh + 20);
+
+    const uint32_t SHF_ALLOC = 0x2;
+    const uint32_t SHT_NOBITS = 8;
+    if (!(flags & SHF_ALLOC) || type == SHT_NOBITS || size == 0 ||
+        (size_t)offset + size > elf.size()) {
+      continue;
+    }
+    Section section;
+    section.address = address;
+    section.data.assign(elf.begin() + offset, elf.begin() + offset + size);
+    sections.push_back(section);
+  }
+  return !sections.empty();
+}
+
+static const char* formatAt(uint32_t address) {
+  for (const Section& section : sections) {
+    if (address < section.address || address - section.address >= section.data.size()) continue;
+    const char* text = (const char*)section.data.data() + (address - section.address);
+    size_t room = section.data.size() - (address - section.address);
+    return (memchr(text, '\0', room) != nullptr) ? text : nullptr;
+  }
+  return nullptr;
+}
+
+// ============================================================================
+// DECODER
+// ============================================================================
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s firmware.elf [capture.bin]\n", argv[0]);
+    return 2;
+  }
+  if (!loadElf(argv[1])) {
+    return 1;
+  }
+  FILE* input = (argc > 2) ? fopen(argv[2], "rb") : stdin;
+  if (input == nullptr) {
+    fprintf(stderr, "Cannot open %s\n", argv[2]);
+    return 1;
+  }
+
+  LogRing::FrameReader reader;
+  uint64_t wraps = 0;
+  uint32_t lastTimestamp = 0;
+  unsigned long records = 0;
+  unsigned long unknown = 0;
+  int c;
+
+  while ((c = fgetc(input)) != EOF) {
+    uint8_t byte = (uint8_t)c;
+    if (reader.isIdle() && byte != LogRing::FRAME_MAGIC0) {
+      putchar(byte);  // Plain text between frames
+      continue;
+    }
+
+    const uint8_t* data;
+    size_t size;
+    if (!reader.feed(byte, data, size)) {
+      continue;
+    }
+
+    LogRing::Record record;
+    if (!LogRing::parse(data, size, record)) continue;
+    if (record.timestampUs < lastTimestamp) wraps++;
+    lastTimestamp = record.timestampUs;
+    double seconds = ((wraps << 32) + record.timestampUs) / 1e6;
+
+    const char* format = formatAt(record.formatId);
+    char text[256];
+    if (format != nullptr) {
+      LogRing::render(record, format, text, sizeof(text));
+    } else {
+      snprintf(text, sizeof(text), "<unknown format 0x%08x - wrong ELF?>", record.formatId);
+      unknown++;
+    }
+    const char* module = LogRing::moduleName(record.module);
+    if (module != nullptr) {
+      printf("[%12.6f] [%s] [%s] %s\n", seconds, LogRing::levelName(record.level), module, text);
+    } else {
+      printf("[%12.6f] [%s] %s\n", seconds, LogRing::levelName(record.level), text);
+    }
+    records++;
+  }
+
+  fprintf(stderr, "%lu records, %lu unknown formats, %u CRC errors\n", records, unknown,
+          reader.getCrcErrors());
+  return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * Deferred Log Tests (host)
+ *
+ * Checks the LogRing record path end to end: arguments captured by type,
+ * rendered text identical to printf, level and module packed together,
+ * binary frames surviving noise and corruption, ring wrap-around and
+ * overflow accounting. Also times a log
+ * call (encode + push) against formatting the same line immediately.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DLOG_RING_LOCKED=0 -I../../src/managers -I../../src/core \
+ *       log_ring_tests.cpp ../../src/managers/log_ring.cpp ../../src/core/checksum.cpp \
+ *       -o log_ring_tests
+ *   ./log_ring_tests
+ */
+
+#include "log_ring.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// Encode, parse and render one call
+template<typename... Args>
+static std::string roundTrip(const char* format, Args... args) {
+  uint8_t record[LogRing::MAX_RECORD];
+  size_t size = LogRing::encode(record, 1, format, 0, args...);
+  LogRing::Record parsed;
+  if (!LogRing::parse(record, size, parsed)) return "<parse failed>";
+  char text[160];
+  LogRing::render(parsed, format, text, sizeof(text));
+  return text;
+}
+
+enum TestState { STATE_A, STATE_B, STATE_C };
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Rendered text matches printf for the formats the firmware uses */
+static void testRenderMatchesPrintf() {
+  struct Case {
+    std::string got;
+    std::string want;
+  };
+  char want[160];
+  std::vector<Case> cases;
+
+#define CASE(...)                                   \
+  snprintf(want, sizeof(want), __VA_ARGS__);        \
+  cases.push_back({ roundTrip(__VA_ARGS__), want });
+
+  unsigned long hz = 400000;
+  CASE("SD card initialized at %lu Hz", hz);
+  CASE("Retry attempt %d of %d", 2, 3);
+  CASE("Low heap: %d bytes (threshold: %d)", -12, 20000);
+  CASE("=== INITIALIZATION COMPLETE (%.1fs) ===", 2345 / 1000.0);
+  CASE("Chip temp: %.1f°C", 47.25f);
+  CASE("I2C test: OLED=%s, RTC=%s", "PASS", "FAIL");
+  CASE("Flash erases/page/day: %lu.%03lu", 12UL, 7UL);
+  CASE("[%-6s|%6s] %08X %x %o %c %%", "ab", "cd", 0xBEEFu, 255u, 8u, 'Z');
+  CASE("64-bit: %lld %llu", -1234567890123LL, 18446744073709551615ULL);
+  CASE("Width from arg: [%*d]", 6, 42);
+  CASE("Event %d in state %d", 3, (int)STATE_C);
+#undef CASE
+
+  int mismatches = 0;
+  std::string first;
+  for (const Case& c : cases) {
+    if (c.got != c.want) {
+      if (mismatches++ == 0) first = "got \"" + c.got + "\" want \"" + c.want + "\"";
+    }
+  }
+  // Enums are recorded as int
+  bool enumOk = roundTrip("state %d", STATE_B) == "state 1";
+
+  char details[200];
+  snprintf(details, sizeof(details), "%zu formats, %d mismatched %s", cases.size(), mismatches,
+           first.c_str());
+  check("render == printf", mismatches == 0 && enumOk, details);
+}
+
+/** Over-long strings and argument lists are cut, and marked */
+static void testTruncation() {
+  std::string longText(100, 'x');
+  std::string s = roundTrip("%s", longText.c_str());
+  std::string many = roundTrip("%d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+
+  char details[160];
+  snprintf(details, sizeof(details), "string %zu chars, \"%s\"", s.size(), many.c_str());
+  check("truncation is marked", s == std::string(LogRing::MAX_STRING, 'x') + " [...]" &&
+        many == "1 2 3 4 5 6 7 8 <?> <?> [...]", details);
+}
+
+/** Level and module share the level byte and come back apart */
+static void testModuleByte() {
+  uint8_t record[LogRing::MAX_RECORD];
+  int ok = 0;
+  for (uint8_t module = 0; module < 7; module++) {
+    for (uint8_t level = 0; level <= 4; level++) {
+      size_t size = LogRing::encode(record, (uint8_t)(level | (module << LogRing::MODULE_SHIFT)),
+                                    "x", 0);
+      LogRing::Record parsed;
+      if (LogRing::parse(record, size, parsed) && parsed.level == level && parsed.module == module) ok++;
+    }
+  }
+  bool names = LogRing::moduleName(0) == nullptr && strcmp(LogRing::moduleName(2), "Storage") == 0;
+
+  char details[64];
+  snprintf(details, sizeof(details), "%d/35 level+module pairs", ok);
+  check("module in level byte", ok == 35 && names, details);
+}
+
+/** Frames survive text between them and a corrupted frame */
+static void testFrames() {
+  std::vector<uint8_t> stream;
+  const char* text = "[StorageManager] Saved\r\n";
+  uint8_t record[LogRing::MAX_RECORD];
+  uint8_t frame[LogRing::MAX_FRAME];
+  const char* format = "Count %d at %s";
+
+  for (int i = 0; i < 20; i++) {
+    size_t size = LogRing::encode(record, 1, format, 1000 * i, i, "line 3");
+    size_t n = LogRing::frame(record, size, frame);
+    if (i == 7) frame[n / 2] ^= 0x10;                       // Bit error
+    stream.insert(stream.end(), text, text + strlen(text)); // Plain prints between
+    stream.insert(stream.end(), frame, frame + n);
+  }
+
+  LogRing::FrameReader reader;
+  int decoded = 0;
+  int sequenceOk = 0;
+  int expected = 0;
+  for (uint8_t byte : stream) {
+    const uint8_t* data;
+    size_t size;
+    if (!reader.feed(byte, data, size)) continue;
+    LogRing::Record parsed;
+    char line[64];
+    LogRing::parse(data, size, parsed);
+    LogRing::render(parsed, format, line, sizeof(line));
+    if (expected == 7) expected++;
+    char want[64];
+    snprintf(want, sizeof(want), "Count %d at line 3", expected++);
+    if (strcmp(line, want) == 0 && parsed.timestampUs == 1000u * (expected - 1)) sequenceOk++;
+    decoded++;
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "%d decoded, %u CRC errors, %u text bytes skipped", decoded,
+           reader.getCrcErrors(), reader.getSkippedBytes());
+  check("frames: noise + bit error", decoded == 19 && sequenceOk == 19 &&
+        reader.getCrcErrors() == 1, details);
+}
+
+/** Records wrap around the ring end intact; a full ring drops and counts */
+static void testRingWrap() {
+  static LogRing ring;
+  uint8_t record[LogRing::MAX_RECORD];
+  uint8_t out[LogRing::MAX_RECORD];
+  int intact = 0;
+  int total = 0;
+
+  for (int i = 0; i < 2000; i++) {
+    std::string s(i % 30, 'a' + i % 26);
+    size_t size = LogRing::encode(record, 0, "%d %s", i, i, s.c_str());
+    ring.push(record, size);
+    size_t got = ring.pop(out);
+    if (got == size && memcmp(out, record, size) == 0) intact++;
+    total++;
+  }
+
+  ring.resetStats();
+  size_t size = LogRing::encode(record, 0, "%d", 0, 12345);
+  int accepted = 0;
+  for (int i = 0; i < 1000; i++) {
+    if (ring.push(record, size)) accepted++;
+  }
+  int expectedFit = LogRing::RING_SIZE / size;
+  int popped = 0;
+  while (ring.pop(out) > 0) popped++;
+
+  char details[128];
+  snprintf(details, sizeof(details), "%d/%d intact across wraps; full: %d kept, %u dropped",
+           intact, total, accepted, ring.getDropped());
+  check("ring wrap + overflow", intact == total && accepted == expectedFit &&
+        popped == expectedFit && ring.getDropped() == (uint32_t)(1000 - expectedFit) &&
+        ring.isEmpty(), details);
+}
+
+/** Cost of a log call vs. formatting the line on the spot */
+static void benchmarkLogCall() {
+  static LogRing ring;
+  uint8_t record[LogRing::MAX_RECORD];
+  uint8_t out[LogRing::MAX_RECORD];
+  const int CALLS = 2000000;
+  volatile size_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CALLS; i++) {
+    size_t size = LogRing::encode(record, 1, "Event %d in state %d", (uint32_t)i, i & 7, 2);
+    ring.push(record, size);
+    if ((i & 63) == 63) {
+      while (ring.pop(out) > 0) {}   // Drain (not timed separately)
+    }
+  }
+  double deferredNs = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / CALLS;
+
+  char text[160];
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CALLS; i++) {
+    sink += snprintf(text, sizeof(text), "[INFO] Event %d in state %d", i & 7, 2);
+  }
+  double formatNs = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / CALLS;
+
+  printf("BENCH log_call deferred_ns=%.1f format_ns=%.1f\n", deferredNs, formatNs);
+  char details[128];
+  snprintf(details, sizeof(details), "%.1f ns/call deferred (incl. drain), %.1f ns to format (host)",
+           deferredNs, formatNs);
+  check("log call cost", deferredNs < 1000, details);
+  (void)sink;
+}
+
+int main() {
+  testRenderMatchesPrintf();
+  testTruncation();
+  testModuleByte();
+  testFrames();
+  testRingWrap();
+  benchmarkLogCall();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * Main Screen Ownership Tests (host)
+ *
+ * Replays the loop as production_firmware runs it, one pass per
+ * millisecond: the READY or PRODUCTION state handler, then
+ * DisplayManager::render() with the pass's DisplayView (built like
+ * buildDisplayView()). The handlers must leave the screen to the view:
+ *   - an unchanged view renders once, every later pass is skipped
+ *   - frames rendered never exceed the number of view changes
+ *   - the panel ends up identical to the golden image of that view
+ *     (golden/, see display_golden_tests.cpp), so nothing else drew
+ *     over its fields
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DDISPLAY_ASYNC=0 -DSERIAL_OUT_LOCKED=0 -Ishim -I../../src/core \
+ *       -I../../src/managers -I../../src/hal \
+ *       main_screen_tests.cpp host_runtime.cpp ssd1306_emulator.cpp \
+ *       ../../src/core/active_states.cpp ../../src/managers/display_manager.cpp \
+ *       ../../src/managers/display_link.cpp ../../src/managers/rate_meter.cpp \
+ *       ../../src/hal/serial_out.cpp -o main_screen_tests
+ *   ./main_screen_tests
+ */
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "state_handlers.h"
+#include "ssd1306_emulator.h"
+
+Adafruit_SSD1306 display(128, 64, &Wire, -1);
+
+static int testsRun = 0;
+static int testsFailed = 0;
+static int healthChecks = 0;
+
+static const unsigned long REPLAY_MS = 60000;
+
+// Stand-in for state_handlers.cpp (heap, temperature, watchdog)
+bool checkSystemHealth() {
+  healthChecks++;
+  return true;
+}
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// LOOP REPLAY
+// ============================================================================
+
+struct Replay {
+  uint32_t passes = 0;
+  uint32_t afterFirstFrame = 0;    // Passes after the first frame drawn
+  uint32_t viewChanges = 0;
+  uint32_t rendered = 0;
+  uint32_t skipped = 0;
+  bool handlersHealthy = true;
+};
+
+static DisplayView makeView(SystemState state, long count, int hour, int minute) {
+  DisplayView view;
+  memset(&view, 0, sizeof(view));
+  view.state = (uint8_t)state;
+  view.count = count;
+  view.rtcOk = true;
+  view.hour = hour;
+  view.minute = minute;
+  view.sdOk = true;
+  strncpy(view.status, state == SystemState::PRODUCTION ? "PRODUCTION ACTIVE" : "READY",
+          sizeof(view.status) - 1);
+  if (state == SystemState::PRODUCTION) {
+    view.rateShown = true;
+    view.rateNow = 425;
+    view.rateAverage = 401;
+  }
+  return view;
+}
+
+// `countAt` gives the count `elapsed` ms into the replay
+template <typename CountAt>
+static Replay replay(SystemState state, int hour, int minute, CountAt countAt) {
+  DisplayManager& dm = DisplayManager::getInstance();
+  uint32_t renderedBefore = dm.getFramesRendered();
+  uint32_t skippedBefore = dm.getFramesSkipped();
+
+  Replay r;
+  long lastCount = -1;
+  bool drawn = false;
+  for (unsigned long elapsed = 0; elapsed < REPLAY_MS; elapsed++) {
+    bool healthy = (state == SystemState::PRODUCTION) ? executeProductionState()
+                                                      : executeReadyState();
+    r.handlersHealthy = r.handlersHealthy && healthy;
+
+    long count = countAt(elapsed);
+    if (count != lastCount) {
+      r.viewChanges++;
+      lastCount = count;
+    }
+    if (drawn) {
+      r.afterFirstFrame++;
+    }
+    drawn = dm.render(makeView(state, count, hour, minute)) || drawn;
+    r.passes++;
+    hostAdvanceMillis(1);
+  }
+
+  r.rendered = dm.getFramesRendered() - renderedBefore;
+  r.skipped = dm.getFramesSkipped() - skippedBefore;
+  return r;
+}
+
+// Pixels differing from golden/<name>.pbm, -1 if it cannot be read
+static int goldenDifferences(const char* name) {
+  char path[96];
+  snprintf(path, sizeof(path), "golden/%s.pbm", name);
+  uint8_t golden[Ssd1306Emulator::RAM_SIZE];
+  if (!Ssd1306Emulator::readPbm(path, golden)) {
+    return -1;
+  }
+  const uint8_t* panel = Ssd1306Emulator::getInstance().panelRam();
+  int bufferDiff = Ssd1306Emulator::countDifferences(panel, display.getBuffer());
+  return Ssd1306Emulator::countDifferences(panel, golden) + bufferDiff;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** 60 s of READY with nothing changing: one frame, the rest skipped */
+static void testReadyIdle() {
+  int checksBefore = healthChecks;
+  Replay r = replay(SystemState::READY, 9, 5, [](unsigned long) { return 0L; });
+  int diff = goldenDifferences("ready");
+
+  char details[128];
+  snprintf(details, sizeof(details), "%lu passes: %lu rendered, %lu skipped, %d px off golden",
+           (unsigned long)r.passes, (unsigned long)r.rendered, (unsigned long)r.skipped, diff);
+  check("READY handler leaves the screen", r.handlersHealthy && r.rendered == 1 &&
+        r.skipped == r.afterFirstFrame && diff == 0 && healthChecks > checksBefore, details);
+}
+
+/** 60 s of PRODUCTION, 1200 -> 1234 items: one frame per count at most */
+static void testProductionCounting() {
+  int checksBefore = healthChecks;
+  Replay r = replay(SystemState::PRODUCTION, 14, 32, [](unsigned long elapsed) {
+    return 1200L + (long)((elapsed + 1) * 34 / REPLAY_MS);
+  });
+  int diff = goldenDifferences("production_rate");
+
+  char details[128];
+  snprintf(details, sizeof(details), "%lu view changes: %lu rendered, %d px off golden",
+           (unsigned long)r.viewChanges, (unsigned long)r.rendered, diff);
+  check("PRODUCTION handler leaves the screen", r.handlersHealthy && r.rendered > 0 &&
+        r.rendered <= r.viewChanges && diff == 0 && healthChecks > checksBefore, details);
+}
+
+int main() {
+  display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  DisplayManager& dm = DisplayManager::getInstance();
+  dm.initialize();
+  dm.showInitializationScreen();
+
+  testReadyIdle();
+  testProductionCounting();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/**
+ * Production Rate Meter Tests (host)
+ *
+ * Feeds RateMeter a simulated line (one item every N ms) through a loop
+ * that passes the count every 2 ms, like production_firmware. Checks:
+ *   - steady rate: every rate exact once the windows have filled
+ *   - rate step: rolling windows match the exact blend, EWMA follows
+ *     within a few time constants
+ *   - warm-up: short windows are meaningful before they fill
+ *   - loop stalls lose no items; an idle line decays to 0
+ *   - a session resumed after a power cut rates only the new items
+ *   - cost of update() per loop pass and per closed bucket
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/managers rate_meter_tests.cpp \
+ *       ../../src/managers/rate_meter.cpp -o rate_meter_tests
+ *   ./rate_meter_tests
+ */
+
+#include "rate_meter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static const uint32_t LOOP_MS = 2;
+static const uint32_t START_MS = 123457;         // Not on a bucket boundary
+
+// ============================================================================
+// SIMULATED LINE
+// ============================================================================
+
+struct Line {
+  uint32_t nowMs = START_MS;
+  uint32_t count = 0;
+  uint32_t itemEveryMs = 0;    // 0 = idle
+  uint32_t nextItemMs = 0;
+};
+
+static Line line;
+
+static void setRate(uint32_t itemEveryMs) {
+  line.itemEveryMs = itemEveryMs;
+  line.nextItemMs = line.nowMs + itemEveryMs;
+}
+
+static void reset(RateMeter& meter, uint32_t itemEveryMs) {
+  line = Line();
+  setRate(itemEveryMs);
+  meter.begin(line.count, line.nowMs);
+}
+
+// Items count as they happen; the loop only sees the count every
+// LOOP_MS, or not at all while stalled
+static void run(RateMeter& meter, uint32_t durationMs, bool stalled = false) {
+  uint32_t end = line.nowMs + durationMs;
+  while (line.nowMs < end) {
+    line.nowMs += LOOP_MS;
+    while (line.itemEveryMs && (int32_t)(line.nowMs - line.nextItemMs) >= 0) {
+      line.count++;
+      line.nextItemMs += line.itemEveryMs;
+    }
+    if (!stalled) {
+      meter.update(line.count, line.nowMs);
+    }
+  }
+}
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+static void describe(const RateMeter::Rates& r, char* out, size_t size) {
+  snprintf(out, size, "now %lu, 1m %lu, 5m %lu, 15m %lu, session %lu (tenths/min)",
+           (unsigned long)r.now, (unsigned long)r.oneMinute, (unsigned long)r.fiveMinutes,
+           (unsigned long)r.fifteenMinutes, (unsigned long)r.session);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** One item per second: every rate reads 60.0/min */
+static void testSteady() {
+  RateMeter meter;
+  reset(meter, 1000);
+  run(meter, 20 * 60000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[128];
+  describe(r, details, sizeof(details));
+  check("steady 60/min", r.now == 600 && r.oneMinute == 600 && r.fiveMinutes == 600 &&
+        r.fifteenMinutes == 600 && r.session == 600, details);
+}
+
+/** 60/min for 15 min, then 120/min: windows blend exactly, EWMA follows */
+static void testStep() {
+  RateMeter meter;
+  reset(meter, 1000);
+  run(meter, 15 * 60000);
+  setRate(500);
+
+  run(meter, 30000);
+  uint32_t ewmaAt30s = meter.getRates().now;
+  run(meter, 30000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[160];
+  describe(r, details, sizeof(details));
+  // After 1 minute at 120: 1m all new, 5m = (4*60 + 120)/5, 15m = (14*60 + 120)/15
+  bool windows = abs((int)r.oneMinute - 1200) <= 2 && abs((int)r.fiveMinutes - 720) <= 2 &&
+                 abs((int)r.fifteenMinutes - 640) <= 2;
+  // 1 and 2 time constants: 1 - e^-1 and 1 - e^-2 of the way
+  bool ewma = abs((int)ewmaAt30s - 979) <= 10 && abs((int)r.now - 1119) <= 10;
+  check("step 60 -> 120/min", windows && ewma, details);
+}
+
+/** 30 s in: the 1-minute rate is over the 6 buckets seen, not 12 */
+static void testWarmUp() {
+  RateMeter meter;
+  reset(meter, 1000);
+  run(meter, 2000);
+  bool quiet = meter.getRates().oneMinute == 0 && meter.getBucketsClosed() == 0;
+  run(meter, 28000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[128];
+  describe(r, details, sizeof(details));
+  check("warm-up after 30 s", quiet && r.oneMinute == 600 && r.fifteenMinutes == 600 &&
+        r.session == 600, details);
+}
+
+/** A 12 s loop stall spreads its items over the buckets it covered */
+static void testStall() {
+  RateMeter meter;
+  reset(meter, 250);
+  run(meter, 60000);
+  run(meter, 12000, true);
+  run(meter, 48000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[128];
+  describe(r, details, sizeof(details));
+  check("12 s loop stall", r.oneMinute == 2400 && r.session == 2400, details);
+}
+
+/** Line stops: every window empties, EWMA reaches 0 */
+static void testIdle() {
+  RateMeter meter;
+  reset(meter, 1000);
+  run(meter, 10 * 60000);
+  setRate(0);
+  run(meter, 60000);
+  uint32_t oneMinuteAfterStop = meter.getRates().oneMinute;
+  run(meter, 15 * 60000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[128];
+  describe(r, details, sizeof(details));
+  check("idle line decays", oneMinuteAfterStop == 0 && r.now == 0 && r.fiveMinutes == 0 &&
+        r.fifteenMinutes == 0 && r.session == 230, details);  // 600 items / 26 min
+}
+
+/** stop() freezes the last session's rates */
+static void testStop() {
+  RateMeter meter;
+  reset(meter, 1000);
+  run(meter, 60000);
+  meter.stop();
+  setRate(100);
+  run(meter, 60000);
+
+  char details[128];
+  describe(meter.getRates(), details, sizeof(details));
+  check("stop() freezes rates", !meter.isActive() && meter.getRates().oneMinute == 600, details);
+}
+
+/** Resumed at a recovered 5000 items (loadSessionFromFile): 60/min, not 5000 at once */
+static void testResumed() {
+  RateMeter meter;
+  line = Line();
+  line.count = 5000;
+  setRate(1000);
+  meter.begin(line.count, line.nowMs);
+  run(meter, 5 * 60000);
+
+  const RateMeter::Rates& r = meter.getRates();
+  char details[128];
+  describe(r, details, sizeof(details));
+  check("resumed session", meter.isActive() && r.now == 600 && r.oneMinute == 600 &&
+        r.fiveMinutes == 600 && r.session == 600, details);
+}
+
+/** "42.5" */
+static void testFormat() {
+  char a[12], b[12];
+  RateMeter::formatTenths(425, a, sizeof(a));
+  RateMeter::formatTenths(7, b, sizeof(b));
+  char details[64];
+  snprintf(details, sizeof(details), "425 -> %s, 7 -> %s", a, b);
+  check("formatTenths", std::string(a) == "42.5" && std::string(b) == "0.7", details);
+}
+
+/** Cost of update(): a compare per pass, O(1) per closed bucket */
+static void benchUpdate() {
+  typedef std::chrono::steady_clock BenchClock;
+  RateMeter meter;
+  meter.begin(0, 0);
+
+  const uint32_t passes = 10000000;
+  BenchClock::time_point start = BenchClock::now();
+  for (uint32_t t = 1; t <= passes; t++) {
+    meter.update(t / 4, t);                       // 15000 items/min
+  }
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+
+  char details[128];
+  snprintf(details, sizeof(details), "%.1f ns per pass, %lu buckets closed",
+           ns / passes, (unsigned long)meter.getBucketsClosed());
+  check("update() cost", meter.getRates().oneMinute == 150000, details);
+  printf("BENCH update_ns_per_pass=%.2f\n", ns / passes);
+}
+
+int main() {
+  testSteady();
+  testStep();
+  testWarmUp();
+  testStall();
+  testIdle();
+  testStop();
+  testResumed();
+  testFormat();
+  benchUpdate();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
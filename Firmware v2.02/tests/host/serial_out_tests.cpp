@@ -0,0 +1,279 @@
+/**
+ * Serial Output Ring Tests (host)
+ *
+ * Drives SerialOut against a simulated UART: the TX FIFO (128 bytes)
+ * empties at 115200 baud, or not at all for a stalled terminal. Checks
+ * that prints never block, that bytes come out in order, and what each
+ * drop policy keeps when the ring overflows. Also replays a burst of
+ * manager output through plain Serial and through Console and reports how
+ * long the loop would have been blocked.
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -DSERIAL_OUT_LOCKED=0 -Ishim -I../../src/hal \
+ *       serial_out_tests.cpp ../../src/hal/serial_out.cpp -o serial_out_tests
+ *   ./serial_out_tests
+ */
+
+#include "serial_out.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+HostSerial Serial;
+
+static unsigned long long hostMicros = 0;
+unsigned long millis() { return (unsigned long)(hostMicros / 1000); }
+unsigned long micros() { return (unsigned long)hostMicros; }
+void delay(unsigned long ms) { hostMicros += (unsigned long long)ms * 1000; }
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// SIMULATED UART
+// ============================================================================
+
+static const int FIFO_SIZE = 128;
+static const double BYTES_PER_MS = 115200 / 10 / 1000.0;
+
+static std::string received;
+static void captureByte(uint8_t c) { received.push_back((char)c); }
+
+static void resetUart(int txFree) {
+  received.clear();
+  Serial.txFree = txFree;
+  Serial.txBlocked = 0;
+  Serial.capture = captureByte;
+}
+
+// Let the UART shift out `ms` worth of bytes
+static void uartRun(double ms) {
+  static double carry = 0;
+  carry += ms * BYTES_PER_MS;
+  int sent = (int)carry;
+  carry -= sent;
+  Serial.txFree = (Serial.txFree + sent > FIFO_SIZE) ? FIFO_SIZE : Serial.txFree + sent;
+}
+
+static std::string line(int i) {
+  char text[64];
+  snprintf(text, sizeof(text), "[ProductionManager] Count incremented: %d\r\n", i);
+  return text;
+}
+
+// True if `text` is made only of whole line(i) lines, in increasing order
+static bool wholeLinesInOrder(const std::string& text, int& first, int& last) {
+  first = last = -1;
+  size_t at = 0;
+  while (at < text.size()) {
+    int value;
+    if (sscanf(text.c_str() + at, "[ProductionManager] Count incremented: %d", &value) != 1) return false;
+    std::string expected = line(value);
+    if (text.compare(at, expected.size(), expected) != 0 || value <= last) return false;
+    if (first < 0) first = value;
+    last = value;
+    at += expected.size();
+  }
+  return true;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** A terminal that keeps up sees exactly what was printed */
+static void testPassThrough() {
+  SerialOut out;
+  resetUart(FIFO_SIZE);
+  std::string printed;
+  for (int i = 0; i < 500; i++) {
+    printed += line(i);
+    out.print(line(i).c_str());
+    uartRun(5);
+    if (i % 7 == 0) out.pump();   // loop()
+  }
+  for (int i = 0; i < 100 && out.getUsed() > 0; i++) {
+    uartRun(20);
+    out.pump();
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "%zu/%zu bytes, %lu blocked, %u dropped", received.size(),
+           printed.size(), Serial.txBlocked, out.getDroppedBytes());
+  check("pass-through in order", received == printed && Serial.txBlocked == 0 &&
+        out.getDroppedBytes() == 0, details);
+}
+
+/** Stalled terminal: nothing blocks, the ring keeps the newest whole lines */
+static void testDropOldest() {
+  SerialOut out;
+  resetUart(0);
+  size_t offered = 0;
+  const int LINES = 400;
+  for (int i = 0; i < LINES; i++) {
+    std::string text = line(i);
+    offered += text.size();
+    out.print(text.c_str());
+    out.pump();
+  }
+  resetUart(FIFO_SIZE);
+  for (int i = 0; i < 1000 && (out.getUsed() > 0 || received.empty()); i++) {
+    uartRun(20);
+    out.pump();
+  }
+
+  const char* marker = "[SerialOut] ";
+  size_t markerEnd = received.find("bytes dropped\r\n");
+  bool markerFirst = received.compare(0, strlen(marker), marker) == 0 && markerEnd != std::string::npos;
+  unsigned long reported = strtoul(received.c_str() + strlen(marker), nullptr, 10);
+  std::string rest = markerFirst ? received.substr(markerEnd + 15) : "";
+  int first, last;
+  bool whole = wholeLinesInOrder(rest, first, last);
+
+  char details[128];
+  snprintf(details, sizeof(details), "lines %d..%d kept, %lu dropped (reported %lu), %lu blocked",
+           first, last, (unsigned long)out.getDroppedBytes(), reported, Serial.txBlocked);
+  check("drop-oldest keeps latest lines", markerFirst && whole && last == LINES - 1 &&
+        reported == out.getDroppedBytes() && rest.size() + out.getDroppedBytes() == offered &&
+        Serial.txBlocked == 0, details);
+}
+
+/** Held (bulk transfer): nothing reaches the UART, all of it follows on release */
+static void testHeld() {
+  SerialOut out;
+  resetUart(FIFO_SIZE);
+  std::string printed;
+  out.setHeld(true);
+  for (int i = 0; i < 40; i++) {
+    printed += line(i);
+    out.print(line(i).c_str());
+    uartRun(5);
+    out.pump();
+  }
+  unsigned long before = millis();
+  out.flush();                     // Returns at once while held
+  unsigned long flushMs = millis() - before;
+  size_t whileHeld = received.size();
+
+  out.setHeld(false);
+  for (int i = 0; i < 100 && out.getUsed() > 0; i++) {
+    uartRun(20);
+    out.pump();
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "%zu bytes while held, %zu/%zu after release", whileHeld,
+           received.size(), printed.size());
+  check("held output waits in order", whileHeld == 0 && flushMs == 0 && received == printed, details);
+}
+
+/** Drop-newest keeps the earliest output; the marker sits at the gap */
+static void testDropNewest() {
+  SerialOut out;
+  out.setDropPolicy(SerialOut::DROP_NEWEST);
+  resetUart(0);
+  size_t offered = 0;
+  for (int i = 0; i < 400; i++) {
+    std::string text = line(i);
+    offered += text.size();
+    out.print(text.c_str());
+  }
+  resetUart(FIFO_SIZE);
+  for (int i = 0; i < 1000 && (out.getUsed() > 0 || received.find("dropped") == std::string::npos); i++) {
+    uartRun(20);
+    out.pump();
+  }
+
+  size_t gap = received.find("[SerialOut] ");
+  int first = -1, last = -1;
+  bool whole = gap != std::string::npos && wholeLinesInOrder(received.substr(0, gap), first, last);
+  size_t kept = (gap == std::string::npos) ? 0 : gap;
+
+  char details[128];
+  snprintf(details, sizeof(details), "lines %d..%d kept, %u dropped, %lu blocked", first, last,
+           out.getDroppedBytes(), Serial.txBlocked);
+  check("drop-newest keeps earliest lines", whole && first == 0 &&
+        kept + out.getDroppedBytes() == offered && kept <= SerialOut::RING_SIZE &&
+        Serial.txBlocked == 0, details);
+}
+
+/** A burst of manager output at 115200 baud: time the loop spends blocked */
+static void testBurstBlocking() {
+  // Startup-style burst: 60 lines printed in fragments, 1 ms of work each
+  const int LINES = 60;
+
+  // Direct Serial: a write that does not fit waits for the UART
+  resetUart(FIFO_SIZE);
+  double blockedMs = 0;
+  for (int i = 0; i < LINES; i++) {
+    std::string text = line(i);
+    for (char c : text) {
+      while (Serial.txFree == 0) {
+        uartRun(0.01);
+        blockedMs += 0.01;
+      }
+      Serial.write((uint8_t)c);
+    }
+    uartRun(1);
+  }
+
+  SerialOut out;
+  resetUart(FIFO_SIZE);
+  int maxQueued = 0;
+  for (int i = 0; i < LINES; i++) {
+    std::string text = line(i);
+    out.print(text.substr(0, 20).c_str());
+    out.print(text.substr(20).c_str());
+    if ((int)out.getUsed() > maxQueued) maxQueued = out.getUsed();
+    uartRun(1);
+    out.pump();
+  }
+
+  printf("BENCH serial_burst lines=%d direct_blocked_ms=%.1f console_blocked_bytes=%lu "
+         "console_max_queued=%d\n", LINES, blockedMs, Serial.txBlocked, maxQueued);
+  char details[96];
+  snprintf(details, sizeof(details), "direct: %.1f ms blocked; Console: %lu bytes blocked, %d queued",
+           blockedMs, Serial.txBlocked, maxQueued);
+  check("burst never blocks the loop", Serial.txBlocked == 0 && blockedMs > 100 &&
+        out.getDroppedBytes() == 0, details);
+}
+
+/** Cost of a print into the ring while the terminal is stalled */
+static void benchmarkPrint() {
+  static SerialOut out;
+  resetUart(0);
+  Serial.capture = nullptr;
+  const int CALLS = 1000000;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CALLS; i++) {
+    out.print("[StorageManager] Count saved: ");
+    out.println(i);
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+  printf("BENCH serial_print ns_per_line=%.1f\n", ns);
+  char details[64];
+  snprintf(details, sizeof(details), "%.1f ns per line (3 writes)", ns);
+  check("print cost", ns < 2000, details);
+}
+
+int main() {
+  testPassThrough();
+  testDropOldest();
+  testDropNewest();
+  testHeld();
+  testBurstBlocking();
+  benchmarkPrint();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
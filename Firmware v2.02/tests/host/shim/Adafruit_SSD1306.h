@@ -0,0 +1,61 @@
+/**
+ * Host stand-in for Adafruit_SSD1306 + Adafruit_GFX: a 128x64 page-format
+ * frame buffer with the GFX drawing and classic 5x7 text semantics
+ * (transparent background, 6x8 cell per character scaled by text size,
+ * wrap at the right edge). display() pushes the whole frame over the
+ * emulated bus like the real library.
+ */
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+
+class Adafruit_SSD1306 : public Print {
+public:
+  Adafruit_SSD1306(int16_t w, int16_t h, TwoWire* wire, int8_t resetPin);
+
+  bool begin(uint8_t vccState, uint8_t address);
+  void display();
+  void clearDisplay();
+  uint8_t* getBuffer() { return started ? buffer : nullptr; }
+  int16_t width() const { return WIDTH; }
+  int16_t height() const { return HEIGHT; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+  void setTextSize(uint8_t size) { textSize = size ? size : 1; }
+  void setTextColor(uint16_t color) { textColor = textBackground = color; }
+  void setTextColor(uint16_t color, uint16_t background) { textColor = color; textBackground = background; }
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+  void setTextWrap(bool enable) { wrap = enable; }
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+private:
+  static const int16_t WIDTH = 128;
+  static const int16_t HEIGHT = 64;
+
+  uint8_t buffer[WIDTH * HEIGHT / 8];
+  uint8_t address = 0x3C;
+  bool started = false;
+  int16_t cursorX = 0;
+  int16_t cursorY = 0;
+  uint8_t textSize = 1;
+  uint16_t textColor = SSD1306_WHITE;
+  uint16_t textBackground = SSD1306_WHITE;
+  bool wrap = true;
+};
+
+#endif // HOST_ADAFRUIT_SSD1306_H
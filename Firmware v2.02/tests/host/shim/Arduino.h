@@ -0,0 +1,76 @@
+/**
+ * Host stand-in for <Arduino.h> - only what the display code uses.
+ * Time is simulated: millis()/micros() advance via delay() or
+ * hostAdvanceMillis(), so rate limits and status holds are deterministic.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#define HEX 16
+#define DEC 10
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) write(data[i]);
+    return length;
+  }
+  virtual void flush() {}
+  size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long value, int base = DEC) { return printNumber(value, base); }
+  size_t print(int value, int base = DEC) { return printNumber(value, base); }
+  size_t print(unsigned long value, int base = DEC) { return printNumber((long long)value, base); }
+  size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+  size_t println() { return print("\n"); }
+  template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+
+private:
+  size_t printNumber(long long value, int base) {
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%llX" : "%lld", value);
+    return print(text);
+  }
+};
+
+// Serial output is discarded unless HOST_SERIAL_ECHO is set at build time.
+// txFree models the UART TX FIFO: tests shrink it to simulate a slow or
+// stalled terminal and count writes that would have blocked.
+class HostSerial : public Print {
+public:
+  size_t write(uint8_t c) override {
+#ifdef HOST_SERIAL_ECHO
+    fputc(c, stderr);
+#endif
+    if (txFree > 0) {
+      txFree--;
+    } else {
+      txBlocked++;
+    }
+    if (capture != nullptr) capture(c);
+    return 1;
+  }
+  using Print::write;
+  int availableForWrite() { return txFree; }
+
+  int txFree = 1 << 30;
+  unsigned long txBlocked = 0;
+  void (*capture)(uint8_t c) = nullptr;
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void hostAdvanceMillis(unsigned long ms);
+
+#endif // HOST_ARDUINO_H
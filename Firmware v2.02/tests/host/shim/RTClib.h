@@ -0,0 +1,27 @@
+/**
+ * Host stand-in for RTClib - DateTime only.
+ */
+#ifndef HOST_RTCLIB_H
+#define HOST_RTCLIB_H
+
+#include <stdint.h>
+
+class DateTime {
+public:
+  DateTime(uint16_t year = 2000, uint8_t month = 1, uint8_t day = 1,
+           uint8_t hour = 0, uint8_t minute = 0, uint8_t second = 0)
+    : y(year), m(month), d(day), hh(hour), mm(minute), ss(second) {}
+
+  uint16_t year() const { return y; }
+  uint8_t month() const { return m; }
+  uint8_t day() const { return d; }
+  uint8_t hour() const { return hh; }
+  uint8_t minute() const { return mm; }
+  uint8_t second() const { return ss; }
+
+private:
+  uint16_t y;
+  uint8_t m, d, hh, mm, ss;
+};
+
+#endif // HOST_RTCLIB_H
@@ -0,0 +1,10 @@
+/**
+ * Host stand-in for <Wire.h> - the bus is modelled by Ssd1306Emulator.
+ */
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+class TwoWire {};
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,66 @@
+/**
+ * Host stand-in for <freertos/task.h> - one task, which never runs on its
+ * own: hostRunTask() runs it on the caller's stack until it would block
+ * in ulTaskNotifyTake(). Lets a test decide exactly when the task gets
+ * the CPU (e.g. two submits before the transmitter wakes).
+ */
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+struct HostTask {
+  TaskFunction_t entry = nullptr;
+  void* parameter = nullptr;
+  uint32_t notifications = 0;
+};
+typedef HostTask* TaskHandle_t;
+
+struct HostTaskBlocked {};         // Unwinds the task loop back to hostRunTask()
+
+inline HostTask& hostTask() {
+  static HostTask task;
+  return task;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char*, uint32_t,
+                                          void* parameter, UBaseType_t,
+                                          TaskHandle_t* handle, BaseType_t) {
+  HostTask& task = hostTask();
+  task.entry = entry;
+  task.parameter = parameter;
+  task.notifications = 0;
+  *handle = &task;
+  return pdPASS;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task) {
+  task->notifications++;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t) {
+  HostTask& task = hostTask();
+  if (task.notifications == 0) {
+    throw HostTaskBlocked();
+  }
+  uint32_t value = task.notifications;
+  task.notifications = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+// Run the task until it waits for a notification; false if none is pending
+inline bool hostRunTask() {
+  HostTask& task = hostTask();
+  if (task.entry == nullptr || task.notifications == 0) {
+    return false;
+  }
+  try {
+    task.entry(task.parameter);
+  } catch (const HostTaskBlocked&) {
+  }
+  return true;
+}
+
+#endif // HOST_FREERTOS_TASK_H
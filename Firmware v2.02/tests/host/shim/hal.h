@@ -0,0 +1,29 @@
+/**
+ * Host stand-in for src/hal/hal.h - only the I2C calls used by the display
+ * path. Writes go to the SSD1306 emulator (see ssd1306_emulator.h); the
+ * host is single-threaded, so there is no bus arbitration.
+ */
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <Arduino.h>
+
+class I2C {
+public:
+  enum Priority : uint8_t {
+    PRIORITY_BULK,
+    PRIORITY_NORMAL,
+    PRIORITY_URGENT
+  };
+  
+  static const size_t BULK_CHUNK = 32;
+
+  static bool write(uint8_t address, const uint8_t* data, size_t length,
+                    Priority priority = PRIORITY_NORMAL);
+  static bool ssd1306WriteWindow(uint8_t address, uint8_t pageStart, uint8_t pageEnd,
+                                 uint8_t colStart, uint8_t colEnd,
+                                 const uint8_t* data, size_t length);
+  static uint32_t getBytesTransferred();
+};
+
+#endif // HOST_HAL_H
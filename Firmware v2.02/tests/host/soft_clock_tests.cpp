@@ -0,0 +1,239 @@
+/**
+ * Software Clock Tests (host)
+ *
+ * Runs SoftClock against a simulated DS3231 (ideal 1 Hz seconds counter)
+ * with an MCU timer that drifts by a fixed rate, polling once per
+ * millisecond like loop(). Checks:
+ *   - clock error stays within a few ms once drift has been measured
+ *   - the measured drift matches the simulated oscillator error
+ *   - RTC reads per hour (bus cost) vs. one read per loop pass
+ *   - read failures, a stopped oscillator and an externally set RTC
+ *
+ * Build & run (from this directory):
+ *   g++ -std=c++11 -O2 -I../../src/managers soft_clock_tests.cpp \
+ *       ../../src/managers/soft_clock.cpp -o soft_clock_tests
+ *   ./soft_clock_tests
+ */
+
+#include "soft_clock.h"
+#include <cmath>
+#include <cstdio>
+
+static int testsRun = 0;
+static int testsFailed = 0;
+
+// ============================================================================
+// SIMULATED HARDWARE
+// ============================================================================
+
+static const uint32_t RTC_START = 1767258000;   // 2026-01-01 09:00:00
+static const int64_t LOOP_US = 1000;
+
+struct Simulation {
+  int64_t trueUs = 0;        // Real time since start
+  double timerPpm = 0;       // MCU timer rate error (+ = fast)
+  int64_t rtcSkewUs = 0;     // RTC set forward/back at some point
+  bool rtcStopped = false;
+  int failReads = 0;         // Next N reads fail
+
+  int64_t mcuMicros() const { return trueUs + (int64_t)llround(trueUs * timerPpm * 1e-6); }
+  uint32_t rtcSeconds() const {
+    int64_t t = rtcStopped ? 0 : trueUs + rtcSkewUs;
+    return RTC_START + (uint32_t)(t / 1000000);
+  }
+};
+
+static Simulation sim;
+
+static bool readSimulatedRtc(uint32_t& unixSeconds) {
+  if (sim.failReads > 0) {
+    sim.failReads--;
+    return false;
+  }
+  unixSeconds = sim.rtcSeconds();
+  return true;
+}
+
+static void reset(double timerPpm) {
+  sim = Simulation();
+  sim.timerPpm = timerPpm;
+  sim.trueUs = 123456;  // Not on an edge
+}
+
+// Error of the software clock against true RTC time, in microseconds
+static int64_t clockError(const SoftClock& clock) {
+  int64_t truth = (int64_t)RTC_START * 1000000 + sim.trueUs + sim.rtcSkewUs;
+  return clock.unixMicros(sim.mcuMicros()) - truth;
+}
+
+// Advance real time, polling every loop pass; returns the worst error seen
+// after `settleUs` (0 = not checked)
+static int64_t run(SoftClock& clock, int64_t durationUs, int64_t settleUs = -1) {
+  int64_t worst = 0;
+  int64_t end = sim.trueUs + durationUs;
+  int64_t checkFrom = sim.trueUs + settleUs;
+  while (sim.trueUs < end) {
+    clock.poll(sim.mcuMicros());
+    if (settleUs >= 0 && sim.trueUs >= checkFrom && clock.isSynced() && !clock.isCapturing()) {
+      int64_t error = llabs(clockError(clock));
+      if (error > worst) worst = error;
+    }
+    sim.trueUs += LOOP_US;
+  }
+  return worst;
+}
+
+static void check(const char* name, bool passed, const char* details) {
+  testsRun++;
+  if (!passed) testsFailed++;
+  printf("%s %-34s %s\n", passed ? "[PASS]" : "[FAIL]", name, details);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+/** Drift is measured and corrected; error stays within a few ms */
+static void testDriftTracking(double timerPpm) {
+  reset(timerPpm);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 600000);
+
+  run(clock, 3600LL * 1000000);                             // First hour: learn drift
+  uint32_t readsBefore = clock.getRtcReads();
+  int64_t worst = run(clock, 23 * 3600LL * 1000000, 0);    // Rest of the day
+  uint32_t readsPerHour = (clock.getRtcReads() - readsBefore) / 23;
+
+  char name[48];
+  char details[160];
+  snprintf(name, sizeof(name), "drift %+.0f ppm over 24 h", timerPpm);
+  snprintf(details, sizeof(details),
+           "measured %+.2f ppm, worst error %lld us, %u RTC reads/h (per-pass: 3600000)",
+           clock.getDriftPpm(), (long long)worst, readsPerHour);
+  check(name, fabs(clock.getDriftPpm() - timerPpm) < 2.0 && worst < 3000 &&
+        readsPerHour < 400 && clock.getFailedSyncs() == 0, details);
+}
+
+/** Time is available right after the first edge capture */
+static void testFirstSync() {
+  reset(0);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc);
+  int64_t start = sim.trueUs;
+  while (!clock.isSynced() && sim.trueUs - start < 2000000) {
+    clock.poll(sim.mcuMicros());
+    sim.trueUs += LOOP_US;
+  }
+
+  char details[96];
+  snprintf(details, sizeof(details), "synced after %lld ms, error %lld us",
+           (long long)(sim.trueUs - start) / 1000, (long long)clockError(clock));
+  check("first sync captures an edge", clock.isSynced() && llabs(clockError(clock)) <= LOOP_US,
+        details);
+}
+
+/** Failed reads are retried; the clock keeps running meanwhile */
+static void testReadFailures() {
+  reset(30);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 60000);
+  run(clock, 600LL * 1000000);
+
+  sim.failReads = 3;
+  int64_t worst = run(clock, 600LL * 1000000, 0);
+
+  char details[96];
+  snprintf(details, sizeof(details), "%u failed, %u synced, worst error %lld us",
+           clock.getFailedSyncs(), clock.getSyncCount(), (long long)worst);
+  check("RTC read failures", clock.getFailedSyncs() == 3 && worst < 3000, details);
+}
+
+/** A stopped RTC oscillator times out instead of capturing forever */
+static void testStoppedRtc() {
+  reset(0);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 60000);
+  run(clock, 120LL * 1000000);
+
+  sim.rtcStopped = true;
+  uint32_t readsBefore = clock.getRtcReads();
+  run(clock, 60LL * 1000000);
+  uint32_t reads = clock.getRtcReads() - readsBefore;
+
+  char details[96];
+  snprintf(details, sizeof(details), "%u failed, %u reads in 60 s", clock.getFailedSyncs(), reads);
+  check("stopped RTC times out", clock.getFailedSyncs() >= 1 && !clock.isCapturing() &&
+        reads < 6000, details);
+}
+
+/** The RTC being set elsewhere is a step, not drift */
+static void testRtcStep() {
+  reset(20);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 60000);
+  run(clock, 1800LL * 1000000);
+  float driftBefore = clock.getDriftPpm();
+
+  sim.rtcSkewUs = 3600LL * 1000000;  // Someone set the RTC an hour ahead
+  run(clock, 70LL * 1000000);
+  int64_t worst = run(clock, 600LL * 1000000, 0);
+
+  char details[96];
+  snprintf(details, sizeof(details), "%u steps, drift %+.2f -> %+.2f ppm, worst error %lld us",
+           clock.getSteps(), driftBefore, clock.getDriftPpm(), (long long)worst);
+  check("RTC set externally", clock.getSteps() == 1 && worst < 3000 &&
+        fabs(clock.getDriftPpm() - driftBefore) < 1.0, details);
+}
+
+/** set() takes effect immediately and re-locks to the RTC edge */
+static void testSet() {
+  reset(-50);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 60000);
+  run(clock, 600LL * 1000000);
+
+  // setTime(): RTC written (its divider restarts), software clock set
+  int64_t phase = (sim.trueUs + sim.rtcSkewUs) % 1000000;
+  sim.rtcSkewUs += 7200LL * 1000000 - phase;
+  clock.set(sim.rtcSeconds(), sim.mcuMicros());
+  int64_t afterSet = llabs(clockError(clock));
+  int64_t worst = run(clock, 120LL * 1000000, 2000000);
+
+  char details[96];
+  snprintf(details, sizeof(details), "error %lld us after set, worst %lld us after resync",
+           (long long)afterSet, (long long)worst);
+  check("set() then resync", afterSet < 1000000 && worst < 3000, details);
+}
+
+/** timerAt() is the inverse of unixMicros() (hour deadlines for the ISRs) */
+static void testTimerAt() {
+  reset(-85);
+  SoftClock clock;
+  clock.begin(readSimulatedRtc, 600000);
+  run(clock, 7200LL * 1000000);
+
+  uint32_t nextHour = (clock.unixTime(sim.mcuMicros()) / 3600 + 1) * 3600;
+  int64_t at = clock.timerAt(nextHour);
+  int64_t roundTrip = clock.unixMicros(at) - (int64_t)nextHour * 1000000;
+  int64_t before = clock.unixMicros(at - 1) - (int64_t)nextHour * 1000000;
+
+  char details[96];
+  snprintf(details, sizeof(details), "round trip %lld us, 1 us earlier %lld us",
+           (long long)roundTrip, (long long)before);
+  check("timerAt() inverts the clock", roundTrip >= 0 && roundTrip <= 1 && before < 0, details);
+}
+
+int main() {
+  testFirstSync();
+  testDriftTracking(0);
+  testDriftTracking(40);
+  testDriftTracking(-85);
+  testReadFailures();
+  testStoppedRtc();
+  testRtcStep();
+  testSet();
+  testTimerAt();
+
+  printf("\n%d tests, %d failed\n", testsRun, testsFailed);
+  return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include "ssd1306_emulator.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint8_t CONTROL_DATA_BIT = 0x40;
+static const uint8_t ADDRESS = 0x3C;
+
+// Argument bytes of the SSD1306 commands with parameters
+static uint8_t argumentCount(uint8_t command) {
+  switch (command) {
+    case 0x21:  // Column address
+    case 0x22:  // Page address
+      return 2;
+    case 0x20:  // Memory addressing mode
+    case 0x81:  // Contrast
+    case 0x8D:  // Charge pump
+    case 0xA8:  // Multiplex ratio
+    case 0xD3:  // Display offset
+    case 0xD5:  // Clock divide
+    case 0xD9:  // Pre-charge
+    case 0xDA:  // COM pins
+    case 0xDB:  // VCOMH deselect
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+Ssd1306Emulator& Ssd1306Emulator::getInstance() {
+  static Ssd1306Emulator instance;
+  return instance;
+}
+
+Ssd1306Emulator::Ssd1306Emulator() {
+  reset();
+}
+
+void Ssd1306Emulator::reset() {
+  memset(ram, 0, sizeof(ram));
+  colStart = column = 0;
+  colEnd = WIDTH - 1;
+  pageStart = page = 0;
+  pageEnd = PAGES - 1;
+  pendingLength = pendingExpected = 0;
+}
+
+void Ssd1306Emulator::resetStats() {
+  busBytes = 0;
+  transactions = 0;
+  dataBytes = 0;
+}
+
+void Ssd1306Emulator::transaction(uint8_t address, const uint8_t* bytes, size_t length) {
+  busBytes += length + 1;
+  transactions++;
+  if (address != ADDRESS || length == 0) {
+    return;
+  }
+
+  bool isData = (bytes[0] & CONTROL_DATA_BIT) != 0;
+  for (size_t i = 1; i < length; i++) {
+    if (isData) {
+      data(bytes[i]);
+    } else {
+      command(bytes[i]);
+    }
+  }
+}
+
+void Ssd1306Emulator::command(uint8_t byte) {
+  if (pendingExpected == 0) {
+    pending[0] = byte;
+    pendingLength = 1;
+    pendingExpected = argumentCount(byte) + 1;
+  } else {
+    pending[pendingLength++] = byte;
+  }
+  if (pendingLength < pendingExpected) {
+    return;
+  }
+
+  if (pending[0] == 0x21) {
+    colStart = column = pending[1] & 0x7F;
+    colEnd = pending[2] & 0x7F;
+  } else if (pending[0] == 0x22) {
+    pageStart = page = pending[1] & 0x07;
+    pageEnd = pending[2] & 0x07;
+  }
+  pendingExpected = 0;
+}
+
+void Ssd1306Emulator::data(uint8_t byte) {
+  ram[page * WIDTH + column] = byte;
+  dataBytes++;
+
+  // Horizontal addressing: next column, wrap to the next page of the window
+  if (column >= colEnd) {
+    column = colStart;
+    page = (page >= pageEnd) ? pageStart : page + 1;
+  } else {
+    column++;
+  }
+}
+
+bool Ssd1306Emulator::writePbm(const char* path, const uint8_t* frame) {
+  FILE* file = fopen(path, "w");
+  if (!file) {
+    return false;
+  }
+  fprintf(file, "P1\n%d %d\n", WIDTH, HEIGHT);
+  for (int y = 0; y < HEIGHT; y++) {
+    for (int x = 0; x < WIDTH; x++) {
+      fputc(((frame[(y / 8) * WIDTH + x] >> (y & 7)) & 1) ? '1' : '0', file);
+    }
+    fputc('\n', file);
+  }
+  fclose(file);
+  return true;
+}
+
+bool Ssd1306Emulator::readPbm(const char* path, uint8_t* frame) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    return false;
+  }
+  int width = 0;
+  int height = 0;
+  bool ok = fscanf(file, "P1 %d %d", &width, &height) == 2 && width == WIDTH && height == HEIGHT;
+
+  memset(frame, 0, RAM_SIZE);
+  for (int i = 0; ok && i < WIDTH * HEIGHT; ) {
+    int c = fgetc(file);
+    if (c == EOF) {
+      ok = false;
+    } else if (c == '0' || c == '1') {
+      int x = i % WIDTH;
+      int y = i / WIDTH;
+      if (c == '1') frame[(y / 8) * WIDTH + x] |= 1 << (y & 7);
+      i++;
+    }
+  }
+  fclose(file);
+  return ok;
+}
+
+int Ssd1306Emulator::countDifferences(const uint8_t* a, const uint8_t* b) {
+  int differences = 0;
+  for (size_t i = 0; i < RAM_SIZE; i++) {
+    uint8_t diff = a[i] ^ b[i];
+    while (diff) {
+      differences += diff & 1;
+      diff >>= 1;
+    }
+  }
+  return differences;
+}
@@ -0,0 +1,66 @@
+/**
+ * SSD1306 Panel Emulator (host)
+ *
+ * Models the controller side of the I2C link: decodes the command and data
+ * streams written by I2C::write() into the panel's own display RAM, in
+ * horizontal addressing mode with the column/page window set by 0x21/0x22.
+ * What ends up in panelRam() is what a physical OLED would show, so
+ * partial updates are verified end to end, not just the MCU frame buffer.
+ *
+ * Every byte clocked out (address byte included) is counted, as on the
+ * target's HAL.
+ */
+#ifndef SSD1306_EMULATOR_H
+#define SSD1306_EMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Ssd1306Emulator {
+public:
+  static const int WIDTH = 128;
+  static const int HEIGHT = 64;
+  static const int PAGES = HEIGHT / 8;
+  static const size_t RAM_SIZE = WIDTH * PAGES;
+
+  static Ssd1306Emulator& getInstance();
+
+  // One I2C write transaction (control byte first)
+  void transaction(uint8_t address, const uint8_t* data, size_t length);
+
+  const uint8_t* panelRam() const { return ram; }
+  bool pixel(int x, int y) const { return (ram[(y / 8) * WIDTH + x] >> (y & 7)) & 1; }
+  void reset();
+
+  // Bus statistics
+  uint32_t getBusBytes() const { return busBytes; }
+  uint32_t getTransactions() const { return transactions; }
+  uint32_t getDataBytes() const { return dataBytes; }
+  void resetStats();
+
+  // Portable bitmap (P1, plain text) of a page-format frame
+  static bool writePbm(const char* path, const uint8_t* frame);
+  static bool readPbm(const char* path, uint8_t* frame);
+  static int countDifferences(const uint8_t* a, const uint8_t* b);
+
+private:
+  Ssd1306Emulator();
+  void command(uint8_t byte);
+  void data(uint8_t byte);
+
+  uint8_t ram[RAM_SIZE];
+  uint8_t colStart = 0, colEnd = WIDTH - 1;
+  uint8_t pageStart = 0, pageEnd = PAGES - 1;
+  uint8_t column = 0, page = 0;
+
+  // Multi-byte command being assembled
+  uint8_t pending[3];
+  uint8_t pendingLength = 0;
+  uint8_t pendingExpected = 0;
+
+  uint32_t busBytes = 0;
+  uint32_t transactions = 0;
+  uint32_t dataBytes = 0;
+};
+
+#endif // SSD1306_EMULATOR_H
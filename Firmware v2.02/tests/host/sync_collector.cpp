@@ -0,0 +1,270 @@
+/**
+ * Production Record Collector (host)
+ *
+ * Keeps a host copy of the device's record journal
+ * (src/managers/record_journal.h) up to date without re-reading it: sends
+ * SYNC,<watermark> at 115200, appends the records that come back to
+ * <out> and moves the watermark (<out>.wm, the last sequence number held)
+ * forward. The watermark only moves after SYNC,END's count and CRC32
+ * match the records received, and the records are on disk first, so an
+ * interrupted run repeats no more than itself.
+ *
+ * Build (from this directory, Linux/macOS):
+ *   g++ -std=c++11 -O2 -I../../src/core sync_collector.cpp ../../src/core/checksum.cpp \
+ *       -o sync_collector
+ *
+ * Usage:
+ *   ./sync_collector /dev/ttyUSB0 records.csv
+ *   --since N   Ignore the watermark file and start after record N
+ *
+ * Exit status: 0 synced (possibly nothing new), 1 nothing committed.
+ */
+
+#include "checksum.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <sys/time.h>
+#include <termios.h>
+#include <unistd.h>
+
+static const int QUIET_TIMEOUT_MS = 5000;  // No SYNC line for this long: give up
+
+static int port = -1;
+
+static long long nowMs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// ============================================================================
+// SERIAL PORT
+// ============================================================================
+
+static bool openPort(const char* path) {
+  port = open(path, O_RDWR | O_NOCTTY);
+  if (port < 0) {
+    fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  struct termios tty;
+  if (tcgetattr(port, &tty) == 0) {   // Not a tty (e.g. a test pipe): use as is
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, B115200);
+    cfsetospeed(&tty, B115200);
+    tcsetattr(port, TCSANOW, &tty);
+    tcflush(port, TCIFLUSH);
+  }
+  return true;
+}
+
+static void writeAll(const char* data, size_t length) {
+  while (length > 0) {
+    ssize_t n = write(port, data, length);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EINTR) continue;
+      return;
+    }
+    data += n;
+    length -= n;
+  }
+}
+
+// Next line without its line ending, or false after timeoutMs
+static bool readLine(std::string& line, int timeoutMs) {
+  static char pending[512];
+  static size_t pendingLength = 0;
+  static size_t pendingAt = 0;
+  long long deadline = nowMs() + timeoutMs;
+  line.clear();
+
+  for (;;) {
+    while (pendingAt < pendingLength) {
+      char c = pending[pendingAt++];
+      if (c == '\n') {
+        return true;
+      }
+      if (c != '\r') {
+        line += c;
+      }
+    }
+    long long left = deadline - nowMs();
+    if (left <= 0) {
+      return false;
+    }
+    struct pollfd pfd = { port, POLLIN, 0 };
+    if (poll(&pfd, 1, (int)left) <= 0) {
+      continue;
+    }
+    ssize_t n = read(port, pending, sizeof(pending));
+    if (n == 0) {
+      return false;                // End of a test pipe
+    }
+    if (n > 0) {
+      pendingLength = n;
+      pendingAt = 0;
+    }
+  }
+}
+
+// ============================================================================
+// WATERMARK
+// ============================================================================
+
+static unsigned long readWatermark(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "r");
+  if (f == nullptr) {
+    return 0;                      // First run
+  }
+  unsigned long value = 0;
+  if (fscanf(f, "%lu", &value) != 1) {
+    value = 0;
+  }
+  fclose(f);
+  return value;
+}
+
+// Replaced in one rename, so a crash leaves the old or the new value
+static bool writeWatermark(const std::string& path, unsigned long value) {
+  std::string temp = path + ".tmp";
+  FILE* f = fopen(temp.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "%lu\n", value);
+  bool ok = fflush(f) == 0 && fsync(fileno(f)) == 0;
+  ok = (fclose(f) == 0) && ok;
+  return ok && rename(temp.c_str(), path.c_str()) == 0;
+}
+
+// ============================================================================
+// SYNC
+// ============================================================================
+
+static unsigned long parseSequence(const char* record) {
+  char* end;
+  unsigned long sequence = strtoul(record, &end, 10);
+  return (end != record && *end == ',') ? sequence : 0;
+}
+
+static int sync(const char* outPath, unsigned long since) {
+  char command[32];
+  snprintf(command, sizeof(command), "\nSYNC,%lu\n", since);
+  writeAll(command, strlen(command));
+
+  // Earlier output (and an earlier SYNC's reply) is skipped up to our BEGIN
+  char begin[48];
+  snprintf(begin, sizeof(begin), "SYNC,BEGIN,%lu,", since);
+  std::string line;
+  unsigned long last = 0;
+  for (;;) {
+    if (!readLine(line, QUIET_TIMEOUT_MS)) {
+      fprintf(stderr, "No SYNC reply from the device\n");
+      return 1;
+    }
+    if (line.compare(0, strlen(begin), begin) == 0) {
+      last = strtoul(line.c_str() + strlen(begin), nullptr, 10);
+      break;
+    }
+  }
+  if (last < since) {
+    fprintf(stderr, "Device journal ends at %lu, before the watermark %lu (card replaced?)"
+            " - use --since\n", last, since);
+    return 1;
+  }
+
+  std::string records;
+  unsigned long expect = since + 1;
+  uint32_t crc = crc32Begin();
+  for (;;) {
+    if (!readLine(line, QUIET_TIMEOUT_MS)) {
+      fprintf(stderr, "Device went quiet after record %lu - nothing committed\n", expect - 1);
+      return 1;
+    }
+    if (line.compare(0, 5, "SYNC,") != 0) {
+      continue;                    // Diagnostic output in between
+    }
+    const char* body = line.c_str() + 5;
+    if (strncmp(body, "END,", 4) == 0) {
+      unsigned long count = 0;
+      unsigned long lastSent = 0;
+      unsigned long deviceCrc = 0;
+      if (sscanf(body + 4, "%lu,%lu,%lx", &count, &lastSent, &deviceCrc) != 3 ||
+          count != expect - 1 - since || lastSent != expect - 1 ||
+          deviceCrc != crc32End(crc)) {
+        fprintf(stderr, "END does not match what arrived (%s) - nothing committed\n", body);
+        return 1;
+      }
+      break;
+    }
+    if (parseSequence(body) != expect) {
+      fprintf(stderr, "Expected record %lu, got: %s - nothing committed\n", expect, body);
+      return 1;
+    }
+    size_t length = strlen(body);
+    crc = crc32Update(crc, body, length);
+    crc = crc32Update(crc, "\n", 1);
+    records.append(body, length);
+    records += '\n';
+    expect++;
+  }
+
+  unsigned long received = expect - 1 - since;
+  if (received > 0) {
+    FILE* out = fopen(outPath, "ab");
+    if (out == nullptr) {
+      fprintf(stderr, "Cannot open %s\n", outPath);
+      return 1;
+    }
+    bool ok = fwrite(records.data(), 1, records.size(), out) == records.size() &&
+              fflush(out) == 0 && fsync(fileno(out)) == 0;
+    ok = (fclose(out) == 0) && ok;
+    if (!ok || !writeWatermark(std::string(outPath) + ".wm", expect - 1)) {
+      fprintf(stderr, "Cannot write %s - watermark left at %lu\n", outPath, since);
+      return 1;
+    }
+  }
+  if (received > 0) {
+    fprintf(stderr, "%lu new records (%lu..%lu)\n", received, since + 1, expect - 1);
+  } else {
+    fprintf(stderr, "No new records after %lu\n", since);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  const char* args[2] = { nullptr, nullptr };
+  int count = 0;
+  bool haveSince = false;
+  unsigned long since = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--since") == 0 && i + 1 < argc) {
+      since = strtoul(argv[++i], nullptr, 10);
+      haveSince = true;
+    } else if (count < 2) {
+      args[count++] = argv[i];
+    }
+  }
+  if (count < 2) {
+    fprintf(stderr, "Usage: %s <port> <out> [--since N]\n", argv[0]);
+    return 2;
+  }
+  if (!haveSince) {
+    since = readWatermark(std::string(args[1]) + ".wm");
+  }
+
+  if (!openPort(args[0])) {
+    return 1;
+  }
+  int result = sync(args[1], since);
+  close(port);
+  return result;
+}
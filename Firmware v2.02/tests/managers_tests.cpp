@@ -3,9 +3,9 @@
  * Tests for ProductionManager, TimeManager, StorageManager, DisplayManager, LoggerManager, ConfigManager
  * 
  * Test Coverage:
- * - ProductionManager (6 methods)
- * - TimeManager (7 methods)
- * - StorageManager (8 methods)
+ * - ProductionManager (6 methods + session clock)
+ * - TimeManager (7 methods + software clock)
+ * - StorageManager (8 methods + read cache, record journal)
  * - ConfigManager (10 methods)
  * - DisplayManager (basic functionality)
  * - LoggerManager (basic functionality)
@@ -13,6 +13,11 @@
 
 #include <Arduino.h>
 #include "../managers.h"
+#include "../prealloc_log.h"
+#include "../read_cache.h"
+#include "../record_journal.h"
+#include "../display_link.h"
+#include "../serial_out.h"
 
 // Test tracking
 struct ManagerTestResult {
@@ -141,6 +146,34 @@ bool test_ProductionManager_RecoverSession() {
   return success;
 }
 
+/**
+ * Test PM-7: Session Times From the Software Clock
+ * Start, duration and stop read TimeManager, never the RTC on the bus
+ */
+bool test_ProductionManager_SessionClock() {
+  ProductionManager& pm = ProductionManager::getInstance();
+  TimeManager& tm = TimeManager::getInstance();
+  tm.initialize();
+  if (pm.isSessionActive()) {
+    pm.stopSession();
+  }
+  
+  uint32_t readsBefore = tm.getClock().getRtcReads();
+  bool started = pm.startSession();
+  unsigned long duration = pm.getSessionDuration();
+  bool stopped = pm.stopSession();
+  bool noBusTraffic = (tm.getClock().getRtcReads() == readsBefore);
+  
+  long startOffset = (long)pm.getStartTime().unixtime() - (long)tm.getUnixTime();
+  bool result = started && stopped && noBusTraffic && duration <= 1 &&
+                startOffset >= -1 && startOffset <= 0;
+  static char details[64];  // Results keep the pointer
+  snprintf(details, sizeof(details), "RTC reads %s, start offset %lds",
+           noBusTraffic ? "none" : "SEEN", startOffset);
+  recordManagerTest("PM_SessionClock", "ProductionManager", result, details);
+  return result;
+}
+
 // ============================================================================
 // TIME MANAGER TESTS
 // ============================================================================
@@ -232,6 +265,37 @@ bool test_TimeManager_ValidateTime() {
   return isValid;
 }
 
+/**
+ * Test TM-8: Software Clock (no RTC reads between resyncs, tracks the RTC)
+ */
+bool test_TimeManager_SoftwareClock() {
+  TimeManager& tm = TimeManager::getInstance();
+  tm.initialize();
+  
+  const SoftClock& clock = tm.getClock();
+  uint32_t readsBefore = clock.getRtcReads();
+  uint32_t start = tm.getUnixTime();
+  for (int i = 0; i < 1000; i++) {
+    tm.getCurrentTime();
+  }
+  bool noBusTraffic = (clock.getRtcReads() == readsBefore);
+  
+  delay(2000);
+  uint32_t elapsed = tm.getUnixTime() - start;
+  
+  // Software clock must agree with a direct RTC read (to the second)
+  extern RTC_DS3231 rtc;
+  long offset = (long)rtc.now().unixtime() - (long)tm.getUnixTime();
+  
+  bool result = clock.isSynced() && noBusTraffic && elapsed >= 1 && elapsed <= 3 &&
+                offset >= -1 && offset <= 1;
+  static char details[64];  // Results keep the pointer
+  snprintf(details, sizeof(details), "RTC reads %s, %lus elapsed, offset %lds",
+           noBusTraffic ? "none" : "SEEN", (unsigned long)elapsed, offset);
+  recordManagerTest("TM_SoftClock", "TimeManager", result, details);
+  return result;
+}
+
 // ============================================================================
 // STORAGE MANAGER TESTS
 // ============================================================================
@@ -340,6 +404,181 @@ bool test_StorageManager_DeleteFile() {
   return success;
 }
 
+/**
+ * Test SM-9: Read Cache Hits and Write Invalidation
+ * Second read of the same file is served from the cache; an append
+ * drops the cached blocks so the new text is visible immediately
+ */
+bool test_StorageManager_ReadCache() {
+  StorageManager& sm = StorageManager::getInstance();
+  sm.initialize();
+  ReadCache& cache = ReadCache::getInstance();
+  
+  const char* path = "/cache_test.txt";
+  SD.remove(path);
+  cache.invalidate(path, true);
+  PreallocLog::getInstance().append(path, "first\n");
+  
+  char buffer[32];
+  cache.resetStats();
+  sm.readFile(path, buffer, sizeof(buffer));
+  uint32_t coldMisses = cache.getMisses();
+  sm.readFile(path, buffer, sizeof(buffer));
+  bool warmHit = cache.getMisses() == coldMisses && cache.getHits() > 0;
+  
+  PreallocLog::getInstance().append(path, "second\n");
+  sm.readFile(path, buffer, sizeof(buffer));
+  bool invalidated = strcmp(buffer, "first\nsecond\n") == 0 &&
+                     cache.getMisses() > coldMisses;
+  
+  // FAT names are case-insensitive, so are cache keys
+  bool caseFolded = ReadCache::pathKey("/Production_a.txt") == ReadCache::pathKey("PRODUCTION_A.TXT");
+  
+  SD.remove(path);
+  cache.invalidate(path, true);
+  
+  bool result = warmHit && invalidated && caseFolded;
+  recordManagerTest("SM_ReadCache", "StorageManager", result, "Cache hit on re-read, invalidated by append");
+  return result;
+}
+
+/**
+ * Test SM-10: Record Journal Sequence, Seek and Repair
+ * Records get consecutive sequence numbers, SYNC-style reads start after
+ * a watermark, and a line whose index entry was lost is re-indexed by
+ * the next begin()
+ */
+bool test_StorageManager_RecordJournal() {
+  StorageManager& sm = StorageManager::getInstance();
+  sm.initialize();
+  RecordJournal& journal = RecordJournal::getInstance();
+  
+  const char* text = "/journal_test.txt";
+  const char* index = "/journal_test.idx";
+  SD.remove(text);
+  SD.remove(index);
+  ReadCache::getInstance().invalidate(text, true);
+  ReadCache::getInstance().invalidate(index, true);
+  
+  DateTime start(2026, 10, 17, 8, 0, 0);
+  DateTime stop(2026, 10, 17, 9, 30, 0);
+  bool opened = journal.begin(text, index) && journal.getLastSequence() == 0;
+  bool numbered = journal.addHour(start, 42) == 1 && journal.addSession(start, stop, 120) == 2;
+  
+  char line[RecordJournal::MAX_RECORD + 1];
+  JournalCursor cursor;
+  bool sought = journal.seek(1, cursor) && journal.next(cursor, line, sizeof(line)) &&
+                strcmp(line, "2,SESSION,2026-10-17 08:00:00,2026-10-17 09:30:00,120") == 0 &&
+                !journal.next(cursor, line, sizeof(line));
+  
+  // Power cut between the text and the index write
+  PreallocLog::getInstance().append(text, "3,HOUR,2026-10-17 09:00,7\n");
+  uint32_t repairedBefore = journal.getRepaired();
+  bool repaired = journal.begin(text, index) && journal.getLastSequence() == 3 &&
+                  journal.getRepaired() == repairedBefore + 1 && journal.addHour(stop, 1) == 4 &&
+                  journal.seek(2, cursor) && journal.next(cursor, line, sizeof(line)) &&
+                  RecordJournal::parseSequence(line) == 3;
+  
+  SD.remove(text);
+  SD.remove(index);
+  ReadCache::getInstance().invalidate(text, true);
+  ReadCache::getInstance().invalidate(index, true);
+  journal.begin();
+  
+  bool result = opened && numbered && sought && repaired;
+  recordManagerTest("SM_RecordJournal", "StorageManager", result, "Sequenced appends, seek after watermark, boot repair");
+  return result;
+}
+
+/**
+ * Test SM-11: Paced File Output
+ * READ of a file four times the TX ring, written from the loop while the
+ * UART drains it: every line arrives, Console drops nothing
+ */
+bool test_StorageManager_PacedOutput() {
+  StorageManager& sm = StorageManager::getInstance();
+  sm.initialize();
+  
+  const char* path = "/paced_test.txt";
+  SD.remove(path);
+  ReadCache::getInstance().invalidate(path, true);
+  char line[64];
+  int lines = 0;
+  for (uint32_t size = 0; size < 4 * SerialOut::RING_SIZE; size += strlen(line)) {
+    snprintf(line, sizeof(line), "Paced output test line %04d ........................\n", ++lines);
+    PreallocLog::getInstance().append(path, line);
+  }
+  
+  Console.flush();
+  uint32_t droppedBefore = Console.getDroppedBytes();
+  uint32_t writtenBefore = Console.getWritten();
+  bool started = sm.printFile(path);
+  unsigned long start = millis();
+  while (sm.isOutputActive() && millis() - start < 10000) {
+    sm.serviceOutput();
+    Console.pump();
+    delay(1);
+  }
+  Console.flush();
+  
+  uint32_t written = Console.getWritten() - writtenBefore;
+  bool finished = started && !sm.isOutputActive();
+  bool complete = Console.getDroppedBytes() == droppedBefore &&
+                  written > (uint32_t)lines * 40;
+  
+  SD.remove(path);
+  ReadCache::getInstance().invalidate(path, true);
+  
+  bool result = finished && complete;
+  char details[96];
+  snprintf(details, sizeof(details), "%d lines, %lu bytes written, %lu dropped", lines,
+           (unsigned long)written, (unsigned long)(Console.getDroppedBytes() - droppedBefore));
+  recordManagerTest("SM_PacedOutput", "StorageManager", result, details);
+  return result;
+}
+
+/**
+ * Test SM-12: Bounded Output Passes
+ * SEARCH for a name nothing matches prints no lines, so only the step
+ * limit ends each pass: the listing takes one pass per
+ * OUTPUT_STEPS_PER_PASS entries instead of one pass for the whole card
+ */
+static void countListed(const char*, uint32_t, bool, void* context) {
+  (*static_cast<int*>(context))++;
+}
+
+bool test_StorageManager_BoundedOutput() {
+  StorageManager& sm = StorageManager::getInstance();
+  sm.initialize();
+  
+  int files = 0;
+  sm.forEachFile(countListed, &files);
+  
+  uint32_t handlerStart = micros();
+  bool started = sm.searchFiles("NO_SUCH_FILE_ANYWHERE");
+  uint32_t handlerUs = micros() - handlerStart;
+  
+  int passes = 0;
+  uint32_t worstUs = 0;
+  while (sm.isOutputActive() && passes < 100000) {
+    uint32_t passStart = micros();
+    sm.serviceOutput();
+    uint32_t elapsed = micros() - passStart;
+    if (elapsed > worstUs) worstUs = elapsed;
+    Console.pump();
+    passes++;
+  }
+  Console.flush();
+  
+  bool result = started && !sm.isOutputActive() &&
+                passes >= files / StorageManager::OUTPUT_STEPS_PER_PASS && handlerUs < 1000;
+  char details[96];
+  snprintf(details, sizeof(details), "%d files, %d passes, worst %lu us, handler %lu us", files,
+           passes, (unsigned long)worstUs, (unsigned long)handlerUs);
+  recordManagerTest("SM_BoundedOutput", "StorageManager", result, details);
+  return result;
+}
+
 // ============================================================================
 // CONFIG MANAGER TESTS
 // ============================================================================
@@ -546,6 +785,35 @@ bool test_LoggerManager_SetLevel() {
   return true;
 }
 
+/**
+ * Test LM-7: Coalescing
+ * Only identical messages are counted as repeats; ERROR is never coalesced
+ */
+bool test_LoggerManager_Coalescing() {
+  static const char* const transition = "Coalescing test %s -> %s";
+  static const char* const failure = "Coalescing test error %d";
+  uint32_t before = LoggerManager::getCoalesced();
+  
+  LOG_WARN(FSM, transition, "INITIALIZATION", "READY");
+  LOG_WARN(FSM, transition, "READY", "PRODUCTION");
+  bool differentArgs = LoggerManager::getCoalesced() == before;
+  
+  LOG_WARN(FSM, transition, "READY", "PRODUCTION");
+  bool identical = LoggerManager::getCoalesced() == before + 1;
+  
+  LOG_ERROR(FSM, failure, 7);
+  LOG_ERROR(FSM, failure, 7);
+  bool errors = LoggerManager::getCoalesced() == before + 1;
+  
+  bool result = differentArgs && identical && errors;
+  char details[96];
+  snprintf(details, sizeof(details), "args differ %s, identical %s, errors %s",
+           differentArgs ? "kept" : "LOST", identical ? "counted" : "PRINTED",
+           errors ? "kept" : "LOST");
+  recordManagerTest("LM_Coalescing", "LoggerManager", result, details);
+  return result;
+}
+
 // ============================================================================
 // DISPLAY MANAGER TESTS
 // ============================================================================
@@ -597,6 +865,114 @@ bool test_DisplayManager_Clear() {
   return success;
 }
 
+/**
+ * Test DM-5: Partial Page Updates
+ * Only changed fields go over I2C - a count change costs a fraction of a frame
+ */
+static void waitForDisplayLink() {
+  unsigned long start = millis();
+  while (!DisplayLink::getInstance().isIdle() && millis() - start < 200) {
+    delay(1);
+  }
+}
+
+bool test_DisplayManager_PartialUpdate() {
+  DisplayManager& dm = DisplayManager::getInstance();
+  DisplayLink& link = DisplayLink::getInstance();
+  dm.initialize();
+  
+  dm.setStatusText("READY");
+  dm.setCount(41);
+  dm.setClock(12, 34);
+  dm.setStorageOk(true);
+  dm.update();  // First flush sends the whole frame
+  waitForDisplayLink();
+  
+  dm.resetStats();
+  dm.setStatusText("READY");
+  dm.setCount(41);
+  dm.update();
+  waitForDisplayLink();
+  bool unchangedSilent = (link.getBytesSent() == 0);
+  
+  dm.setCount(42);
+  dm.update();
+  waitForDisplayLink();
+  uint32_t countBytes = link.getBytesSent();
+  bool countPartial = (countBytes > 0 && countBytes < 1024 / 10);
+  
+  bool success = unchangedSilent && countPartial;
+  static char details[64];  // Results keep the pointer
+  snprintf(details, sizeof(details), "Count change sent %lu bytes (full frame 1024)",
+           (unsigned long)countBytes);
+  recordManagerTest("DM_PartialUpdate", "DisplayManager", success, details);
+  return success;
+}
+
+/**
+ * Test DM-6: Non-blocking Flush
+ * A full-screen update returns long before its ~1 KB transfer completes
+ */
+bool test_DisplayManager_AsyncFlush() {
+  DisplayManager& dm = DisplayManager::getInstance();
+  DisplayLink& link = DisplayLink::getInstance();
+  dm.initialize();
+  waitForDisplayLink();
+  link.resetStats();
+  
+  unsigned long start = micros();
+  dm.showErrorScreen("ASYNC TEST");  // Full screen: every page changes
+  unsigned long submitMicros = micros() - start;
+  
+  waitForDisplayLink();
+  unsigned long transferMicros = link.getLastFrameMicros();
+  
+  bool success = link.isAsync() && link.getFramesSent() >= 1 &&
+                 link.getFailedFrames() == 0 && submitMicros < transferMicros;
+  static char details[64];  // Results keep the pointer
+  snprintf(details, sizeof(details), "Submit %lu us, transfer %lu us",
+           submitMicros, transferMicros);
+  recordManagerTest("DM_AsyncFlush", "DisplayManager", success, details);
+  return success;
+}
+
+/**
+ * Test DM-7: View Model Diff
+ * An unchanged view renders nothing; a new minute renders one frame
+ */
+bool test_DisplayManager_ViewModelDiff() {
+  DisplayManager& dm = DisplayManager::getInstance();
+  dm.initialize();
+  
+  DisplayView view;
+  memset(&view, 0, sizeof(view));
+  view.count = 7;
+  view.rtcOk = true;
+  view.hour = 9;
+  view.minute = 15;
+  view.sdOk = true;
+  strncpy(view.status, "READY", sizeof(view.status) - 1);
+  
+  delay(150);  // Past the refresh rate limit
+  bool first = dm.render(view);
+  dm.resetStats();
+  
+  // Idle READY screen: a second's worth of loop passes
+  for (int i = 0; i < 1000; i++) {
+    dm.render(view);
+  }
+  bool idleSkipped = (dm.getFramesRendered() == 0 && dm.getFramesSkipped() == 1000);
+  
+  delay(150);
+  view.minute = 16;
+  bool minuteRendered = dm.render(view) && dm.getFramesRendered() == 1;
+  
+  bool success = first && idleSkipped && minuteRendered;
+  recordManagerTest("DM_ViewModelDiff", "DisplayManager", success,
+                    "Unchanged views skipped, new minute renders once");
+  return success;
+}
+
 // ============================================================================
 // RUN ALL MANAGER TESTS
 // ============================================================================
@@ -616,6 +992,7 @@ void runAllManagerTests() {
   test_ProductionManager_IncrementCount();
   test_ProductionManager_GetCurrentCount();
   test_ProductionManager_RecoverSession();
+  test_ProductionManager_SessionClock();
   
   // Time Manager Tests
   Serial.println("Testing TimeManager...");
@@ -626,6 +1003,7 @@ void runAllManagerTests() {
   test_TimeManager_GetHourOfDay();
   test_TimeManager_GetDayOfMonth();
   test_TimeManager_ValidateTime();
+  test_TimeManager_SoftwareClock();
   
   // Storage Manager Tests
   Serial.println("Testing StorageManager...");
@@ -637,6 +1015,10 @@ void runAllManagerTests() {
   test_StorageManager_WriteLogEntry();
   test_StorageManager_GetFreeSpace();
   test_StorageManager_DeleteFile();
+  test_StorageManager_ReadCache();
+  test_StorageManager_RecordJournal();
+  test_StorageManager_PacedOutput();
+  test_StorageManager_BoundedOutput();
   
   // Config Manager Tests
   Serial.println("Testing ConfigManager...");
@@ -659,6 +1041,7 @@ void runAllManagerTests() {
   test_LoggerManager_Warn();
   test_LoggerManager_Error();
   test_LoggerManager_SetLevel();
+  test_LoggerManager_Coalescing();
   
   // Display Manager Tests
   Serial.println("Testing DisplayManager...");
@@ -666,6 +1049,9 @@ void runAllManagerTests() {
   test_DisplayManager_StartupScreen();
   test_DisplayManager_ProductionDisplay();
   test_DisplayManager_Clear();
+  test_DisplayManager_PartialUpdate();
+  test_DisplayManager_AsyncFlush();
+  test_DisplayManager_ViewModelDiff();
   
   unsigned long totalTime = millis() - totalStartTime;
   
@@ -13,6 +13,10 @@
 #include <Arduino.h>
 #include "../state_manager.h"
 #include "../managers.h"
+#include "../state_store.h"
+#include "../checkpoint_ring.h"
+#include "../prealloc_log.h"
+#include "../session_archive.h"
 
 struct RecoveryTestResult {
   const char* testName;
@@ -161,6 +165,224 @@ bool test_TimePersistenceAfterPowerLoss() {
   return timeValid;
 }
 
+/**
+ * Test REC-5: Torn State Record Rejected
+ * Verify a partially written state record fails CRC validation
+ */
+bool test_TornStateRecordRejected() {
+  unsigned long startTime = millis();
+  
+  PersistentStateRecord rec;
+  StateStore::resetRecord(rec);
+  rec.sequence = 7;
+  rec.currentCount = 1234;
+  rec.cumulativeCount = 5678;
+  StateStore::seal(rec);
+  bool sealedValid = StateStore::isValid(rec);
+  
+  // Simulate power loss halfway through the 64-byte write
+  PersistentStateRecord torn = rec;
+  memset(reinterpret_cast<uint8_t*>(&torn) + 32, 0, sizeof(torn) - 32);
+  bool tornRejected = !StateStore::isValid(torn);
+  
+  // Single bit flip must also be caught
+  PersistentStateRecord flipped = rec;
+  flipped.currentCount ^= 0x10;
+  bool flipRejected = !StateStore::isValid(flipped);
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = sealedValid && tornRejected && flipRejected;
+  recordRecoveryTest("REC_TornState", result, "Torn/corrupt state record rejected by CRC");
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
+/**
+ * Test REC-6: State Block Commit/Reload Round Trip
+ * Verify all counters come back from one read after a commit
+ */
+bool test_StateBlockRoundTrip() {
+  unsigned long startTime = millis();
+  
+  StateStore& store = StateStore::getInstance();
+  bool loaded = store.begin();
+  
+  PersistentStateRecord& state = store.data();
+  uint32_t seqBefore = store.getSequence();
+  state.currentCount = 321;
+  state.hourlyCount = 45;
+  state.cumulativeCount = 6789;
+  state.productionActive = 1;
+  bool committed = store.commit();
+  
+  // Simulate reboot: reload from card
+  bool reloaded = store.begin();
+  const PersistentStateRecord& after = store.data();
+  
+  bool valuesMatch = after.currentCount == 321 && after.hourlyCount == 45 &&
+                     after.cumulativeCount == 6789 && after.productionActive == 1 &&
+                     after.sequence == seqBefore + 1;
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = loaded && committed && reloaded && valuesMatch;
+  recordRecoveryTest("REC_StateBlock", result, "State block committed and reloaded atomically");
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
+/**
+ * Test REC-7: Checkpoint Ring Wrap-Around
+ * Verify the newest checkpoint survives a reboot after the ring wraps
+ */
+bool test_CheckpointRingWrapAround() {
+  unsigned long startTime = millis();
+  
+  CheckpointRing& ring = CheckpointRing::getInstance();
+  bool ready = ring.begin();
+  
+  // Write more records than slots so the ring wraps
+  const int writes = CheckpointRing::RING_SLOTS + 5;
+  bool allWritten = true;
+  for (int i = 1; i <= writes; i++) {
+    CheckpointRecord cp;
+    memset(&cp, 0, sizeof(cp));
+    cp.currentCount = i;
+    cp.productionStartUnix = 1700000000UL + i;
+    allWritten = allWritten && ring.write(cp);
+  }
+  
+  // Simulate reboot: rescan the ring
+  ring.begin();
+  CheckpointRecord newest;
+  bool found = ring.latest(newest);
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = ready && allWritten && found && newest.currentCount == writes &&
+                newest.productionStartUnix == 1700000000UL + writes;
+  recordRecoveryTest("REC_CheckpointRing", result, "Newest checkpoint recovered after wrap", writes);
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
+/**
+ * Test REC-8: Checkpoint Commits Touch One Sector
+ * Verify a checkpoint only rewrites the sector holding its slot
+ */
+bool test_CheckpointSingleSectorCommit() {
+  unsigned long startTime = millis();
+  
+  CheckpointRing& ring = CheckpointRing::getInstance();
+  ring.begin();
+  
+  uint32_t sectorWritesBefore = EEPROM_HAL::getSectorWriteCount();
+  CheckpointRecord cp;
+  memset(&cp, 0, sizeof(cp));
+  cp.currentCount = 99;
+  bool written = ring.write(cp);
+  uint32_t sectorWrites = EEPROM_HAL::getSectorWriteCount() - sectorWritesBefore;
+  
+  // Slower interval must never project a shorter life
+  EnduranceReport fast = CheckpointRing::projectEndurance(1000);
+  EnduranceReport slow = CheckpointRing::projectEndurance(10000);
+  bool projectionSane = fast.checkpointsPerDay == 86400 &&
+                        slow.projectedLifeYears >= fast.projectedLifeYears;
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = written && sectorWrites == 1 && projectionSane;
+  recordRecoveryTest("REC_CheckpointSector", result, "One sector per checkpoint, endurance projected");
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
+/**
+ * Test REC-9: Pre-allocated Log Header
+ * Verify the logical length survives a round trip and a torn header is
+ * rejected (the file is then read as plain text, never past real data)
+ */
+bool test_PreallocLogHeader() {
+  unsigned long startTime = millis();
+  
+  char header[PreallocLog::HEADER_SIZE + 1];
+  PreallocLog::formatHeader(header, 123, PreallocLog::DAILY_CAPACITY);
+  
+  uint32_t length = 0;
+  uint32_t capacity = 0;
+  bool parsed = PreallocLog::parseHeader(header, length, capacity);
+  bool roundTrip = parsed && length == 123 && capacity == PreallocLog::DAILY_CAPACITY &&
+                   strlen(header) == PreallocLog::HEADER_SIZE;
+  
+  // Power cut mid-header: digits overwritten by padding
+  header[12] = PreallocLog::PAD_BYTE;
+  bool tornRejected = !PreallocLog::parseHeader(header, length, capacity);
+  
+  // Length beyond capacity is never valid
+  PreallocLog::formatHeader(header, 600, 512);
+  bool overrunRejected = !PreallocLog::parseHeader(header, length, capacity);
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = roundTrip && tornRejected && overrunRejected;
+  recordRecoveryTest("REC_LogHeader", result, "Log length header round-trips, torn header rejected");
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
+/**
+ * Test REC-10: Session Archive Header and Names
+ * Verify archive headers reject tearing/overflow and session files map to
+ * the right monthly container (including upper-cased serial input)
+ */
+bool test_SessionArchiveHeader() {
+  unsigned long startTime = millis();
+  
+  ArchiveHeader header;
+  memset(&header, 0, sizeof(header));
+  header.maxEntries = SessionArchive::MAX_ENTRIES;
+  header.entryCount = 3;
+  SessionArchive::seal(header);
+  bool sealedValid = SessionArchive::isValid(header);
+  
+  // Count bumped without re-sealing (torn header write)
+  header.entryCount = 4;
+  bool tornRejected = !SessionArchive::isValid(header);
+  
+  // Count beyond the reserved index
+  header.entryCount = SessionArchive::MAX_ENTRIES + 1;
+  SessionArchive::seal(header);
+  bool overflowRejected = !SessionArchive::isValid(header);
+  
+  char month[8];
+  char path[32];
+  bool monthParsed =
+    SessionArchive::sessionMonth("/Production_2025-11-15_14h30m-16h45m.txt", month) &&
+    strcmp(month, "2025-11") == 0 &&
+    SessionArchive::sessionMonth("PRODUCTION_2025-11-15_14H30M-16H45M.TXT", month);
+  bool othersIgnored = !SessionArchive::sessionMonth("/DailyProduction_2025-11-15.txt", month) &&
+                       !SessionArchive::sessionMonth("/Production_next.tmp", month);
+  SessionArchive::formatArchivePath(path, sizeof(path), "2025-11");
+  bool pathValid = strcmp(path, "/Archive_2025-11.arc") == 0 &&
+                   SessionArchive::isArchiveName(path) &&
+                   !SessionArchive::isArchiveName("/Archive_2025-11.txt");
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  bool result = sealedValid && tornRejected && overflowRejected &&
+                monthParsed && othersIgnored && pathValid;
+  recordRecoveryTest("REC_ArchiveHeader", result, "Archive index header validated, months mapped");
+  recoveryResults[recoveryTestCount - 1].executionTime = elapsed;
+  
+  return result;
+}
+
 // ============================================================================
 // HARDWARE FAILURE SIMULATION TESTS
 // ============================================================================
@@ -558,6 +780,12 @@ void runAllRecoveryTests() {
   test_SessionRecoveryAfterPowerLoss();
   test_ConfigurationPersistence();
   test_TimePersistenceAfterPowerLoss();
+  test_TornStateRecordRejected();
+  test_StateBlockRoundTrip();
+  test_CheckpointRingWrapAround();
+  test_CheckpointSingleSectorCommit();
+  test_PreallocLogHeader();
+  test_SessionArchiveHeader();
   
   // Hardware Failure Simulation
   Serial.println("Hardware Failure Handling:");